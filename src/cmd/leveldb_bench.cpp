@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/program_options.hpp>
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+#include "depends/common/FixedHash.h"
+#include "depends/libDatabase/LevelDB.h"
+
+/// Measures the latency of random point lookups, as for the state trie nodes
+/// and the transaction bodies, under the LevelDB tuning profiles and key
+/// encodings. Reads constants.xml from the current directory.
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+#define ERROR_UNEXPECTED -3
+
+using namespace std;
+namespace po = boost::program_options;
+
+struct Latency {
+  double m_avgUs{0};
+  double m_p50Us{0};
+  double m_p99Us{0};
+};
+
+Latency Summarize(vector<double>& samples) {
+  Latency latency;
+  if (samples.empty()) {
+    return latency;
+  }
+  sort(samples.begin(), samples.end());
+  for (const auto& sample : samples) {
+    latency.m_avgUs += sample;
+  }
+  latency.m_avgUs /= samples.size();
+  latency.m_p50Us = samples[samples.size() / 2];
+  latency.m_p99Us = samples[samples.size() * 99 / 100];
+  return latency;
+}
+
+string ToKey(const dev::h256& hash, bool binaryKeys) {
+  return binaryKeys ? string((const char*)hash.data(), hash.size)
+                    : hash.hex();
+}
+
+/// Fills a database with numKeys random keys, then times numGets lookups of
+/// the keys present and as many of keys absent
+bool RunBenchmark(const string& path, const string& profile, bool binaryKeys,
+                  const vector<dev::h256>& keys, unsigned int valueSize,
+                  unsigned int numGets) {
+  boost::filesystem::remove_all(path);
+
+  leveldb::DB* rawDB = nullptr;
+  leveldb::Status status =
+      leveldb::DB::Open(LevelDB::GetProfileOptions(profile), path, &rawDB);
+  if (!status.ok()) {
+    std::cerr << "Failed to open " << path << ": " << status.ToString()
+              << std::endl;
+    return false;
+  }
+  unique_ptr<leveldb::DB> db(rawDB);
+
+  mt19937_64 rng(1);
+  const string value(valueSize, 'v');
+  leveldb::WriteBatch batch;
+  for (size_t i = 0; i < keys.size(); i++) {
+    batch.Put(ToKey(keys[i], binaryKeys), value);
+    if ((i + 1) % 10000 == 0 || i + 1 == keys.size()) {
+      status = db->Write(leveldb::WriteOptions(), &batch);
+      batch.Clear();
+      if (!status.ok()) {
+        std::cerr << "Write failed: " << status.ToString() << std::endl;
+        return false;
+      }
+    }
+  }
+  // Reads from the tables rather than the memtable
+  db->CompactRange(nullptr, nullptr);
+
+  using Clock = chrono::steady_clock;
+  vector<double> hits;
+  vector<double> misses;
+  uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+  string read;
+  for (unsigned int i = 0; i < numGets; i++) {
+    const string key = ToKey(keys[pick(rng)], binaryKeys);
+    auto start = Clock::now();
+    status = db->Get(leveldb::ReadOptions(), key, &read);
+    hits.emplace_back(
+        chrono::duration<double, micro>(Clock::now() - start).count());
+    if (!status.ok()) {
+      std::cerr << "Missing key: " << status.ToString() << std::endl;
+      return false;
+    }
+
+    dev::h256 absent;
+    for (auto& byte : absent.asArray()) {
+      byte = rng();
+    }
+    const string absentKey = ToKey(absent, binaryKeys);
+    start = Clock::now();
+    db->Get(leveldb::ReadOptions(), absentKey, &read);
+    misses.emplace_back(
+        chrono::duration<double, micro>(Clock::now() - start).count());
+  }
+
+  const Latency hit = Summarize(hits);
+  const Latency miss = Summarize(misses);
+  std::cout << profile << (binaryKeys ? " binary keys" : " hex keys")
+            << ": hit avg " << hit.m_avgUs << " us, p50 " << hit.m_p50Us
+            << " us, p99 " << hit.m_p99Us << " us; miss avg " << miss.m_avgUs
+            << " us, p50 " << miss.m_p50Us << " us, p99 " << miss.m_p99Us
+            << " us" << std::endl;
+
+  db.reset();
+  boost::filesystem::remove_all(path);
+  return true;
+}
+
+int main(int argc, const char* argv[]) {
+  string path;
+  unsigned int numKeys = 0;
+  unsigned int valueSize = 0;
+  unsigned int numGets = 0;
+
+  try {
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "path,p", po::value<string>(&path)->default_value("leveldb_bench"),
+        "scratch directory of the databases, removed afterwards")(
+        "keys,k", po::value<unsigned int>(&numKeys)->default_value(500000),
+        "number of keys")(
+        "value_size,v", po::value<unsigned int>(&valueSize)->default_value(200),
+        "size of the values in bytes")(
+        "gets,g", po::value<unsigned int>(&numGets)->default_value(100000),
+        "number of lookups of present keys, and of absent keys");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    if (numKeys == 0) {
+      std::cerr << "ERROR: no keys" << std::endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    mt19937_64 rng(0);
+    vector<dev::h256> keys(numKeys);
+    for (auto& key : keys) {
+      for (auto& byte : key.asArray()) {
+        byte = rng();
+      }
+    }
+
+    // Before, then with each of the tunings
+    const vector<pair<string, bool>> runs = {{"default", false},
+                                             {"point_lookup", false},
+                                             {"point_lookup", true}};
+    for (const auto& run : runs) {
+      if (!RunBenchmark(path, run.first, run.second, keys, valueSize,
+                        numGets)) {
+        return ERROR_UNEXPECTED;
+      }
+    }
+  } catch (std::exception& e) {
+    std::cerr << "Unhandled Exception reached the top of main: " << e.what()
+              << ", application will now exit" << std::endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
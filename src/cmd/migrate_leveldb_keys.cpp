@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include "depends/libDatabase/LevelDB.h"
+
+/// Rewrites the h256 keys of a database stored in hex as their 32 bytes, for
+/// LEVELDB_BINARY_KEY_DBS, or back with --revert. Run it on a stopped node.
+///
+/// Every key of 64 hex characters is rewritten, and with --revert every key
+/// of 32 bytes, whatever it stands for. Only convert the databases read and
+/// written through OverlayDB, whose keys of that size are all trie node
+/// hashes: state and contractTrie. Their 33-byte aux keys, and the
+/// state_purge and contractTrie_purge databases, are left as they are. The
+/// other databases are also looked up or iterated by string keys, and must
+/// stay in hex.
+///
+/// The format is recorded in the database, and the node refuses to open it
+/// if it is not the one set by LEVELDB_BINARY_KEY_DBS.
+
+#define SUCCESS 0
+#define ERROR_IN_COMMAND_LINE -1
+#define ERROR_UNHANDLED_EXCEPTION -2
+#define ERROR_UNEXPECTED -3
+
+using namespace std;
+namespace po = boost::program_options;
+
+int main(int argc, const char* argv[]) {
+  string dbPath;
+  bool revert = false;
+
+  try {
+    po::options_description desc("Options");
+
+    desc.add_options()("help,h", "Print help messages")(
+        "db,d", po::value<string>(&dbPath)->required(),
+        "path of the database, e.g. persistence/state")(
+        "revert,r", po::bool_switch(&revert),
+        "convert the binary keys back to hex");
+
+    po::variables_map vm;
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm);
+
+      if (vm.count("help")) {
+        cout << desc << endl;
+        return SUCCESS;
+      }
+      po::notify(vm);
+    } catch (boost::program_options::required_option& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      std::cout << desc;
+      return ERROR_IN_COMMAND_LINE;
+    } catch (boost::program_options::error& e) {
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+
+    uint64_t numKeys = 0;
+    uint64_t numConverted = 0;
+    if (!LevelDB::MigrateKeys(dbPath, !revert, numKeys, numConverted)) {
+      std::cerr << "Migration of " << dbPath << " failed" << std::endl;
+      return ERROR_UNEXPECTED;
+    }
+
+    std::cout << numConverted << " of " << numKeys << " keys converted to "
+              << (revert ? "hex" : "binary") << std::endl;
+  } catch (std::exception& e) {
+    std::cerr << "Unhandled Exception reached the top of main: " << e.what()
+              << ", application will now exit" << std::endl;
+    return ERROR_UNHANDLED_EXCEPTION;
+  }
+
+  return SUCCESS;
+}
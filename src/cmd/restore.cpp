@@ -205,7 +205,7 @@ int main(int argc, char* argv[]) {
 
   sync.InitializeGenesisBlocks(mediator.m_dsBlockChain,
                                mediator.m_txBlockChain);
-  // cout << dsBlock.GetHeader().GetBlockNum() << endl;
+  // cout << dsBlock->GetHeader().GetBlockNum() << endl;
   // AccountStore::GetInstance().Init();
   {
     lock_guard<mutex> lock(mediator.m_mutexInitialDSCommittee);
@@ -271,9 +271,9 @@ int main(int argc, char* argv[]) {
     cout << "Failed to reset BlockLinkDB" << endl;
     return PERSISTENCE_ERROR;
   }
-  const auto& dsBlock = mediator.m_dsBlockChain.GetBlock(0);
+  const auto dsBlock = mediator.m_dsBlockChain.GetBlockPtr(0);
   mediator.m_blocklinkchain.AddBlockLink(0, 0, BlockType::DS,
-                                         dsBlock.GetBlockHash());
+                                         dsBlock->GetBlockHash());
 
   TxBlockSharedPtr latestTxBlockPruned;
   if (!BlockStorage::GetBlockStorage().GetTxBlock(epoch, latestTxBlockPruned)) {
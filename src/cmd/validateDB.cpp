@@ -40,8 +40,8 @@ int main() {
 
   sync.InitializeGenesisBlocks(mediator.m_dsBlockChain,
                                mediator.m_txBlockChain);
-  const auto& dsBlock = mediator.m_dsBlockChain.GetBlock(0);
-  // cout << dsBlock.GetHeader().GetBlockNum() << endl;
+  const auto dsBlock = mediator.m_dsBlockChain.GetBlockPtr(0);
+  // cout << dsBlock->GetHeader().GetBlockNum() << endl;
   {
     lock_guard<mutex> lock(mediator.m_mutexInitialDSCommittee);
     if (!UpgradeManager::GetInstance().LoadInitialDS(
@@ -50,7 +50,7 @@ int main() {
     }
   }
   mediator.m_blocklinkchain.AddBlockLink(0, 0, BlockType::DS,
-                                         dsBlock.GetBlockHash());
+                                         dsBlock->GetBlockHash());
 
   if (GUARD_MODE) {
     Guard::GetInstance().Init();
@@ -130,6 +130,8 @@ const unsigned int NUM_DS_EPOCHS_STATE_HISTORY{
 
 const uint64_t INIT_TRIE_DB_SNAPSHOT_EPOCH{
     ReadConstantUInt64("INIT_TRIE_DB_SNAPSHOT_EPOCH")};
+const unsigned int STATE_TRIE_NODE_CACHE_MB{
+    ReadConstantNumeric("STATE_TRIE_NODE_CACHE_MB")};
 
 // Version constants
 const unsigned int MSG_VERSION{
@@ -282,6 +284,10 @@ const unsigned int RETRY_REJOINING_TIMEOUT{
     ReadConstantNumeric("RETRY_REJOINING_TIMEOUT", "node.epoch_timing.")};
 const unsigned int RETRY_GETSTATEDELTAS_COUNT{
     ReadConstantNumeric("RETRY_GETSTATEDELTAS_COUNT", "node.epoch_timing.")};
+const unsigned int STATEDELTAS_CHUNK_SIZE{
+    ReadConstantNumeric("STATEDELTAS_CHUNK_SIZE", "node.epoch_timing.")};
+const unsigned int STATEDELTAS_FETCH_WINDOW{
+    ReadConstantNumeric("STATEDELTAS_FETCH_WINDOW", "node.epoch_timing.")};
 const unsigned int RETRY_COSIGREWARDS_COUNT{
     ReadConstantNumeric("RETRY_COSIGREWARDS_COUNT", "node.epoch_timing.")};
 const unsigned int MAX_FETCHMISSINGMBS_NUM{
@@ -404,6 +410,12 @@ const bool ENABLE_STATUS_RPC{
     ReadConstantString("ENABLE_STATUS_RPC", "node.jsonrpc.") == "true"};
 const unsigned int NUM_SHARD_PEER_TO_REVEAL{
     ReadConstantNumeric("NUM_SHARD_PEER_TO_REVEAL", "node.jsonrpc.")};
+const unsigned int TXN_INGRESS_THREADS{
+    ReadConstantNumeric("TXN_INGRESS_THREADS", "node.jsonrpc.")};
+const unsigned int TXN_INGRESS_QUEUE_SIZE{
+    ReadConstantNumeric("TXN_INGRESS_QUEUE_SIZE", "node.jsonrpc.")};
+const unsigned int TXN_INGRESS_BATCH_SIZE{
+    ReadConstantNumeric("TXN_INGRESS_BATCH_SIZE", "node.jsonrpc.")};
 const std::string SCILLA_IPC_SOCKET_PATH{
     ReadConstantString("SCILLA_IPC_SOCKET_PATH", "node.jsonrpc.")};
 const std::string SCILLA_SERVER_SOCKET_PATH{
@@ -430,6 +442,20 @@ const unsigned int CONNECTION_ALL_TIMEOUT{
 const unsigned int CONNECTION_CALLBACK_TIMEOUT{
     ReadConstantNumeric("CONNECTION_CALLBACK_TIMEOUT", "node.jsonrpc.")};
 
+// LevelDB constants
+const string LEVELDB_PROFILES{
+    ReadConstantString("LEVELDB_PROFILES", "node.leveldb.")};
+const unsigned int LEVELDB_BLOCK_CACHE_MB{
+    ReadConstantNumeric("LEVELDB_BLOCK_CACHE_MB", "node.leveldb.")};
+const unsigned int LEVELDB_BLOOM_BITS_PER_KEY{
+    ReadConstantNumeric("LEVELDB_BLOOM_BITS_PER_KEY", "node.leveldb.")};
+const unsigned int LEVELDB_WRITE_BUFFER_MB{
+    ReadConstantNumeric("LEVELDB_WRITE_BUFFER_MB", "node.leveldb.")};
+const string LEVELDB_COMPRESSION{
+    ReadConstantString("LEVELDB_COMPRESSION", "node.leveldb.")};
+const string LEVELDB_BINARY_KEY_DBS{
+    ReadConstantString("LEVELDB_BINARY_KEY_DBS", "node.leveldb.")};
+
 // Network composition constants
 const unsigned int COMM_SIZE{
     ReadConstantNumeric("COMM_SIZE", "node.network_composition.")};
@@ -459,8 +485,22 @@ const uint32_t MAXRECVMESSAGE{
     ReadConstantNumeric("MAXRECVMESSAGE", "node.p2pcomm.")};
 const unsigned int MAXRETRYCONN{
     ReadConstantNumeric("MAXRETRYCONN", "node.p2pcomm.")};
-const unsigned int MSGQUEUE_SIZE{
-    ReadConstantNumeric("MSGQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int CONSENSUS_MSGQUEUE_SIZE{
+    ReadConstantNumeric("CONSENSUS_MSGQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int CONSENSUS_MSGQUEUE_WEIGHT{
+    ReadConstantNumeric("CONSENSUS_MSGQUEUE_WEIGHT", "node.p2pcomm.")};
+const unsigned int BLOCK_MSGQUEUE_SIZE{
+    ReadConstantNumeric("BLOCK_MSGQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int BLOCK_MSGQUEUE_WEIGHT{
+    ReadConstantNumeric("BLOCK_MSGQUEUE_WEIGHT", "node.p2pcomm.")};
+const unsigned int LOOKUP_MSGQUEUE_SIZE{
+    ReadConstantNumeric("LOOKUP_MSGQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int LOOKUP_MSGQUEUE_WEIGHT{
+    ReadConstantNumeric("LOOKUP_MSGQUEUE_WEIGHT", "node.p2pcomm.")};
+const unsigned int TXN_MSGQUEUE_SIZE{
+    ReadConstantNumeric("TXN_MSGQUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int TXN_MSGQUEUE_WEIGHT{
+    ReadConstantNumeric("TXN_MSGQUEUE_WEIGHT", "node.p2pcomm.")};
 const unsigned int PUMPMESSAGE_MILLISECONDS{
     ReadConstantNumeric("PUMPMESSAGE_MILLISECONDS", "node.p2pcomm.")};
 const unsigned int SENDQUEUE_SIZE{
@@ -481,6 +521,31 @@ const unsigned int MAX_WHITELISTREQ_LIMIT{
     ReadConstantNumeric("MAX_WHITELISTREQ_LIMIT", "node.p2pcomm.")};
 const unsigned int SENDJOBPEERS_TIMEOUT{
     ReadConstantNumeric("SENDJOBPEERS_TIMEOUT", "node.p2pcomm.")};
+const bool ENABLE_P2P_CONNECTION_POOL{
+    ReadConstantString("ENABLE_P2P_CONNECTION_POOL", "node.p2pcomm.") ==
+    "true"};
+const unsigned int P2P_CONNECTION_IDLE_TIMEOUT{
+    ReadConstantNumeric("P2P_CONNECTION_IDLE_TIMEOUT", "node.p2pcomm.")};
+const unsigned int P2P_CONNECTION_MAX_BACKOFF{
+    ReadConstantNumeric("P2P_CONNECTION_MAX_BACKOFF", "node.p2pcomm.")};
+const bool ENABLE_P2P_EVENT_SEND{
+    ReadConstantString("ENABLE_P2P_EVENT_SEND", "node.p2pcomm.") == "true"};
+const unsigned int P2P_SEND_QUEUE_SIZE{
+    ReadConstantNumeric("P2P_SEND_QUEUE_SIZE", "node.p2pcomm.")};
+const unsigned int P2P_SEND_HIGH_WATERMARK_IN_BYTES{
+    ReadConstantNumeric("P2P_SEND_HIGH_WATERMARK_IN_BYTES", "node.p2pcomm.")};
+const unsigned int P2P_SEND_LOW_WATERMARK_IN_BYTES{
+    ReadConstantNumeric("P2P_SEND_LOW_WATERMARK_IN_BYTES", "node.p2pcomm.")};
+const bool ENABLE_WIRE_COMPRESSION{
+    ReadConstantString("ENABLE_WIRE_COMPRESSION", "node.p2pcomm.") == "true"};
+const unsigned int WIRE_COMPRESSION_MIN_BYTES{
+    ReadConstantNumeric("WIRE_COMPRESSION_MIN_BYTES", "node.p2pcomm.")};
+const unsigned int WIRE_COMPRESSION_LEVEL{
+    ReadConstantNumeric("WIRE_COMPRESSION_LEVEL", "node.p2pcomm.")};
+const unsigned int WIRE_COMPRESSION_PROBE_INTERVAL{
+    ReadConstantNumeric("WIRE_COMPRESSION_PROBE_INTERVAL", "node.p2pcomm.")};
+const string WIRE_COMPRESSION_MESSAGES{
+    ReadConstantString("WIRE_COMPRESSION_MESSAGES", "node.p2pcomm.")};
 
 // PoW constants
 const bool CUDA_GPU_MINE{ReadConstantString("CUDA_GPU_MINE", "node.pow.") ==
@@ -567,6 +632,11 @@ const unsigned int RESUME_BLACKLIST_DELAY_IN_SECONDS{
     ReadConstantNumeric("RESUME_BLACKLIST_DELAY_IN_SECONDS", "node.recovery.")};
 const unsigned int INCRDB_DSNUMS_WITH_STATEDELTAS{
     ReadConstantNumeric("INCRDB_DSNUMS_WITH_STATEDELTAS", "node.recovery.")};
+const bool MERGE_STATEDELTAS_ON_RESTART{
+    ReadConstantString("MERGE_STATEDELTAS_ON_RESTART", "node.recovery.") ==
+    "true"};
+const unsigned int STATEDELTA_REPLAY_THREADS{
+    ReadConstantNumeric("STATEDELTA_REPLAY_THREADS", "node.recovery.")};
 const bool CONTRACT_STATES_MIGRATED{
     ReadConstantString("CONTRACT_STATES_MIGRATED", "node.recovery.") == "true"};
 const unsigned int MAX_IPCHANGE_REQUEST_LIMIT{
@@ -620,6 +690,13 @@ const string LIBRARY_CODE_EXTENSION{
     ReadConstantString("LIBRARY_CODE_EXTENSION", "node.smart_contract.")};
 const string EXTLIB_FOLDER{
     ReadConstantString("EXTLIB_FOLDER", "node.smart_contract.")};
+const bool ENABLE_SCILLA_FILES_CACHE{
+    ReadConstantString("ENABLE_SCILLA_FILES_CACHE", "node.smart_contract.") ==
+    "true"};
+const string SCILLA_FILES_CACHE{
+    ReadConstantString("SCILLA_FILES_CACHE", "node.smart_contract.")};
+const unsigned int SCILLA_FILES_CACHE_SIZE{
+    ReadConstantNumeric("SCILLA_FILES_CACHE_SIZE", "node.smart_contract.")};
 const bool ENABLE_SCILLA_MULTI_VERSION{
     ReadConstantString("ENABLE_SCILLA_MULTI_VERSION", "node.smart_contract.") ==
     "true"};
@@ -674,6 +751,8 @@ const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS{ReadConstantNumeric(
     "SYS_TIMESTAMP_VARIANCE_IN_SECONDS", "node.transactions.")};
 const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT{ReadConstantNumeric(
     "TXN_MISORDER_TOLERANCE_IN_PERCENT", "node.transactions.")};
+const unsigned int GAS_PRICE_TXN_ORDER_DS_NUM{
+    ReadConstantNumeric("GAS_PRICE_TXN_ORDER_DS_NUM", "node.transactions.")};
 const unsigned int TXNS_MISSING_TOLERANCE_IN_PERCENT{ReadConstantNumeric(
     "TXNS_MISSING_TOLERANCE_IN_PERCENT", "node.transactions.")};
 const unsigned int PACKET_EPOCH_LATE_ALLOW{
@@ -695,6 +774,17 @@ const unsigned int NUM_STORE_TX_BODIES_INTERVAL{
     ReadConstantNumeric("NUM_STORE_TX_BODIES_INTERVAL", "node.transactions.")};
 const string BUCKET_NAME{
     ReadConstantString("BUCKET_NAME", "node.transactions.")};
+const bool ENABLE_NATIVE_PERSISTENCE_DOWNLOAD{
+    ReadConstantString("ENABLE_NATIVE_PERSISTENCE_DOWNLOAD",
+                       "node.transactions.") == "true"};
+const string PERSISTENCE_DOWNLOAD_URL{
+    ReadConstantString("PERSISTENCE_DOWNLOAD_URL", "node.transactions.")};
+const string TESTNET_NAME{
+    ReadConstantString("TESTNET_NAME", "node.transactions.")};
+const unsigned int PERSISTENCE_DOWNLOAD_THREADS{
+    ReadConstantNumeric("PERSISTENCE_DOWNLOAD_THREADS", "node.transactions.")};
+const unsigned int PERSISTENCE_DOWNLOAD_CHUNK_SIZE_MB{ReadConstantNumeric(
+    "PERSISTENCE_DOWNLOAD_CHUNK_SIZE_MB", "node.transactions.")};
 const string TXN_PERSISTENCE_NAME{
     ReadConstantString("TXN_PERSISTENCE_NAME", "node.transactions.")};
 const bool ENABLE_TXNS_BACKUP{
@@ -706,6 +796,17 @@ const double BLOOM_FILTER_FALSE_RATE{
     ReadConstantDouble("BLOOM_FILTER_FALSE_RATE", "node.transactions.")};
 const unsigned int TXN_DISPATCH_ATTEMPT_LIMIT{
     ReadConstantNumeric("TXN_DISPATCH_ATTEMPT_LIMIT", "node.transactions.")};
+const bool ENABLE_PARALLEL_TXN_EXECUTION{
+    ReadConstantString("ENABLE_PARALLEL_TXN_EXECUTION", "node.transactions.") ==
+    "true"};
+const unsigned int PARALLEL_TXN_EXECUTION_THREADS{ReadConstantNumeric(
+    "PARALLEL_TXN_EXECUTION_THREADS", "node.transactions.")};
+const unsigned int PARALLEL_TXN_EXECUTION_WAVE_SIZE{ReadConstantNumeric(
+    "PARALLEL_TXN_EXECUTION_WAVE_SIZE", "node.transactions.")};
+const unsigned int TXN_SIGNATURE_VERIFICATION_THREADS{ReadConstantNumeric(
+    "TXN_SIGNATURE_VERIFICATION_THREADS", "node.transactions.")};
+const unsigned int STATEDELTA_DECODE_THREADS{
+    ReadConstantNumeric("STATEDELTA_DECODE_THREADS", "node.transactions.")};
 
 // Viewchange constants
 const unsigned int POST_VIEWCHANGE_BUFFER{
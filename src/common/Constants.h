@@ -48,6 +48,8 @@ const unsigned int CHALLENGE_SIZE = 32;
 const unsigned int RESPONSE_SIZE = 32;
 
 const unsigned int BLOCKCHAIN_SIZE = 50;
+// Older blocks read back from the persistent storage that are kept in memory
+const unsigned int BLOCKCHAIN_CACHE_SIZE = 1024;
 
 // Number of nodes sent from lookup node to newly joined node
 const unsigned int SEED_PEER_LIST_SIZE = 20;
@@ -159,6 +161,7 @@ extern const bool KEEP_HISTORICAL_STATE;
 extern const bool ENABLE_MEMORY_STATS;
 extern const unsigned int NUM_DS_EPOCHS_STATE_HISTORY;
 extern const uint64_t INIT_TRIE_DB_SNAPSHOT_EPOCH;
+extern const unsigned int STATE_TRIE_NODE_CACHE_MB;
 
 // Version constants
 extern const unsigned int MSG_VERSION;
@@ -240,6 +243,8 @@ extern const unsigned int GETSTATEDELTAS_TIMEOUT_IN_SECONDS;
 extern const unsigned int GETCOSIGREWARDS_TIMEOUT_IN_SECONDS;
 extern const unsigned int RETRY_REJOINING_TIMEOUT;
 extern const unsigned int RETRY_GETSTATEDELTAS_COUNT;
+extern const unsigned int STATEDELTAS_CHUNK_SIZE;
+extern const unsigned int STATEDELTAS_FETCH_WINDOW;
 extern const unsigned int RETRY_COSIGREWARDS_COUNT;
 extern const unsigned int MAX_FETCHMISSINGMBS_NUM;
 extern const unsigned int LAST_N_TXBLKS_TOCHECK_FOR_MISSINGMBS;
@@ -315,6 +320,9 @@ extern const std::string IP_TO_BIND;  // Only for non-lookup nodes
 extern const bool ENABLE_STAKING_RPC;
 extern const bool ENABLE_STATUS_RPC;
 extern const unsigned int NUM_SHARD_PEER_TO_REVEAL;
+extern const unsigned int TXN_INGRESS_THREADS;
+extern const unsigned int TXN_INGRESS_QUEUE_SIZE;
+extern const unsigned int TXN_INGRESS_BATCH_SIZE;
 extern const std::string SCILLA_IPC_SOCKET_PATH;
 extern const std::string SCILLA_SERVER_SOCKET_PATH;
 extern const std::string SCILLA_SERVER_BINARY;
@@ -328,6 +336,14 @@ extern const bool CONNECTION_IO_USE_EPOLL;
 extern const unsigned int CONNECTION_ALL_TIMEOUT;
 extern const unsigned int CONNECTION_CALLBACK_TIMEOUT;
 
+// LevelDB constants
+extern const std::string LEVELDB_PROFILES;
+extern const unsigned int LEVELDB_BLOCK_CACHE_MB;
+extern const unsigned int LEVELDB_BLOOM_BITS_PER_KEY;
+extern const unsigned int LEVELDB_WRITE_BUFFER_MB;
+extern const std::string LEVELDB_COMPRESSION;
+extern const std::string LEVELDB_BINARY_KEY_DBS;
+
 // Network composition constants
 extern const unsigned int COMM_SIZE;
 extern const unsigned int NUM_DS_ELECTION;
@@ -344,7 +360,14 @@ extern const unsigned int FETCH_LOOKUP_MSG_MAX_RETRY;
 extern const uint32_t MAXSENDMESSAGE;
 extern const uint32_t MAXRECVMESSAGE;
 extern const unsigned int MAXRETRYCONN;
-extern const unsigned int MSGQUEUE_SIZE;
+extern const unsigned int CONSENSUS_MSGQUEUE_SIZE;
+extern const unsigned int CONSENSUS_MSGQUEUE_WEIGHT;
+extern const unsigned int BLOCK_MSGQUEUE_SIZE;
+extern const unsigned int BLOCK_MSGQUEUE_WEIGHT;
+extern const unsigned int LOOKUP_MSGQUEUE_SIZE;
+extern const unsigned int LOOKUP_MSGQUEUE_WEIGHT;
+extern const unsigned int TXN_MSGQUEUE_SIZE;
+extern const unsigned int TXN_MSGQUEUE_WEIGHT;
 extern const unsigned int PUMPMESSAGE_MILLISECONDS;
 extern const unsigned int SENDQUEUE_SIZE;
 extern const unsigned int MAX_GOSSIP_MSG_SIZE_IN_BYTES;
@@ -355,6 +378,18 @@ extern const unsigned int MAX_PEER_CONNECTION;
 extern const unsigned int MAX_PEER_CONNECTION_P2PSEED;
 extern const unsigned int MAX_WHITELISTREQ_LIMIT;
 extern const unsigned int SENDJOBPEERS_TIMEOUT;
+extern const bool ENABLE_P2P_CONNECTION_POOL;
+extern const unsigned int P2P_CONNECTION_IDLE_TIMEOUT;
+extern const unsigned int P2P_CONNECTION_MAX_BACKOFF;
+extern const bool ENABLE_P2P_EVENT_SEND;
+extern const unsigned int P2P_SEND_QUEUE_SIZE;
+extern const unsigned int P2P_SEND_HIGH_WATERMARK_IN_BYTES;
+extern const unsigned int P2P_SEND_LOW_WATERMARK_IN_BYTES;
+extern const bool ENABLE_WIRE_COMPRESSION;
+extern const unsigned int WIRE_COMPRESSION_MIN_BYTES;
+extern const unsigned int WIRE_COMPRESSION_LEVEL;
+extern const unsigned int WIRE_COMPRESSION_PROBE_INTERVAL;
+extern const std::string WIRE_COMPRESSION_MESSAGES;
 
 // PoW constants
 extern const bool CUDA_GPU_MINE;
@@ -399,6 +434,8 @@ extern const std::string UPGRADE_HOST_REPO;
 extern const bool REJOIN_NODE_NOT_IN_NETWORK;
 extern const unsigned int RESUME_BLACKLIST_DELAY_IN_SECONDS;
 extern const unsigned int INCRDB_DSNUMS_WITH_STATEDELTAS;
+extern const bool MERGE_STATEDELTAS_ON_RESTART;
+extern const unsigned int STATEDELTA_REPLAY_THREADS;
 extern const bool CONTRACT_STATES_MIGRATED;
 extern const unsigned int MAX_IPCHANGE_REQUEST_LIMIT;
 extern const unsigned int MAX_REJOIN_NETWORK_ATTEMPTS;
@@ -422,6 +459,9 @@ extern const std::string INPUT_CODE;
 extern const std::string CONTRACT_FILE_EXTENSION;
 extern const std::string LIBRARY_CODE_EXTENSION;
 extern const std::string EXTLIB_FOLDER;
+extern const bool ENABLE_SCILLA_FILES_CACHE;
+extern const std::string SCILLA_FILES_CACHE;
+extern const unsigned int SCILLA_FILES_CACHE_SIZE;
 extern const bool ENABLE_SCILLA_MULTI_VERSION;
 
 extern const bool LOG_SC;
@@ -464,6 +504,7 @@ extern const unsigned int SCILLA_CHECKER_INVOKE_GAS;
 extern const unsigned int SCILLA_RUNNER_INVOKE_GAS;
 extern const unsigned int SYS_TIMESTAMP_VARIANCE_IN_SECONDS;
 extern const unsigned int TXN_MISORDER_TOLERANCE_IN_PERCENT;
+extern const unsigned int GAS_PRICE_TXN_ORDER_DS_NUM;
 extern const unsigned int TXNS_MISSING_TOLERANCE_IN_PERCENT;
 extern const unsigned int PACKET_EPOCH_LATE_ALLOW;
 extern const unsigned int PACKET_BYTESIZE_LIMIT;
@@ -474,11 +515,21 @@ extern const unsigned int REPOPULATE_STATE_PER_N_DS;
 extern const unsigned int REPOPULATE_STATE_IN_DS;
 extern const unsigned int NUM_STORE_TX_BODIES_INTERVAL;
 extern const std::string BUCKET_NAME;
+extern const bool ENABLE_NATIVE_PERSISTENCE_DOWNLOAD;
+extern const std::string PERSISTENCE_DOWNLOAD_URL;
+extern const std::string TESTNET_NAME;
+extern const unsigned int PERSISTENCE_DOWNLOAD_THREADS;
+extern const unsigned int PERSISTENCE_DOWNLOAD_CHUNK_SIZE_MB;
 extern const std::string TXN_PERSISTENCE_NAME;
 extern const bool ENABLE_TXNS_BACKUP;
 extern const bool SHARDLDR_SAVE_TXN_LOCALLY;
 extern const double BLOOM_FILTER_FALSE_RATE;
 extern const unsigned int TXN_DISPATCH_ATTEMPT_LIMIT;
+extern const bool ENABLE_PARALLEL_TXN_EXECUTION;
+extern const unsigned int PARALLEL_TXN_EXECUTION_THREADS;
+extern const unsigned int PARALLEL_TXN_EXECUTION_WAVE_SIZE;
+extern const unsigned int TXN_SIGNATURE_VERIFICATION_THREADS;
+extern const unsigned int STATEDELTA_DECODE_THREADS;
 
 // Viewchange constants
 extern const unsigned int POST_VIEWCHANGE_BUFFER;
@@ -15,9 +15,14 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
+#include <memory>
 #include <string>
 
+#include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
 
 #include "LevelDB.h"
 #include "common/Constants.h"
@@ -28,6 +33,274 @@
 
 using namespace std;
 
+namespace
+{
+    /// Finds name in a comma separated list of names, each with an optional
+    /// ":value"
+    bool FindInList(const string & list, const string & name, string & value)
+    {
+        vector<string> entries;
+        boost::split(entries, list, boost::is_any_of(","));
+        for (auto & entry : entries)
+        {
+            boost::trim(entry);
+            const auto pos = entry.find(':');
+            if (entry.substr(0, pos) == name)
+            {
+                value = (pos == string::npos) ? "" : entry.substr(pos + 1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Never freed, as they must outlive every database opened with them
+
+    leveldb::Cache* GetSharedBlockCache()
+    {
+        static leveldb::Cache* cache = (LEVELDB_BLOCK_CACHE_MB > 0)
+            ? leveldb::NewLRUCache((size_t)LEVELDB_BLOCK_CACHE_MB << 20)
+            : nullptr;
+        return cache;
+    }
+
+    const leveldb::FilterPolicy* GetBloomFilter()
+    {
+        static const leveldb::FilterPolicy* filter =
+            (LEVELDB_BLOOM_BITS_PER_KEY > 0)
+            ? leveldb::NewBloomFilterPolicy(LEVELDB_BLOOM_BITS_PER_KEY)
+            : nullptr;
+        return filter;
+    }
+
+    /// Key recording the format of the h256 keys, of neither 32 nor 64 bytes
+    const string KEY_FORMAT_KEY = "zilliqa_key_format";
+    const string KEY_FORMAT_BINARY = "binary";
+    const string KEY_FORMAT_HEX = "hex";
+
+    bool IsHexKey(const leveldb::Slice & key)
+    {
+        if (key.size() != 2 * dev::h256::size)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < key.size(); i++)
+        {
+            if (!isxdigit((unsigned char)key.data()[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+leveldb::Options LevelDB::GetProfileOptions(const string & profile)
+{
+    leveldb::Options options;
+    options.max_open_files = 256;
+    options.create_if_missing = true;
+
+    if (profile == "default")
+    {
+        return options;
+    }
+
+    // Without a shared cache, each database keeps its own 8 MB one
+    options.block_cache = GetSharedBlockCache();
+    options.write_buffer_size = (size_t)LEVELDB_WRITE_BUFFER_MB << 20;
+    options.compression = (LEVELDB_COMPRESSION == "none")
+        ? leveldb::kNoCompression
+        : leveldb::kSnappyCompression;
+
+    if (profile == "point_lookup")
+    {
+        options.filter_policy = GetBloomFilter();
+    }
+    else if (profile == "bulk_write")
+    {
+        // Fewer flushes and compactions for the large batches
+        options.write_buffer_size *= 4;
+        options.max_file_size = 8 << 20;
+    }
+    else
+    {
+        LOG_GENERAL(WARNING, "Unknown LevelDB profile " << profile << ", using default");
+        return GetProfileOptions("default");
+    }
+
+    return options;
+}
+
+string LevelDB::GetProfile(const string & dbName)
+{
+    string profile;
+    if (!FindInList(LEVELDB_PROFILES, dbName, profile) || profile.empty())
+    {
+        return "default";
+    }
+    return profile;
+}
+
+bool LevelDB::UsesBinaryKeys(const string & dbName)
+{
+    string ignored;
+    return FindInList(LEVELDB_BINARY_KEY_DBS, dbName, ignored);
+}
+
+void LevelDB::InitOptions()
+{
+    const string profile = GetProfile(m_dbName);
+    m_options = GetProfileOptions(profile);
+    m_binaryKeys = UsesBinaryKeys(m_dbName);
+
+    if (profile != "default" || m_binaryKeys)
+    {
+        LOG_GENERAL(INFO, "LevelDB " << m_dbName << " profile " << profile
+                    << (m_binaryKeys ? " with binary keys" : ""));
+    }
+}
+
+string LevelDB::toKey(const dev::h256 & key) const
+{
+    return m_binaryKeys ? string((char const*)key.data(), key.size) : key.hex();
+}
+
+bool LevelDB::CheckKeyFormat(leveldb::DB & db, bool binaryKeys)
+{
+    const string& expected = binaryKeys ? KEY_FORMAT_BINARY : KEY_FORMAT_HEX;
+    string format;
+    leveldb::Status status = db.Get(leveldb::ReadOptions(), KEY_FORMAT_KEY, &format);
+    if (status.ok())
+    {
+        return format == expected;
+    }
+    if (!status.IsNotFound())
+    {
+        LOG_GENERAL(WARNING, "Failed to read the key format: " << status.ToString());
+        return false;
+    }
+
+    if (!binaryKeys)
+    {
+        return true;
+    }
+    unique_ptr<leveldb::Iterator> it(db.NewIterator(leveldb::ReadOptions()));
+    it->SeekToFirst();
+    if (it->Valid() || !it->status().ok())
+    {
+        return false;
+    }
+    return db.Put(leveldb::WriteOptions(), KEY_FORMAT_KEY, expected).ok();
+}
+
+void LevelDB::VerifyKeyFormat() const
+{
+    if (!CheckKeyFormat(*m_db, m_binaryKeys))
+    {
+        LOG_GENERAL(FATAL, "LevelDB " << m_dbName << " keys are not "
+                    << (m_binaryKeys ? "binary" : "hex") << " as in LEVELDB_BINARY_KEY_DBS,"
+                    << " convert them with migrate_leveldb_keys first");
+    }
+}
+
+bool LevelDB::MigrateKeys(const string & dbPath, bool toBinary,
+                          uint64_t & numKeys, uint64_t & numConverted)
+{
+    const unsigned int BATCH_SIZE = 10000;
+
+    leveldb::Options options;
+    options.max_open_files = 256;
+    leveldb::DB* rawDB = nullptr;
+    leveldb::Status status = leveldb::DB::Open(options, dbPath, &rawDB);
+    if (!status.ok())
+    {
+        LOG_GENERAL(WARNING, "Failed to open " << dbPath << ": " << status.ToString());
+        return false;
+    }
+    unique_ptr<leveldb::DB> db(rawDB);
+
+    // Only the databases recorded as binary are reverted, the others may
+    // have 32-byte keys that are not h256
+    string format;
+    status = db->Get(leveldb::ReadOptions(), KEY_FORMAT_KEY, &format);
+    if (!status.ok() && !status.IsNotFound())
+    {
+        LOG_GENERAL(WARNING, "Failed to read the key format of " << dbPath << ": "
+                    << status.ToString());
+        return false;
+    }
+    if ((toBinary && format == KEY_FORMAT_BINARY)
+        || (!toBinary && format != KEY_FORMAT_BINARY))
+    {
+        LOG_GENERAL(WARNING, dbPath << " keys are already "
+                    << (toBinary ? "binary" : "hex"));
+        return false;
+    }
+
+    // The iterator reads a snapshot, so the rewritten keys are not met again
+    leveldb::ReadOptions readOptions;
+    readOptions.fill_cache = false;
+    unique_ptr<leveldb::Iterator> it(db->NewIterator(readOptions));
+
+    ldb::WriteBatch batch;
+    numKeys = 0;
+    numConverted = 0;
+    auto flush = [&]() {
+        status = db->Write(leveldb::WriteOptions(), &batch);
+        batch.Clear();
+        return status.ok();
+    };
+
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        const leveldb::Slice key = it->key();
+        if (key.compare(KEY_FORMAT_KEY) == 0)
+        {
+            continue;
+        }
+        numKeys++;
+        string newKey;
+        if (toBinary && IsHexKey(key))
+        {
+            const dev::h256 hash(key.ToString());
+            newKey.assign((char const*)hash.data(), hash.size);
+        }
+        else if (!toBinary && key.size() == dev::h256::size)
+        {
+            newKey = dev::h256((const uint8_t*)key.data(),
+                               dev::h256::ConstructFromPointer).hex();
+        }
+        else
+        {
+            continue;
+        }
+
+        batch.Put(newKey, it->value());
+        batch.Delete(key);
+        if (++numConverted % BATCH_SIZE == 0)
+        {
+            if (!flush())
+            {
+                break;
+            }
+            LOG_GENERAL(INFO, numConverted << " keys converted");
+        }
+    }
+
+    // Recorded last, so that an interrupted migration is run again rather
+    // than taken for done
+    batch.Put(KEY_FORMAT_KEY, toBinary ? KEY_FORMAT_BINARY : KEY_FORMAT_HEX);
+    if (!it->status().ok() || !status.ok() || !flush())
+    {
+        LOG_GENERAL(WARNING, "Migration of " << dbPath << " failed: "
+                    << (it->status().ok() ? status : it->status()).ToString());
+        return false;
+    }
+
+    return true;
+}
+
 void LevelDB::log_error(leveldb::Status status) const
 {
     if(!status.IsNotFound())
@@ -48,8 +321,7 @@ LevelDB::LevelDB(const string& dbName, const string& path, const string& subdire
         return;
     }
 
-    m_options.max_open_files = 256;
-    m_options.create_if_missing = true;
+    InitOptions();
 
     leveldb::DB* db;
     leveldb::Status status;
@@ -79,6 +351,10 @@ LevelDB::LevelDB(const string& dbName, const string& path, const string& subdire
     }
 
     m_db.reset(db);
+    if (status.ok())
+    {
+        VerifyKeyFormat();
+    }
 }
 
 LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bool diagnostic)
@@ -86,8 +362,7 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
     this->m_subdirectory = subdirectory;
     this->m_dbName = dbName;
 
-    m_options.max_open_files = 256;
-    m_options.create_if_missing = true;
+    InitOptions();
 
     leveldb::DB* db;
     leveldb::Status status;
@@ -111,6 +386,10 @@ LevelDB::LevelDB(const std::string & dbName, const std::string& subdirectory, bo
     }
 
     m_db.reset(db);
+    if (status.ok())
+    {
+        VerifyKeyFormat();
+    }
 }
 
 void LevelDB::Reopen() {
@@ -125,6 +404,10 @@ void LevelDB::Reopen() {
         LOG_GENERAL(WARNING, "LevelDB " << m_dbName << " status is not OK - " << status.ToString());
     }
     m_db.reset(db);
+    if (status.ok())
+    {
+        VerifyKeyFormat();
+    }
 }
 
 leveldb::Slice toSlice(boost::multiprecision::uint256_t num)
@@ -205,7 +488,7 @@ string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum, bool &
 string LevelDB::Lookup(const dev::h256 & key) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(key.hex()), &value);
+    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), leveldb::Slice(toKey(key)), &value);
     if (!s.ok())
     {
         log_error(s); 
@@ -218,7 +501,7 @@ string LevelDB::Lookup(const dev::h256 & key) const
 string LevelDB::Lookup(const dev::bytesConstRef & key) const
 {
     string value;
-    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), ldb::Slice((char const*)key.data(), 32),
+    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), ldb::Slice((char const*)key.data(), key.size()),
                                   &value);
     if (!s.ok())
     {
@@ -321,7 +604,7 @@ int LevelDB::Insert(const dev::h256 & key, const string & value)
 
 int LevelDB::Insert(const dev::h256 & key, const vector<unsigned char> & body)
 {
-    leveldb::Status s = m_db->Put(leveldb::WriteOptions(), leveldb::Slice(key.hex()),
+    leveldb::Status s = m_db->Put(leveldb::WriteOptions(), leveldb::Slice(toKey(key)),
                                   leveldb::Slice(vector_ref<const unsigned char>(&body[0],
                                                                                  body.size())));
     if (!s.ok())
@@ -353,7 +636,7 @@ bool LevelDB::BatchInsert(const std::unordered_map<dev::h256, std::pair<std::str
 
     for (const auto & i: m_main) {
         if (i.second.second || (LOOKUP_NODE_MODE && KEEP_HISTORICAL_STATE)) {
-            batch.Put(leveldb::Slice(i.first.hex()),
+            batch.Put(leveldb::Slice(toKey(i.first)),
                       leveldb::Slice(i.second.first.data(), i.second.first.size()));
             if(i.second.second)
             {
@@ -405,7 +688,7 @@ bool LevelDB::BatchInsert(const std::unordered_map<std::string, std::string>& kv
 bool LevelDB::BatchDelete(const std::vector<dev::h256>& toDelete) {
     ldb::WriteBatch batch;
     for (const auto& i : toDelete) {
-        batch.Delete(leveldb::Slice(i.hex()));
+        batch.Delete(leveldb::Slice(toKey(i)));
     }
 
     ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
@@ -444,7 +727,7 @@ bool LevelDB::Exists(const std::string & key) const
 
 int LevelDB::DeleteKey(const dev::h256 & key)
 {
-    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(key.hex()));
+    leveldb::Status s = m_db->Delete(leveldb::WriteOptions(), ldb::Slice(toKey(key)));
     if (!s.ok())
     {
         LOG_GENERAL(WARNING, "[DeleteDB] Status: " << s.ToString());
@@ -518,13 +801,9 @@ bool LevelDB::RefreshDB()
 {
     m_db.reset();
 
-    leveldb::Options options;
-    options.max_open_files = 256;
-    options.create_if_missing = true;
-
     leveldb::DB* db;
 
-    leveldb::Status status = leveldb::DB::Open(options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
+    leveldb::Status status = leveldb::DB::Open(m_options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
     if(!status.ok())
     {
         // throw exception();
@@ -533,6 +812,10 @@ bool LevelDB::RefreshDB()
     }
 
     m_db.reset(db);
+    if (status.ok())
+    {
+        VerifyKeyFormat();
+    }
     return true;
 }
 
@@ -562,13 +845,9 @@ bool LevelDB::ResetDBForNormalNode()
     {
         boost::filesystem::remove_all(STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
-
         leveldb::DB* db;
 
-        leveldb::Status status = leveldb::DB::Open(options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
+        leveldb::Status status = leveldb::DB::Open(m_options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
         if(!status.ok())
         {
             // throw exception();
@@ -576,6 +855,10 @@ bool LevelDB::ResetDBForNormalNode()
         }
 
         m_db.reset(db);
+        if (status.ok())
+        {
+            VerifyKeyFormat();
+        }
         return true;
     }
     else if(this->m_subdirectory.size())
@@ -605,13 +888,9 @@ bool LevelDB::ResetDBForLookupNode()
     {
         boost::filesystem::remove_all(STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName);
 
-        leveldb::Options options;
-        options.max_open_files = 256;
-        options.create_if_missing = true;
-
         leveldb::DB* db;
 
-        leveldb::Status status = leveldb::DB::Open(options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
+        leveldb::Status status = leveldb::DB::Open(m_options, STORAGE_PATH + PERSISTENCE_PATH + "/" + this->m_dbName, &db);
         if(!status.ok())
         {
             // throw exception();
@@ -620,6 +899,10 @@ bool LevelDB::ResetDBForLookupNode()
         }
 
         m_db.reset(db);
+        if (status.ok())
+        {
+            VerifyKeyFormat();
+        }
         return true;
     }
     return false;
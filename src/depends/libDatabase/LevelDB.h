@@ -45,8 +45,21 @@ class LevelDB
 
     std::string m_open_db_path;
 
+    /// Set if the h256 keys are stored as their 32 bytes rather than in hex
+    bool m_binaryKeys = false;
+
     void log_error(leveldb::Status status) const;
 
+    /// Sets m_options and m_binaryKeys as configured for the database
+    void InitOptions();
+
+    /// Key of the h256 in the database
+    std::string toKey(const dev::h256 & key) const;
+
+    /// Stops the node if the keys of the database just opened are not in the
+    /// format configured for it
+    void VerifyKeyFormat() const;
+
 public:
 
     /// Constructor.
@@ -69,6 +82,30 @@ public:
     /// Returns the DB Name
     std::string GetDBName();
 
+    /// Options of a tuning profile: "default", "point_lookup" for the
+    /// databases read by key, with bloom filters and the shared block cache,
+    /// or "bulk_write" for the ones written in large batches
+    static leveldb::Options GetProfileOptions(const std::string & profile);
+
+    /// Profile of the database in LEVELDB_PROFILES, "default" if not listed
+    static std::string GetProfile(const std::string & dbName);
+
+    /// Returns true if the database is in LEVELDB_BINARY_KEY_DBS
+    static bool UsesBinaryKeys(const std::string & dbName);
+
+    /// Rewrites the keys of the closed database at dbPath from hex to their
+    /// 32 bytes, or back if not toBinary. Every key of 64 hex characters, or
+    /// of 32 bytes when reverting, is taken for an h256 key. The new format
+    /// is recorded in the database, and only a database recorded as binary
+    /// is reverted.
+    static bool MigrateKeys(const std::string & dbPath, bool toBinary,
+                            uint64_t & numKeys, uint64_t & numConverted);
+
+    /// Returns false if the key format recorded in the database is not the
+    /// one of binaryKeys. The databases without a record have hex keys, but
+    /// for the empty ones, where the format of binaryKeys is recorded.
+    static bool CheckKeyFormat(leveldb::DB & db, bool binaryKeys);
+
     /// Returns the value at the specified key.
     std::string Lookup(const std::string & key) const;
 
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "NodeCache.h"
+
+using namespace std;
+
+namespace dev
+{
+    NodeCache::NodeCache(size_t _capacity): m_capacity(_capacity) {}
+
+    bool NodeCache::lookup(h256 const& _h, std::string& o_value)
+    {
+        if (!enabled())
+            return false;
+
+        Shard& shard = shardOf(_h);
+        {
+            lock_guard<mutex> g(shard.mutex);
+            auto it = shard.index.find(_h);
+            if (it != shard.index.end())
+            {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+                o_value = it->second->second;
+                ++m_hits;
+                return true;
+            }
+        }
+        ++m_misses;
+        return false;
+    }
+
+    bool NodeCache::exists(h256 const& _h) const
+    {
+        if (!enabled())
+            return false;
+
+        Shard const& shard = shardOf(_h);
+        lock_guard<mutex> g(shard.mutex);
+        return shard.index.count(_h);
+    }
+
+    void NodeCache::insert(h256 const& _h, std::string const& _value)
+    {
+        size_t const size = _value.size() + c_entryOverhead;
+        size_t const shardCapacity = m_capacity / c_numShards;
+        if (size > shardCapacity)
+            return;
+
+        Shard& shard = shardOf(_h);
+        lock_guard<mutex> g(shard.mutex);
+        if (shard.index.count(_h))
+            return;
+
+        while (!shard.lru.empty() && shard.bytes + size > shardCapacity)
+        {
+            shard.bytes -= shard.lru.back().second.size() + c_entryOverhead;
+            shard.index.erase(shard.lru.back().first);
+            shard.lru.pop_back();
+            ++m_evictions;
+        }
+
+        shard.lru.emplace_front(_h, _value);
+        shard.index.emplace(_h, shard.lru.begin());
+        shard.bytes += size;
+    }
+
+    void NodeCache::remove(std::vector<h256> const& _hs)
+    {
+        if (!enabled())
+            return;
+
+        for (auto const& h: _hs)
+        {
+            Shard& shard = shardOf(h);
+            lock_guard<mutex> g(shard.mutex);
+            auto it = shard.index.find(h);
+            if (it == shard.index.end())
+                continue;
+            shard.bytes -= it->second->second.size() + c_entryOverhead;
+            shard.lru.erase(it->second);
+            shard.index.erase(it);
+        }
+    }
+
+    void NodeCache::clear()
+    {
+        for (auto& shard: m_shards)
+        {
+            lock_guard<mutex> g(shard.mutex);
+            shard.lru.clear();
+            shard.index.clear();
+            shard.bytes = 0;
+        }
+    }
+
+    NodeCache::Stats NodeCache::stats() const
+    {
+        Stats ret;
+        ret.hits = m_hits;
+        ret.misses = m_misses;
+        ret.evictions = m_evictions;
+        ret.capacity = m_capacity;
+        for (auto const& shard: m_shards)
+        {
+            lock_guard<mutex> g(shard.mutex);
+            ret.entries += shard.index.size();
+            ret.bytes += shard.bytes;
+        }
+        return ret;
+    }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __NODECACHE_H__
+#define __NODECACHE_H__
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "depends/common/FixedHash.h"
+
+namespace dev
+{
+    /// Bounded LRU cache of the trie nodes read from the LevelDB, by hash. Nodes are
+    /// content-addressed so a cached node never goes stale, it only has to be dropped
+    /// when it is deleted from the LevelDB.
+    class NodeCache
+    {
+    public:
+        struct Stats
+        {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+            size_t entries = 0;
+            size_t bytes = 0;
+            size_t capacity = 0;
+        };
+
+        /// @a _capacity in bytes, 0 disables the cache
+        explicit NodeCache(size_t _capacity = 0);
+
+        bool enabled() const { return m_capacity > 0; }
+
+        bool lookup(h256 const& _h, std::string& o_value);
+        bool exists(h256 const& _h) const;
+        void insert(h256 const& _h, std::string const& _value);
+        void remove(std::vector<h256> const& _hs);
+        void clear();
+
+        Stats stats() const;
+
+    private:
+        static constexpr size_t c_numShards = 16;
+        // Approximate bookkeeping size of an entry besides the node itself
+        static constexpr size_t c_entryOverhead = 96;
+
+        using Entry = std::pair<h256, std::string>;
+
+        struct Shard
+        {
+            mutable std::mutex mutex;
+            // Most recently used first
+            std::list<Entry> lru;
+            std::unordered_map<h256, std::list<Entry>::iterator> index;
+            size_t bytes = 0;
+        };
+
+        Shard& shardOf(h256 const& _h) { return m_shards[_h[0] % c_numShards]; }
+        Shard const& shardOf(h256 const& _h) const { return m_shards[_h[0] % c_numShards]; }
+
+        size_t const m_capacity;
+        std::array<Shard, c_numShards> m_shards;
+
+        std::atomic<uint64_t> m_hits{0};
+        std::atomic<uint64_t> m_misses{0};
+        std::atomic<uint64_t> m_evictions{0};
+    };
+}
+
+#endif // __NODECACHE_H__
@@ -35,11 +35,13 @@ namespace dev
 	void OverlayDB::ResetDB()
 	{
 		m_levelDB.ResetDB();
+		m_nodeCache.clear();
 		clear();
 	}
 
 	bool OverlayDB::RefreshDB()
 	{
+		m_nodeCache.clear();
 		return m_levelDB.RefreshDB();
 	}
 
@@ -56,6 +58,7 @@ namespace dev
 			purge(toPurge, false);
 			if (!keepHistory) {
 				m_levelDB.BatchDelete(toPurge);
+				m_nodeCache.remove(toPurge);
 			}
 
 			/// add newly created nodes in disk
@@ -114,16 +117,20 @@ namespace dev
 	std::string OverlayDB::lookup(h256 const& _h) const
 	{
 		std::string ret = MemoryDB::lookup(_h);
-	
-		if (ret.empty())
+
+		if (ret.empty() && !m_nodeCache.lookup(_h, ret))
+		{
 			ret = m_levelDB.Lookup(_h);
-	
+			if (!ret.empty())
+				m_nodeCache.insert(_h, ret);
+		}
+
 		return ret;
 	}
 
 	bool OverlayDB::exists(h256 const& _h) const
 	{
-		if (MemoryDB::exists(_h))
+		if (MemoryDB::exists(_h) || m_nodeCache.exists(_h))
 			return true;
 
 		return m_levelDB.Exists(_h);
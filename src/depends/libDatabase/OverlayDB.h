@@ -26,6 +26,7 @@
 #include "depends/common/RLP.h"
 #include "LevelDB.h"
 #include "MemoryDB.h"
+#include "NodeCache.h"
 #include "libUtils/DataConversion.h"
 
 namespace dev
@@ -37,7 +38,8 @@ namespace dev
 	class OverlayDB: public MemoryDB
 	{
 	public:
-		explicit OverlayDB(const std::string & dbName): m_levelDB(dbName) {}
+		/// @a nodeCacheSize in bytes for the nodes read from the LevelDB, 0 for no cache
+		explicit OverlayDB(const std::string & dbName, size_t nodeCacheSize = 0): m_levelDB(dbName), m_nodeCache(nodeCacheSize) {}
 		~OverlayDB() = default;
 
 		void ResetDB();
@@ -52,10 +54,14 @@ namespace dev
 
 		bytes lookupAux(h256 const& _h) const;
 
+		NodeCache::Stats nodeCacheStats() const { return m_nodeCache.stats(); }
+
 	protected:
 		// using MemoryDB::clear;
 
 		LevelDB m_levelDB;
+		// Only holds nodes already in m_levelDB, to be kept in sync when deleting from it
+		mutable NodeCache m_nodeCache;
 	};
 }
 
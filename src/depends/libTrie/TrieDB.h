@@ -19,8 +19,11 @@
 #ifndef __TRIEDB_H__
 #define __TRIEDB_H__
 
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <map>
+#include <vector>
 
 #include "depends/common/Exceptions.h"
 #include "depends/common/SHA3.h"
@@ -146,6 +149,11 @@ namespace dev
 
         void insert(bytesConstRef _key, bytesConstRef _value);
 
+        /// Inserts all the pairs, with the same root as inserting them one by one in order.
+        /// If @a _parallel, the subtries under the topmost branch node are merged and hashed
+        /// concurrently, on at most one thread per nibble, so the DB must allow concurrent access.
+        void insertBatch(std::vector<std::pair<bytes, bytes>> const& _items, bool _parallel = true);
+
         void remove(bytes const& _key) { remove(&_key); }
         void remove(bytesConstRef _key);
 
@@ -301,6 +309,18 @@ namespace dev
         bytes mergeAt(RLP const& _replace, NibbleSlice _k, bytesConstRef _v, bool _inLine = false);
         bytes mergeAt(RLP const& _replace, h256 const& _replaceHash, NibbleSlice _k, bytesConstRef _v, bool _inLine = false);
 
+        // Keys sorted, with _depth nibbles already consumed above the node being merged
+        using BatchItem = std::pair<NibbleSlice, bytesConstRef>;
+        using BatchIterator = typename std::vector<BatchItem>::const_iterator;
+
+        // Below this number of pairs a subtrie is merged on the calling thread
+        static constexpr size_t c_minBatchPerTask = 32;
+
+        // Only the subtries of the topmost branch are merged in parallel, nested levels would
+        // multiply the threads
+        void mergeBatchAtAux(RLPStream& _out, RLP const& _replace, BatchIterator _begin, BatchIterator _end, unsigned _depth, bool _parallel);
+        bytes mergeBatchAt(RLP const& _replace, h256 const& _replaceHash, BatchIterator _begin, BatchIterator _end, unsigned _depth, bool _inLine, bool _parallel);
+
         bool deleteAtAux(RLPStream& _out, RLP const& _replace, NibbleSlice _key);
         bytes deleteAt(RLP const& _replace, NibbleSlice _k);
 
@@ -902,6 +922,38 @@ namespace dev
         m_root = forceInsertNode(&b);
     }
 
+    template <class DB> void GenericTrieDB<DB>::insertBatch(std::vector<std::pair<bytes, bytes>> const& _items, bool _parallel)
+    {
+        if (_items.empty())
+            return;
+
+        std::vector<BatchItem> items;
+        items.reserve(_items.size());
+        for (auto const& i: _items)
+            items.emplace_back(NibbleSlice(&i.first), bytesConstRef(&i.second));
+
+        // Stable, so that the last value of a key inserted twice is kept
+        std::stable_sort(items.begin(), items.end(), [](BatchItem const& _a, BatchItem const& _b) {
+            return std::lexicographical_compare(_a.first.data.begin(), _a.first.data.end(), _b.first.data.begin(), _b.first.data.end());
+        });
+
+        std::string rootValue = node(m_root);
+
+        if(rootValue.size() == 0)
+        {
+            LOG_GENERAL(FATAL,
+                        "assertion failed (" << __FILE__ << ":" << __LINE__ << ": "
+                                             << __FUNCTION__ << ")");
+        }
+
+        bytes b = mergeBatchAt(RLP(rootValue), m_root, items.begin(), items.end(), 0, false, _parallel);
+
+        // As in insert, the root is always hashed
+        if (rootValue.size() < 32)
+            forceKillNode(m_root);
+        m_root = forceInsertNode(&b);
+    }
+
     template <class DB> std::string GenericTrieDB<DB>::at(bytesConstRef _key) const
     {
         return atAux(RLP(node(m_root)), _key);
@@ -1109,6 +1161,109 @@ namespace dev
         streamNode(_out, b);
     }
 
+    template <class DB> bytes GenericTrieDB<DB>::mergeBatchAt(RLP const& _orig, h256 const& _origHash, BatchIterator _begin, BatchIterator _end, unsigned _depth, bool _inLine, bool _parallel)
+    {
+        // The node as merged with the pairs so far. It is not stored in the DB until all the
+        // pairs are merged, a serial insert would have stored it and killed it again.
+        bytes merged;
+        RLP here = _orig;
+        bool inLine = _inLine;
+
+        for (auto it = _begin; it != _end;)
+        {
+            bool const split = _parallel && size_t(_end - it) >= 2 * c_minBatchPerTask && here.isList();
+
+            if (split && here.itemCount() == 17 && it->first.size() > _depth)
+            {
+                // Branch with no value to place here - the subtries under each nibble are independent
+                if (!inLine)
+                    killNode(here, _origHash);
+
+                std::vector<bytes> children(16);
+                std::vector<bool> changed(16, false);
+                std::vector<std::future<void>> tasks;
+                for (auto groupBegin = it; groupBegin != _end;)
+                {
+                    byte const n = groupBegin->first[_depth];
+                    auto groupEnd = std::find_if(groupBegin, _end, [&](BatchItem const& _i) { return _i.first[_depth] != n; });
+                    auto mergeChild = [this, &here, &children, n, groupBegin, groupEnd, _depth]() {
+                        RLPStream s(1);
+                        mergeBatchAtAux(s, here[n], groupBegin, groupEnd, _depth + 1, false);
+                        children[n] = RLP(s.out())[0].data().toBytes();
+                    };
+                    changed[n] = true;
+                    if (size_t(groupEnd - groupBegin) >= c_minBatchPerTask)
+                        tasks.emplace_back(std::async(std::launch::async, mergeChild));
+                    else
+                        mergeChild();
+                    groupBegin = groupEnd;
+                }
+                for (auto& t: tasks)
+                    t.get();
+
+                RLPStream r(17);
+                for (byte i = 0; i < 17; ++i)
+                    if (i < 16 && changed[i])
+                        r.appendRaw(children[i]);
+                    else
+                        r.append(here[i]);
+                return r.out();
+            }
+
+            if (split && here.itemCount() == 2 && !isLeaf(here))
+            {
+                // Extension shared by all the remaining keys (sorted, so the first and the last) - move down
+                NibbleSlice k = keyOf(here);
+                if (it->first.mid(_depth).contains(k) && std::prev(_end)->first.mid(_depth).contains(k))
+                {
+                    if (!inLine)
+                        killNode(here, _origHash);
+                    RLPStream s(2);
+                    s.append(here[0]);
+                    mergeBatchAtAux(s, here[1], it, _end, _depth + k.size(), _parallel);
+                    return s.out();
+                }
+            }
+
+            // Otherwise merge the next pair as a serial insert would
+            bytes b = mergeAt(here, _origHash, it->first.mid(_depth), it->second, inLine);
+            merged = std::move(b);
+            here = RLP(merged);
+            inLine = true;
+            ++it;
+        }
+
+        return merged;
+    }
+
+    template <class DB> void GenericTrieDB<DB>::mergeBatchAtAux(RLPStream& _out, RLP const& _orig, BatchIterator _begin, BatchIterator _end, unsigned _depth, bool _parallel)
+    {
+        // As mergeAtAux - a hashed child is dereferenced and removable
+        RLP r = _orig;
+        std::string s;
+        h256 h;
+        bool isRemovable = false;
+        if (!r.isList() && !r.isEmpty())
+        {
+            h = _orig.toHash<h256>();
+            s = node(h);
+            r = RLP(s);
+
+            if(r.isNull())
+            {
+                LOG_GENERAL(FATAL,
+                            "assertion failed (" << __FILE__ << ":" << __LINE__ << ": "
+                                                 << __FUNCTION__ << ")");
+            }
+
+            isRemovable = true;
+        }
+        else
+            h = sha3(r.data());
+        bytes b = mergeBatchAt(r, h, _begin, _end, _depth, !isRemovable, _parallel);
+        streamNode(_out, b);
+    }
+
     template <class DB> void GenericTrieDB<DB>::remove(bytesConstRef _key)
     {
         std::string rv = node(m_root);
@@ -495,17 +495,18 @@ bool Account::SetCode(const bytes& code) {
     return false;
   }
 
-  m_codeCache = code;
+  m_codeCache = CodeStore::GetInstance().Add(code);
   return true;
 }
 
-const bytes Account::GetCode() const {
+CodeBytes Account::GetCode() const {
   if (!isContract()) {
-    return {};
+    return CodeStore::Empty();
   }
 
-  if (m_codeCache.empty()) {
-    return ContractStorage::GetContractStorage().GetContractCode(m_address);
+  if (!m_codeCache || m_codeCache->empty()) {
+    return make_shared<const bytes>(
+        ContractStorage::GetContractStorage().GetContractCode(m_address));
   }
   return m_codeCache;
 }
@@ -534,12 +535,12 @@ bool Account::RetrieveContractAuxiliaries() {
     return false;
   }
 
-  bytes initData = GetInitData();
+  const CodeBytes initData = GetInitData();
   if (!JSONUtils::GetInstance().convertStrtoJson(
-          DataConversion::CharArrayToString(initData), m_initDataJson)) {
+          DataConversion::CharArrayToString(*initData), m_initDataJson)) {
     LOG_GENERAL(WARNING, "Convert InitData to Json failed"
                              << endl
-                             << DataConversion::CharArrayToString(initData));
+                             << DataConversion::CharArrayToString(*initData));
     return false;
   }
 
@@ -549,17 +550,18 @@ bool Account::RetrieveContractAuxiliaries() {
 
 bool Account::SetInitData(const bytes& initData) {
   // LOG_MARKER();
-  m_initDataCache = initData;
+  m_initDataCache = CodeStore::GetInstance().Add(initData);
   return true;
 }
 
-const bytes Account::GetInitData() const {
+CodeBytes Account::GetInitData() const {
   if (!isContract()) {
-    return {};
+    return CodeStore::Empty();
   }
 
-  if (m_initDataCache.empty()) {
-    return ContractStorage::GetContractStorage().GetInitData(m_address);
+  if (!m_initDataCache || m_initDataCache->empty()) {
+    return make_shared<const bytes>(
+        ContractStorage::GetContractStorage().GetInitData(m_address));
   }
   return m_initDataCache;
 }
@@ -576,3 +578,16 @@ bool Account::SetImmutable(const bytes& code, const bytes& initData) {
   // LOG_GENERAL(INFO, "m_codeHash: " << m_codeHash);
   return true;
 }
+
+bool Account::SetImmutable(const CodeBytes& code, const CodeBytes& initData,
+                           const dev::h256& codeHash) {
+  if (!code || code->empty()) {
+    LOG_GENERAL(WARNING, "Code for this contract is empty");
+    return false;
+  }
+
+  m_codeCache = code;
+  m_initDataCache = initData ? initData : CodeStore::Empty();
+  SetCodeHash(codeHash);
+  return true;
+}
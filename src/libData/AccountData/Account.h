@@ -23,6 +23,7 @@
 #include <array>
 
 #include "Address.h"
+#include "CodeStore.h"
 #include "common/Constants.h"
 #include "common/Serializable.h"
 
@@ -112,9 +113,9 @@ inline std::ostream& operator<<(std::ostream& out,
 }
 
 class Account : public AccountBase {
-  // The associated code for this account.
-  bytes m_codeCache;
-  bytes m_initDataCache;
+  // The associated code for this account, shared with its copies.
+  CodeBytes m_codeCache;
+  CodeBytes m_initDataCache;
 
   Address m_address;  // used by contract account only
   Json::Value m_initDataJson = Json::nullValue;
@@ -148,6 +149,11 @@ class Account : public AccountBase {
 
   bool SetImmutable(const bytes& code, const bytes& initData);
 
+  /// As above, with code and initData already in CodeStore and codeHash
+  /// their SHA256
+  bool SetImmutable(const CodeBytes& code, const CodeBytes& initData,
+                    const dev::h256& codeHash);
+
   /// Implements the Serialize function inherited from Serializable.
   bool Serialize(bytes& dst, unsigned int offset) const;
 
@@ -166,11 +172,13 @@ class Account : public AccountBase {
 
   bool SetCode(const bytes& code);
 
-  const bytes GetCode() const;
+  /// Never null, empty if not a contract
+  CodeBytes GetCode() const;
 
   bool SetInitData(const bytes& initData);
 
-  const bytes GetInitData() const;
+  /// Never null, empty if not a contract
+  CodeBytes GetInitData() const;
 
   bool GetContractAuxiliaries(bool& is_library, uint32_t& scilla_version,
                               std::vector<Address>& extlibs);
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AccountSnapshot.h"
+
+using namespace std;
+
+AccountSnapshot::Base::Base(const dev::h256& root, LoadFunc load)
+    : m_root(root), m_load(move(load)) {}
+
+bool AccountSnapshot::Base::GetAccount(const Address& address,
+                                       AccountPtr& account) const {
+  Shard& shard = m_shards[hash<Address>()(address) % NUM_SHARDS];
+
+  {
+    lock_guard<mutex> g(shard.m_mutex);
+    auto it = shard.m_accounts.find(address);
+    if (it != shard.m_accounts.end()) {
+      account = it->second;
+      return true;
+    }
+  }
+
+  account = nullptr;
+  if (m_root == dev::h256()) {
+    return true;
+  }
+
+  // Loaded outside of the shard lock, concurrent misses for the same account
+  // read the same immutable trie nodes
+  auto loaded = make_shared<Account>();
+  bool found = false;
+  if (!m_load(address, m_root, *loaded, found)) {
+    return false;
+  }
+  if (!found) {
+    return true;
+  }
+
+  lock_guard<mutex> g(shard.m_mutex);
+  if (shard.m_accounts.size() >= MAX_ACCOUNTS_PER_SHARD) {
+    shard.m_accounts.clear();
+  }
+  account = shard.m_accounts.emplace(address, move(loaded)).first->second;
+  return true;
+}
+
+AccountSnapshot::AccountSnapshot(uint64_t version, const dev::h256& stateRoot,
+                                 shared_ptr<const Base> base,
+                                 shared_ptr<const Accounts> changes)
+    : m_version(version),
+      m_stateRoot(stateRoot),
+      m_base(move(base)),
+      m_changes(move(changes)) {}
+
+bool AccountSnapshot::GetAccount(const Address& address,
+                                 AccountPtr& account) const {
+  auto it = m_changes->find(address);
+  if (it != m_changes->end()) {
+    account = it->second;
+    return true;
+  }
+  return m_base->GetAccount(address, account);
+}
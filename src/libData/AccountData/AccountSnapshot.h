@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Account.h"
+#include "Address.h"
+#include "depends/common/FixedHash.h"
+
+/// Immutable view of the account states after a committed block. A snapshot
+/// is made of the accounts changed since the last commit to disk, on top of a
+/// base reading the state trie at the root committed to disk. A new snapshot
+/// is published after each block, readers holding an older one keep reading
+/// it consistently without taking the AccountStore primary mutex.
+class AccountSnapshot {
+ public:
+  using AccountPtr = std::shared_ptr<const Account>;
+  using Accounts = std::unordered_map<Address, AccountPtr>;
+
+  /// Reads the account from the state trie at the given root, setting found
+  /// if it exists. Returns false if the root can no longer be read.
+  using LoadFunc =
+      std::function<bool(const Address& address, const dev::h256& root,
+                         Account& account, bool& found)>;
+
+  /// Accounts read from the state trie at a root committed to disk, shared by
+  /// all the snapshots on top of that root. The cache is split into shards
+  /// so that concurrent readers seldom wait for each other.
+  class Base {
+    static constexpr size_t NUM_SHARDS = 16;
+    static constexpr size_t MAX_ACCOUNTS_PER_SHARD = 4096;
+
+    struct Shard {
+      std::mutex m_mutex;
+      Accounts m_accounts;
+    };
+
+    const dev::h256 m_root;
+    const LoadFunc m_load;
+    mutable std::array<Shard, NUM_SHARDS> m_shards;
+
+   public:
+    Base(const dev::h256& root, LoadFunc load);
+
+    const dev::h256& GetRoot() const { return m_root; }
+
+    /// Sets account to nullptr if it does not exist at the root. Returns
+    /// false if the root can no longer be read.
+    bool GetAccount(const Address& address, AccountPtr& account) const;
+  };
+
+  AccountSnapshot(uint64_t version, const dev::h256& stateRoot,
+                  std::shared_ptr<const Base> base,
+                  std::shared_ptr<const Accounts> changes);
+
+  /// Sets account to nullptr if it does not exist in this snapshot. Returns
+  /// false if the accounts of the base can no longer be read, once the
+  /// nodes of its root are deleted from the disk.
+  bool GetAccount(const Address& address, AccountPtr& account) const;
+
+  /// Increases with every snapshot published
+  uint64_t GetVersion() const { return m_version; }
+
+  const dev::h256& GetStateRoot() const { return m_stateRoot; }
+
+  const std::shared_ptr<const Base>& GetBase() const { return m_base; }
+
+  const std::shared_ptr<const Accounts>& GetChanges() const {
+    return m_changes;
+  }
+
+ private:
+  const uint64_t m_version;
+  const dev::h256 m_stateRoot;
+  const std::shared_ptr<const Base> m_base;
+  const std::shared_ptr<const Accounts> m_changes;
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_ACCOUNTSNAPSHOT_H_
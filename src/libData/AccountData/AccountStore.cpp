@@ -17,6 +17,7 @@
 
 #include <leveldb/db.h>
 #include <regex>
+#include <unordered_set>
 
 #include "AccountStore.h"
 #include "libCrypto/Sha2.h"
@@ -90,6 +91,8 @@ void AccountStore::InitSoft() {
 
   AccountStoreTrie<unordered_map<Address, Account>>::Init();
 
+  RebaseSnapshot(dev::h256());
+
   InitRevertibles();
 
   InitTemp();
@@ -143,9 +146,18 @@ bool AccountStore::Deserialize(const bytes& src, unsigned int offset) {
 
   if (!Messenger::GetAccountStore(src, offset, *this)) {
     LOG_GENERAL(WARNING, "Messenger::GetAccountStore failed.");
+    UpdateSnapshot();
+    return false;
+  }
+
+  if (!UpdateStateTrieChanged()) {
+    LOG_GENERAL(WARNING, "UpdateStateTrieChanged failed.");
+    UpdateSnapshot();
     return false;
   }
 
+  UpdateSnapshot();
+
   m_prevRoot = GetStateRootHash();
 
   return true;
@@ -160,9 +172,18 @@ bool AccountStore::Deserialize(const string& src, unsigned int offset) {
 
   if (!Messenger::GetAccountStore(src, offset, *this)) {
     LOG_GENERAL(WARNING, "Messenger::GetAccountStore failed.");
+    UpdateSnapshot();
     return false;
   }
 
+  if (!UpdateStateTrieChanged()) {
+    LOG_GENERAL(WARNING, "UpdateStateTrieChanged failed.");
+    UpdateSnapshot();
+    return false;
+  }
+
+  UpdateSnapshot();
+
   return true;
 }
 
@@ -207,24 +228,48 @@ bool AccountStore::DeserializeDelta(const bytes& src, unsigned int offset,
     }
   }
 
+  // Decoded off the lock, so that only the apply holds it
+  vector<AccountDelta> deltas;
+  if (!Messenger::DecodeAccountStoreDelta(src, offset, deltas,
+                                          STATEDELTA_DECODE_THREADS)) {
+    LOG_GENERAL(WARNING, "Messenger::DecodeAccountStoreDelta failed.");
+    return false;
+  }
+
   if (revertible) {
     unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
     unique_lock<mutex> g2(m_mutexRevertibles, defer_lock);
     lock(g, g2);
 
-    if (!Messenger::GetAccountStoreDelta(src, offset, *this, revertible,
-                                         false)) {
-      LOG_GENERAL(WARNING, "Messenger::GetAccountStoreDelta failed.");
+    if (!Messenger::ApplyAccountStoreDelta(deltas, *this, revertible, false)) {
+      LOG_GENERAL(WARNING, "Messenger::ApplyAccountStoreDelta failed.");
+      UpdateSnapshot();
+      return false;
+    }
+
+    if (!UpdateStateTrieChanged()) {
+      LOG_GENERAL(WARNING, "UpdateStateTrieChanged failed.");
+      UpdateSnapshot();
       return false;
     }
+
+    UpdateSnapshot();
   } else {
     unique_lock<shared_timed_mutex> g(m_mutexPrimary);
 
-    if (!Messenger::GetAccountStoreDelta(src, offset, *this, revertible,
-                                         false)) {
-      LOG_GENERAL(WARNING, "Messenger::GetAccountStoreDelta failed.");
+    if (!Messenger::ApplyAccountStoreDelta(deltas, *this, revertible, false)) {
+      LOG_GENERAL(WARNING, "Messenger::ApplyAccountStoreDelta failed.");
+      UpdateSnapshot();
       return false;
     }
+
+    if (!UpdateStateTrieChanged()) {
+      LOG_GENERAL(WARNING, "UpdateStateTrieChanged failed.");
+      UpdateSnapshot();
+      return false;
+    }
+
+    UpdateSnapshot();
   }
 
   m_prevRoot = GetStateRootHash();
@@ -262,12 +307,12 @@ bool AccountStore::MoveUpdatesToDisk(uint64_t dsBlockNum) {
               .GetContractCode(i.first)
               .empty()) {
         code_batch.insert({i.first.hex(), DataConversion::CharArrayToString(
-                                              i.second.GetCode())});
+                                              *i.second.GetCode())});
       }
 
       if (ContractStorage::GetContractStorage().GetInitData(i.first).empty()) {
         initdata_batch.insert({i.first.hex(), DataConversion::CharArrayToString(
-                                                  i.second.GetInitData())});
+                                                  *i.second.GetInitData())});
       }
     }
   }
@@ -320,9 +365,104 @@ bool AccountStore::MoveUpdatesToDisk(uint64_t dsBlockNum) {
 
   m_addressToAccount->clear();
 
+  RebaseSnapshot(GetStateRootHash());
+
   return true;
 }
 
+bool AccountStore::UpdateStateTrieAll() {
+  bool ret = AccountStoreTrie<unordered_map<Address, Account>>::
+      UpdateStateTrieAll();
+  RepublishSnapshot();
+  return ret;
+}
+
+bool AccountStore::UpdateStateTrieChanged() {
+  vector<pair<Address, const Account*>> accounts;
+  accounts.reserve(m_changedAddresses.size());
+  unordered_set<Address> added;
+  for (const auto& address : m_changedAddresses) {
+    auto it = m_addressToAccount->find(address);
+    if (it == m_addressToAccount->end() || !added.emplace(address).second) {
+      continue;
+    }
+    accounts.emplace_back(address, &it->second);
+  }
+
+  if (accounts.empty()) {
+    return true;
+  }
+
+  return UpdateStateTrie(accounts);
+}
+
+void AccountStore::RebaseSnapshot(const dev::h256& root) {
+  auto base = make_shared<const AccountSnapshot::Base>(
+      root, [this](const Address& address, const dev::h256& baseRoot,
+                   Account& account, bool& found) {
+        return GetAccountAtRoot(address, baseRoot, account, found);
+      });
+  auto snapshot = make_shared<const AccountSnapshot>(
+      ++m_snapshotVersion, root, move(base),
+      make_shared<const AccountSnapshot::Accounts>());
+  atomic_store(&m_snapshot, shared_ptr<const AccountSnapshot>(move(snapshot)));
+  m_changedAddresses.clear();
+}
+
+void AccountStore::UpdateSnapshot(const AccountSnapshot::Accounts& written) {
+  auto snapshot = atomic_load(&m_snapshot);
+  if (snapshot == nullptr) {
+    m_changedAddresses.clear();
+    return;
+  }
+
+  auto changes =
+      make_shared<AccountSnapshot::Accounts>(*snapshot->GetChanges());
+  for (const auto& entry : written) {
+    (*changes)[entry.first] = entry.second;
+  }
+  for (const auto& address : m_changedAddresses) {
+    auto it = m_addressToAccount->find(address);
+    if (it == m_addressToAccount->end()) {
+      changes->erase(address);
+      continue;
+    }
+    (*changes)[address] = make_shared<const Account>(it->second);
+  }
+  m_changedAddresses.clear();
+
+  auto updated = make_shared<const AccountSnapshot>(
+      ++m_snapshotVersion, GetStateRootHash(), snapshot->GetBase(),
+      move(changes));
+  atomic_store(&m_snapshot, shared_ptr<const AccountSnapshot>(move(updated)));
+}
+
+void AccountStore::RepublishSnapshot() {
+  m_changedAddresses.clear();
+  m_changedAddresses.reserve(m_addressToAccount->size());
+  for (const auto& entry : *m_addressToAccount) {
+    m_changedAddresses.emplace_back(entry.first);
+  }
+  UpdateSnapshot();
+}
+
+shared_ptr<const Account> AccountStore::GetCommittedAccount(
+    const Address& address) {
+  auto snapshot = GetSnapshot();
+  AccountSnapshot::AccountPtr account;
+  if (snapshot != nullptr && snapshot->GetAccount(address, account)) {
+    return account;
+  }
+
+  // No snapshot yet, or the root of an outdated one already deleted
+  shared_lock<shared_timed_mutex> lock(m_mutexPrimary);
+  const Account* current = GetAccount(address, true);
+  if (current == nullptr) {
+    return nullptr;
+  }
+  return make_shared<const Account>(*current);
+}
+
 void AccountStore::PurgeUnnecessary() {
   m_state.db()->DetachedExecutePurge();
   ContractStorage::GetContractStorage().PurgeUnnecessary();
@@ -342,6 +482,8 @@ bool AccountStore::UpdateStateTrieFromTempStateDB() {
   LOG_MARKER();
 
   leveldb::Iterator* iter = nullptr;
+  // The states only go to the trie, not to the account map
+  AccountSnapshot::Accounts written;
 
   while (iter == nullptr || iter->Valid()) {
     vector<StateSharedPtr> states;
@@ -350,13 +492,24 @@ bool AccountStore::UpdateStateTrieFromTempStateDB() {
       delete iter;
       return false;
     }
+    vector<pair<Address, const Account*>> accounts;
+    accounts.reserve(states.size());
     for (const auto& state : states) {
-      UpdateStateTrie(state->first, state->second);
+      accounts.emplace_back(state->first, &state->second);
+      written[state->first] = make_shared<const Account>(state->second);
+    }
+    if (!accounts.empty() && !UpdateStateTrie(accounts)) {
+      LOG_GENERAL(WARNING, "UpdateStateTrie failed");
+      delete iter;
+      UpdateSnapshot(written);
+      return false;
     }
   }
 
   delete iter;
 
+  UpdateSnapshot(written);
+
   if (!BlockStorage::GetBlockStorage().ResetDB(BlockStorage::TEMP_STATE)) {
     LOG_GENERAL(WARNING, "BlockStorage::ResetDB (TEMP_STATE) failed");
     return false;
@@ -389,6 +542,8 @@ void AccountStore::DiscardUnsavedUpdates() {
     LOG_GENERAL(WARNING, "Error with AccountStore::DiscardUnsavedUpdates. "
                              << boost::diagnostic_information(e));
   }
+
+  RebaseSnapshot(GetStateRootHash());
 }
 
 bool AccountStore::RetrieveFromDisk() {
@@ -433,6 +588,9 @@ bool AccountStore::RetrieveFromDisk() {
                              << boost::diagnostic_information(e));
     return false;
   }
+
+  RebaseSnapshot(GetStateRootHash());
+
   return true;
 }
 
@@ -471,6 +629,9 @@ bool AccountStore::RetrieveFromDiskOld() {
                              << boost::diagnostic_information(e));
     return false;
   }
+
+  RebaseSnapshot(GetStateRootHash());
+
   return true;
 }
 
@@ -496,6 +657,92 @@ bool AccountStore::UpdateAccountsTemp(const uint64_t& blockNum,
                                             transaction, receipt, error_code);
 }
 
+void AccountStore::UpdateAccountsTempInParallel(
+    const uint64_t& blockNum, const unsigned int& numShards, const bool& isDS,
+    const vector<Transaction>& transactions,
+    const function<bool(size_t, const TxnExecutionResult&)>& onResult) {
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary, defer_lock);
+  unique_lock<mutex> g2(m_mutexDelta, defer_lock);
+  lock(g, g2);
+
+  if (!m_parallelTxnExecutor) {
+    m_parallelTxnExecutor =
+        make_unique<ParallelTxnExecutor>(PARALLEL_TXN_EXECUTION_THREADS);
+  }
+
+  // Copy the accounts the wave may touch without adding them into
+  // AccountStoreTemp, as only the transactions applied below may change the
+  // content of the state delta
+  TxnExecutionSnapshot snapshot;
+  const auto& tempAccounts = m_accountStoreTemp->GetAddressToAccount();
+  auto prefetch = [this, &snapshot, &tempAccounts](const Address& address) {
+    if (!snapshot.m_addresses.emplace(address).second) {
+      return;
+    }
+    auto it = tempAccounts->find(address);
+    if (it != tempAccounts->end()) {
+      snapshot.m_accounts.emplace(address, it->second);
+      return;
+    }
+    const Account* account = this->GetAccount(address);
+    if (account != nullptr) {
+      snapshot.m_accounts.emplace(address, *account);
+    }
+  };
+
+  vector<SpeculativeExecution> executions(transactions.size());
+  for (unsigned int i = 0; i < transactions.size(); ++i) {
+    prefetch(transactions[i].GetSenderAddr());
+    prefetch(transactions[i].GetToAddr());
+    executions[i].m_result.m_receipt.SetEpochNum(blockNum);
+  }
+
+  m_parallelTxnExecutor->Speculate(transactions, snapshot, executions);
+
+  // Commit in order, any transaction which read an account written by an
+  // earlier one of this wave is executed again on the latest states
+  unordered_set<Address> written;
+  unsigned int numReExecuted = 0;
+  for (unsigned int i = 0; i < transactions.size(); ++i) {
+    const Transaction& transaction = transactions[i];
+    SpeculativeExecution& execution = executions[i];
+
+    bool conflict = execution.m_outsideSnapshot ||
+                    !ParallelTxnExecutor::IsParallelizable(transaction);
+    for (const auto& address : execution.m_readSet) {
+      if (conflict) {
+        break;
+      }
+      conflict = written.find(address) != written.end();
+    }
+
+    if (conflict) {
+      numReExecuted++;
+      TxnExecutionResult& result = execution.m_result;
+      result.m_receipt = TransactionReceipt();
+      result.m_receipt.SetEpochNum(blockNum);
+      result.m_success = m_accountStoreTemp->UpdateAccounts(
+          blockNum, numShards, isDS, transaction, result.m_receipt,
+          result.m_errorCode);
+      written.emplace(transaction.GetSenderAddr());
+      written.emplace(transaction.GetToAddr());
+    } else {
+      for (auto& entry : execution.m_writeSet) {
+        written.emplace(entry.first);
+        (*tempAccounts)[entry.first] = move(entry.second);
+      }
+    }
+
+    if (!onResult(i, execution.m_result)) {
+      break;
+    }
+  }
+
+  LOG_GENERAL(INFO, "Txns executed in parallel: " << transactions.size()
+                                                  << " re-executed: "
+                                                  << numReExecuted);
+}
+
 bool AccountStore::UpdateCoinbaseTemp(const Address& rewardee,
                                       const Address& genesisAddress,
                                       const uint128_t& amount) {
@@ -564,14 +811,18 @@ bool AccountStore::RevertCommitTemp() {
   for (auto const& entry : m_addressToAccountRevChanged) {
     (*m_addressToAccount)[entry.first] = entry.second;
     UpdateStateTrie(entry.first, entry.second);
+    m_changedAddresses.emplace_back(entry.first);
   }
   for (auto const& entry : m_addressToAccountRevCreated) {
     RemoveAccount(entry.first);
     RemoveFromTrie(entry.first);
+    m_changedAddresses.emplace_back(entry.first);
   }
 
   ContractStorage::GetContractStorage().RevertContractStates();
 
+  UpdateSnapshot();
+
   return true;
 }
 
@@ -793,7 +1044,7 @@ bool AccountStore::MigrateContractStates(
     TransactionReceipt receipt;
     uint64_t gasRem = UINT64_MAX;
 
-    InvokeInterpreter(CHECKER, checkerPrint, scilla_version, is_library, gasRem,
+    InvokeInterpreter(CHECKER, checkerPrint, scilla_version, gasRem,
                       std::numeric_limits<uint128_t>::max(), ret_checker,
                       receipt);
 
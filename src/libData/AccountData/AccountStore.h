@@ -26,9 +26,11 @@
 
 #include <Schnorr.h>
 #include "Account.h"
+#include "AccountSnapshot.h"
 #include "AccountStoreSC.h"
 #include "AccountStoreTrie.h"
 #include "Address.h"
+#include "ParallelTxnExecutor.h"
 #include "TransactionReceipt.h"
 #include "common/Constants.h"
 #include "common/Singleton.h"
@@ -88,6 +90,18 @@ class AccountStore
   /// buffer for the raw bytes of state delta serialized
   bytes m_stateDeltaSerialized;
 
+  /// states after the last committed block for the RPC queries, replaced
+  /// under the primary mutex and read with std::atomic_load only
+  std::shared_ptr<const AccountSnapshot> m_snapshot;
+  uint64_t m_snapshotVersion = 0;
+  /// accounts changed by the account store or state delta being
+  /// deserialized, added to the state trie in one batch and to the snapshot
+  std::vector<Address> m_changedAddresses;
+
+  /// workers for executing payment transactions concurrently, created on first
+  /// use
+  std::unique_ptr<ParallelTxnExecutor> m_parallelTxnExecutor;
+
   /// Scilla IPC server related
   std::shared_ptr<ScillaIPCServer> m_scillaIPCServer;
   std::unique_ptr<jsonrpc::UnixDomainSocketServer> m_scillaIPCServerConnector;
@@ -98,6 +112,18 @@ class AccountStore
   /// Store the trie root to leveldb
   bool MoveRootToDisk(const dev::h256& root);
 
+  /// Insert the accounts changed by the last deserialization into the state
+  /// trie in one batch
+  bool UpdateStateTrieChanged();
+
+  /// Publish a snapshot with no changes on top of the root committed to disk
+  void RebaseSnapshot(const dev::h256& root);
+  /// Publish a snapshot adding the accounts in m_changedAddresses, as they
+  /// are in the account map, and the accounts only written to the trie
+  void UpdateSnapshot(const AccountSnapshot::Accounts& written = {});
+  /// Publish a snapshot adding all the accounts in the account map
+  void RepublishSnapshot();
+
  public:
   /// Returns the singleton AccountStore instance.
   static AccountStore& GetInstance();
@@ -133,6 +159,10 @@ class AccountStore
   /// Use the states in Temp State DB to refresh the state merkle trie
   bool UpdateStateTrieFromTempStateDB();
 
+  /// Put all the accounts in memory into the state trie, and publish them in
+  /// the snapshot
+  bool UpdateStateTrieAll();
+
   /// commit the in-memory states into persistent storage
   bool MoveUpdatesToDisk(uint64_t dsBlockNum = 0);
 
@@ -156,6 +186,16 @@ class AccountStore
                           const Transaction& transaction,
                           TransactionReceipt& receipt, TxnStatus& error_code);
 
+  /// update account states in AccountStoreTemp for a batch of payment
+  /// transactions executed concurrently, with the same outcome as calling
+  /// UpdateAccountsTemp for each of them in order. onResult is invoked in order
+  /// after each transaction is applied; returning false leaves the remaining
+  /// ones unapplied
+  void UpdateAccountsTempInParallel(
+      const uint64_t& blockNum, const unsigned int& numShards,
+      const bool& isDS, const std::vector<Transaction>& transactions,
+      const std::function<bool(size_t, const TxnExecutionResult&)>& onResult);
+
   /// add account in AccountStoreTemp
   void AddAccountTemp(const Address& address, const Account& account) {
     std::lock_guard<std::mutex> g(m_mutexDelta);
@@ -200,6 +240,7 @@ class AccountStore
                                        const bool fullCopy = false,
                                        const bool revertible = false) {
     (*m_addressToAccount)[address] = account;
+    m_changedAddresses.emplace_back(address);
 
     if (revertible) {
       if (fullCopy) {
@@ -208,8 +249,6 @@ class AccountStore
         m_addressToAccountRevChanged[address] = oriAccount;
       }
     }
-
-    UpdateStateTrie(address, account);
   }
 
   /// return the hash of the raw bytes of StateDelta
@@ -241,6 +280,16 @@ class AccountStore
 
   std::shared_timed_mutex& GetPrimaryMutex() { return m_mutexPrimary; }
 
+  /// Returns the states after the last committed block, or nullptr if not
+  /// available yet
+  std::shared_ptr<const AccountSnapshot> GetSnapshot() const {
+    return std::atomic_load(&m_snapshot);
+  }
+
+  /// Returns the account after the last committed block, read from the
+  /// snapshot without the primary mutex when one is available
+  std::shared_ptr<const Account> GetCommittedAccount(const Address& address);
+
   bool MigrateContractStates(
       bool ignoreCheckerFailure, bool disambiguation,
       const std::string& contract_address_output_filename,
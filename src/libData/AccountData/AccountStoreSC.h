@@ -96,6 +96,17 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   /// the interpreter path for each hop of invoking
   std::string m_root_w_version;
 
+  /// the folder of the input and output files of the interpreter, one per
+  /// account store so that the calls of different stores, running on
+  /// different interpreter processes, never write to the same file
+  std::string m_scillaFilesFolder;
+
+  /// the code and init files given to the interpreter for each hop of invoking
+  std::string m_codePath;
+  std::string m_initPath;
+  /// code hash of the contract, to route the calls to the same interpreter
+  dev::h256 m_codeHash;
+
   /// the depth of chain call while executing the current txn
   unsigned int m_curEdges{0};
 
@@ -148,10 +159,20 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
                                    uint32_t tree_depth,
                                    uint32_t pre_scilla_version);
 
+  /// prepare the folder for the input files of the interpreter
+  void PrepareScillaFiles();
+
+  /// export the code and init files of the contract, which are reused across
+  /// invocations if ENABLE_SCILLA_FILES_CACHE
+  bool ExportCodeAndInitFiles(const Account& contract, bool is_library);
+
+  /// write a file shared with the other account stores through a temporary
+  /// one in m_scillaFilesFolder, so that it is either complete or absent
+  void ExportSharedFile(const std::string& path, const std::string& content);
+
   /// export files that ExportCreateContractFiles and ExportContractFiles
   /// both needs
   void ExportCommonFiles(
-      std::ofstream& os, const Account& contract,
       const std::map<Address, std::pair<std::string, std::string>>&
           extlibs_exports);
 
@@ -205,7 +226,7 @@ class AccountStoreSC : public AccountStoreBase<MAP> {
   /// invoke scilla interpreter
   void InvokeInterpreter(INVOKE_TYPE invoke_type,
                          std::string& interprinterPrint,
-                         const uint32_t& version, bool is_library,
+                         const uint32_t& version,
                          const uint64_t& available_gas,
                          const boost::multiprecision::uint128_t& balance,
                          bool& ret, TransactionReceipt& receipt);
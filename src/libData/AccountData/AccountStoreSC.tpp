@@ -22,6 +22,7 @@
 #include <vector>
 #include "EvmClient.h"
 #include "ScillaClient.h"
+#include "ScillaFilesCache.h"
 #include "libPersistence/ContractStorage.h"
 #include "libServer/ScillaIPCServer.h"
 #include "libUtils/DataConversion.h"
@@ -37,7 +38,8 @@
 const unsigned int MAX_SCILLA_OUTPUT_SIZE_IN_BYTES = 5120;
 
 template <class MAP>
-AccountStoreSC<MAP>::AccountStoreSC() {
+AccountStoreSC<MAP>::AccountStoreSC()
+    : m_scillaFilesFolder(ScillaUtils::NewFilesFolder()) {
   m_accountStoreAtomic = std::make_unique<AccountStoreAtomic<MAP>>(*this);
   m_txnProcessTimeout = false;
 }
@@ -55,47 +57,55 @@ void AccountStoreSC<MAP>::Init() {
 
   boost::filesystem::remove_all(EXTLIB_FOLDER);
   boost::filesystem::create_directories(EXTLIB_FOLDER);
+
+  if (ENABLE_SCILLA_FILES_CACHE) {
+    ScillaFilesCache::GetInstance().Prune(SCILLA_FILES_CACHE_SIZE);
+  }
 }
 
 template <class MAP>
 void AccountStoreSC<MAP>::InvokeInterpreter(
     INVOKE_TYPE invoke_type, std::string& interprinterPrint,
-    const uint32_t& version, bool is_library, const uint64_t& available_gas,
+    const uint32_t& version, const uint64_t& available_gas,
     const boost::multiprecision::uint128_t& balance, bool& ret,
     TransactionReceipt& receipt) {
   bool call_already_finished = false;
-  auto func = [this, &interprinterPrint, &invoke_type, &version, &is_library,
+  auto func = [this, &interprinterPrint, &invoke_type, &version,
                &available_gas, &balance, &ret, &receipt,
                &call_already_finished]() mutable -> void {
     switch (invoke_type) {
       case CHECKER:
         if (!ScillaClient::GetInstance().CallChecker(
                 version,
-                ScillaUtils::GetContractCheckerJson(m_root_w_version,
-                                                    is_library, available_gas),
-                interprinterPrint)) {
+                ScillaUtils::GetContractCheckerJson(
+                    m_root_w_version, m_codePath, m_initPath, available_gas),
+                interprinterPrint, m_codeHash)) {
         }
         break;
       case RUNNER_CREATE:
         if (!ScillaClient::GetInstance().CallRunner(
                 version,
-                ScillaUtils::GetCreateContractJson(m_root_w_version, is_library,
-                                                   available_gas, balance),
-                interprinterPrint)) {
+                ScillaUtils::GetCreateContractJson(
+                    m_root_w_version, m_scillaFilesFolder, m_codePath,
+                    m_initPath, available_gas, balance),
+                interprinterPrint, m_codeHash)) {
         }
         break;
       case RUNNER_CALL:
         if (!ScillaClient::GetInstance().CallRunner(
                 version,
-                ScillaUtils::GetCallContractJson(m_root_w_version,
-                                                 available_gas, balance),
-                interprinterPrint)) {
+                ScillaUtils::GetCallContractJson(
+                    m_root_w_version, m_scillaFilesFolder, m_codePath,
+                    m_initPath, available_gas, balance),
+                interprinterPrint, m_codeHash)) {
         }
         break;
       case DISAMBIGUATE:
         if (!ScillaClient::GetInstance().CallDisambiguate(
-                version, ScillaUtils::GetDisambiguateJson(),
-                interprinterPrint)) {
+                version,
+                ScillaUtils::GetDisambiguateJson(m_scillaFilesFolder,
+                                                 m_codePath, m_initPath),
+                interprinterPrint, m_codeHash)) {
         }
         break;
     }
@@ -276,7 +286,7 @@ uint64_t AccountStoreSC<MAP>::InvokeEvmInterpreter(
           if (it->hasCode() && it->Code().size() > 0) {
             targetAccount->SetImmutable(
                 DataConversion::StringToCharArray("EVM" + it->Code()),
-                contractAccount->GetInitData());
+                *contractAccount->GetInitData());
           }
         } catch (std::exception& e) {
           // for now catch any generic exceptions and report them
@@ -341,7 +351,7 @@ uint64_t AccountStoreSC<MAP>::InvokeEvmInterpreter(
   if (invoke_type == RUNNER_CREATE) {
     contractAccount->SetImmutable(DataConversion::StringToCharArray(
                                       "EVM" + evmReturnValues.ReturnedBytes()),
-                                  contractAccount->GetInitData());
+                                  *contractAccount->GetInitData());
   }
   return gas;
 }
@@ -559,8 +569,8 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
       std::string checkerPrint;
 
       if (isScilla)
-        InvokeInterpreter(CHECKER, checkerPrint, scilla_version, is_library,
-                          gasRemained, 0, ret_checker, receipt);
+        InvokeInterpreter(CHECKER, checkerPrint, scilla_version, gasRemained,
+                          0, ret_checker, receipt);
       // 0xabc._version
       // 0xabc._depth.data1
       // 0xabc._type.data1
@@ -595,8 +605,8 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
 
           if (isScilla) {
             InvokeInterpreter(RUNNER_CREATE, runnerPrint, scilla_version,
-                              is_library, gasRemained, transaction.GetAmount(),
-                              ret, receipt);
+                              gasRemained, transaction.GetAmount(), ret,
+                              receipt);
             // parse runner output
             try {
               if (ret && !ParseCreateContract(gasRemained, runnerPrint, receipt,
@@ -792,14 +802,14 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
         error_code = TxnStatus::INVALID_TO_ACCOUNT;
         return false;
       }
-      if (contractAccount->GetCode().empty()) {
+      if (contractAccount->GetCode()->empty()) {
         LOG_GENERAL(
             WARNING,
             "Trying to call a smart contract that has no code will fail");
         error_code = TxnStatus::NOT_PRESENT;
         return false;
       }
-      isScilla = !EvmUtils::isEvm(contractAccount->GetCode());
+      isScilla = !EvmUtils::isEvm(*contractAccount->GetCode());
       bool is_library;
       uint32_t scilla_version;
       uint32_t evm_version{0};
@@ -876,15 +886,15 @@ bool AccountStoreSC<MAP>::UpdateAccounts(const uint64_t& blockNum,
       bool ret = true;
 
       if (isScilla) {
-        InvokeInterpreter(
-            RUNNER_CALL, runnerPrint, scilla_version, is_library, gasRemained,
-            this->GetBalance(transaction.GetToAddr()), ret, receipt);
+        InvokeInterpreter(RUNNER_CALL, runnerPrint, scilla_version, gasRemained,
+                          this->GetBalance(transaction.GetToAddr()), ret,
+                          receipt);
 
       } else {
         EvmCallParameters params = {
             m_curContractAddr.hex(),
             fromAddr.hex(),
-            DataConversion::CharArrayToString(contractAccount->GetCode()),
+            DataConversion::CharArrayToString(*contractAccount->GetCode()),
             DataConversion::CharArrayToString(transaction.GetData()),
             transaction.GetGasLimit(),
             transaction.GetAmount()};
@@ -1051,8 +1061,8 @@ bool AccountStoreSC<MAP>::PopulateExtlibsExports(
       }
 
       extlibs_exports[libAddr] = {
-          DataConversion::CharArrayToString(libAcc->GetCode()),
-          DataConversion::CharArrayToString(libAcc->GetInitData())};
+          DataConversion::CharArrayToString(*libAcc->GetCode()),
+          DataConversion::CharArrayToString(*libAcc->GetInitData())};
 
       if (!extlibsExporter(ext_extlibs, extlibs_exports)) {
         return false;
@@ -1064,6 +1074,71 @@ bool AccountStoreSC<MAP>::PopulateExtlibsExports(
   return extlibsExporter(extlibs, extlibs_exports);
 }
 
+template <class MAP>
+void AccountStoreSC<MAP>::PrepareScillaFiles() {
+  // The files of the previous invocation are all overwritten when cached
+  if (!ENABLE_SCILLA_FILES_CACHE) {
+    boost::filesystem::remove_all("./" + m_scillaFilesFolder);
+  }
+  boost::filesystem::create_directories("./" + m_scillaFilesFolder);
+
+  if (!(boost::filesystem::exists("./" + SCILLA_LOG))) {
+    boost::filesystem::create_directories("./" + SCILLA_LOG);
+  }
+}
+
+template <class MAP>
+bool AccountStoreSC<MAP>::ExportCodeAndInitFiles(const Account& contract,
+                                                 bool is_library) {
+  const std::string& extension =
+      is_library ? LIBRARY_CODE_EXTENSION : CONTRACT_FILE_EXTENSION;
+  m_codeHash = contract.GetCodeHash();
+
+  if (ENABLE_SCILLA_FILES_CACHE && contract.GetCodeHash() != dev::h256()) {
+    if (!ScillaFilesCache::GetInstance().Export(
+            contract.GetCodeHash(), extension, *contract.GetCode(),
+            *contract.GetInitData(), m_codePath, m_initPath)) {
+      LOG_GENERAL(WARNING, "Failed to export the files of the contract");
+      return false;
+    }
+    return true;
+  }
+
+  m_codePath =
+      ScillaUtils::GetFilePath(m_scillaFilesFolder, INPUT_CODE) + extension;
+  m_initPath = ScillaUtils::GetFilePath(m_scillaFilesFolder, INIT_JSON);
+
+  auto exportFile = [](const std::string& path, const bytes& content) {
+    std::ofstream os(path);
+    os << DataConversion::CharArrayToString(content);
+    os.close();
+  };
+
+  // Scilla code
+  exportFile(m_codePath, *contract.GetCode());
+
+  const CodeBytes initData = contract.GetInitData();
+  if (LOG_SC) {
+    LOG_GENERAL(INFO, "init data to export: "
+                          << DataConversion::CharArrayToString(*initData));
+  }
+  exportFile(m_initPath, *initData);
+
+  return true;
+}
+
+template <class MAP>
+void AccountStoreSC<MAP>::ExportSharedFile(const std::string& path,
+                                           const std::string& content) {
+  const std::string tmpPath = ScillaUtils::GetFilePath(
+      m_scillaFilesFolder,
+      boost::filesystem::path(path).filename().string() + ".tmp");
+  std::ofstream os(tmpPath);
+  os << content;
+  os.close();
+  boost::filesystem::rename(tmpPath, path);
+}
+
 template <class MAP>
 bool AccountStoreSC<MAP>::ExportCreateContractFiles(
     const Account& contract, bool is_library, uint32_t scilla_version,
@@ -1071,12 +1146,7 @@ bool AccountStoreSC<MAP>::ExportCreateContractFiles(
         extlibs_exports) {
   LOG_MARKER();
 
-  boost::filesystem::remove_all("./" + SCILLA_FILES);
-  boost::filesystem::create_directories("./" + SCILLA_FILES);
-
-  if (!(boost::filesystem::exists("./" + SCILLA_LOG))) {
-    boost::filesystem::create_directories("./" + SCILLA_LOG);
-  }
+  PrepareScillaFiles();
 
   if (!ScillaUtils::PrepareRootPathWVersion(scilla_version, m_root_w_version)) {
     LOG_GENERAL(WARNING, "PrepareRootPathWVersion failed");
@@ -1084,13 +1154,11 @@ bool AccountStoreSC<MAP>::ExportCreateContractFiles(
   }
 
   try {
-    // Scilla code
-    std::ofstream os(INPUT_CODE + (is_library ? LIBRARY_CODE_EXTENSION
-                                              : CONTRACT_FILE_EXTENSION));
-    os << DataConversion::CharArrayToString(contract.GetCode());
-    os.close();
+    if (!ExportCodeAndInitFiles(contract, is_library)) {
+      return false;
+    }
 
-    ExportCommonFiles(os, contract, extlibs_exports);
+    ExportCommonFiles(extlibs_exports);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -1101,40 +1169,24 @@ bool AccountStoreSC<MAP>::ExportCreateContractFiles(
 
 template <class MAP>
 void AccountStoreSC<MAP>::ExportCommonFiles(
-    std::ofstream& os, const Account& contract,
     const std::map<Address, std::pair<std::string, std::string>>&
         extlibs_exports) {
-  os.open(INIT_JSON);
-  if (LOG_SC) {
-    LOG_GENERAL(
-        INFO, "init data to export: "
-                  << DataConversion::CharArrayToString(contract.GetInitData()));
-  }
-  os << DataConversion::CharArrayToString(contract.GetInitData());
-  os.close();
-
+  // The libraries are read by the calls of all the account stores
   for (const auto& extlib_export : extlibs_exports) {
     std::string code_path =
         EXTLIB_FOLDER + '/' + "0x" + extlib_export.first.hex();
     code_path += LIBRARY_CODE_EXTENSION;
-    boost::filesystem::remove(code_path);
-
-    os.open(code_path);
-    os << extlib_export.second.first;
-    os.close();
+    ExportSharedFile(code_path, extlib_export.second.first);
 
     std::string init_path =
         EXTLIB_FOLDER + '/' + "0x" + extlib_export.first.hex() + ".json";
-    boost::filesystem::remove(init_path);
-
-    os.open(init_path);
-    os << extlib_export.second.second;
-    os.close();
+    ExportSharedFile(init_path, extlib_export.second.second);
   }
 
   // Block Json
   JSONUtils::GetInstance().writeJsontoFile(
-      INPUT_BLOCKCHAIN_JSON, ScillaUtils::GetBlockStateJson(m_curBlockNum));
+      ScillaUtils::GetFilePath(m_scillaFilesFolder, INPUT_BLOCKCHAIN_JSON),
+      ScillaUtils::GetBlockStateJson(m_curBlockNum));
 }
 
 template <class MAP>
@@ -1145,12 +1197,7 @@ bool AccountStoreSC<MAP>::ExportContractFiles(
   LOG_MARKER();
   std::chrono::system_clock::time_point tpStart;
 
-  boost::filesystem::remove_all("./" + SCILLA_FILES);
-  boost::filesystem::create_directories("./" + SCILLA_FILES);
-
-  if (!(boost::filesystem::exists("./" + SCILLA_LOG))) {
-    boost::filesystem::create_directories("./" + SCILLA_LOG);
-  }
+  PrepareScillaFiles();
 
   if (ENABLE_CHECK_PERFORMANCE_LOG) {
     tpStart = r_timer_start();
@@ -1162,12 +1209,11 @@ bool AccountStoreSC<MAP>::ExportContractFiles(
   }
 
   try {
-    // Scilla code
-    std::ofstream os(INPUT_CODE + CONTRACT_FILE_EXTENSION);
-    os << DataConversion::CharArrayToString(contract.GetCode());
-    os.close();
+    if (!ExportCodeAndInitFiles(contract, false)) {
+      return false;
+    }
 
-    ExportCommonFiles(os, contract, extlibs_exports);
+    ExportCommonFiles(extlibs_exports);
 
     if (ENABLE_CHECK_PERFORMANCE_LOG) {
       LOG_GENERAL(INFO, "LDB Read (microsec) = " << r_timer_end(tpStart));
@@ -1205,7 +1251,9 @@ bool AccountStoreSC<MAP>::ExportCallContractFiles(
     msgObj["_origin"] = prepend + m_originAddr.hex();
     msgObj["_amount"] = transaction.GetAmount().convert_to<std::string>();
 
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_MESSAGE_JSON, msgObj);
+    JSONUtils::GetInstance().writeJsontoFile(
+        ScillaUtils::GetFilePath(m_scillaFilesFolder, INPUT_MESSAGE_JSON),
+        msgObj);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -1227,7 +1275,9 @@ bool AccountStoreSC<MAP>::ExportCallContractFiles(
   }
 
   try {
-    JSONUtils::GetInstance().writeJsontoFile(INPUT_MESSAGE_JSON, contractData);
+    JSONUtils::GetInstance().writeJsontoFile(
+        ScillaUtils::GetFilePath(m_scillaFilesFolder, INPUT_MESSAGE_JSON),
+        contractData);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
@@ -1787,8 +1837,8 @@ bool AccountStoreSC<MAP>::ParseCallContractJsonOutput(
       std::string runnerPrint;
       bool result = true;
 
-      InvokeInterpreter(RUNNER_CALL, runnerPrint, scilla_version, is_library,
-                        gasRemained, account->GetBalance(), result, receipt);
+      InvokeInterpreter(RUNNER_CALL, runnerPrint, scilla_version, gasRemained,
+                        account->GetBalance(), result, receipt);
 
       if (ENABLE_CHECK_PERFORMANCE_LOG) {
         LOG_GENERAL(INFO, "Executed " << input_message["_tag"] << " in "
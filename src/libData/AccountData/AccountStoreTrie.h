@@ -35,6 +35,10 @@ class AccountStoreTrie : public AccountStoreSC<MAP> {
   AccountStoreTrie();
 
   bool UpdateStateTrie(const Address& address, const Account& account);
+  /// Inserts the accounts in one batch, the subtries of the state trie are
+  /// merged and hashed in parallel
+  bool UpdateStateTrie(
+      const std::vector<std::pair<Address, const Account*>>& accounts);
   bool RemoveFromTrie(const Address& address);
 
  public:
@@ -48,11 +52,22 @@ class AccountStoreTrie : public AccountStoreSC<MAP> {
 
   Account* GetAccount(const Address& address, bool resetRoot);
 
+  /// Reads the account from the trie at a root committed to disk, without
+  /// locking the trie as the nodes under such a root do not change. Sets
+  /// found if the account exists, returns false if the nodes of the root were
+  /// deleted from the disk.
+  bool GetAccountAtRoot(const Address& address, const dev::h256& root,
+                        Account& account, bool& found);
+
   bool GetProof(const Address& address, const dev::h256& rootHash,
                 Account& account, std::set<std::string>& nodes);
 
   dev::h256 GetStateRootHash() const;
   dev::h256 GetPrevRootHash() const;
+  /// Counters of the cache of the trie nodes read from disk
+  dev::NodeCache::Stats GetNodeCacheStats() const {
+    return m_db.nodeCacheStats();
+  }
   bool UpdateStateTrieAll();
 
   void PrintAccountState() override;
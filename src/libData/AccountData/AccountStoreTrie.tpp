@@ -18,7 +18,9 @@
 #include "libMessage/MessengerAccountStoreTrie.h"
 
 template <class MAP>
-AccountStoreTrie<MAP>::AccountStoreTrie() : m_db("state"), m_state(&m_db) {}
+AccountStoreTrie<MAP>::AccountStoreTrie()
+    : m_db("state", size_t(STATE_TRIE_NODE_CACHE_MB) * 1024 * 1024),
+      m_state(&m_db) {}
 
 template <class MAP>
 void AccountStoreTrie<MAP>::Init() {
@@ -120,6 +122,52 @@ Account* AccountStoreTrie<MAP>::GetAccount(const Address& address,
   return &it2.first->second;
 }
 
+template <class MAP>
+bool AccountStoreTrie<MAP>::GetAccountAtRoot(const Address& address,
+                                             const dev::h256& root,
+                                             Account& account, bool& found) {
+  found = false;
+  std::string rawAccountBase;
+
+  // The nodes are not deleted while read, and not read once deleted
+  std::shared_lock<std::shared_timed_mutex> lock(m_db.GetPurgeMutex());
+  if (!m_db.exists(root)) {
+    LOG_GENERAL(WARNING, "Root " << root.hex() << " no longer on disk");
+    return false;
+  }
+
+  try {
+    dev::GenericTrieDB<TraceableDB> t_state(&m_db);
+    t_state.setRoot(root);
+    rawAccountBase =
+        t_state.at(DataConversion::StringToCharArray(address.hex()));
+  } catch (std::exception& e) {
+    LOG_GENERAL(WARNING,
+                "setRoot for " << root.hex() << " failed, " << e.what());
+    return false;
+  }
+
+  if (rawAccountBase.empty()) {
+    return true;
+  }
+
+  Account t_account;
+  if (!t_account.DeserializeBase(
+          bytes(rawAccountBase.begin(), rawAccountBase.end()), 0)) {
+    LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+    return false;
+  }
+
+  if (t_account.isContract()) {
+    t_account.SetAddress(address);
+  }
+
+  account = std::move(t_account);
+  found = true;
+
+  return true;
+}
+
 template <class MAP>
 bool AccountStoreTrie<MAP>::GetProof(const Address& address,
                                      const dev::h256& rootHash,
@@ -192,6 +240,25 @@ bool AccountStoreTrie<MAP>::UpdateStateTrie(const Address& address,
   return true;
 }
 
+template <class MAP>
+bool AccountStoreTrie<MAP>::UpdateStateTrie(
+    const std::vector<std::pair<Address, const Account*>>& accounts) {
+  std::vector<std::pair<bytes, bytes>> items(accounts.size());
+  for (unsigned int i = 0; i < accounts.size(); i++) {
+    if (!accounts[i].second->SerializeBase(items[i].second, 0)) {
+      LOG_GENERAL(WARNING, "Messenger::SetAccountBase failed");
+      return false;
+    }
+    items[i].first =
+        DataConversion::StringToCharArray(accounts[i].first.hex());
+  }
+
+  std::lock_guard<std::mutex> g(m_mutexTrie);
+  m_state.insertBatch(items);
+
+  return true;
+}
+
 template <class MAP>
 bool AccountStoreTrie<MAP>::RemoveFromTrie(const Address& address) {
   // LOG_MARKER();
@@ -227,15 +294,18 @@ bool AccountStoreTrie<MAP>::UpdateStateTrieAll() {
       return false;
     }
   }
+  std::vector<std::pair<bytes, bytes>> items;
+  items.reserve(this->m_addressToAccount->size());
   for (auto const& entry : *(this->m_addressToAccount)) {
     bytes rawBytes;
     if (!entry.second.SerializeBase(rawBytes, 0)) {
       LOG_GENERAL(WARNING, "Messenger::SetAccountBase failed");
       return false;
     }
-    m_state.insert(DataConversion::StringToCharArray(entry.first.hex()),
-                   rawBytes);
+    items.emplace_back(DataConversion::StringToCharArray(entry.first.hex()),
+                       std::move(rawBytes));
   }
+  m_state.insertBatch(items);
 
   m_prevRoot = m_state.root();
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CodeStore.h"
+#include "libCrypto/Sha2.h"
+
+using namespace std;
+
+CodeStore& CodeStore::GetInstance() {
+  static CodeStore codeStore;
+  return codeStore;
+}
+
+CodeBytes CodeStore::Add(const bytes& data) {
+  if (data.empty()) {
+    return Empty();
+  }
+
+  SHA2<HashType::HASH_VARIANT_256> sha2;
+  sha2.Update(data);
+  const dev::h256 key(sha2.Finalize());
+
+  lock_guard<mutex> g(m_mutex);
+  auto& entry = m_entries[key];
+  CodeBytes code = entry.lock();
+  if (!code) {
+    code = make_shared<const bytes>(data);
+    entry = code;
+    if (m_entries.size() >= m_purgeThreshold) {
+      PurgeExpired();
+    }
+  }
+  return code;
+}
+
+const CodeBytes& CodeStore::Empty() {
+  static const CodeBytes empty = make_shared<const bytes>();
+  return empty;
+}
+
+void CodeStore::GetStats(size_t& numEntries, uint64_t& numBytes) {
+  lock_guard<mutex> g(m_mutex);
+  numEntries = 0;
+  numBytes = 0;
+  for (const auto& entry : m_entries) {
+    if (const CodeBytes code = entry.second.lock()) {
+      numEntries++;
+      numBytes += code->size();
+    }
+  }
+}
+
+void CodeStore::PurgeExpired() {
+  for (auto it = m_entries.begin(); it != m_entries.end();) {
+    if (it->second.expired()) {
+      it = m_entries.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  m_purgeThreshold = max<size_t>(1024, m_entries.size() * 2);
+}
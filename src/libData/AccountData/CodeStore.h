@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_CODESTORE_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_CODESTORE_H_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+/// Code or init data of a contract, immutable and shared by the accounts
+using CodeBytes = std::shared_ptr<const bytes>;
+
+/// Content-addressed store of the code and init data of the contracts, keyed
+/// by their SHA256. The accounts only hold handles to the entries, so copying
+/// an account does not copy its code, and contracts deployed with the same
+/// code share one buffer. An entry is dropped with the last handle to it.
+class CodeStore {
+ public:
+  static CodeStore& GetInstance();
+
+  /// Returns the entry with the same content as data, adding it if needed
+  CodeBytes Add(const bytes& data);
+
+  /// Handle to empty bytes, for the accounts without code
+  static const CodeBytes& Empty();
+
+  /// Number of entries still held, and their total size in bytes
+  void GetStats(size_t& numEntries, uint64_t& numBytes);
+
+ private:
+  CodeStore() = default;
+  CodeStore(const CodeStore&) = delete;
+  CodeStore& operator=(const CodeStore&) = delete;
+
+  /// Drops the entries no longer held, called with m_mutex locked
+  void PurgeExpired();
+
+  std::mutex m_mutex;
+  std::unordered_map<dev::h256, std::weak_ptr<const bytes>> m_entries;
+  /// Size of m_entries past which the dropped entries are purged
+  size_t m_purgeThreshold{1024};
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_CODESTORE_H_
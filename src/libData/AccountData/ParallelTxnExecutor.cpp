@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+
+#include "ParallelTxnExecutor.h"
+
+using namespace std;
+using namespace boost::multiprecision;
+
+AccountStoreSpeculative::AccountStoreSpeculative(
+    const TxnExecutionSnapshot& snapshot)
+    : m_snapshot(snapshot) {}
+
+Account* AccountStoreSpeculative::GetAccount(const Address& address) {
+  Account* account =
+      AccountStoreBase<unordered_map<Address, Account>>::GetAccount(address);
+  if (account != nullptr) {
+    return account;
+  }
+
+  m_readSet.emplace(address);
+  if (m_snapshot.m_addresses.find(address) == m_snapshot.m_addresses.end()) {
+    m_outsideSnapshot = true;
+    return nullptr;
+  }
+
+  auto it = m_snapshot.m_accounts.find(address);
+  if (it == m_snapshot.m_accounts.end()) {
+    return nullptr;
+  }
+
+  return &(m_addressToAccount->emplace(address, it->second).first->second);
+}
+
+bool AccountStoreSpeculative::UpdateAccounts(const Transaction& transaction,
+                                             TransactionReceipt& receipt,
+                                             TxnStatus& error_code) {
+  error_code = TxnStatus::NOT_PRESENT;
+
+  uint128_t gasDeposit;
+  if (!SafeMath<uint128_t>::mul(transaction.GetGasLimit(),
+                                transaction.GetGasPrice(), gasDeposit)) {
+    error_code = TxnStatus::MATH_ERROR;
+    return false;
+  }
+
+  // Disallow normal transaction to contract account
+  Account* toAccount = this->GetAccount(transaction.GetToAddr());
+  if (toAccount != nullptr) {
+    if (toAccount->isContract()) {
+      LOG_GENERAL(WARNING, "Contract account won't accept normal txn");
+      error_code = TxnStatus::INVALID_TO_ACCOUNT;
+      return false;
+    }
+  }
+
+  return AccountStoreBase<unordered_map<Address, Account>>::UpdateAccounts(
+      transaction, receipt, error_code);
+}
+
+ParallelTxnExecutor::ParallelTxnExecutor(const unsigned int numWorkers)
+    : m_numWorkers(max(numWorkers, 1u)),
+      m_workers(m_numWorkers, "ParallelTxnExecutor") {}
+
+bool ParallelTxnExecutor::IsParallelizable(const Transaction& transaction) {
+  return Transaction::GetTransactionType(transaction) ==
+         Transaction::NON_CONTRACT;
+}
+
+void ParallelTxnExecutor::Speculate(const vector<Transaction>& transactions,
+                                    const TxnExecutionSnapshot& snapshot,
+                                    vector<SpeculativeExecution>& executions) {
+  if (executions.size() != transactions.size()) {
+    LOG_GENERAL(WARNING, "Mismatched executions size " << executions.size()
+                                                       << " for "
+                                                       << transactions.size()
+                                                       << " txns");
+    return;
+  }
+
+  atomic<size_t> next{0};
+
+  auto executeAll = [&transactions, &snapshot, &executions, &next]() -> void {
+    for (size_t i = next++; i < transactions.size(); i = next++) {
+      AccountStoreSpeculative store(snapshot);
+      SpeculativeExecution& execution = executions[i];
+      execution.m_result.m_success =
+          store.UpdateAccounts(transactions[i], execution.m_result.m_receipt,
+                               execution.m_result.m_errorCode);
+      execution.m_readSet = store.GetReadSet();
+      execution.m_writeSet = move(*store.GetAddressToAccount());
+      execution.m_outsideSnapshot = store.IsOutsideSnapshot();
+    }
+  };
+
+  const unsigned int numJobs = min(
+      m_numWorkers, static_cast<unsigned int>(transactions.size()));
+  if (numJobs <= 1) {
+    executeAll();
+    return;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexWave);
+    m_pendingWorkers = numJobs;
+  }
+
+  for (unsigned int i = 0; i < numJobs; ++i) {
+    m_workers.AddJob([this, &executeAll]() -> void {
+      executeAll();
+      lock_guard<mutex> g(m_mutexWave);
+      if (--m_pendingWorkers == 0) {
+        cv_waveFinished.notify_all();
+      }
+    });
+  }
+
+  unique_lock<mutex> lock(m_mutexWave);
+  cv_waveFinished.wait(lock, [this] { return m_pendingWorkers == 0; });
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PARALLELTXNEXECUTOR_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PARALLELTXNEXECUTOR_H_
+
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "AccountStoreBase.h"
+#include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
+
+/// Outcome of executing one transaction, same as returned by
+/// AccountStore::UpdateAccountsTemp
+struct TxnExecutionResult {
+  TransactionReceipt m_receipt;
+  TxnStatus m_errorCode{TxnStatus::NOT_PRESENT};
+  bool m_success{false};
+};
+
+/// Read-only copy of every account a wave of transactions may touch, taken
+/// before the wave is executed
+struct TxnExecutionSnapshot {
+  /// accounts that exist at the time the snapshot is taken
+  std::unordered_map<Address, Account> m_accounts;
+  /// all the addresses looked up, including the ones without an account
+  std::unordered_set<Address> m_addresses;
+};
+
+/// Account view used by a single speculative execution. Accounts are copied on
+/// first access from the snapshot and every address accessed is recorded, so
+/// the accounts held at the end are the write set of the transaction.
+class AccountStoreSpeculative
+    : public AccountStoreBase<std::unordered_map<Address, Account>> {
+  const TxnExecutionSnapshot& m_snapshot;
+  std::set<Address> m_readSet;
+  bool m_outsideSnapshot{false};
+
+ public:
+  AccountStoreSpeculative(const TxnExecutionSnapshot& snapshot);
+
+  Account* GetAccount(const Address& address) override;
+
+  /// same logic as AccountStoreSC::UpdateAccounts for Transaction::NON_CONTRACT
+  bool UpdateAccounts(const Transaction& transaction,
+                      TransactionReceipt& receipt, TxnStatus& error_code);
+
+  const std::set<Address>& GetReadSet() const { return m_readSet; }
+
+  /// whether an address not covered by the snapshot has been accessed
+  bool IsOutsideSnapshot() const { return m_outsideSnapshot; }
+
+  const std::shared_ptr<std::unordered_map<Address, Account>>&
+  GetAddressToAccount() {
+    return this->m_addressToAccount;
+  }
+};
+
+/// Speculative execution of one transaction of a wave
+struct SpeculativeExecution {
+  TxnExecutionResult m_result;
+  std::set<Address> m_readSet;
+  std::unordered_map<Address, Account> m_writeSet;
+  bool m_outsideSnapshot{false};
+};
+
+/// Executes a wave of payment transactions concurrently on a pool of workers.
+/// Each transaction runs in isolation against the same snapshot; the caller
+/// commits the results in the original order and re-executes serially any
+/// transaction whose read set intersects the writes committed before it, which
+/// makes the outcome identical to executing the wave serially.
+class ParallelTxnExecutor {
+  const unsigned int m_numWorkers;
+  ThreadPool m_workers;
+
+  std::mutex m_mutexWave;
+  std::condition_variable cv_waveFinished;
+  unsigned int m_pendingWorkers{0};
+
+ public:
+  explicit ParallelTxnExecutor(const unsigned int numWorkers);
+
+  /// Only normal payments can be executed speculatively
+  static bool IsParallelizable(const Transaction& transaction);
+
+  /// Execute every transaction against the snapshot, the receipts in
+  /// executions are expected to be initialized by the caller
+  void Speculate(const std::vector<Transaction>& transactions,
+                 const TxnExecutionSnapshot& snapshot,
+                 std::vector<SpeculativeExecution>& executions);
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PARALLELTXNEXECUTOR_H_
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "PendingTxnQueue.h"
+
+using namespace std;
+using namespace boost::multiprecision;
+
+void PendingTxnQueue::Unready(const Address& address) {
+  auto it = m_readyKeys.find(address);
+  if (it != m_readyKeys.end()) {
+    m_ready.erase(it->second);
+    m_readyKeys.erase(it);
+  }
+}
+
+void PendingTxnQueue::Insert(const Transaction& t, const uint128_t& nonce) {
+  const Address senderAddr = t.GetSenderAddr();
+  auto& txns = m_txns[senderAddr];
+  auto it = txns.find(t.GetNonce());
+  if (it != txns.end()) {
+    // found the txn with same addr and same nonce
+    // then compare the gasprice and remains the higher one
+    if (t.GetGasPrice() <= it->second.GetGasPrice()) {
+      return;
+    }
+    it->second = t;
+  } else {
+    txns.emplace(t.GetNonce(), t);
+  }
+  UpdateNonce(senderAddr, nonce);
+}
+
+void PendingTxnQueue::Erase(const Address& address, const uint64_t& nonce) {
+  auto it = m_txns.find(address);
+  if (it == m_txns.end()) {
+    return;
+  }
+  if (it->second.begin()->first == nonce) {
+    Unready(address);
+  }
+  it->second.erase(nonce);
+  if (it->second.empty()) {
+    m_txns.erase(it);
+  }
+}
+
+void PendingTxnQueue::UpdateNonce(const Address& address,
+                                  const uint128_t& nonce) {
+  Unready(address);
+
+  auto it = m_txns.find(address);
+  if (it == m_txns.end()) {
+    return;
+  }
+
+  const Transaction& next = it->second.begin()->second;
+  if (next.GetNonce() == nonce + 1) {
+    ReadyKey key{next.GetGasPrice(), next.GetTranID(), address};
+    m_ready.emplace(key);
+    m_readyKeys.emplace(address, move(key));
+  }
+}
+
+bool PendingTxnQueue::FindOne(Transaction& t) {
+  if (m_ready.empty()) {
+    return false;
+  }
+
+  const Address address = get<2>(*m_ready.begin());
+  m_ready.erase(m_ready.begin());
+  m_readyKeys.erase(address);
+
+  // The following nonce of this sender only becomes executable once this txn
+  // has been applied, see UpdateNonce
+  auto it = m_txns.find(address);
+  t = move(it->second.begin()->second);
+  it->second.erase(it->second.begin());
+  if (it->second.empty()) {
+    m_txns.erase(it);
+  }
+  return true;
+}
+
+bool PendingTxnQueue::Get(const Address& address, const uint64_t& nonce,
+                          Transaction& t) const {
+  auto it = m_txns.find(address);
+  if (it == m_txns.end()) {
+    return false;
+  }
+  auto it2 = it->second.find(nonce);
+  if (it2 == it->second.end()) {
+    return false;
+  }
+  t = it2->second;
+  return true;
+}
+
+void PendingTxnQueue::Clear() {
+  m_txns.clear();
+  m_ready.clear();
+  m_readyKeys.clear();
+}
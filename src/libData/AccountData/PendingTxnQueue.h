@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
+
+#include <functional>
+#include <map>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+#include "Address.h"
+#include "Transaction.h"
+
+/// Transactions whose nonce is ahead of their sender's, held until the nonces
+/// in between are used. The lowest nonce transaction of a sender is promoted
+/// into a ready set once it follows the sender's current nonce, so the next
+/// executable transaction is found in O(log n) instead of checking every
+/// sender.
+class PendingTxnQueue {
+ public:
+  /// Order in which the ready transactions are taken out. It is part of the
+  /// txn ordering the backups check the leader's against.
+  enum class Order {
+    /// lowest sender address first, as the scan of the senders did
+    BY_ADDRESS,
+    /// highest gas price first, then txn hash
+    BY_GAS_PRICE
+  };
+
+ private:
+  using ReadyKey = std::tuple<uint128_t, TxnHash, Address>;
+  struct ReadyKeyCompare {
+    Order m_order;
+
+    bool operator()(const ReadyKey& a, const ReadyKey& b) const {
+      if (m_order == Order::BY_ADDRESS) {
+        return std::get<2>(a) < std::get<2>(b);
+      }
+      if (std::get<0>(a) != std::get<0>(b)) {
+        return std::get<0>(a) > std::get<0>(b);
+      }
+      return std::get<1>(a) < std::get<1>(b);
+    }
+  };
+
+  std::map<Address, std::map<uint64_t, Transaction>> m_txns;
+  std::set<ReadyKey, ReadyKeyCompare> m_ready;
+  std::unordered_map<Address, ReadyKey> m_readyKeys;
+
+  void Unready(const Address& address);
+
+ public:
+  explicit PendingTxnQueue(Order order) : m_ready(ReadyKeyCompare{order}) {}
+
+  /// Queue a transaction, if one with the same sender and nonce is already
+  /// queued only the one with the higher gas price is kept. nonce is the
+  /// current nonce of the sender.
+  void Insert(const Transaction& t, const uint128_t& nonce);
+
+  /// Remove the transaction of the sender with the given nonce, if any
+  void Erase(const Address& address, const uint64_t& nonce);
+
+  /// To be called when the nonce of the sender may have changed
+  void UpdateNonce(const Address& address, const uint128_t& nonce);
+
+  /// Take out the first executable transaction in the order of the queue
+  bool FindOne(Transaction& t);
+
+  bool Get(const Address& address, const uint64_t& nonce,
+           Transaction& t) const;
+
+  /// All the queued transactions by sender and nonce
+  const std::map<Address, std::map<uint64_t, Transaction>>& GetTxns() const {
+    return m_txns;
+  }
+
+  bool Empty() const { return m_txns.empty(); }
+
+  size_t NumReady() const { return m_ready.size(); }
+
+  void Clear();
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_PENDINGTXNQUEUE_H_
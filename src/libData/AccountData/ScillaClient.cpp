@@ -17,6 +17,8 @@
 
 #include "ScillaClient.h"
 
+#include <sstream>
+
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/JsonUtils.h"
 #include "libUtils/ScillaUtils.h"
@@ -28,6 +30,21 @@
 
 using namespace boost::filesystem;
 
+namespace {
+uint64_t NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+ScillaClient::ScillaClient() {
+  for (const auto& method : {"check", "run", "disambiguate"}) {
+    m_latencies.emplace(std::piecewise_construct,
+                        std::forward_as_tuple(method), std::forward_as_tuple());
+  }
+}
+
 ScillaClient::~ScillaClient() {
   std::string cmdStr = "pkill " + SCILLA_SERVER_BINARY + " >/dev/null &";
   LOG_GENERAL(INFO, "cmdStr: " << cmdStr);
@@ -73,6 +90,11 @@ void ScillaClient::Init() {
   }
 }
 
+std::string ScillaClient::GetSocketPath(uint32_t version) {
+  return SCILLA_SERVER_SOCKET_PATH +
+         (ENABLE_SCILLA_MULTI_VERSION ? ("." + std::to_string(version)) : "");
+}
+
 bool ScillaClient::OpenServer(uint32_t version) {
   LOG_MARKER();
 
@@ -89,11 +111,10 @@ bool ScillaClient::OpenServer(uint32_t version) {
   if (ENABLE_SCILLA_MULTI_VERSION) {
     cmdStr = "ps aux | awk '{print $2\"\\t\"$11}' | grep \"" + server_path +
              "\" | awk '{print $1}' | xargs kill -SIGTERM ; " + server_path +
-             " -socket " + SCILLA_SERVER_SOCKET_PATH + "." +
-             std::to_string(version) + " >/dev/null &";
+             " -socket " + GetSocketPath(version) + " >/dev/null &";
   } else {
     cmdStr = "pkill " + SCILLA_SERVER_BINARY + " ; " + server_path +
-             " -socket " + SCILLA_SERVER_SOCKET_PATH + " >/dev/null &";
+             " -socket " + GetSocketPath(version) + " >/dev/null &";
   }
 
   LOG_GENERAL(INFO, "cmdStr: " << cmdStr);
@@ -120,74 +141,98 @@ bool ScillaClient::OpenServer(uint32_t version) {
   return true;
 }
 
-bool ScillaClient::CheckClient(uint32_t version, bool enforce) {
-  std::lock_guard<std::mutex> g(m_mutexMain);
-
-  if (m_clients.find(version) != m_clients.end() && !enforce) {
+bool ScillaClient::RestartServer(uint32_t version, Interpreter& interpreter,
+                                 uint64_t numRestarts) {
+  std::lock_guard<std::mutex> start(m_mutexStart);
+  if (interpreter.m_numRestarts != numRestarts) {
     return true;
   }
 
+  // Counted before the process is killed, so that the failure of the call it
+  // was serving is known to come from the restart
+  interpreter.m_numRestarts++;
   if (!OpenServer(version)) {
-    LOG_GENERAL(WARNING, "OpenServer for version " << version << "failed");
+    LOG_GENERAL(WARNING, "OpenServer for version " << version << " failed");
     return false;
   }
 
-  std::shared_ptr<jsonrpc::UnixDomainSocketClient> conn =
-      std::make_shared<jsonrpc::UnixDomainSocketClient>(
-          SCILLA_SERVER_SOCKET_PATH +
-          (ENABLE_SCILLA_MULTI_VERSION ? ("." + std::to_string(version)) : ""));
-
-  m_connectors[version] = conn;
-
-  std::shared_ptr<jsonrpc::Client> c = std::make_shared<jsonrpc::Client>(
-      *m_connectors.at(version), jsonrpc::JSONRPC_CLIENT_V2);
-  m_clients[version] = c;
-
   return true;
 }
 
-bool ScillaClient::CallChecker(uint32_t version, const Json::Value& _json,
-                               std::string& result, uint32_t counter) {
-  if (counter == 0) {
-    return false;
-  }
-
+bool ScillaClient::CheckClient(uint32_t version, bool enforce) {
   if (!ENABLE_SCILLA_MULTI_VERSION) {
     version = 0;
   }
 
-  if (!CheckClient(version)) {
-    LOG_GENERAL(WARNING, "CheckClient failed");
-    return false;
+  std::shared_ptr<Interpreter> interpreter;
+  {
+    std::lock_guard<std::mutex> g(m_mutexMain);
+    const auto it = m_interpreters.find(version);
+    if (it != m_interpreters.end()) {
+      interpreter = it->second;
+    }
+  }
+  if (interpreter) {
+    // Not waiting for m_mutexCall, held by the call the process is stuck in
+    return !enforce ||
+           RestartServer(version, *interpreter, interpreter->m_numRestarts);
   }
 
-  try {
+  // Launching the process takes SCILLA_SERVER_PENDING_IN_MS, during which
+  // the calls to the versions already started go on
+  std::lock_guard<std::mutex> start(m_mutexStart);
+  {
     std::lock_guard<std::mutex> g(m_mutexMain);
-    result = m_clients.at(version)->CallMethod("check", _json).asString();
-  } catch (jsonrpc::JsonRpcException& e) {
-    LOG_GENERAL(WARNING, "CallChecker failed: " << e.what());
-    if (std::string(e.what()).find(SCILLA_SERVER_SOCKET_PATH) !=
-        std::string::npos) {
-      if (!CheckClient(version, true)) {
-        LOG_GENERAL(WARNING, "CheckClient for version " << version << "failed");
-        return CallChecker(version, _json, result, counter - 1);
-      }
-    } else {
-      result = e.what();
+    if (m_interpreters.find(version) != m_interpreters.end()) {
+      return true;
     }
+  }
 
+  if (!OpenServer(version)) {
+    LOG_GENERAL(WARNING, "OpenServer for version " << version << "failed");
     return false;
   }
 
+  interpreter = std::make_shared<Interpreter>();
+  interpreter->m_socketPath = GetSocketPath(version);
+  interpreter->m_connector = std::make_shared<jsonrpc::UnixDomainSocketClient>(
+      interpreter->m_socketPath);
+  interpreter->m_client = std::make_shared<jsonrpc::Client>(
+      *interpreter->m_connector, jsonrpc::JSONRPC_CLIENT_V2);
+
+  std::lock_guard<std::mutex> g(m_mutexMain);
+  m_interpreters[version] = std::move(interpreter);
+
   return true;
 }
 
-bool ScillaClient::CallRunner(uint32_t version, const Json::Value& _json,
-                              std::string& result, uint32_t counter) {
-  if (counter == 0) {
-    return false;
+std::unique_lock<std::mutex> ScillaClient::AcquireInterpreter(
+    Interpreter& interpreter) {
+  std::unique_lock<std::mutex> lock(interpreter.m_mutexCall, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    m_queueDepth++;
+    lock.lock();
+    m_queueDepth--;
+  }
+  return lock;
+}
+
+void ScillaClient::OnCall(Interpreter& interpreter, const dev::h256& codeHash) {
+  interpreter.m_numCalls++;
+  if (interpreter.m_codeHashesRestarts != interpreter.m_numRestarts) {
+    // The contracts parsed before the restart are gone with the process
+    interpreter.m_codeHashes.clear();
+    interpreter.m_codeHashesRestarts = interpreter.m_numRestarts;
+  }
+  if (codeHash != dev::h256() &&
+      !interpreter.m_codeHashes.emplace(codeHash).second) {
+    interpreter.m_numWarmCalls++;
   }
+}
 
+bool ScillaClient::CallMethod(const std::string& method, uint32_t version,
+                              const Json::Value& _json, std::string& result,
+                              const dev::h256& codeHash) {
   if (!ENABLE_SCILLA_MULTI_VERSION) {
     version = 0;
   }
@@ -197,16 +242,28 @@ bool ScillaClient::CallRunner(uint32_t version, const Json::Value& _json,
     return false;
   }
 
-  try {
+  std::shared_ptr<Interpreter> interpreter;
+  {
     std::lock_guard<std::mutex> g(m_mutexMain);
-    result = m_clients.at(version)->CallMethod("run", _json).asString();
+    interpreter = m_interpreters.at(version);
+  }
+
+  std::unique_lock<std::mutex> lock = AcquireInterpreter(*interpreter);
+  const uint64_t startMs = NowMs();
+  const uint64_t numRestarts = interpreter->m_numRestarts;
+  OnCall(*interpreter, codeHash);
+
+  try {
+    result = interpreter->m_client->CallMethod(method, _json).asString();
   } catch (jsonrpc::JsonRpcException& e) {
-    LOG_GENERAL(WARNING, "CallRunner failed: " << e.what());
+    lock.unlock();
+
+    LOG_GENERAL(WARNING, "Call " << method << " failed: " << e.what());
     if (std::string(e.what()).find(SCILLA_SERVER_SOCKET_PATH) !=
         std::string::npos) {
-      if (!CheckClient(version, true)) {
-        LOG_GENERAL(WARNING, "CheckClient for version " << version << "failed");
-        return CallRunner(version, _json, result, counter - 1);
+      if (!RestartServer(version, *interpreter, numRestarts)) {
+        LOG_GENERAL(WARNING,
+                    "RestartServer for version " << version << " failed");
       }
     } else {
       result = e.what();
@@ -215,42 +272,49 @@ bool ScillaClient::CallRunner(uint32_t version, const Json::Value& _json,
     return false;
   }
 
+  lock.unlock();
+  m_latencies.at(method).Record(NowMs() - startMs);
+  if (LOG_SC) {
+    LOG_GENERAL(INFO, GetStats());
+  }
+
   return true;
 }
 
-bool ScillaClient::CallDisambiguate(uint32_t version, const Json::Value& _json,
-                                    std::string& result, uint32_t counter) {
-  if (counter == 0) {
-    return false;
-  }
+bool ScillaClient::CallChecker(uint32_t version, const Json::Value& _json,
+                               std::string& result,
+                               const dev::h256& codeHash) {
+  return CallMethod("check", version, _json, result, codeHash);
+}
 
-  if (!ENABLE_SCILLA_MULTI_VERSION) {
-    version = 0;
-  }
+bool ScillaClient::CallRunner(uint32_t version, const Json::Value& _json,
+                              std::string& result, const dev::h256& codeHash) {
+  return CallMethod("run", version, _json, result, codeHash);
+}
 
-  if (!CheckClient(version)) {
-    LOG_GENERAL(WARNING, "CheckClient failed");
-    return false;
-  }
+bool ScillaClient::CallDisambiguate(uint32_t version, const Json::Value& _json,
+                                    std::string& result,
+                                    const dev::h256& codeHash) {
+  return CallMethod("disambiguate", version, _json, result, codeHash);
+}
 
-  try {
+std::string ScillaClient::GetStats() {
+  std::map<uint32_t, std::shared_ptr<Interpreter>> interpreters;
+  {
     std::lock_guard<std::mutex> g(m_mutexMain);
-    result =
-        m_clients.at(version)->CallMethod("disambiguate", _json).asString();
-  } catch (jsonrpc::JsonRpcException& e) {
-    LOG_GENERAL(WARNING, "CallDisambiguate failed: " << e.what());
-    if (std::string(e.what()).find(SCILLA_SERVER_SOCKET_PATH) !=
-        std::string::npos) {
-      if (!CheckClient(version, true)) {
-        LOG_GENERAL(WARNING, "CheckClient for version " << version << "failed");
-        return CallDisambiguate(version, _json, result, counter - 1);
-      }
-    } else {
-      result = e.what();
-    }
-
-    return false;
+    interpreters = m_interpreters;
   }
 
-  return true;
-}
\ No newline at end of file
+  std::ostringstream oss;
+  oss << "Scilla queue depth: " << m_queueDepth;
+  for (const auto& latency : m_latencies) {
+    oss << ", " << latency.first << ": " << latency.second.ToString();
+  }
+  for (const auto& entry : interpreters) {
+    const Interpreter& interpreter = *entry.second;
+    oss << ", [" << interpreter.m_socketPath << " calls "
+        << interpreter.m_numCalls << " warm " << interpreter.m_numWarmCalls
+        << " restarts " << interpreter.m_numRestarts << "]";
+  }
+  return oss.str();
+}
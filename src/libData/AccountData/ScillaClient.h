@@ -18,42 +18,99 @@
 #ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLACLIENT_H_
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLACLIENT_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 #include <jsonrpccpp/client.h>
 #include <jsonrpccpp/client/connectors/unixdomainsocketclient.h>
 
 #include "common/Constants.h"
+#include "depends/common/FixedHash.h"
+#include "libUtils/LatencyHistogram.h"
 
 class ScillaClient {
-  std::map<uint32_t, std::shared_ptr<jsonrpc::Client>> m_clients;
-  std::map<uint32_t, std::shared_ptr<jsonrpc::UnixDomainSocketClient>>
-      m_connectors;
-
-  std::mutex m_mutexMain;
-
-  ScillaClient(){};
-  ~ScillaClient();
-
-  bool OpenServer(uint32_t version);
-
  public:
   static ScillaClient& GetInstance() {
     static ScillaClient scillaclient;
     return scillaclient;
   }
 
+  /// Start the interpreter of the version if not started yet. If enforce,
+  /// restart it, cutting the call it may be stuck in.
   bool CheckClient(uint32_t version, bool enforce = false);
 
   void Init();
 
   bool CallChecker(uint32_t version, const Json::Value& _json,
-                   std::string& result, uint32_t counter = MAXRETRYCONN);
+                   std::string& result,
+                   const dev::h256& codeHash = dev::h256());
   bool CallRunner(uint32_t version, const Json::Value& _json,
-                  std::string& result, uint32_t counter = MAXRETRYCONN);
+                  std::string& result, const dev::h256& codeHash = dev::h256());
   bool CallDisambiguate(uint32_t version, const Json::Value& _json,
-                        std::string& result, uint32_t counter = MAXRETRYCONN);
+                        std::string& result,
+                        const dev::h256& codeHash = dev::h256());
+
+  /// Queue depth, latencies and per interpreter counters
+  std::string GetStats();
+
+ private:
+  friend class ScillaClientTest;
+
+  /// The interpreter process of a version, serving one call at a time. The
+  /// calls are not spread over several processes: the IPC server and the
+  /// contract storage they read the state through serve one call at a time.
+  struct Interpreter {
+    std::string m_socketPath;
+    std::shared_ptr<jsonrpc::UnixDomainSocketClient> m_connector;
+    std::shared_ptr<jsonrpc::Client> m_client;
+
+    std::mutex m_mutexCall;
+
+    /// code hashes of the contracts already parsed by the process, guarded
+    /// by m_mutexCall
+    std::unordered_set<dev::h256> m_codeHashes;
+    uint64_t m_codeHashesRestarts = 0;
+    std::atomic<uint64_t> m_numCalls{0};
+    std::atomic<uint64_t> m_numWarmCalls{0};
+    std::atomic<uint64_t> m_numRestarts{0};
+  };
+
+  std::map<uint32_t, std::shared_ptr<Interpreter>> m_interpreters;
+
+  /// guards m_interpreters
+  std::mutex m_mutexMain;
+  /// serializes the launches of the interpreter processes
+  std::mutex m_mutexStart;
+
+  /// number of calls waiting for the interpreter
+  std::atomic<uint64_t> m_queueDepth{0};
+  std::map<std::string, LatencyHistogram> m_latencies;
+
+  ScillaClient();
+  ~ScillaClient();
+
+  static std::string GetSocketPath(uint32_t version);
+
+  bool OpenServer(uint32_t version);
+
+  /// Restart the interpreter, unless it was restarted since the caller saw
+  /// it numRestarts times, so that a call cut by a restart does not restart
+  /// it again
+  bool RestartServer(uint32_t version, Interpreter& interpreter,
+                     uint64_t numRestarts);
+
+  /// Lock the interpreter for a call, counting the calls waiting for it
+  std::unique_lock<std::mutex> AcquireInterpreter(Interpreter& interpreter);
+
+  /// Bookkeeping of a call of the contract of codeHash, under m_mutexCall
+  static void OnCall(Interpreter& interpreter, const dev::h256& codeHash);
+
+  bool CallMethod(const std::string& method, uint32_t version,
+                  const Json::Value& _json, std::string& result,
+                  const dev::h256& codeHash);
 };
 
-#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLACLIENT_H_
\ No newline at end of file
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLACLIENT_H_
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "ScillaFilesCache.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+
+/// Writes the file through a temporary one, so that it is either complete or
+/// absent for the interpreters reading it
+bool WriteFile(const string& path, const bytes& content) {
+  const string tmpPath = path + ".tmp";
+  ofstream os(tmpPath, ios::binary);
+  os.write(reinterpret_cast<const char*>(content.data()), content.size());
+  os.close();
+  if (!os) {
+    LOG_GENERAL(WARNING, "Failed to write " << tmpPath);
+    return false;
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpPath, path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to rename " << tmpPath << ": " << ec);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+ScillaFilesCache::ScillaFilesCache() {
+  // The files left by a previous run are not tracked
+  Clear();
+}
+
+ScillaFilesCache& ScillaFilesCache::GetInstance() {
+  static ScillaFilesCache scillaFilesCache;
+  return scillaFilesCache;
+}
+
+bool ScillaFilesCache::Export(const dev::h256& codeHash,
+                              const string& extension, const bytes& code,
+                              const bytes& initData, string& codePath,
+                              string& initPath) {
+  const string prefix = SCILLA_FILES_CACHE + '/' + codeHash.hex();
+  codePath = prefix + extension;
+  initPath = prefix + ".json";
+
+  lock_guard<mutex> g(m_mutex);
+  auto it = m_entries.find(codeHash);
+  if (it != m_entries.end() && it->second.m_codePath == codePath &&
+      boost::filesystem::exists(codePath) &&
+      boost::filesystem::exists(initPath)) {
+    m_numHits++;
+    it->second.m_generation = m_generation;
+    m_lru.splice(m_lru.begin(), m_lru, it->second.m_lruPos);
+    return true;
+  }
+
+  m_numMisses++;
+  if (it != m_entries.end()) {
+    Remove(it->second);
+    m_lru.erase(it->second.m_lruPos);
+    m_entries.erase(it);
+  }
+
+  if (!WriteFile(codePath, code) || !WriteFile(initPath, initData)) {
+    return false;
+  }
+
+  m_lru.push_front(codeHash);
+  m_entries.emplace(codeHash,
+                    Entry{codePath, initPath, m_generation, m_lru.begin()});
+  return true;
+}
+
+void ScillaFilesCache::Prune(size_t capacity) {
+  lock_guard<mutex> g(m_mutex);
+  // The entries used since the previous call are all at the front of m_lru
+  size_t numEvicted = 0;
+  while (m_entries.size() > capacity && !m_lru.empty()) {
+    auto it = m_entries.find(m_lru.back());
+    if (it->second.m_generation == m_generation) {
+      break;
+    }
+    Remove(it->second);
+    m_entries.erase(it);
+    m_lru.pop_back();
+    numEvicted++;
+  }
+  m_generation++;
+  m_numEvicted += numEvicted;
+
+  if (numEvicted > 0) {
+    LOG_GENERAL(INFO, "Evicted " << numEvicted << " contracts, "
+                                 << m_entries.size() << " left");
+  }
+}
+
+void ScillaFilesCache::Clear() {
+  lock_guard<mutex> g(m_mutex);
+  m_entries.clear();
+  m_lru.clear();
+  boost::filesystem::remove_all(SCILLA_FILES_CACHE);
+  boost::filesystem::create_directories(SCILLA_FILES_CACHE);
+}
+
+void ScillaFilesCache::GetStats(uint64_t& numHits, uint64_t& numMisses,
+                                uint64_t& numEvicted, size_t& numEntries) {
+  lock_guard<mutex> g(m_mutex);
+  numHits = m_numHits;
+  numMisses = m_numMisses;
+  numEvicted = m_numEvicted;
+  numEntries = m_entries.size();
+}
+
+void ScillaFilesCache::Remove(const Entry& entry) {
+  boost::system::error_code ec;
+  boost::filesystem::remove(entry.m_codePath, ec);
+  boost::filesystem::remove(entry.m_initPath, ec);
+}
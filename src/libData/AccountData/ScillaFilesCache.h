@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLAFILESCACHE_H_
+#define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLAFILESCACHE_H_
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+/// Code and init files of the contracts exported to SCILLA_FILES_CACHE, named
+/// by the code hash of the contract. The code hash covers both the code and
+/// the init data, so a file is never rewritten and a contract whose init data
+/// differs gets files of its own. The least recently used files are deleted
+/// by Prune once there are more than SCILLA_FILES_CACHE_SIZE contracts.
+class ScillaFilesCache {
+ public:
+  static ScillaFilesCache& GetInstance();
+
+  /// Sets codePath and initPath to the files of the contract with codeHash,
+  /// writing them on a miss. Returns false if they could not be written
+  bool Export(const dev::h256& codeHash, const std::string& extension,
+              const bytes& code, const bytes& initData, std::string& codePath,
+              std::string& initPath);
+
+  /// Deletes the least recently used files past capacity contracts. The files
+  /// used since the previous call are kept, as a call of another account
+  /// store may still be reading them
+  void Prune(size_t capacity);
+
+  /// Deletes all the files
+  void Clear();
+
+  void GetStats(uint64_t& numHits, uint64_t& numMisses, uint64_t& numEvicted,
+                size_t& numEntries);
+
+ private:
+  ScillaFilesCache();
+  ScillaFilesCache(const ScillaFilesCache&) = delete;
+  ScillaFilesCache& operator=(const ScillaFilesCache&) = delete;
+
+  struct Entry {
+    std::string m_codePath;
+    std::string m_initPath;
+    /// Value of m_generation when the files were last used
+    uint64_t m_generation;
+    std::list<dev::h256>::iterator m_lruPos;
+  };
+
+  /// Deletes the files of the entry, called with m_mutex locked
+  static void Remove(const Entry& entry);
+
+  std::mutex m_mutex;
+  std::unordered_map<dev::h256, Entry> m_entries;
+  /// Code hashes of m_entries, most recently used first
+  std::list<dev::h256> m_lru;
+  /// Number of calls to Prune
+  uint64_t m_generation{0};
+  uint64_t m_numHits{0};
+  uint64_t m_numMisses{0};
+  uint64_t m_numEvicted{0};
+};
+
+#endif  // ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_SCILLAFILESCACHE_H_
@@ -17,11 +17,14 @@
 
 #include "Transaction.h"
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include "Account.h"
 #include "libCrypto/EthCrypto.h"
 #include "libCrypto/Sha2.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/Logger.h"
+#include "libUtils/ThreadPool.h"
 
 using namespace std;
 using namespace boost::multiprecision;
@@ -183,13 +186,6 @@ bool Transaction::IsSignedSchnorr() const {
   bytes txnData;
   Messenger::SetTransactionCoreInfo(txnData, 0, GetCoreInfo());
 
-  // Generate the transaction ID
-  SHA2<HashType::HASH_VARIANT_256> sha2;
-  sha2.Update(txnData);
-
-  std::string res;
-  boost::algorithm::hex(txnData.begin(), txnData.end(), back_inserter(res));
-
   return Schnorr::Verify(txnData, GetSignature(), GetCoreInfo().senderPubKey);
 }
 
@@ -217,6 +213,73 @@ bool Transaction::IsSigned() const {
   return IsSignedSchnorr();
 }
 
+namespace {
+/// Smallest number of signatures worth handing over to another thread
+const size_t MIN_SIGNATURES_PER_JOB = 64;
+}  // namespace
+
+bool Transaction::VerifySignatures(
+    size_t numTxns, const function<const Transaction&(size_t)>& getTxn,
+    vector<size_t>& invalidIndexes) {
+  invalidIndexes.clear();
+
+  // Not a vector<bool>, as its elements are written by several threads
+  vector<char> valid(numTxns, 0);
+  auto verifyRange = [&getTxn, &valid](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      valid[i] = getTxn(i).IsSigned();
+    }
+  };
+
+  const size_t numJobs =
+      min<size_t>(TXN_SIGNATURE_VERIFICATION_THREADS + 1,
+                  (numTxns + MIN_SIGNATURES_PER_JOB - 1) /
+                      MIN_SIGNATURES_PER_JOB);
+  if (numJobs <= 1) {
+    verifyRange(0, numTxns);
+  } else {
+    static ThreadPool verifyPool(TXN_SIGNATURE_VERIFICATION_THREADS,
+                                 "TxnSignatureVerification");
+
+    mutex mutexJobs;
+    condition_variable cv_jobsFinished;
+    size_t pendingJobs = numJobs - 1;
+
+    // The calling thread takes the first range
+    const size_t jobSize = (numTxns + numJobs - 1) / numJobs;
+    for (size_t job = 1; job < numJobs; job++) {
+      const size_t begin = min(numTxns, job * jobSize);
+      const size_t end = min(numTxns, begin + jobSize);
+      verifyPool.AddJob([&verifyRange, &mutexJobs, &cv_jobsFinished,
+                         &pendingJobs, begin, end]() -> void {
+        verifyRange(begin, end);
+        lock_guard<mutex> g(mutexJobs);
+        pendingJobs--;
+        cv_jobsFinished.notify_all();
+      });
+    }
+    verifyRange(0, min(numTxns, jobSize));
+
+    unique_lock<mutex> lock(mutexJobs);
+    cv_jobsFinished.wait(lock, [&pendingJobs] { return pendingJobs == 0; });
+  }
+
+  for (size_t i = 0; i < numTxns; i++) {
+    if (!valid[i]) {
+      invalidIndexes.emplace_back(i);
+    }
+  }
+  return invalidIndexes.empty();
+}
+
+bool Transaction::VerifySignatures(const vector<Transaction>& txns,
+                                   vector<size_t>& invalidIndexes) {
+  return VerifySignatures(
+      txns.size(),
+      [&txns](size_t index) -> const Transaction& { return txns[index]; },
+      invalidIndexes);
+}
+
 void Transaction::SetSignature(const Signature& signature) {
   m_signature = signature;
 }
@@ -19,6 +19,8 @@
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TRANSACTION_H_
 
 #include <array>
+#include <functional>
+#include <vector>
 
 #include <Schnorr.h>
 #include "Address.h"
@@ -152,6 +154,16 @@ class Transaction : public SerializableDataBlock {
   /// Return whether the transaction has been correctly signed
   bool IsSigned() const;
 
+  /// Verify the signatures of numTxns transactions at once, spread over
+  /// TXN_SIGNATURE_VERIFICATION_THREADS threads. Returns whether all of them
+  /// are correctly signed, the indexes of the others are put in
+  /// invalidIndexes.
+  static bool VerifySignatures(
+      size_t numTxns, const std::function<const Transaction&(size_t)>& getTxn,
+      std::vector<size_t>& invalidIndexes);
+  static bool VerifySignatures(const std::vector<Transaction>& txns,
+                               std::vector<size_t>& invalidIndexes);
+
   unsigned int GetShardIndex(unsigned int numShards) const;
 
   /// Set the signature
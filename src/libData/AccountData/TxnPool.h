@@ -18,8 +18,10 @@
 #ifndef ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNPOOL_H_
 #define ZILLIQA_SRC_LIBDATA_ACCOUNTDATA_TXNPOOL_H_
 
+#include <atomic>
 #include <functional>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 #include "Account.h"
@@ -28,7 +30,12 @@
 
 using MempoolInsertionStatus = std::pair<TxnStatus, TxnHash>;
 
+/// Pending transactions indexed by hash, gas price and sender nonce. Each
+/// transaction is stored once and shared by the indexes. Copying a TxnPool is
+/// cheap as the copies share the indexes until one of them is modified.
 struct TxnPool {
+  using TxnPtr = std::shared_ptr<const Transaction>;
+
   struct PubKeyNonceHash {
     std::size_t operator()(const std::pair<PubKey, uint128_t>& p) const {
       std::size_t seed = 0;
@@ -39,29 +46,62 @@ struct TxnPool {
     }
   };
 
-  std::unordered_map<TxnHash, Transaction> HashIndex;
-  std::map<uint128_t, std::map<TxnHash, Transaction>, std::greater<uint128_t>>
-      GasIndex;
-  std::unordered_map<std::pair<PubKey, uint64_t>, Transaction, PubKeyNonceHash>
-      NonceIndex;
+  using HashIndexMap = std::unordered_map<TxnHash, TxnPtr>;
+  using GasIndexMap = std::map<uint128_t, std::map<TxnHash, TxnPtr>,
+                               std::greater<uint128_t>>;
+  using NonceIndexMap =
+      std::unordered_map<std::pair<PubKey, uint64_t>, TxnPtr, PubKeyNonceHash>;
+
+ private:
+  struct Indexes {
+    HashIndexMap HashIndex;
+    GasIndexMap GasIndex;
+    NonceIndexMap NonceIndex;
+  };
+
+  std::shared_ptr<Indexes> m_indexes{std::make_shared<Indexes>()};
 
-  void clear() {
-    HashIndex.clear();
-    GasIndex.clear();
-    NonceIndex.clear();
+  /// Indexes owned by this pool only, cloned if shared with a copy
+  Indexes& indexes() {
+    if (m_indexes.use_count() > 1) {
+      m_indexes = std::make_shared<Indexes>(*m_indexes);
+    } else {
+      // The copies sharing the indexes may have been released by other
+      // threads, make sure their reads are done before modifying
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *m_indexes;
   }
 
-  unsigned int size() { return HashIndex.size(); }
+  void erase(Indexes& idx, const Transaction& t) {
+    auto searchGas = idx.GasIndex.find(t.GetGasPrice());
+    if (searchGas != idx.GasIndex.end()) {
+      searchGas->second.erase(t.GetTranID());
+      if (searchGas->second.empty()) {
+        idx.GasIndex.erase(searchGas);
+      }
+    }
+    idx.NonceIndex.erase({t.GetSenderPubKey(), t.GetNonce()});
+    idx.HashIndex.erase(t.GetTranID());
+  }
+
+ public:
+  const HashIndexMap& GetHashIndex() const { return m_indexes->HashIndex; }
+
+  void clear() { m_indexes = std::make_shared<Indexes>(); }
 
-  bool exist(const TxnHash& th) {
-    return HashIndex.find(th) != HashIndex.end();
+  unsigned int size() const { return m_indexes->HashIndex.size(); }
+
+  bool exist(const TxnHash& th) const {
+    return m_indexes->HashIndex.find(th) != m_indexes->HashIndex.end();
   }
 
-  bool get(const TxnHash& th, Transaction& t) {
-    if (!exist(th)) {
+  bool get(const TxnHash& th, Transaction& t) const {
+    auto searchHash = m_indexes->HashIndex.find(th);
+    if (searchHash == m_indexes->HashIndex.end()) {
       return false;
     }
-    t = HashIndex.at(th);
+    t = *searchHash->second;
 
     return true;
   }
@@ -72,35 +112,24 @@ struct TxnPool {
       return false;
     }
 
-    auto searchNonce = NonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
-    if (searchNonce != NonceIndex.end()) {
-      if ((t.GetGasPrice() > searchNonce->second.GetGasPrice()) ||
-          (t.GetGasPrice() == searchNonce->second.GetGasPrice() &&
-           t.GetTranID() < searchNonce->second.GetTranID())) {
-        // erase from HashIdxTxns
-        TxnHash hashToBeRemoved = searchNonce->second.GetTranID();
-        auto searchHash = HashIndex.find(searchNonce->second.GetTranID());
-        if (searchHash != HashIndex.end()) {
-          HashIndex.erase(searchHash);
-        }
-        // erase from GasIdxTxns
-        auto smallerGasPrice = searchNonce->second.GetGasPrice();
-        auto searchGas = GasIndex.find(searchNonce->second.GetGasPrice());
-        if (searchGas != GasIndex.end()) {
-          auto searchGasHash =
-              searchGas->second.find(searchNonce->second.GetTranID());
-          if (searchGasHash != searchGas->second.end()) {
-            searchGas->second.erase(searchGasHash);
-          }
-          if (GasIndex[smallerGasPrice].empty()) {
-            GasIndex.erase(smallerGasPrice);
-          }
-        }
-        HashIndex[t.GetTranID()] = t;
-        GasIndex[t.GetGasPrice()][t.GetTranID()] = t;
-        searchNonce->second = t;
-
-        status = {TxnStatus::MEMPOOL_SAME_NONCE_LOWER_GAS, hashToBeRemoved};
+    const auto& nonceIndex = m_indexes->NonceIndex;
+    auto searchNonce = nonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
+    if (searchNonce != nonceIndex.end()) {
+      if ((t.GetGasPrice() > searchNonce->second->GetGasPrice()) ||
+          (t.GetGasPrice() == searchNonce->second->GetGasPrice() &&
+           t.GetTranID() < searchNonce->second->GetTranID())) {
+        // erase from all the indexes
+        TxnPtr toBeRemoved = searchNonce->second;
+        Indexes& idx = indexes();
+        erase(idx, *toBeRemoved);
+
+        TxnPtr txn = std::make_shared<const Transaction>(t);
+        idx.HashIndex[t.GetTranID()] = txn;
+        idx.GasIndex[t.GetGasPrice()][t.GetTranID()] = txn;
+        idx.NonceIndex[{t.GetSenderPubKey(), t.GetNonce()}] = txn;
+
+        status = {TxnStatus::MEMPOOL_SAME_NONCE_LOWER_GAS,
+                  toBeRemoved->GetTranID()};
         return true;
       } else {
         // GasPrice is higher but of same nonce
@@ -109,53 +138,41 @@ struct TxnPool {
         return false;
       }
     } else {
-      HashIndex[t.GetTranID()] = t;
-      GasIndex[t.GetGasPrice()][t.GetTranID()] = t;
-      NonceIndex[{t.GetSenderPubKey(), t.GetNonce()}] = t;
+      Indexes& idx = indexes();
+      TxnPtr txn = std::make_shared<const Transaction>(t);
+      idx.HashIndex[t.GetTranID()] = txn;
+      idx.GasIndex[t.GetGasPrice()][t.GetTranID()] = txn;
+      idx.NonceIndex[{t.GetSenderPubKey(), t.GetNonce()}] = txn;
     }
     status = {TxnStatus::NOT_PRESENT, t.GetTranID()};
     return true;
   }
 
   void findSameNonceButHigherGas(Transaction& t) {
-    auto searchNonce = NonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
-    if (searchNonce != NonceIndex.end()) {
-      if (searchNonce->second.GetGasPrice() > t.GetGasPrice()) {
-        t = std::move(searchNonce->second);
-
-        // erase tx nonce map
-        NonceIndex.erase(searchNonce);
-        // erase tx gas map
-        GasIndex[t.GetGasPrice()].erase(t.GetTranID());
-        if (GasIndex[t.GetGasPrice()].empty()) {
-          GasIndex.erase(t.GetGasPrice());
-        }
-        // erase tx hash map
-        HashIndex.erase(t.GetTranID());
+    const auto& nonceIndex = m_indexes->NonceIndex;
+    auto searchNonce = nonceIndex.find({t.GetSenderPubKey(), t.GetNonce()});
+    if (searchNonce != nonceIndex.end()) {
+      if (searchNonce->second->GetGasPrice() > t.GetGasPrice()) {
+        TxnPtr found = searchNonce->second;
+        erase(indexes(), *found);
+        t = *found;
       }
     }
   }
 
   bool findOne(Transaction& t) {
-    if (GasIndex.empty()) {
+    const auto& gasIndex = m_indexes->GasIndex;
+    if (gasIndex.empty()) {
       return false;
     }
 
-    auto firstGas = GasIndex.begin();
+    auto firstGas = gasIndex.begin();
     auto firstHash = firstGas->second.begin();
 
     if (firstHash != firstGas->second.end()) {
-      t = std::move(firstHash->second);
-
-      // erase tx gas map
-      firstGas->second.erase(firstHash);
-      if (firstGas->second.empty()) {
-        GasIndex.erase(firstGas);
-      }
-      // erase tx nonce map
-      NonceIndex.erase({t.GetSenderPubKey(), t.GetNonce()});
-      // erase tx hash m ap
-      HashIndex.erase(t.GetTranID());
+      TxnPtr found = firstHash->second;
+      erase(indexes(), *found);
+      t = *found;
       return true;
     }
     return false;
@@ -164,10 +181,10 @@ struct TxnPool {
 
 inline std::ostream& operator<<(std::ostream& os, const TxnPool& t) {
   os << "Txn in txnPool: " << std::endl;
-  for (const auto& entry : t.HashIndex) {
+  for (const auto& entry : t.GetHashIndex()) {
     os << "TranID: " << entry.first.hex()
-       << " Sender:" << entry.second.GetSenderAddr()
-       << " Nonce: " << entry.second.GetNonce() << std::endl;
+       << " Sender:" << entry.second->GetSenderAddr()
+       << " Nonce: " << entry.second->GetNonce() << std::endl;
   }
   return os;
 }
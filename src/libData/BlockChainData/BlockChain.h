@@ -18,18 +18,76 @@
 #ifndef ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKCHAIN_H_
 #define ZILLIQA_SRC_LIBDATA_BLOCKCHAINDATA_BLOCKCHAIN_H_
 
+#include <list>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "libData/BlockData/Block/DSBlock.h"
 #include "libData/DataStructures/CircularArray.h"
 #include "libPersistence/BlockStorage.h"
 
 /// Transient storage for DS/Tx/ Blocks. The block should have function
-/// .GetHeader().GetBlockNum()
+/// .GetHeader().GetBlockNum(). Blocks are kept as shared immutable objects,
+/// so that readers get a handle on a block instead of a copy of it. The older
+/// blocks read back from the persistent storage are kept in an LRU cache.
 template <class T>
 class BlockChain {
-  std::mutex m_mutexBlocks;
-  CircularArray<T> m_blocks;
+ public:
+  using BlockPtr = std::shared_ptr<const T>;
+
+ private:
+  std::shared_timed_mutex m_mutexBlocks;
+  CircularArray<BlockPtr> m_blocks;
+
+  std::mutex m_mutexCache;
+  /// Most recently used first
+  std::list<BlockPtr> m_cache;
+  std::unordered_map<uint64_t, typename std::list<BlockPtr>::iterator>
+      m_cacheIndex;
+
+  static uint64_t GetBlockNum(const BlockPtr& block) {
+    return block ? block->GetHeader().GetBlockNum() : INIT_BLOCK_NUMBER;
+  }
+
+  static const BlockPtr& GetDummyBlock() {
+    static const BlockPtr dummyBlock = std::make_shared<const T>();
+    return dummyBlock;
+  }
+
+  BlockPtr GetCachedBlock(const uint64_t& blockNum) {
+    std::lock_guard<std::mutex> g(m_mutexCache);
+    auto it = m_cacheIndex.find(blockNum);
+    if (it == m_cacheIndex.end()) {
+      return nullptr;
+    }
+    m_cache.splice(m_cache.begin(), m_cache, it->second);
+    return *it->second;
+  }
+
+  void CacheBlock(const BlockPtr& block) {
+    const uint64_t blockNum = GetBlockNum(block);
+    std::lock_guard<std::mutex> g(m_mutexCache);
+    if (m_cacheIndex.find(blockNum) != m_cacheIndex.end()) {
+      return;
+    }
+    m_cache.emplace_front(block);
+    m_cacheIndex[blockNum] = m_cache.begin();
+    if (m_cache.size() > BLOCKCHAIN_CACHE_SIZE) {
+      m_cacheIndex.erase(GetBlockNum(m_cache.back()));
+      m_cache.pop_back();
+    }
+  }
+
+  void UncacheBlock(const uint64_t& blockNum) {
+    std::lock_guard<std::mutex> g(m_mutexCache);
+    auto it = m_cacheIndex.find(blockNum);
+    if (it != m_cacheIndex.end()) {
+      m_cache.erase(it->second);
+      m_cacheIndex.erase(it);
+    }
+  }
 
  protected:
   /// Constructor.
@@ -37,60 +95,85 @@ class BlockChain {
 
   ~BlockChain() {}
 
-  virtual T GetBlockFromPersistentStorage(const uint64_t& blockNum) = 0;
+  /// Returns nullptr if the block is not in the persistent storage
+  virtual BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) = 0;
 
  public:
   /// Reset
-  void Reset() { m_blocks.resize(BLOCKCHAIN_SIZE); }
+  void Reset() {
+    {
+      std::unique_lock<std::shared_timed_mutex> g(m_mutexBlocks);
+      m_blocks.resize(BLOCKCHAIN_SIZE);
+    }
+    std::lock_guard<std::mutex> g(m_mutexCache);
+    m_cache.clear();
+    m_cacheIndex.clear();
+  }
 
   /// Returns the number of blocks.
   uint64_t GetBlockCount() {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+    std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
     return m_blocks.size();
   }
 
-  /// Returns the last stored block.
-  const T& GetLastBlock() {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+  /// Returns the last stored block, or a dummy block if there is none. The
+  /// block is shared, so that it outlives its replacement in the chain.
+  BlockPtr GetLastBlock() {
+    std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
     try {
-      return m_blocks.back();
+      const BlockPtr& block = m_blocks.back();
+      if (block) {
+        return block;
+      }
     } catch (...) {
-      static T defaultBlock;
-      return defaultBlock;
     }
+    return GetDummyBlock();
   }
 
-  /// Returns the block at the specified block number.
-  T GetBlock(const uint64_t& blockNum) {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
-
-    if (m_blocks.size() > 0 &&
-        (m_blocks.back().GetHeader().GetBlockNum() < blockNum)) {
-      LOG_GENERAL(WARNING,
-                  "BlockNum too high " << blockNum << " Dummy block used");
-      return T();
-    } else if (blockNum + m_blocks.capacity() < m_blocks.size() ||
-               m_blocks[blockNum].GetHeader().GetBlockNum() != blockNum) {
-      return GetBlockFromPersistentStorage(blockNum);
-    } else {
-      return m_blocks[blockNum];
+  /// Returns the block at the specified block number, or a dummy block if
+  /// there is none. The block is shared, not copied.
+  BlockPtr GetBlockPtr(const uint64_t& blockNum) {
+    {
+      std::shared_lock<std::shared_timed_mutex> g(m_mutexBlocks);
+
+      if (m_blocks.size() > 0 && GetBlockNum(m_blocks.back()) < blockNum) {
+        LOG_GENERAL(WARNING,
+                    "BlockNum too high " << blockNum << " Dummy block used");
+        return GetDummyBlock();
+      } else if (blockNum + m_blocks.capacity() >= m_blocks.size() &&
+                 GetBlockNum(m_blocks[blockNum]) == blockNum) {
+        return m_blocks[blockNum];
+      }
+    }
+
+    BlockPtr block = GetCachedBlock(blockNum);
+    if (block) {
+      return block;
+    }
+    block = GetBlockFromPersistentStorage(blockNum);
+    if (!block) {
+      return GetDummyBlock();
     }
+    CacheBlock(block);
+    return block;
   }
 
+  /// Returns a copy of the block at the specified block number.
+  T GetBlock(const uint64_t& blockNum) { return *GetBlockPtr(blockNum); }
+
   /// Adds a block to the chain.
   int AddBlock(const T& block) {
     uint64_t blockNumOfNewBlock = block.GetHeader().GetBlockNum();
 
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+    std::unique_lock<std::shared_timed_mutex> g(m_mutexBlocks);
 
     uint64_t blockNumOfExistingBlock =
-        m_blocks[blockNumOfNewBlock].GetHeader().GetBlockNum();
+        GetBlockNum(m_blocks[blockNumOfNewBlock]);
 
     if (blockNumOfExistingBlock < blockNumOfNewBlock ||
         INIT_BLOCK_NUMBER == blockNumOfExistingBlock) {
       if (m_blocks.size() > 0) {
-        uint64_t blockNumOfLastBlock =
-            m_blocks.back().GetHeader().GetBlockNum();
+        uint64_t blockNumOfLastBlock = GetBlockNum(m_blocks.back());
         uint64_t blockNumMissed = blockNumOfNewBlock - blockNumOfLastBlock - 1;
         if (blockNumMissed > 0) {
           LOG_GENERAL(INFO,
@@ -102,46 +185,50 @@ class BlockChain {
       } else {
         m_blocks.increase_size(blockNumOfNewBlock);
       }
-      m_blocks.insert_new(blockNumOfNewBlock, block);
+      m_blocks.insert_new(blockNumOfNewBlock,
+                          std::make_shared<const T>(block));
     } else {
       LOG_GENERAL(WARNING, "Failed to add " << blockNumOfNewBlock << " "
                                             << blockNumOfExistingBlock);
       return -1;
     }
+    g.unlock();
 
+    // A block read back before this one replaced it must not be served again
+    UncacheBlock(blockNumOfNewBlock);
     return 1;
   }
 };
 
 class DSBlockChain : public BlockChain<DSBlock> {
  public:
-  DSBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
+  BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
     DSBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetDSBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return DSBlock();
+      return nullptr;
     }
-    return *block;
+    return block;
   }
 };
 
 class TxBlockChain : public BlockChain<TxBlock> {
  public:
-  TxBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
+  BlockPtr GetBlockFromPersistentStorage(const uint64_t& blockNum) override {
     TxBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return TxBlock();
+      return nullptr;
     }
-    return *block;
+    return block;
   }
 };
 
 class VCBlockChain : public BlockChain<VCBlock> {
  public:
-  VCBlock GetBlockFromPersistentStorage([
+  BlockPtr GetBlockFromPersistentStorage([
       [gnu::unused]] const uint64_t& blockNum) override {
     throw "vc block persistent storage not supported";
   }
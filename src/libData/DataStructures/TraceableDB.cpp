@@ -23,10 +23,17 @@ using namespace std;
 bool TraceableDB::commit(const uint64_t& dsBlockNum) {
   std::vector<dev::h256> toPurge;
   unordered_set<dev::h256> inserted;
-  if (!OverlayDB::commit(KEEP_HISTORICAL_STATE && LOOKUP_NODE_MODE, toPurge,
-                         inserted)) {
-    LOG_GENERAL(WARNING, "OverlayDB::commit failed");
-    return false;
+  {
+    // Without history, the nodes replaced are deleted by the commit
+    unique_lock<shared_timed_mutex> lock(m_mutexPurge, defer_lock);
+    if (!(KEEP_HISTORICAL_STATE && LOOKUP_NODE_MODE)) {
+      lock.lock();
+    }
+    if (!OverlayDB::commit(KEEP_HISTORICAL_STATE && LOOKUP_NODE_MODE, toPurge,
+                           inserted)) {
+      LOG_GENERAL(WARNING, "OverlayDB::commit failed");
+      return false;
+    }
   }
 
   if (!(KEEP_HISTORICAL_STATE && LOOKUP_NODE_MODE) || !dsBlockNum) {
@@ -121,7 +128,11 @@ bool TraceableDB::ExecutePurge(const uint64_t& dsBlockNum,
       }
     }
     if ((t_dsBlockNum + NUM_DS_EPOCHS_STATE_HISTORY < dsBlockNum) || purgeAll) {
-      m_levelDB.BatchDelete(toPurge);
+      {
+        unique_lock<shared_timed_mutex> lock(m_mutexPurge);
+        m_levelDB.BatchDelete(toPurge);
+        m_nodeCache.remove(toPurge);
+      }
       m_purgeDB.DeleteKey(iter->key().ToString());
       // compact/cleanup for this key immediately.
       leveldb::Slice k(iter->key());
@@ -148,7 +159,14 @@ bool TraceableDB::ExecutePurge(const uint64_t& dsBlockNum,
   return true;
 }
 
+void TraceableDB::ResetDB() {
+  unique_lock<shared_timed_mutex> lock(m_mutexPurge);
+  OverlayDB::ResetDB();
+}
+
 bool TraceableDB::RefreshDB() {
+  unique_lock<shared_timed_mutex> lock(m_mutexPurge);
+  m_nodeCache.clear();
   return m_levelDB.RefreshDB() && m_purgeDB.RefreshDB();
 }
 
@@ -18,17 +18,24 @@
 #ifndef ZILLIQA_SRC_LIBDATA_DATASTRUCTURES_TRACEABLEDB_H_
 #define ZILLIQA_SRC_LIBDATA_DATASTRUCTURES_TRACEABLEDB_H_
 
+#include <shared_mutex>
+
 #include "depends/libDatabase/OverlayDB.h"
 
 class TraceableDB : public dev::OverlayDB {
  public:
-  explicit TraceableDB(const std::string& dbName)
-      : dev::OverlayDB(dbName), m_purgeDB(dbName + "_purge") {}
+  explicit TraceableDB(const std::string& dbName, size_t nodeCacheSize = 0)
+      : dev::OverlayDB(dbName, nodeCacheSize), m_purgeDB(dbName + "_purge") {}
   ~TraceableDB() = default;
   bool commit(const uint64_t& dsBlockNum);
 
+  /// Held shared while reading the nodes of a committed root without the
+  /// trie, and exclusively while committed nodes are deleted
+  std::shared_timed_mutex& GetPurgeMutex() { return m_mutexPurge; }
+
  private:
   LevelDB m_purgeDB;
+  std::shared_timed_mutex m_mutexPurge;
   std::atomic<bool> m_stopSignal{false};
   std::atomic<bool> m_purgeRunning{false};
 
@@ -45,6 +52,8 @@ class TraceableDB : public dev::OverlayDB {
 
   bool IsPurgeRunning() { return m_purgeRunning; }
 
+  void ResetDB();
+
   bool RefreshDB();
 };
 
@@ -145,12 +145,14 @@ void DirectoryService::InitCoinbase() {
   lock_guard<mutex> g(m_mutexCoinbaseRewardees);
 
   // cleanup - entries from older ds epoch
-  if (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() == 0) {
+  if (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() ==
+      0) {
     LOG_GENERAL(WARNING, "Still only have genesis block");
     return;
   }
   uint64_t firstTxEpoch =
-      (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() - 1) *
+      (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() -
+       1) *
       NUM_FINAL_BLOCK_PER_POW;
 
   auto it = m_coinbaseRewardees.begin();
@@ -388,7 +390,7 @@ void DirectoryService::InitCoinbase() {
   // LuckyDraw
 
   uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes());
   DiagnosticDataCoinbase entry = {
       node_count,  sig_count,        lookup_count, total_reward,
       base_reward, base_reward_each, lookupReward, reward_each_lookup,
@@ -432,12 +434,12 @@ void DirectoryService::StoreCoinbaseInDiagnosticDB(
   if ((MAX_ENTRIES_FOR_DIAGNOSTIC_DATA > 0) &&  // If limit is 0, skip deletion
       (BlockStorage::GetBlockStorage().GetDiagnosticDataCoinbaseCount() >=
        MAX_ENTRIES_FOR_DIAGNOSTIC_DATA) &&  // Limit reached
-      (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+      (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
        MAX_ENTRIES_FOR_DIAGNOSTIC_DATA)) {  // DS Block number is not below
                                             // limit
 
     const uint64_t oldBlockNum =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() -
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() -
         MAX_ENTRIES_FOR_DIAGNOSTIC_DATA;
 
     canPutNewEntry =
@@ -455,7 +457,7 @@ void DirectoryService::StoreCoinbaseInDiagnosticDB(
 
   if (canPutNewEntry) {
     BlockStorage::GetBlockStorage().PutDiagnosticDataCoinbase(
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
         entry);
   }
 }
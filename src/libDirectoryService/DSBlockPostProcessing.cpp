@@ -246,7 +246,7 @@ void DirectoryService::UpdateMyDSModeAndConsensusId() {
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
         DataConversion::charArrTo16Bits(m_mediator.m_dsBlockChain.GetLastBlock()
-                                            .GetHeader()
+                                            ->GetHeader()
                                             .GetHashForRandom()
                                             .asBytes());
   }
@@ -331,7 +331,7 @@ void DirectoryService::UpdateDSCommitteeComposition() {
 
   UpdateDSCommitteeCompositionCore(m_mediator.m_selfKey.second,
                                    *m_mediator.m_DSCommittee,
-                                   m_mediator.m_dsBlockChain.GetLastBlock());
+                                   *m_mediator.m_dsBlockChain.GetLastBlock());
 }
 
 void DirectoryService::StartNextTxEpoch() {
@@ -427,7 +427,7 @@ void DirectoryService::StartNextTxEpoch() {
       "[MIBLKSWAIT]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] BEGIN");
 
   m_stopRecvNewMBSubmission = false;
@@ -469,7 +469,7 @@ void DirectoryService::StartNextTxEpoch() {
                   << setw(15) << left
                   << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
                   << m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                             ->GetHeader()
                              .GetBlockNum() +
                          1
                   << "] TIMEOUT: Didn't receive all Microblock.");
@@ -578,7 +578,7 @@ void DirectoryService::StartFirstTxEpoch() {
         "[MIBLKSWAIT]["
         << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
         << "]["
-        << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
                1
         << "] BEGIN");
 
@@ -625,7 +625,7 @@ void DirectoryService::StartFirstTxEpoch() {
                     << setw(15) << left
                     << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
                     << m_mediator.m_txBlockChain.GetLastBlock()
-                               .GetHeader()
+                               ->GetHeader()
                                .GetBlockNum() +
                            1
                     << "] TIMEOUT: Didn't receive all Microblock.");
@@ -698,7 +698,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
         "[DSCON]["
         << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
         << "]["
-        << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
                1
         << "] DONE");
   }
@@ -717,7 +717,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
     m_pendingDSBlock->SetCoSignatures(*m_consensusObject);
 
     if (m_pendingDSBlock->GetHeader().GetBlockNum() >
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
             1) {
       LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
                 "We are missing some blocks. What to do here?");
@@ -796,7 +796,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
     DataSender::GetInstance().SendDataToOthers(
         *m_pendingDSBlock, *(m_mediator.m_DSCommittee), m_shards, {},
         m_mediator.m_lookup->GetLookupNodes(),
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(),
         m_consensusMyID, composeDSBlockMessageForSender, false,
         sendDSBlockToLookupNodesAndNewDSMembers, sendDSBlockToShardNodes);
   }
@@ -805,7 +805,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
       "[DSBLK]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] AFTER SENDING DSBLOCK");
 
   ClearVCBlockVector();
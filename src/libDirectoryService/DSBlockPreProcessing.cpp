@@ -80,7 +80,7 @@ unsigned int DirectoryService::ComputeDSBlockParameters(
   difficulty = POW_DIFFICULTY;
   auto lastBlockLink = m_mediator.m_blocklinkchain.GetLatestBlockLink();
   if (m_mediator.m_dsBlockChain.GetBlockCount() > 0) {
-    DSBlock lastBlock = m_mediator.m_dsBlockChain.GetLastBlock();
+    DSBlock lastBlock = *m_mediator.m_dsBlockChain.GetLastBlock();
     blockNum = lastBlock.GetHeader().GetBlockNum() + 1;
     prevHash = get<BlockLinkIndex::BLOCKHASH>(lastBlockLink);
 
@@ -90,21 +90,23 @@ unsigned int DirectoryService::ComputeDSBlockParameters(
 
   // Start to adjust difficulty from second DS block.
   if (blockNum > 1) {
-    dsDifficulty = CalculateNewDSDifficulty(
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty());
+    dsDifficulty = CalculateNewDSDifficulty(m_mediator.m_dsBlockChain
+                                                .GetLastBlock()
+                                                ->GetHeader()
+                                                .GetDSDifficulty());
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
               "Current DS difficulty "
                   << std::to_string(m_mediator.m_dsBlockChain.GetLastBlock()
-                                        .GetHeader()
+                                        ->GetHeader()
                                         .GetDSDifficulty())
                   << ", new DS difficulty " << std::to_string(dsDifficulty));
 
     difficulty = CalculateNewDifficulty(
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty());
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty());
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
               "Current difficulty "
                   << std::to_string(m_mediator.m_dsBlockChain.GetLastBlock()
-                                        .GetHeader()
+                                        ->GetHeader()
                                         .GetDifficulty())
                   << ", new difficulty " << std::to_string(difficulty));
   }
@@ -159,7 +161,7 @@ void DirectoryService::ComputeSharding(const VectorOfPoWSoln& sortedPoWSolns) {
 
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
   }
 
   bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
@@ -346,7 +348,7 @@ bool DirectoryService::VerifyPoWWinner(
       if (dsWinnerPoWsFromLeader.find(DSPowWinner.first) !=
           dsWinnerPoWsFromLeader.end()) {
         uint8_t expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlock()
-                                     .GetHeader()
+                                     ->GetHeader()
                                      .GetDSDifficulty();
         const auto& peer = m_allPoWConns.at(DSPowWinner.first);
         const auto& dsPowSoln = dsWinnerPoWsFromLeader.at(DSPowWinner.first);
@@ -397,7 +399,7 @@ bool DirectoryService::VerifyPoWWinner(
 bool DirectoryService::VerifyDifficulty() {
   auto remoteDSDifficulty = m_pendingDSBlock->GetHeader().GetDSDifficulty();
   auto localDSDifficulty = CalculateNewDSDifficulty(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty());
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty());
   uint32_t dsDifficultyDiff = std::max(remoteDSDifficulty, localDSDifficulty) -
                               std::min(remoteDSDifficulty, localDSDifficulty);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -414,7 +416,7 @@ bool DirectoryService::VerifyDifficulty() {
 
   auto remoteDifficulty = m_pendingDSBlock->GetHeader().GetDifficulty();
   auto localDifficulty = CalculateNewDifficulty(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty());
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty());
   uint32_t difficultyDiff = std::max(remoteDifficulty, localDifficulty) -
                             std::min(remoteDifficulty, localDifficulty);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -487,7 +489,7 @@ bool DirectoryService::VerifyPoWOrdering(
 
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
   }
 
   const float MISORDER_TOLERANCE =
@@ -655,7 +657,7 @@ bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
       (GUARD_MODE && Guard::GetInstance().IsNodeInShardGuardList(pubKey))
           ? (POW_DIFFICULTY / POW_DIFFICULTY)
           : m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetDifficulty();
 
   string resultStr, mixHashStr;
@@ -680,7 +682,7 @@ bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
   m_allPoWConns.emplace(pubKey, peer);
 
   auto dsDifficulty =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty();
 
   if (POW::GetInstance().PoWVerify(m_pendingDSBlock->GetHeader().GetBlockNum(),
                                    dsDifficulty, headerHash, powSoln.m_nonce,
@@ -1086,7 +1088,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSPrimary() {
   // Create new consensus object
   uint32_t consensusID = 0;
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
 #ifdef VC_TEST_DS_SUSPEND_1
   if (m_mode == PRIMARY_DS && m_viewChangeCounter < 1) {
@@ -1124,7 +1126,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSPrimary() {
       "[DSCON]["
       << std::setw(15) << std::left
       << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] BEGIN, POWS = " << m_allPoWs.size());
 
   // Refer to Effective mordern C++. Item 32: Use init capture to move objects
@@ -1319,9 +1321,9 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSBackup() {
 
 #ifdef VC_TEST_VC_PRECHECK_1
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   // FIXME: Prechecking not working due at epoch 1 due to the way we have low
   // blocknum
@@ -1343,7 +1345,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSBackup() {
   // Dummy values for now
   uint32_t consensusID = 0x0;
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
@@ -94,7 +94,7 @@ void DirectoryService::StartSynchronization(bool clean) {
           m_mediator.m_blocklinkchain.GetLatestIndex() + 1);
       m_synchronizer.FetchLatestTxBlockSeed(
           m_mediator.m_lookup,
-          m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+          m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
               1);
       this_thread::sleep_for(chrono::seconds(NEW_NODE_SYNC_INTERVAL));
     }
@@ -290,7 +290,7 @@ bool DirectoryService::ProcessSetPrimary(
                              << m_mediator.m_currentEpochNum);
     SetConsensusLeaderID(
         DataConversion::charArrTo16Bits(m_mediator.m_dsBlockChain.GetLastBlock()
-                                            .GetHeader()
+                                            ->GetHeader()
                                             .GetHashForRandom()
                                             .asBytes()) %
         m_mediator.m_DSCommittee->size());
@@ -298,7 +298,7 @@ bool DirectoryService::ProcessSetPrimary(
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlock()
-                                         .GetHeader()
+                                         ->GetHeader()
                                          .GetBlockNum() +
                                      1);
 
@@ -366,9 +366,9 @@ bool DirectoryService::CheckWhetherDSBlockIsFresh(const uint64_t dsblock_num) {
   }
 
   // uint128_t latest_block_num_in_blockchain =
-  // m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  // m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t latest_block_num_in_blockchain =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (dsblock_num < latest_block_num_in_blockchain + 1) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
@@ -613,7 +613,7 @@ bool DirectoryService::FinishRejoinAsDS(bool fetchShardingStruct) {
 
   const auto& bl = m_mediator.m_blocklinkchain.GetLatestBlockLink();
   PairOfNode dsLeader;
-  if (Node::GetDSLeader(bl, m_mediator.m_dsBlockChain.GetLastBlock(), dsComm,
+  if (Node::GetDSLeader(bl, *m_mediator.m_dsBlockChain.GetLastBlock(), dsComm,
                         dsLeader)) {
     auto iterDSLeader = std::find_if(
         dsComm.begin(), dsComm.end(), [dsLeader](const PairOfNode& pubKeyPeer) {
@@ -712,7 +712,7 @@ void DirectoryService::StartNewDSEpochConsensus(bool isRejoin) {
   cv_POWSubmission.notify_all();
 
   POW::GetInstance().EthashConfigureClient(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1,
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1,
       FULL_DATASET_MINE);
 
   if (m_mode == PRIMARY_DS) {
@@ -859,7 +859,7 @@ bool DirectoryService::UpdateDSGuardIdentity() {
                                         DSInstructionType::NEWDSGUARDIDENTITY};
 
   uint64_t curDSEpochNo =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (!Messenger::SetDSLookupNewDSGuardNetworkInfo(
           updatedsguardidentitymessage, MessageOffset::BODY, curDSEpochNo,
@@ -926,7 +926,7 @@ bool DirectoryService::ProcessNewDSGuardNetworkInfo(
   }
 
   uint64_t currentDSEpochNumber =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
   uint64_t loCurrentDSEpochNumber = currentDSEpochNumber - 1;
   uint64_t hiCurrentDSEpochNumber = currentDSEpochNumber + 1;
 
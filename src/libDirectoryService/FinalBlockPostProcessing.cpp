@@ -99,7 +99,7 @@ bool DirectoryService::StoreFinalBlockToDisk() {
   bytes stateDelta;
   AccountStore::GetInstance().GetSerializedDelta(stateDelta);
   if (!BlockStorage::GetBlockStorage().PutStateDelta(
-          m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
           stateDelta)) {
     LOG_GENERAL(WARNING, "Failed to put statedelta in persistence");
     return false;
@@ -121,7 +121,7 @@ bool DirectoryService::ComposeFinalBlockMessageForSender(
   finalblock_message = {MessageType::NODE, NodeInstructionType::FINALBLOCK};
 
   const uint64_t dsBlockNumber =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   bytes stateDelta;
   AccountStore::GetInstance().GetSerializedDelta(stateDelta);
@@ -157,7 +157,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
         "[FBCON]["
         << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
         << "]["
-        << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
                1
         << "] DONE");
   }
@@ -193,7 +193,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
     auto writeStateToDisk = [this]() -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
               m_mediator.m_dsBlockChain.GetLastBlock()
-                  .GetHeader()
+                  ->GetHeader()
                   .GetBlockNum())) {
         LOG_GENERAL(WARNING, "MoveUpdatesToDisk() failed, what to do?");
         return;
@@ -215,13 +215,13 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
                              << "]["
                              << m_mediator.m_txBlockChain.GetLastBlock()
-                                        .GetHeader()
+                                        ->GetHeader()
                                         .GetBlockNum() +
                                     1
                              << "] FINISH WRITE STATE TO DISK");
       }
       if (ENABLE_ACCOUNTS_POPULATING &&
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() <
               PREGEN_ACCOUNT_TIMES) {
         m_mediator.m_node->PopulateAccounts();
       }
@@ -256,7 +256,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
   // Acquire shard receivers cosigs from MicroBlocks
   unordered_map<uint32_t, BlockBase> t_microBlocks;
   const auto& microBlocks = m_microBlocks
-      [m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum()];
+      [m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum()];
   for (const auto& microBlock : microBlocks) {
     t_microBlocks.emplace(microBlock.GetHeader().GetShardId(), microBlock);
   }
@@ -270,14 +270,14 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
       *m_finalBlock, *m_mediator.m_DSCommittee,
       t_shards.empty() ? m_shards : t_shards, t_microBlocks,
       m_mediator.m_lookup->GetLookupNodes(),
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(), m_consensusMyID,
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(), m_consensusMyID,
       composeFinalBlockMessageForSender, m_forceMulticast.load());
 
   LOG_STATE(
       "[FLBLK]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] AFTER SENDING FLBLK");
 
   const bool& toSendPendingTxn = !(m_mediator.m_node->IsUnconfirmedTxnEmpty());
@@ -337,7 +337,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
                   << setw(15) << left
                   << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
                   << m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                             ->GetHeader()
                              .GetBlockNum() +
                          1
                   << "] BEGIN");
@@ -372,7 +372,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
                     << setw(15) << left
                     << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
                     << m_mediator.m_txBlockChain.GetLastBlock()
-                               .GetHeader()
+                               ->GetHeader()
                                .GetBlockNum() +
                            1
                     << "] TIMEOUT: Didn't receive all Microblock.");
@@ -135,7 +135,7 @@ bool DirectoryService::ComposeFinalBlock() {
 
   uint64_t blockNum = 0;
   if (m_mediator.m_txBlockChain.GetBlockCount() > 0) {
-    TxBlock lastBlock = m_mediator.m_txBlockChain.GetLastBlock();
+    TxBlock lastBlock = *m_mediator.m_txBlockChain.GetLastBlock();
     prevHash = lastBlock.GetBlockHash();
 
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -173,7 +173,7 @@ bool DirectoryService::ComposeFinalBlock() {
           allGasLimit, allGasUsed, allRewards, blockNum,
           {stateRoot, stateDeltaHash, mbInfoHash}, numTxs,
           m_mediator.m_selfKey.second,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
           version, committeeHash, prevHash),
       mbInfos, CoSignatures(m_mediator.m_DSCommittee->size())));
 
@@ -181,7 +181,7 @@ bool DirectoryService::ComposeFinalBlock() {
       "[STATS]["
       << std::setw(15) << std::left
       << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "][" << m_finalBlock->GetHeader().GetNumTxs() << "] FINAL");
 
   if (m_mediator.m_node->m_prePrepRunning) {
@@ -293,7 +293,7 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
 
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
   auto commitErrorFunc = [this](const bytes& errorMsg,
                                 const Peer& from) mutable -> bool {
@@ -320,7 +320,7 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
         "[FBCON]["
         << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
         << "]["
-        << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
                1
         << "] BEGIN");
   }
@@ -447,7 +447,7 @@ bool DirectoryService::CheckPreviousFinalBlockHash() {
 
   const BlockHash& finalblockPrevHash = m_finalBlock->GetHeader().GetPrevHash();
   BlockHash expectedPrevHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash();
 
   if (finalblockPrevHash != expectedPrevHash) {
     LOG_CHECK_FAIL("Prev block hash", finalblockPrevHash, expectedPrevHash);
@@ -1189,9 +1189,9 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSBackup() {
 
 #ifdef VC_TEST_VC_PRECHECK_2
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   // FIXME: Prechecking not working due at epoch 1 due to the way we have low
   // blocknum
   if (m_consensusMyID == 3 && dsCurBlockNum != 0 && txCurBlockNum > 10) {
@@ -1222,7 +1222,7 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSBackup() {
 
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
   auto completeFBValidatorFunc =
       [this](const bytes& input, unsigned int offset, bytes& errorMsg,
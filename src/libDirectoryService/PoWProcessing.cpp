@@ -190,7 +190,7 @@ bool DirectoryService::ProcessPoWSubmission(
   }
 
   uint64_t expectedBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
   if (blockNumber != expectedBlockNum) {
     LOG_CHECK_FAIL("BlockNumber", blockNumber, expectedBlockNum);
     return false;
@@ -341,9 +341,9 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
   // Non-genesis block
   if (blockNumber > 1) {
     expectedDSDiff =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty();
     expectedDiff =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty();
   }
 
   if (!GUARD_MODE) {
@@ -419,7 +419,7 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
       uint8_t expectedDSDiff = DS_POW_DIFFICULTY;
       if (blockNumber > 1) {
         expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlock()
-                             .GetHeader()
+                             ->GetHeader()
                              .GetDSDifficulty();
       }
 
@@ -333,7 +333,7 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
     {
       lock_guard<mutex> g(m_mutexMicroBlocks);
       const auto& microBlocks = m_microBlocks
-          [m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum()];
+          [m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum()];
       for (const auto& microBlock : microBlocks) {
         t_microBlocks.emplace(microBlock.GetHeader().GetShardId(), microBlock);
       }
@@ -348,7 +348,7 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
         *m_pendingVCBlock, tmpDSCommittee,
         t_shards.empty() ? m_shards : t_shards, t_microBlocks,
         m_mediator.m_lookup->GetLookupNodes(),
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(),
         m_consensusMyID, composeVCBlockForSender, m_forceMulticast.load(),
         t_sendDataToLookupFunc);
   }
@@ -258,9 +258,9 @@ void DirectoryService::RunConsensusOnViewChange() {
   SetState(VIEWCHANGE_CONSENSUS_PREP);
 
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   // Note: Special check as 0 and 1 have special usage when fetching ds block
   // and final block No need check for 1 as
@@ -432,7 +432,9 @@ bool DirectoryService::ComputeNewCandidateLeader(
     // To-do: Handle exceptions.
     m_pendingVCBlock.reset(new VCBlock(
         VCBlockHeader(
-            m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+            m_mediator.m_dsBlockChain.GetLastBlock()
+                    ->GetHeader()
+                    .GetBlockNum() +
                 1,
             m_mediator.m_currentEpochNum, m_viewChangestate,
             newLeaderNetworkInfo,
@@ -493,7 +495,7 @@ uint16_t DirectoryService::CalculateNewLeaderIndex() {
     LOG_GENERAL(
         INFO, "Using hash of last final block for computing candidate leader");
     sha2.Update(
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes());
   }
 
   bytes vcCounterBytes;
@@ -630,7 +632,7 @@ bool DirectoryService::RunConsensusOnViewChangeWhenCandidateLeader(
   uint32_t consensusID = m_viewChangeCounter;
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
   m_consensusObject.reset(new ConsensusLeader(
       consensusID, m_mediator.m_currentEpochNum, m_consensusBlockHash,
@@ -691,7 +693,7 @@ bool DirectoryService::RunConsensusOnViewChangeWhenNotCandidateLeader(
                 << m_mediator.m_DSCommittee->at(candidateLeaderIndex).second);
 
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
@@ -732,9 +734,9 @@ bytes DirectoryService::ComposeVCGetDSTxBlockMessage() {
   bytes getDSTxBlockMessage = {MessageType::LOOKUP,
                                LookupInstructionType::VCGETLATESTDSTXBLOCK};
   uint64_t dslowBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
   uint64_t txlowBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
   if (!Messenger::SetLookupGetDSTxBlockFromSeed(
           getDSTxBlockMessage, MessageOffset::BODY, dslowBlockNum, 0,
           txlowBlockNum, 0, m_mediator.m_selfPeer.m_listenPortHost)) {
@@ -1370,7 +1370,7 @@ bool Lookup::ProcessGetDSBlockFromL2l(const bytes& message, unsigned int offset,
   // lagging too much and will initiate Rejoin.
   {
     uint64_t latestDSBlkNum =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
     if (blockNum < latestDSBlkNum) {
       blockNum = latestDSBlkNum;
     }
@@ -1453,7 +1453,7 @@ bool Lookup::ProcessGetVCFinalBlockFromL2l(const bytes& message,
   // initiate Rejoin.
   {
     uint64_t lowestLimitNum =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum();
     if (blockNum < lowestLimitNum) {  // requested from older ds epoch
       blockNum = m_mediator.m_currentEpochNum - 1;
     }
@@ -1841,7 +1841,7 @@ void Lookup::RetrieveDSBlocks(vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
   lock_guard<mutex> g(m_mediator.m_node->m_mutexDSBlock);
 
   uint64_t curBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (INIT_BLOCK_NUMBER == curBlockNum) {
     LOG_GENERAL(WARNING,
@@ -1874,17 +1874,17 @@ void Lookup::RetrieveDSBlocks(vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
   uint64_t blockNum;
   for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
     try {
-      DSBlock dsblk = m_mediator.m_dsBlockChain.GetBlock(blockNum);
+      const auto dsblk = m_mediator.m_dsBlockChain.GetBlockPtr(blockNum);
       // TODO
       // Workaround to identify dummy block as == comparator does not work on
       // empty object for DSBlock and DSBlockheader().
-      if (dsblk.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER) {
+      if (dsblk->GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER) {
         LOG_GENERAL(WARNING,
                     "Block Number " << blockNum << " does not exists.");
         break;
       }
 
-      dsBlocks.emplace_back(dsblk);
+      dsBlocks.emplace_back(*dsblk);
     } catch (const char* e) {
       LOG_GENERAL(INFO, "Block Number " << blockNum
                                         << " absent. Didn't include it in "
@@ -1975,7 +1975,7 @@ void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
   }
 
   uint64_t lowestLimitNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum();
   if (lowBlockNum < lowestLimitNum) {
     LOG_GENERAL(WARNING,
                 "Requested number of txBlocks are beyond the current DS epoch "
@@ -1987,7 +1987,7 @@ void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
 
   if (highBlockNum == 0) {
     highBlockNum =
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   }
 
   if (INIT_BLOCK_NUMBER == highBlockNum) {
@@ -1999,17 +1999,17 @@ void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
   uint64_t blockNum;
   for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
     try {
-      TxBlock txblk = m_mediator.m_txBlockChain.GetBlock(blockNum);
+      const auto txblk = m_mediator.m_txBlockChain.GetBlockPtr(blockNum);
       // TODO
       // Workaround to identify dummy block as == comparator does not work on
       // empty object for TxBlock and TxBlockheader().
-      if (txblk.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
-          txblk.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
+      if (txblk->GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
+          txblk->GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
         LOG_GENERAL(WARNING,
                     "Block Number " << blockNum << " does not exists.");
         break;
       }
-      txBlocks.emplace_back(txblk);
+      txBlocks.emplace_back(*txblk);
     } catch (const char* e) {
       LOG_GENERAL(INFO, "Block Number " << blockNum
                                         << " absent. Didn't include it in "
@@ -2242,8 +2242,8 @@ bool Lookup::ProcessSetShardFromSeed(
 }
 
 bool Lookup::AddMicroBlockToStorage(const MicroBlock& microblock) {
-  TxBlock txblk =
-      m_mediator.m_txBlockChain.GetBlock(microblock.GetHeader().GetEpochNum());
+  const auto txblk = m_mediator.m_txBlockChain.GetBlockPtr(
+      microblock.GetHeader().GetEpochNum());
   LOG_GENERAL(INFO, "[SendMB]"
                         << "Add MicroBlock hash: "
                         << microblock.GetBlockHash());
@@ -2253,18 +2253,18 @@ bool Lookup::AddMicroBlockToStorage(const MicroBlock& microblock) {
   // Workaround to identify dummy block as == comparator does not work on
   // empty object for TxBlock and TxBlockheader().
   // if (txblk == TxBlock()) {
-  if (txblk.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
-      txblk.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
+  if (txblk->GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
+      txblk->GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
     LOG_GENERAL(WARNING, "Failed to fetch Txblock");
     return false;
   }
-  for (i = 0; i < txblk.GetMicroBlockInfos().size(); i++) {
-    if (txblk.GetMicroBlockInfos().at(i).m_microBlockHash ==
+  for (i = 0; i < txblk->GetMicroBlockInfos().size(); i++) {
+    if (txblk->GetMicroBlockInfos().at(i).m_microBlockHash ==
         microblock.GetBlockHash()) {
       break;
     }
   }
-  if (i == txblk.GetMicroBlockInfos().size()) {
+  if (i == txblk->GetMicroBlockInfos().size()) {
     LOG_GENERAL(WARNING, "Failed to find mbHash " << microblock.GetBlockHash());
     return false;
   }
@@ -2565,8 +2565,8 @@ bool Lookup::ProcessGetCosigsRewardsFromSeed(
     return false;
   }
 
-  const uint64_t& currDsEpoch =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+  const uint64_t currDsEpoch =
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum();
   if (blockNum < currDsEpoch) {
     LOG_GENERAL(WARNING,
                 "Requested cosigs/rewards for txBlock that is beyond the "
@@ -2820,7 +2820,7 @@ bool Lookup::ProcessSetDSBlockFromSeed(
   }
 
   uint64_t latestSynBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (latestSynBlockNum > highBlockNum) {
     // TODO: We should get blocks from n nodes.
@@ -2850,7 +2850,7 @@ bool Lookup::ProcessSetDSBlockFromSeed(
         return true;
       }
       uint64_t dsblocknumbefore =
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
       uint64_t index_num = m_mediator.m_blocklinkchain.GetLatestIndex() + 1;
 
       DequeOfNode newDScomm;
@@ -2861,7 +2861,7 @@ bool Lookup::ProcessSetDSBlockFromSeed(
       }
       m_mediator.m_blocklinkchain.SetBuiltDSComm(newDScomm);
       uint64_t dsblocknumafter =
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
       LOG_GENERAL(INFO, "DS epoch before" << dsblocknumbefore + 1
                                           << " DS epoch now "
@@ -2997,7 +2997,7 @@ bool Lookup::ProcessSetTxBlockFromSeed(
   }
 
   uint64_t latestSynBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (latestSynBlockNum > highBlockNum) {
     // TODO: We should get blocks from n nodes.
@@ -3137,24 +3137,8 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
   uint64_t highBlockNum = txBlocks.back().GetHeader().GetBlockNum();
   bool placeholder = false;
   if (m_syncType != SyncType::RECOVERY_ALL_SYNC) {
-    unsigned int retry = 1;
-    while (retry <= RETRY_GETSTATEDELTAS_COUNT) {
-      // Get the state-delta for all txBlocks from random lookup nodes
-      GetStateDeltasFromSeedNodes(lowBlockNum, highBlockNum);
-      std::unique_lock<std::mutex> cv_lk(m_mutexSetStateDeltasFromSeed);
-      if (cv_setStateDeltasFromSeed.wait_for(
-              cv_lk, std::chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS)) ==
-          std::cv_status::timeout) {
-        LOG_GENERAL(
-            WARNING,
-            "[Retry: " << retry
-                       << "] Didn't receive statedeltas! Will try again");
-        retry++;
-      } else {
-        break;
-      }
-    }
-    if (retry > RETRY_GETSTATEDELTAS_COUNT) {
+    // Get the state-delta for all txBlocks from random lookup nodes
+    if (!SyncStateDeltas(lowBlockNum, highBlockNum)) {
       LOG_GENERAL(WARNING, "Failed to receive state-deltas for txBlks: "
                                << lowBlockNum << "-" << highBlockNum);
       cv_setTxBlockFromSeed.notify_all();
@@ -3237,7 +3221,7 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
   }
 
   m_mediator.m_currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   // To trigger m_isVacuousEpoch calculation
   m_mediator.IncreaseEpochNum();
 
@@ -3288,7 +3272,7 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
                         "I was already part of shard in current ds epoch");
             if (!m_currDSExpired &&
                 m_mediator.m_dsBlockChain.GetLastBlock()
-                        .GetHeader()
+                        ->GetHeader()
                         .GetEpochNum() < m_mediator.m_currentEpochNum) {
               GetDSInfo();
               m_isFirstLoop = true;
@@ -3318,7 +3302,7 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
                  for now */
               m_mediator.m_currentEpochNum % NUM_FINAL_BLOCK_PER_POW == 0)) {
     if (!m_currDSExpired &&
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum() <
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum() <
             m_mediator.m_currentEpochNum) {
       if (m_mediator.m_currentEpochNum % NUM_FINAL_BLOCK_PER_POW == 0 ||
           !m_fetchNextTxBlock) {
@@ -3401,7 +3385,7 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
                   }
                   FetchMBnForwardTxMessageFromL2l(
                       m_mediator.m_txBlockChain.GetLastBlock()
-                          .GetHeader()
+                          ->GetHeader()
                           .GetBlockNum());  // last block
                 } else {
                   continue;
@@ -3440,7 +3424,7 @@ bool Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
 void Lookup::FindMissingMBsForLastNTxBlks(const uint32_t& num) {
   LOG_MARKER();
   uint64_t upperLimit =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t lowerLimit = 1;
 
   if (upperLimit > num) {
@@ -3448,8 +3432,8 @@ void Lookup::FindMissingMBsForLastNTxBlks(const uint32_t& num) {
   }
 
   for (auto& i = lowerLimit; i <= upperLimit; i++) {
-    TxBlock b = m_mediator.m_txBlockChain.GetBlock(i);
-    auto mbsinfo = b.GetMicroBlockInfos();
+    const auto b = m_mediator.m_txBlockChain.GetBlockPtr(i);
+    const auto& mbsinfo = b->GetMicroBlockInfos();
     for (const auto& info : mbsinfo) {
       MicroBlockSharedPtr mbptr;
       if (!BlockStorage::GetBlockStorage().CheckMicroBlock(
@@ -3520,8 +3504,8 @@ bool Lookup::ProcessSetStateDeltaFromSeed(
   BlockStorage::GetBlockStorage().PutStateDelta(blockNum, stateDelta);
 
   m_mediator.m_ds->SaveCoinbase(
-      m_mediator.m_txBlockChain.GetLastBlock().GetB1(),
-      m_mediator.m_txBlockChain.GetLastBlock().GetB2(),
+      m_mediator.m_txBlockChain.GetLastBlock()->GetB1(),
+      m_mediator.m_txBlockChain.GetLastBlock()->GetB2(),
       CoinbaseReward::FINALBLOCK_REWARD, m_mediator.m_currentEpochNum);
   cv_setStateDeltaFromSeed.notify_all();
   return true;
@@ -3533,10 +3517,8 @@ bool Lookup::ProcessSetStateDeltasFromSeed(
   LOG_MARKER();
 
   if (AlreadyJoinedNetwork()) {
-    cv_setStateDeltasFromSeed.notify_all();
     return true;
   }
-  unique_lock<std::mutex> lock(m_mutexSetStateDeltasFromSeed);
 
   uint64_t lowBlockNum = 0;
   uint64_t highBlockNum = 0;
@@ -3570,7 +3552,69 @@ bool Lookup::ProcessSetStateDeltasFromSeed(
     return false;
   }
 
-  int txBlkNum = lowBlockNum;
+  // The deltas are applied in order by SyncStateDeltas
+  shared_ptr<StateDeltaSync> sync;
+  {
+    lock_guard<mutex> g(m_mutexStateDeltaSync);
+    sync = m_stateDeltaSync;
+  }
+  if (!sync ||
+      !sync->AddChunk(lowBlockNum, highBlockNum, std::move(stateDeltas))) {
+    LOG_GENERAL(INFO, "StateDeltas for blocks " << lowBlockNum << " to "
+                                                << highBlockNum
+                                                << " not awaited, ignored");
+  }
+  return true;
+}
+
+bool Lookup::SyncStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum) {
+  LOG_MARKER();
+
+  auto sync = make_shared<StateDeltaSync>(
+      lowBlockNum, highBlockNum, STATEDELTAS_CHUNK_SIZE,
+      STATEDELTAS_FETCH_WINDOW,
+      chrono::seconds(GETSTATEDELTAS_TIMEOUT_IN_SECONDS),
+      RETRY_GETSTATEDELTAS_COUNT, [this](uint64_t low, uint64_t high) {
+        GetStateDeltasFromSeedNodes(low, high);
+      });
+  {
+    lock_guard<mutex> g(m_mutexStateDeltaSync);
+    m_stateDeltaSync = sync;
+  }
+
+  // The chunks after this one are fetched while it is being applied
+  bool applied = true;
+  uint64_t chunkLowBlockNum = 0;
+  vector<bytes> stateDeltas;
+  while (sync->GetNextChunk(chunkLowBlockNum, stateDeltas)) {
+    if (!ApplyStateDeltas(chunkLowBlockNum, highBlockNum, stateDeltas)) {
+      applied = false;
+      break;
+    }
+  }
+  const bool result = applied && sync->IsComplete();
+
+  const auto stats = sync->GetStats();
+  {
+    lock_guard<mutex> g(m_mutexStateDeltaSync);
+    m_stateDeltaSync.reset();
+    m_stateDeltaSyncLast = stats;
+    m_stateDeltaSyncTotal.m_numBlocks += stats.m_numBlocks;
+    m_stateDeltaSyncTotal.m_numChunks += stats.m_numChunks;
+    m_stateDeltaSyncTotal.m_numRetries += stats.m_numRetries;
+    m_stateDeltaSyncTotal.m_syncTimeSec += stats.m_syncTimeSec;
+  }
+  LOG_GENERAL(INFO, "Synced statedeltas of "
+                        << stats.m_numBlocks << " blocks in "
+                        << stats.m_syncTimeSec << " s ("
+                        << stats.m_numChunks << " chunks, "
+                        << stats.m_numRetries << " retries)");
+  return result;
+}
+
+bool Lookup::ApplyStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                              const vector<bytes>& stateDeltas) {
+  uint64_t txBlkNum = lowBlockNum;
   bytes tmp;
   for (const auto& delta : stateDeltas) {
     // TBD - To verify state delta hash against one from TxBlk.
@@ -3601,14 +3645,19 @@ bool Lookup::ProcessSetStateDeltasFromSeed(
           }
         }
       }
-      txBlkNum++;
     }
+    txBlkNum++;
   }
-
-  cv_setStateDeltasFromSeed.notify_all();
   return true;
 }
 
+void Lookup::GetStateDeltaSyncStats(StateDeltaSyncStats& total,
+                                    StateDeltaSyncStats& last) {
+  lock_guard<mutex> g(m_mutexStateDeltaSync);
+  total = m_stateDeltaSyncTotal;
+  last = m_stateDeltaSyncLast;
+}
+
 void Lookup::RejoinNetwork() {
   LOG_MARKER();
   if (m_rejoinNetworkAttempts >= MAX_REJOIN_NETWORK_ATTEMPTS) {
@@ -3955,7 +4004,7 @@ bool Lookup::CheckStateRoot() {
 
   StateHash stateRoot = AccountStore::GetInstance().GetStateRootHash();
   StateHash rootInFinalBlock =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetStateRootHash();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetStateRootHash();
 
   if (stateRoot == rootInFinalBlock) {
     LOG_GENERAL(INFO, "CheckStateRoot match");
@@ -3987,7 +4036,7 @@ bool Lookup::InitMining() {
   }
 
   uint64_t curDsBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   m_mediator.UpdateDSBlockRand();
   auto dsBlockRand = m_mediator.m_dsBlockRand;
@@ -4004,7 +4053,7 @@ bool Lookup::InitMining() {
 
   m_mediator.m_node->SetState(Node::POW_SUBMISSION);
   POW::GetInstance().EthashConfigureClient(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1,
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1,
       FULL_DATASET_MINE);
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -4012,12 +4061,12 @@ bool Lookup::InitMining() {
 
   m_mediator.m_node->StartPoW(
       curDsBlockNum + 1,
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty(),
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty(),
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty(),
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty(),
       dsBlockRand, txBlockRand, 0);
 
   uint64_t lastTxBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (m_startedPoW) {
     unique_lock<mutex> lk(m_mutexCVJoined);
@@ -4030,7 +4079,7 @@ bool Lookup::InitMining() {
   // It is new DS epoch now, clear the seed node from black list
   RemoveSeedNodesFromBlackList();
 
-  if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() >
+  if (m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >
       lastTxBlockNum) {
     if (GetSyncType() != SyncType::NO_SYNC) {
       LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -4844,8 +4893,8 @@ bool Lookup::ProcessGetDirectoryBlocksFromSeed(const bytes& message,
     }
     if (get<BlockLinkIndex::BLOCKTYPE>(b) == BlockType::DS) {
       count++;
-      dirBlocks.emplace_back(
-          m_mediator.m_dsBlockChain.GetBlock(get<BlockLinkIndex::DSINDEX>(b)));
+      dirBlocks.emplace_back(*m_mediator.m_dsBlockChain.GetBlockPtr(
+          get<BlockLinkIndex::DSINDEX>(b)));
     } else if (get<BlockLinkIndex::BLOCKTYPE>(b) == BlockType::VC) {
       VCBlockSharedPtr vcblockptr;
       if (!BlockStorage::GetBlockStorage().GetVCBlock(
@@ -4881,10 +4930,10 @@ bool Lookup::ProcessGetDirectoryBlocksFromSeed(const bytes& message,
       if (get<BlockLinkIndex::BLOCKTYPE>(b) == BlockType::DS) {
         MinerInfoDSComm minerInfoDSComm;
         MinerInfoShards minerInfoShards;
-        uint64_t dsBlockNum =
-            m_mediator.m_dsBlockChain.GetBlock(get<BlockLinkIndex::DSINDEX>(b))
-                .GetHeader()
-                .GetBlockNum();
+        uint64_t dsBlockNum = m_mediator.m_dsBlockChain
+                                  .GetBlockPtr(get<BlockLinkIndex::DSINDEX>(b))
+                                  ->GetHeader()
+                                  .GetBlockNum();
         if (!BlockStorage::GetBlockStorage().GetMinerInfoDSComm(
                 dsBlockNum, minerInfoDSComm)) {
           LOG_GENERAL(WARNING,
@@ -4978,7 +5027,7 @@ bool Lookup::ProcessSetDirectoryBlocksFromSeed(
   DequeOfNode newDScomm;
 
   uint64_t dsblocknumbefore =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   LOG_GENERAL(INFO, "[DSINFOVERIF]"
                         << "Recvd " << dirBlocks.size() << " from lookup");
   {
@@ -4999,7 +5048,7 @@ bool Lookup::ProcessSetDirectoryBlocksFromSeed(
     m_mediator.m_blocklinkchain.SetBuiltDSComm(newDScomm);
   }
   uint64_t dsblocknumafter =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (dsblocknumafter > dsblocknumbefore) {
     if (m_syncType == SyncType::NO_SYNC &&
@@ -5213,6 +5262,11 @@ bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId,
     size += x.second.size();
   }
 
+  return AddToTxnShardMapNoLock(tx, shardId, txnShardMap, size);
+}
+
+bool Lookup::AddToTxnShardMapNoLock(const Transaction& tx, uint32_t shardId,
+                                    TxnShardMap& txnShardMap, uint32_t& size) {
   if (size >= TXN_STORAGE_LIMIT) {
     LOG_GENERAL(INFO, "Number of txns exceeded limit");
     return false;
@@ -5228,6 +5282,7 @@ bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId,
   }
 
   txnShardMap[shardId].emplace_back(make_pair(tx, 0));
+  size++;
   LOG_GENERAL(INFO, "Added Txn " << tx.GetTranID().hex() << " to shard "
                                  << shardId << " of fromAddr "
                                  << tx.GetSenderAddr());
@@ -5250,6 +5305,32 @@ bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
   return AddToTxnShardMap(tx, shardId, m_txnShardMap, m_txnShardMapMutex);
 }
 
+void Lookup::AddToTxnShardMap(
+    const vector<pair<Transaction, uint32_t>>& txnsAndShardIds,
+    vector<bool>& added) {
+  added.clear();
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::AddToTxnShardMap not expected to be called from "
+                "other than the LookUp node.");
+    added.resize(txnsAndShardIds.size(), true);
+    return;
+  }
+
+  lock_guard<mutex> g(m_txnShardMapMutex);
+
+  uint32_t size = 0;
+
+  for (const auto& x : m_txnShardMap) {
+    size += x.second.size();
+  }
+
+  for (const auto& txnAndShardId : txnsAndShardIds) {
+    added.emplace_back(AddToTxnShardMapNoLock(
+        txnAndShardId.first, txnAndShardId.second, m_txnShardMap, size));
+  }
+}
+
 bool Lookup::DeleteTxnShardMap(uint32_t shardId) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -5387,7 +5468,7 @@ void Lookup::SendTxnPacketToShard(const uint32_t shardId, bool toDS,
 
     result = Messenger::SetNodeForwardTxnBlock(
         msg, MessageOffset::BODY, epoch,
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
         shardId, m_mediator.m_selfKey, GetTxnFromShardMap(shardId),
         m_txnShardMapGenerated[shardId]);
   }
@@ -5403,7 +5484,7 @@ void Lookup::SendTxnPacketToShard(const uint32_t shardId, bool toDS,
     {
       lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
       uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-          m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+          m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes());
 
       if (m_mediator.m_ds->m_shards.at(shardId).empty()) {
         return;
@@ -5450,7 +5531,7 @@ void Lookup::SendTxnPacketToShard(const uint32_t shardId, bool toDS,
       // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
       PairOfNode dsLeader;
       if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
-                            m_mediator.m_dsBlockChain.GetLastBlock(),
+                            *m_mediator.m_dsBlockChain.GetLastBlock(),
                             *m_mediator.m_DSCommittee, dsLeader)) {
         toSend.push_back(dsLeader.second);
       }
@@ -5856,8 +5937,8 @@ void Lookup::FetchMBnForwardTxMessageFromL2l(uint64_t blockNum) {
                         << mbs.size());
 
         // for each nonempty mb, send the request to l2l data provider
-        auto txBlock = m_mediator.m_txBlockChain.GetBlock(blockNum);
-        const auto& microBlockInfos = txBlock.GetMicroBlockInfos();
+        const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(blockNum);
+        const auto& microBlockInfos = txBlock->GetMicroBlockInfos();
 
         for (const auto& mb : mbs) {
           for (const auto& info : microBlockInfos) {
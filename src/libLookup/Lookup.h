@@ -34,6 +34,7 @@
 #include "libData/BlockData/Block/DSBlock.h"
 #include "libData/BlockData/Block/MicroBlock.h"
 #include "libData/BlockData/Block/TxBlock.h"
+#include "libLookup/StateDeltaSync.h"
 #include "libNetwork/P2PComm.h"
 #include "libNetwork/Peer.h"
 #include "libNetwork/ShardStruct.h"
@@ -131,9 +132,15 @@ class Lookup : public Executable {
   TxnShardMap m_txnShardMapGenerated;
   std::map<Address, uint64_t> m_gentxnAddrLatestNonceSent;
 
-  // Get StateDeltas from seed
-  std::mutex m_mutexSetStateDeltasFromSeed;
-  std::condition_variable cv_setStateDeltasFromSeed;
+  /// Expects the shard map to be locked, size is its current total of txns
+  bool AddToTxnShardMapNoLock(const Transaction& tx, uint32_t shardId,
+                              TxnShardMap& txnShardMap, uint32_t& size);
+
+  // Get StateDeltas from seed, one range at a time
+  std::mutex m_mutexStateDeltaSync;
+  std::shared_ptr<StateDeltaSync> m_stateDeltaSync;
+  StateDeltaSyncStats m_stateDeltaSyncTotal;
+  StateDeltaSyncStats m_stateDeltaSyncLast;
 
   // TxBlockBuffer
   std::vector<TxBlock> m_txBlockBuffer;
@@ -248,6 +255,14 @@ class Lookup : public Executable {
   bool GetStateDeltaFromSeedNodes(const uint64_t& blockNum);
   bool GetStateDeltasFromSeedNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
 
+  /// Fetches the state deltas of the blocks in chunks from the seed nodes,
+  /// and applies each chunk while the next ones are being fetched
+  bool SyncStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum);
+  /// Applies the state deltas of the blocks from lowBlockNum on, highBlockNum
+  /// being the last block of the whole range being synced
+  bool ApplyStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                        const std::vector<bytes>& stateDeltas);
+
   // UNUSED
   bool ProcessGetShardFromSeed([[gnu::unused]] const bytes& message,
                                [[gnu::unused]] unsigned int offset,
@@ -304,6 +319,10 @@ class Lookup : public Executable {
   bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId);
   bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId,
                         TxnShardMap& txnShardMap, std::mutex& txnShardMapMutex);
+  /// Adds a batch of txns under a single lock of the txn shard map
+  void AddToTxnShardMap(
+      const std::vector<std::pair<Transaction, uint32_t>>& txnsAndShardIds,
+      std::vector<bool>& added);
 
   void CheckBufferTxBlocks();
 
@@ -499,10 +518,18 @@ class Lookup : public Executable {
     m_lookupServer = std::move(lookupServer);
   }
 
+  std::shared_ptr<LookupServer> GetLookupServer() const {
+    return m_lookupServer;
+  }
+
   void SetStakingServer(std::shared_ptr<StakingServer> stakingServer) {
     m_stakingServer = std::move(stakingServer);
   }
 
+  /// Returns the totals of the state delta syncs and the last one of them
+  void GetStateDeltaSyncStats(StateDeltaSyncStats& total,
+                              StateDeltaSyncStats& last);
+
   void RejoinNetwork();
 
   bool StartJsonRpcPort();
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "StateDeltaSync.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+StateDeltaSync::StateDeltaSync(uint64_t lowBlockNum, uint64_t highBlockNum,
+                               uint64_t chunkSize, unsigned int window,
+                               chrono::milliseconds timeout,
+                               unsigned int maxRequests,
+                               const RequestFunc& request)
+    : m_lowBlockNum(lowBlockNum),
+      m_chunkSize(max<uint64_t>(chunkSize, 1)),
+      m_window(max(window, 1u)),
+      m_timeout(timeout),
+      m_maxRequests(max(maxRequests, 1u)),
+      m_request(request),
+      m_startTime(Clock::now()) {
+  uint64_t low = lowBlockNum;
+  while (low <= highBlockNum) {
+    Chunk chunk;
+    chunk.m_lowBlockNum = low;
+    chunk.m_highBlockNum = min(low + m_chunkSize - 1, highBlockNum);
+    m_chunks.emplace_back(move(chunk));
+    if (m_chunks.back().m_highBlockNum == highBlockNum) {
+      break;
+    }
+    low += m_chunkSize;
+  }
+}
+
+bool StateDeltaSync::AddChunk(uint64_t lowBlockNum, uint64_t highBlockNum,
+                              vector<bytes>&& stateDeltas) {
+  lock_guard<mutex> g(m_mutex);
+
+  if (lowBlockNum < m_lowBlockNum) {
+    return false;
+  }
+  const uint64_t index = (lowBlockNum - m_lowBlockNum) / m_chunkSize;
+  if (index < m_nextChunk || index >= m_chunks.size()) {
+    return false;
+  }
+  Chunk& chunk = m_chunks[index];
+  if (chunk.m_received || chunk.m_lowBlockNum != lowBlockNum ||
+      chunk.m_highBlockNum != highBlockNum) {
+    return false;
+  }
+  chunk.m_stateDeltas = move(stateDeltas);
+  chunk.m_received = true;
+  m_cv.notify_all();
+  return true;
+}
+
+StateDeltaSync::Clock::time_point StateDeltaSync::SendRequests(
+    unique_lock<mutex>& lock) {
+  const auto now = Clock::now();
+  auto deadline = now + m_timeout;
+  vector<pair<uint64_t, uint64_t>> requests;
+
+  const size_t end = min(m_nextChunk + m_window, m_chunks.size());
+  for (size_t i = m_nextChunk; i < end; i++) {
+    Chunk& chunk = m_chunks[i];
+    if (chunk.m_received) {
+      continue;
+    }
+    if (chunk.m_numRequests > 0 && now < chunk.m_requestTime + m_timeout) {
+      deadline = min(deadline, chunk.m_requestTime + m_timeout);
+      continue;
+    }
+    if (chunk.m_numRequests >= m_maxRequests) {
+      LOG_GENERAL(WARNING, "Didn't receive statedeltas for blocks "
+                               << chunk.m_lowBlockNum << " to "
+                               << chunk.m_highBlockNum << " after "
+                               << chunk.m_numRequests << " requests");
+      m_failed = true;
+      return now;
+    }
+    if (chunk.m_numRequests > 0) {
+      LOG_GENERAL(WARNING, "[Retry: " << chunk.m_numRequests
+                                      << "] Didn't receive statedeltas for "
+                                         "blocks "
+                                      << chunk.m_lowBlockNum << " to "
+                                      << chunk.m_highBlockNum
+                                      << "! Will try again");
+      m_stats.m_numRetries++;
+    }
+    chunk.m_numRequests++;
+    chunk.m_requestTime = now;
+    requests.emplace_back(chunk.m_lowBlockNum, chunk.m_highBlockNum);
+  }
+
+  if (!requests.empty()) {
+    lock.unlock();
+    for (const auto& request : requests) {
+      m_request(request.first, request.second);
+    }
+    lock.lock();
+  }
+  return deadline;
+}
+
+bool StateDeltaSync::GetNextChunk(uint64_t& lowBlockNum,
+                                  vector<bytes>& stateDeltas) {
+  unique_lock<mutex> lock(m_mutex);
+
+  while (!m_failed && m_nextChunk < m_chunks.size()) {
+    Chunk& next = m_chunks[m_nextChunk];
+    if (next.m_received) {
+      lowBlockNum = next.m_lowBlockNum;
+      stateDeltas = move(next.m_stateDeltas);
+      next.m_stateDeltas.clear();
+      m_nextChunk++;
+      m_stats.m_numBlocks += next.m_highBlockNum - next.m_lowBlockNum + 1;
+      m_stats.m_numChunks++;
+      // Keeps the window full while the caller applies this chunk
+      SendRequests(lock);
+      return !m_failed;
+    }
+
+    const auto deadline = SendRequests(lock);
+    if (m_failed) {
+      break;
+    }
+    m_cv.wait_until(lock, deadline, [this]() {
+      return m_chunks[m_nextChunk].m_received;
+    });
+  }
+  return false;
+}
+
+bool StateDeltaSync::IsComplete() {
+  lock_guard<mutex> g(m_mutex);
+  return !m_failed && m_nextChunk == m_chunks.size();
+}
+
+StateDeltaSyncStats StateDeltaSync::GetStats() {
+  lock_guard<mutex> g(m_mutex);
+  StateDeltaSyncStats stats = m_stats;
+  stats.m_syncTimeSec =
+      chrono::duration<double>(Clock::now() - m_startTime).count();
+  return stats;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBLOOKUP_STATEDELTASYNC_H_
+#define ZILLIQA_SRC_LIBLOOKUP_STATEDELTASYNC_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "common/BaseType.h"
+
+struct StateDeltaSyncStats {
+  uint64_t m_numBlocks{0};
+  uint64_t m_numChunks{0};
+  uint64_t m_numRetries{0};
+  double m_syncTimeSec{0};
+};
+
+/// Fetches the state deltas of a range of tx blocks in chunks. A window of
+/// chunks is requested at once, each from the node picked by the request
+/// function. The chunks may arrive in any order but are handed out in
+/// order, and a chunk not received in time is requested again on its own.
+class StateDeltaSync {
+ public:
+  using RequestFunc =
+      std::function<void(uint64_t lowBlockNum, uint64_t highBlockNum)>;
+
+  StateDeltaSync(uint64_t lowBlockNum, uint64_t highBlockNum,
+                 uint64_t chunkSize, unsigned int window,
+                 std::chrono::milliseconds timeout, unsigned int maxRequests,
+                 const RequestFunc& request);
+
+  /// Stores a received chunk, returns false if it is not awaited
+  bool AddChunk(uint64_t lowBlockNum, uint64_t highBlockNum,
+                std::vector<bytes>&& stateDeltas);
+
+  /// Waits for the next chunk in order, sending the requests of the window
+  /// meanwhile. Returns false once all the chunks were handed out, or when
+  /// one of them could not be fetched in maxRequests attempts.
+  bool GetNextChunk(uint64_t& lowBlockNum, std::vector<bytes>& stateDeltas);
+
+  /// Returns true if all the chunks were handed out
+  bool IsComplete();
+
+  StateDeltaSyncStats GetStats();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Chunk {
+    uint64_t m_lowBlockNum;
+    uint64_t m_highBlockNum;
+    unsigned int m_numRequests{0};
+    Clock::time_point m_requestTime;
+    bool m_received{false};
+    std::vector<bytes> m_stateDeltas;
+  };
+
+  /// Sends the requests due in the window, without holding the lock while
+  /// sending. Returns when the earliest chunk in flight times out.
+  Clock::time_point SendRequests(std::unique_lock<std::mutex>& lock);
+
+  const uint64_t m_lowBlockNum;
+  const uint64_t m_chunkSize;
+  const unsigned int m_window;
+  const std::chrono::milliseconds m_timeout;
+  const unsigned int m_maxRequests;
+  const RequestFunc m_request;
+  const Clock::time_point m_startTime;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::vector<Chunk> m_chunks;
+  size_t m_nextChunk{0};
+  bool m_failed{false};
+  StateDeltaSyncStats m_stats;
+};
+
+#endif  // ZILLIQA_SRC_LIBLOOKUP_STATEDELTASYNC_H_
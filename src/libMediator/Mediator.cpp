@@ -80,7 +80,7 @@ void Mediator::UpdateDSBlockRand(bool isGenesis) {
     DataConversion::HexStrToStdArray(RAND1_GENESIS, rand1);
     copy(rand1.begin(), rand1.end(), m_dsBlockRand.begin());
   } else {
-    DSBlock lastBlock = m_dsBlockChain.GetLastBlock();
+    DSBlock lastBlock = *m_dsBlockChain.GetLastBlock();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     lastBlock.GetHeader().Serialize(vec, 0);
@@ -100,7 +100,7 @@ void Mediator::UpdateTxBlockRand(bool isGenesis) {
     DataConversion::HexStrToStdArray(RAND2_GENESIS, rand2);
     copy(rand2.begin(), rand2.end(), m_txBlockRand.begin());
   } else {
-    TxBlock lastBlock = m_txBlockChain.GetLastBlock();
+    TxBlock lastBlock = *m_txBlockChain.GetLastBlock();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     lastBlock.GetHeader().Serialize(vec, 0);
@@ -192,7 +192,7 @@ bool Mediator::CheckWhetherBlockIsLatest(const uint64_t& dsblockNum,
   LOG_MARKER();
 
   uint64_t latestDSBlockNumInBlockchain =
-      m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (dsblockNum < (latestDSBlockNumInBlockchain + 1)) {
     LOG_EPOCH(WARNING, m_currentEpochNum,
@@ -253,11 +253,11 @@ void Mediator::SetupLogLevel() {
 
 bool Mediator::ToProcessTransaction() {
   return !GetIsVacuousEpoch() &&
-         ((m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
+         ((m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty() >=
                TXN_SHARD_TARGET_DIFFICULTY &&
-           m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty() >=
+           m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty() >=
                TXN_DS_TARGET_DIFFICULTY) ||
-          m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+          m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
               TXN_DS_TARGET_NUM);
 }
 
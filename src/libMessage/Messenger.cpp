@@ -23,11 +23,15 @@
 #include "libMessage/ZilliqaMessage.pb.h"
 #include "libUtils/Logger.h"
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <algorithm>
 #include <map>
 #include <random>
+#include <set>
+#include <thread>
+#include <type_traits>
 #include <unordered_set>
 
 using namespace boost::multiprecision;
@@ -38,34 +42,89 @@ using namespace ZilliqaMessage;
 // Utility conversion functions
 // ============================================================================
 
+namespace {
+
+/// Reused on each thread for the keys and signatures, which are converted
+/// everywhere. Their serialization never comes back into Messenger, so that
+/// a single buffer per thread is enough.
+bytes& GetCryptoScratch() {
+  thread_local bytes scratch;
+  return scratch;
+}
+
+/// Writes the number big-endian into the S bytes of dst from offset
+template <class T, size_t S>
+void NumberToString(const T& number, string& dst, const size_t offset) {
+  unsigned int rightShift = (S - 1) * 8;
+  for (size_t i = 0; i < S; i++) {
+    const uint8_t byte = static_cast<uint8_t>((number >> rightShift) & 0xFF);
+    dst[offset + i] = static_cast<char>(byte);
+    rightShift -= 8;
+  }
+}
+
+/// Reads the number as Serializable::GetNumber does, 0 if src is too short
+template <class T, size_t S>
+T StringToNumber(const string& src, const size_t offset) {
+  T result = 0;
+  if (offset + S <= src.size()) {
+    unsigned int leftShift = (S - 1) * 8;
+    for (size_t i = 0; i < S; i++) {
+      T tmp = static_cast<uint8_t>(src[offset + i]);
+      result += (tmp << leftShift);
+      leftShift -= 8;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
 template <class T>
-void SerializableToProtobufByteArray(const T& serializable,
-                                     ByteArray& byteArray) {
+typename enable_if<!is_base_of<SerializableCrypto, T>::value>::type
+SerializableToProtobufByteArray(const T& serializable, ByteArray& byteArray) {
   bytes tmp;
   serializable.Serialize(tmp, 0);
   byteArray.set_data(tmp.data(), tmp.size());
 }
 
+template <class T>
+typename enable_if<is_base_of<SerializableCrypto, T>::value>::type
+SerializableToProtobufByteArray(const T& serializable, ByteArray& byteArray) {
+  bytes& scratch = GetCryptoScratch();
+  scratch.clear();
+  serializable.Serialize(scratch, 0);
+  byteArray.set_data(scratch.data(), scratch.size());
+}
+
+// Written straight into the ByteArray, as Peer::Serialize lays it out
+void SerializableToProtobufByteArray(const Peer& peer, ByteArray& byteArray) {
+  string& data = *byteArray.mutable_data();
+  data.resize(UINT128_SIZE + sizeof(uint32_t));
+  NumberToString<uint128_t, UINT128_SIZE>(peer.m_ipAddress, data, 0);
+  NumberToString<uint32_t, sizeof(uint32_t)>(peer.m_listenPortHost, data,
+                                             UINT128_SIZE);
+}
+
 bool ProtobufByteArrayToSerializable(const ByteArray& byteArray,
                                      Serializable& serializable) {
-  bytes tmp(byteArray.data().size());
-  copy(byteArray.data().begin(), byteArray.data().end(), tmp.begin());
+  bytes tmp(byteArray.data().begin(), byteArray.data().end());
   return serializable.Deserialize(tmp, 0) == 0;
 }
 
-bool ProtobufByteArrayToSerializable(const ByteArray& byteArray,
-                                     SerializableCrypto& serializable) {
-  bytes tmp(byteArray.data().size());
-  copy(byteArray.data().begin(), byteArray.data().end(), tmp.begin());
-  return serializable.Deserialize(tmp, 0);
+bool ProtobufByteArrayToSerializable(const ByteArray& byteArray, Peer& peer) {
+  peer.m_ipAddress =
+      StringToNumber<uint128_t, UINT128_SIZE>(byteArray.data(), 0);
+  peer.m_listenPortHost = StringToNumber<uint32_t, sizeof(uint32_t)>(
+      byteArray.data(), UINT128_SIZE);
+  return true;
 }
 
-// Temporary function for use by data blocks
-void SerializableToProtobufByteArray(const SerializableDataBlock& serializable,
-                                     ByteArray& byteArray) {
-  bytes tmp;
-  serializable.Serialize(tmp, 0);
-  byteArray.set_data(tmp.data(), tmp.size());
+bool ProtobufByteArrayToSerializable(const ByteArray& byteArray,
+                                     SerializableCrypto& serializable) {
+  bytes& scratch = GetCryptoScratch();
+  scratch.assign(byteArray.data().begin(), byteArray.data().end());
+  return serializable.Deserialize(scratch, 0);
 }
 
 // Temporary function for use by data blocks
@@ -76,18 +135,39 @@ bool ProtobufByteArrayToSerializable(const ByteArray& byteArray,
 
 template <class T, size_t S>
 void NumberToProtobufByteArray(const T& number, ByteArray& byteArray) {
-  bytes tmp;
-  Serializable::SetNumber<T>(tmp, 0, number, S);
-  byteArray.set_data(tmp.data(), tmp.size());
+  string& data = *byteArray.mutable_data();
+  data.resize(S);
+  NumberToString<T, S>(number, data, 0);
 }
 
 template <class T, size_t S>
 void ProtobufByteArrayToNumber(const ByteArray& byteArray, T& number) {
-  bytes tmp(byteArray.data().size());
-  copy(byteArray.data().begin(), byteArray.data().end(), tmp.begin());
-  number = Serializable::GetNumber<T>(tmp, 0, S);
+  number = StringToNumber<T, S>(byteArray.data(), 0);
 }
 
+/// Holds the large composite messages, i.e. the blocks and the sharding
+/// structure. All their fields are allocated in a few blocks of the arena
+/// and freed at once with it, instead of one by one.
+class MessageArena {
+ public:
+  MessageArena() : m_arena(GetOptions()) {}
+
+  template <class T>
+  T& Create() {
+    return *google::protobuf::Arena::CreateMessage<T>(&m_arena);
+  }
+
+ private:
+  static google::protobuf::ArenaOptions GetOptions() {
+    google::protobuf::ArenaOptions options;
+    options.start_block_size = 16 * 1024;
+    options.max_block_size = 1024 * 1024;
+    return options;
+  }
+
+  google::protobuf::Arena m_arena;
+};
+
 template <class T>
 bool SerializeToArray(const T& protoMessage, bytes& dst,
                       const unsigned int offset) {
@@ -492,12 +572,12 @@ bool AccountToProtobuf(const Account& account, ProtoAccount& protoAccount) {
   AccountBaseToProtobuf(account, *protoAccountBase);
 
   if (!protoAccountBase->codehash().empty()) {
-    bytes codebytes = account.GetCode();
-    protoAccount.set_code(codebytes.data(), codebytes.size());
+    const CodeBytes codebytes = account.GetCode();
+    protoAccount.set_code(codebytes->data(), codebytes->size());
 
     // set initdata
-    bytes initbytes = account.GetInitData();
-    protoAccount.set_initdata(initbytes.data(), initbytes.size());
+    const CodeBytes initbytes = account.GetInitData();
+    protoAccount.set_initdata(initbytes->data(), initbytes->size());
 
     // set data
     map<std::string, bytes> t_states;
@@ -622,10 +702,10 @@ bool AccountDeltaToProtobuf(const Account* oldAccount,
   if (newAccount.isContract()) {
     if (fullCopy) {
       accbase.SetCodeHash(newAccount.GetCodeHash());
-      protoAccount.set_code(newAccount.GetCode().data(),
-                            newAccount.GetCode().size());
-      protoAccount.set_initdata(newAccount.GetInitData().data(),
-                                newAccount.GetInitData().size());
+      const CodeBytes code = newAccount.GetCode();
+      protoAccount.set_code(code->data(), code->size());
+      const CodeBytes initData = newAccount.GetInitData();
+      protoAccount.set_initdata(initData->data(), initData->size());
     }
 
     if (fullCopy ||
@@ -657,15 +737,14 @@ bool AccountDeltaToProtobuf(const Account* oldAccount,
   return true;
 }
 
-bool ProtobufToAccountDelta(const ProtoAccount& protoAccount, Account& account,
-                            const Address& addr, const bool fullCopy, bool temp,
-                            bool revertible = false) {
+bool ProtobufToAccountDelta(const ProtoAccount& protoAccount,
+                            const Address& addr, AccountDelta& delta) {
   if (!CheckRequiredFieldsProtoAccount(protoAccount)) {
     LOG_GENERAL(WARNING, "CheckRequiredFieldsProtoAccount failed");
     return false;
   }
 
-  AccountBase accbase;
+  AccountBase& accbase = delta.m_base;
 
   const ZilliqaMessage::ProtoAccountBase& protoAccountBase =
       protoAccount.base();
@@ -689,36 +768,66 @@ bool ProtobufToAccountDelta(const ProtoAccount& protoAccount, Account& account,
   }
 #endif
 
-  int256_t balanceDelta = protoAccount.numbersign()
-                              ? accbase.GetBalance().convert_to<int256_t>()
-                              : 0 - accbase.GetBalance().convert_to<int256_t>();
-  account.ChangeBalance(balanceDelta);
+  delta.m_address = addr;
+  delta.m_balanceDelta = protoAccount.numbersign()
+                             ? accbase.GetBalance().convert_to<int256_t>()
+                             : 0 - accbase.GetBalance().convert_to<int256_t>();
+
+  // Only applied to the new accounts, checked then
+  delta.m_code = CodeStore::GetInstance().Add(
+      DataConversion::StringToCharArray(protoAccount.code()));
+  delta.m_initData = CodeStore::GetInstance().Add(
+      DataConversion::StringToCharArray(protoAccount.initdata()));
+  if (!delta.m_code->empty()) {
+    SHA2<HashType::HASH_VARIANT_256> sha2;
+    sha2.Update(*delta.m_code);
+    sha2.Update(*delta.m_initData);
+    delta.m_codeHash = dev::h256(sha2.Finalize());
+  }
+
+  if (accbase.GetStorageRoot() == dev::h256()) {
+    for (const auto& entry : protoAccount.storage2()) {
+      delta.m_states.emplace(entry.key(),
+                             DataConversion::StringToCharArray(entry.data()));
+      if (LOG_SC) {
+        LOG_GENERAL(INFO, "Key: " << entry.key() << "  "
+                                  << "Data: " << entry.data());
+      }
+    }
+
+    for (const auto& entry : protoAccount.todelete()) {
+      delta.m_toDelete.emplace_back(entry);
+    }
+  }
+
+  return true;
+}
+
+bool ApplyAccountDelta(const AccountDelta& delta, Account& account,
+                       const bool fullCopy, bool temp, bool revertible) {
+  const AccountBase& accbase = delta.m_base;
+  const Address& addr = delta.m_address;
+
+  account.ChangeBalance(delta.m_balanceDelta);
 
   if (!account.IncreaseNonceBy(accbase.GetNonce())) {
     LOG_GENERAL(WARNING, "IncreaseNonceBy failed");
     return false;
   }
 
-  if ((protoAccount.code().size() > 0) || account.isContract()) {
+  if (!delta.m_code->empty() || account.isContract()) {
     if (fullCopy) {
-      bytes codeBytes, initDataBytes;
-
-      if (protoAccount.code().size() > MAX_CODE_SIZE_IN_BYTES) {
+      if (delta.m_code->size() > MAX_CODE_SIZE_IN_BYTES) {
         LOG_GENERAL(WARNING, "Code size "
-                                 << protoAccount.code().size()
+                                 << delta.m_code->size()
                                  << " greater than MAX_CODE_SIZE_IN_BYTES "
                                  << MAX_CODE_SIZE_IN_BYTES);
         return false;
       }
-      codeBytes.resize(protoAccount.code().size());
-      copy(protoAccount.code().begin(), protoAccount.code().end(),
-           codeBytes.begin());
-      initDataBytes.resize(protoAccount.initdata().size());
-      copy(protoAccount.initdata().begin(), protoAccount.initdata().end(),
-           initDataBytes.begin());
-      if (codeBytes != account.GetCode() ||
-          initDataBytes != account.GetInitData()) {
-        if (!account.SetImmutable(codeBytes, initDataBytes)) {
+      if (*delta.m_code != *account.GetCode() ||
+          *delta.m_initData != *account.GetInitData()) {
+        if (!account.SetImmutable(delta.m_code, delta.m_initData,
+                                  delta.m_codeHash)) {
           LOG_GENERAL(WARNING, "Account::SetImmutable failed");
           return false;
         }
@@ -738,25 +847,7 @@ bool ProtobufToAccountDelta(const ProtoAccount& protoAccount, Account& account,
     }
 
     if (accbase.GetStorageRoot() == dev::h256()) {
-      dev::h256 tmpHash;
-
-      map<string, bytes> t_states;
-      vector<std::string> toDeleteIndices;
-
-      for (const auto& entry : protoAccount.storage2()) {
-        t_states.emplace(entry.key(),
-                         DataConversion::StringToCharArray(entry.data()));
-        if (LOG_SC) {
-          LOG_GENERAL(INFO, "Key: " << entry.key() << "  "
-                                    << "Data: " << entry.data());
-        }
-      }
-
-      for (const auto& entry : protoAccount.todelete()) {
-        toDeleteIndices.emplace_back(entry);
-      }
-
-      if (!account.UpdateStates(addr, t_states, toDeleteIndices, temp,
+      if (!account.UpdateStates(addr, delta.m_states, delta.m_toDelete, temp,
                                 revertible)) {
         LOG_GENERAL(WARNING, "Account::UpdateStates failed");
         return false;
@@ -767,6 +858,14 @@ bool ProtobufToAccountDelta(const ProtoAccount& protoAccount, Account& account,
   return true;
 }
 
+bool ProtobufToAccountDelta(const ProtoAccount& protoAccount, Account& account,
+                            const Address& addr, const bool fullCopy, bool temp,
+                            bool revertible = false) {
+  AccountDelta delta;
+  return ProtobufToAccountDelta(protoAccount, addr, delta) &&
+         ApplyAccountDelta(delta, account, fullCopy, temp, revertible);
+}
+
 void DSCommitteeToProtobuf(const uint32_t version,
                            const DequeOfNode& dsCommittee,
                            ProtoDSCommittee& protoDSCommittee) {
@@ -1210,7 +1309,8 @@ void TransactionToProtobuf(const Transaction& transaction,
 }
 
 bool ProtobufToTransaction(const ProtoTransaction& protoTransaction,
-                           Transaction& transaction) {
+                           Transaction& transaction,
+                           bool verifySignature = true) {
   if (!CheckRequiredFieldsProtoTransaction(protoTransaction)) {
     LOG_GENERAL(WARNING, "CheckRequiredFieldsProtoTransaction failed");
     return false;
@@ -1256,7 +1356,7 @@ bool ProtobufToTransaction(const ProtoTransaction& protoTransaction,
       txnCoreInfo.senderPubKey, txnCoreInfo.amount, txnCoreInfo.gasPrice,
       txnCoreInfo.gasLimit, txnCoreInfo.code, txnCoreInfo.data, signature);
 
-  if (!transaction.IsSigned()) {
+  if (verifySignature && !transaction.IsSigned()) {
     LOG_GENERAL(WARNING,
                 "Signature verification failed when converting tx to protobuf");
     return false;
@@ -1265,6 +1365,27 @@ bool ProtobufToTransaction(const ProtoTransaction& protoTransaction,
   return true;
 }
 
+/// Verify at once the signatures of the transactions decoded with
+/// verifySignature unset, starting from index begin
+bool VerifyTransactionSignatures(
+    size_t begin, size_t end,
+    const function<const Transaction&(size_t)>& getTxn) {
+  vector<size_t> invalidIndexes;
+  if (!Transaction::VerifySignatures(
+          end - begin,
+          [&getTxn, begin](size_t index) -> const Transaction& {
+            return getTxn(begin + index);
+          },
+          invalidIndexes)) {
+    LOG_GENERAL(WARNING,
+                "Signature verification failed for "
+                    << invalidIndexes.size() << " txns, first one "
+                    << getTxn(begin + invalidIndexes.front()).GetTranID());
+    return false;
+  }
+  return true;
+}
+
 void TransactionOffsetToProtobuf(const std::vector<uint32_t>& txnOffsets,
                                  ProtoTxnFileOffset& protoTxnFileOffset) {
   for (const auto& offset : txnOffsets) {
@@ -1298,16 +1419,19 @@ void TransactionArrayToProtobuf(const deque<pair<Transaction, uint32_t>>& txns,
 bool ProtobufToTransactionArray(
     const ProtoTransactionArray& protoTransactionArray,
     std::vector<Transaction>& txns) {
+  const size_t begin = txns.size();
   for (const auto& protoTransaction : protoTransactionArray.transactions()) {
     Transaction txn;
-    if (!ProtobufToTransaction(protoTransaction, txn)) {
+    if (!ProtobufToTransaction(protoTransaction, txn, false)) {
       LOG_GENERAL(WARNING, "ProtobufToTransaction failed");
       return false;
     }
     txns.push_back(txn);
   }
 
-  return true;
+  return VerifyTransactionSignatures(
+      begin, txns.size(),
+      [&txns](size_t index) -> const Transaction& { return txns[index]; });
 }
 
 void TransactionReceiptToProtobuf(const TransactionReceipt& transReceipt,
@@ -1347,9 +1471,11 @@ void TransactionWithReceiptToProtobuf(
 
 bool ProtobufToTransactionWithReceipt(
     const ProtoTransactionWithReceipt& protoWithTransaction,
-    TransactionWithReceipt& transactionWithReceipt) {
+    TransactionWithReceipt& transactionWithReceipt,
+    bool verifySignature = true) {
   Transaction transaction;
-  if (!ProtobufToTransaction(protoWithTransaction.transaction(), transaction)) {
+  if (!ProtobufToTransaction(protoWithTransaction.transaction(), transaction,
+                             verifySignature)) {
     LOG_GENERAL(WARNING, "ProtobufToTransaction failed");
     return false;
   }
@@ -2327,7 +2453,8 @@ bool Messenger::GetShardHash(const Shard& shard, CommitteeHash& dst) {
 bool Messenger::GetShardingStructureHash(const uint32_t& version,
                                          const DequeOfShard& shards,
                                          ShardingHash& dst) {
-  ProtoShardingStructure protoShardingStructure;
+  MessageArena arena;
+  auto& protoShardingStructure = arena.Create<ProtoShardingStructure>();
 
   ShardingStructureToProtobuf(version, shards, protoShardingStructure);
 
@@ -2694,6 +2821,19 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
                                      const unsigned int offset,
                                      AccountStore& accountStore,
                                      const bool revertible, bool temp) {
+  vector<AccountDelta> deltas;
+  return DecodeAccountStoreDelta(src, offset, deltas,
+                                 STATEDELTA_DECODE_THREADS) &&
+         ApplyAccountStoreDelta(deltas, accountStore, revertible, temp);
+}
+
+bool Messenger::DecodeAccountStoreDelta(const bytes& src,
+                                        const unsigned int offset,
+                                        vector<AccountDelta>& deltas,
+                                        unsigned int numThreads) {
+  // Fewer entries per thread cost more to spawn than they save
+  const unsigned int MIN_ENTRIES_PER_THREAD = 256;
+
   ProtoAccountStore result;
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
@@ -2702,17 +2842,59 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
     return false;
   }
 
-  LOG_GENERAL(INFO,
-              "Total Number of Accounts Delta: " << result.entries().size());
+  const auto& entries = result.entries();
+  const size_t numEntries = entries.size();
+  LOG_GENERAL(INFO, "Total Number of Accounts Delta: " << numEntries);
 
-  for (const auto& entry : result.entries()) {
-    Address address;
-    Account account, t_account;
+  deltas.clear();
+  deltas.resize(numEntries);
 
-    copy(entry.address().begin(),
-         entry.address().begin() + min((unsigned int)entry.address().size(),
-                                       (unsigned int)address.size),
-         address.asArray().begin());
+  // The entries are independent, each thread decodes a slice of them
+  const size_t numSlices = max<size_t>(
+      1, min<size_t>(numThreads, numEntries / MIN_ENTRIES_PER_THREAD));
+  const size_t sliceSize = (numEntries + numSlices - 1) / numSlices;
+  vector<char> results(numSlices, true);
+
+  auto decodeSlice = [&](size_t s) {
+    const size_t end = min(numEntries, (s + 1) * sliceSize);
+    for (size_t i = s * sliceSize; i < end; i++) {
+      const auto& entry = entries.Get(i);
+      Address address;
+
+      copy(entry.address().begin(),
+           entry.address().begin() + min((unsigned int)entry.address().size(),
+                                         (unsigned int)address.size),
+           address.asArray().begin());
+
+      if (!ProtobufToAccountDelta(entry.account(), address, deltas[i])) {
+        LOG_GENERAL(WARNING,
+                    "ProtobufToAccountDelta failed for account at address "
+                        << address.hex());
+        results[s] = false;
+        return;
+      }
+    }
+  };
+
+  vector<thread> workers;
+  for (size_t s = 1; s < numSlices; s++) {
+    workers.emplace_back(decodeSlice, s);
+  }
+  decodeSlice(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return all_of(results.begin(), results.end(),
+                [](char result) { return result; });
+}
+
+bool Messenger::ApplyAccountStoreDelta(const vector<AccountDelta>& deltas,
+                                       AccountStore& accountStore,
+                                       const bool revertible, bool temp) {
+  for (const auto& delta : deltas) {
+    const Address& address = delta.m_address;
+    Account account, t_account;
 
     const Account* oriAccount = accountStore.GetAccount(address);
     bool fullCopy = false;
@@ -2730,11 +2912,9 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
 
     t_account = *oriAccount;
     account = *oriAccount;
-    if (!ProtobufToAccountDelta(entry.account(), account, address, fullCopy,
-                                temp, revertible)) {
-      LOG_GENERAL(WARNING,
-                  "ProtobufToAccountDelta failed for account at address "
-                      << address.hex());
+    if (!ApplyAccountDelta(delta, account, fullCopy, temp, revertible)) {
+      LOG_GENERAL(WARNING, "ApplyAccountDelta failed for account at address "
+                               << address.hex());
       return false;
     }
 
@@ -2801,6 +2981,123 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
   return true;
 }
 
+bool Messenger::MergeAccountStoreDeltas(const vector<bytes>& stateDeltas,
+                                        bytes& dst) {
+  // Net change of an account over the deltas
+  struct NetDelta {
+    AccountBase m_base;
+    int256_t m_balance{0};
+    string m_code;
+    string m_initData;
+    map<string, string> m_states;
+    set<string> m_toDelete;
+    /// Set if any delta carries states to apply, which the ones with a
+    /// storage root do not
+    bool m_hasStates{false};
+    dev::h256 m_storageRoot;
+  };
+
+  vector<string> addresses;
+  unordered_map<string, NetDelta> netDeltas;
+
+  for (const auto& stateDelta : stateDeltas) {
+    if (stateDelta.empty()) {
+      continue;
+    }
+    ProtoAccountStore delta;
+    delta.ParseFromArray(stateDelta.data(), stateDelta.size());
+    if (!delta.IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+      return false;
+    }
+
+    for (const auto& entry : delta.entries()) {
+      const ProtoAccount& protoAccount = entry.account();
+      AccountBase accbase;
+      if (!CheckRequiredFieldsProtoAccount(protoAccount) ||
+          !ProtobufToAccountBase(protoAccount.base(), accbase)) {
+        LOG_GENERAL(WARNING, "Invalid account delta");
+        return false;
+      }
+
+      auto it = netDeltas.find(entry.address());
+      if (it == netDeltas.end()) {
+        addresses.emplace_back(entry.address());
+        it = netDeltas.emplace(entry.address(), NetDelta()).first;
+      }
+      NetDelta& net = it->second;
+
+      net.m_base.SetVersion(accbase.GetVersion());
+      const int256_t balance = accbase.GetBalance().convert_to<int256_t>();
+      net.m_balance += protoAccount.numbersign() ? balance : 0 - balance;
+      uint64_t nonce = 0;
+      if (!SafeMath<uint64_t>::add(net.m_base.GetNonce(), accbase.GetNonce(),
+                                   nonce)) {
+        return false;
+      }
+      net.m_base.SetNonce(nonce);
+
+      // Only the delta creating a contract carries its code
+      if (net.m_code.empty() && !protoAccount.code().empty()) {
+        net.m_code = protoAccount.code();
+        net.m_initData = protoAccount.initdata();
+        net.m_base.SetCodeHash(accbase.GetCodeHash());
+      }
+
+      if (accbase.GetStorageRoot() != dev::h256()) {
+        net.m_storageRoot = accbase.GetStorageRoot();
+        continue;
+      }
+      net.m_hasStates = true;
+      for (const auto& state : protoAccount.storage2()) {
+        net.m_states[state.key()] = state.data();
+        net.m_toDelete.erase(state.key());
+      }
+      for (const auto& key : protoAccount.todelete()) {
+        net.m_states.erase(key);
+        net.m_toDelete.insert(key);
+      }
+    }
+  }
+
+  ProtoAccountStore result;
+  for (const auto& address : addresses) {
+    NetDelta& net = netDeltas.at(address);
+    const int256_t magnitude = abs(net.m_balance);
+    if (magnitude > int256_t(numeric_limits<uint128_t>::max())) {
+      LOG_GENERAL(WARNING, "Balance delta overflow");
+      return false;
+    }
+    net.m_base.SetBalance(magnitude.convert_to<uint128_t>());
+    net.m_base.SetStorageRoot(net.m_hasStates ? dev::h256()
+                                              : net.m_storageRoot);
+
+    ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
+    protoEntry->set_address(address);
+    ProtoAccount* protoAccount = protoEntry->mutable_account();
+    protoAccount->set_numbersign(net.m_balance > 0);
+    protoAccount->set_code(net.m_code);
+    protoAccount->set_initdata(net.m_initData);
+    for (const auto& state : net.m_states) {
+      ProtoAccount::StorageData2* protoState = protoAccount->add_storage2();
+      protoState->set_key(state.first);
+      protoState->set_data(state.second);
+    }
+    for (const auto& key : net.m_toDelete) {
+      protoAccount->add_todelete(key);
+    }
+    AccountBaseToProtobuf(net.m_base, *protoAccount->mutable_base());
+  }
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+    return false;
+  }
+
+  dst.clear();
+  return SerializeToArray(result, dst, 0);
+}
+
 bool Messenger::GetMbInfoHash(const std::vector<MicroBlockInfo>& mbInfos,
                               MBInfoHash& dst) {
   bytes tmp;
@@ -2889,7 +3186,8 @@ bool Messenger::GetDSBlockHeader(const string& src, const unsigned int offset,
 
 bool Messenger::SetDSBlock(bytes& dst, const unsigned int offset,
                            const DSBlock& dsBlock) {
-  ProtoDSBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<ProtoDSBlock>();
 
   DSBlockToProtobuf(dsBlock, result);
 
@@ -2909,7 +3207,8 @@ bool Messenger::GetDSBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  ProtoDSBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<ProtoDSBlock>();
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!result.IsInitialized()) {
@@ -2928,7 +3227,8 @@ bool Messenger::GetDSBlock(const string& src, const unsigned int offset,
     return false;
   }
 
-  ProtoDSBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<ProtoDSBlock>();
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!result.IsInitialized()) {
@@ -4226,7 +4526,8 @@ bool Messenger::SetDSDSBlockAnnouncement(
     const MapOfPubKeyPoW& dsWinnerPoWs, bytes& messageToCosign) {
   LOG_MARKER();
 
-  ConsensusAnnouncement announcement;
+  MessageArena arena;
+  auto& announcement = arena.Create<ConsensusAnnouncement>();
 
   // Set the DSBlock announcement parameters
 
@@ -4296,7 +4597,8 @@ bool Messenger::GetDSDSBlockAnnouncement(
     return false;
   }
 
-  ConsensusAnnouncement announcement;
+  MessageArena arena;
+  auto& announcement = arena.Create<ConsensusAnnouncement>();
   announcement.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!announcement.IsInitialized()) {
@@ -4387,7 +4689,8 @@ bool Messenger::SetDSFinalBlockAnnouncement(
     const shared_ptr<MicroBlock>& microBlock, bytes& messageToCosign) {
   LOG_MARKER();
 
-  ConsensusAnnouncement announcement;
+  MessageArena arena;
+  auto& announcement = arena.Create<ConsensusAnnouncement>();
 
   // Set the FinalBlock announcement parameters
 
@@ -4439,7 +4742,8 @@ bool Messenger::GetDSFinalBlockAnnouncement(
     return false;
   }
 
-  ConsensusAnnouncement announcement;
+  MessageArena arena;
+  auto& announcement = arena.Create<ConsensusAnnouncement>();
   announcement.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!announcement.IsInitialized()) {
@@ -4644,7 +4948,8 @@ bool Messenger::SetNodeVCDSBlocksMessage(
     const uint32_t& shardingStructureVersion, const DequeOfShard& shards) {
   LOG_MARKER();
 
-  NodeDSBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<NodeDSBlock>();
 
   result.set_shardid(shardId);
   DSBlockToProtobuf(dsBlock, *result.mutable_dsblock());
@@ -4677,7 +4982,8 @@ bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
     return false;
   }
 
-  NodeDSBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<NodeDSBlock>();
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!result.IsInitialized()) {
@@ -4778,7 +5084,8 @@ bool Messenger::SetNodeFinalBlock(bytes& dst, const unsigned int offset,
                                   const bytes& stateDelta) {
   LOG_MARKER();
 
-  NodeFinalBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<NodeFinalBlock>();
 
   result.set_dsblocknumber(dsBlockNumber);
   result.set_consensusid(consensusID);
@@ -4805,7 +5112,8 @@ bool Messenger::GetNodeFinalBlock(const bytes& src, const unsigned int offset,
     return false;
   }
 
-  NodeFinalBlock result;
+  MessageArena arena;
+  auto& result = arena.Create<NodeFinalBlock>();
   result.ParseFromArray(src.data() + offset, src.size() - offset);
 
   if (!result.IsInitialized()) {
@@ -4984,12 +5292,30 @@ bool Messenger::GetNodeMBnForwardTransaction(const bytes& src,
   unsigned int txnsCount = 0;
 
   for (const auto& txn : result.txnswithreceipt()) {
+    ProtoTransactionWithReceipt protoTxr;
+    protoTxr.ParseFromArray(txn.data().data(), txn.data().size());
+    if (!protoTxr.IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoTransactionWithReceipt initialization failed");
+      return false;
+    }
+
     TransactionWithReceipt txr;
-    PROTOBUFBYTEARRAYTOSERIALIZABLE(txn, txr);
+    if (!ProtobufToTransactionWithReceipt(protoTxr, txr, false)) {
+      LOG_GENERAL(WARNING, "ProtobufToTransactionWithReceipt failed");
+      return false;
+    }
     entry.m_transactions.emplace_back(txr);
     txnsCount++;
   }
 
+  if (!VerifyTransactionSignatures(
+          0, entry.m_transactions.size(),
+          [&entry](size_t index) -> const Transaction& {
+            return entry.m_transactions[index].GetTransaction();
+          })) {
+    return false;
+  }
+
   LOG_GENERAL(INFO, entry << endl << " Txns: " << txnsCount);
 
   return true;
@@ -5212,14 +5538,23 @@ bool Messenger::GetNodeForwardTxnBlock(
       return false;
     }
 
+    const size_t begin = txns.size();
     for (const auto& txn : result.transactions()) {
       Transaction t;
-      if (!ProtobufToTransaction(txn, t)) {
+      if (!ProtobufToTransaction(txn, t, false)) {
         LOG_GENERAL(WARNING, "ProtobufToTransaction failed");
         return false;
       }
       txns.emplace_back(t);
     }
+
+    if (!VerifyTransactionSignatures(
+            begin, txns.size(),
+            [&txns](size_t index) -> const Transaction& {
+              return txns[index];
+            })) {
+      return false;
+    }
   }
 
   LOG_GENERAL(INFO, "Epoch: " << epochNumber << " Shard: " << shardId
@@ -5322,7 +5657,8 @@ bool Messenger::GetNodeMicroBlockAnnouncement(
 bool Messenger::ShardStructureToArray(bytes& dst, const unsigned int offset,
                                       const uint32_t& version,
                                       const DequeOfShard& shards) {
-  ProtoShardingStructure protoShardingStructure;
+  MessageArena arena;
+  auto& protoShardingStructure = arena.Create<ProtoShardingStructure>();
   ShardingStructureToProtobuf(version, shards, protoShardingStructure);
 
   if (!protoShardingStructure.IsInitialized()) {
@@ -5347,7 +5683,8 @@ bool Messenger::ArrayToShardStructure(const bytes& src,
     return false;
   }
 
-  ProtoShardingStructure protoShardingStructure;
+  MessageArena arena;
+  auto& protoShardingStructure = arena.Create<ProtoShardingStructure>();
   protoShardingStructure.ParseFromArray(src.data() + offset,
                                         src.size() - offset);
   return ProtobufToShardingStructure(protoShardingStructure, version, shards);
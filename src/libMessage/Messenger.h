@@ -23,6 +23,7 @@
 #include "common/BaseType.h"
 #include "common/Serializable.h"
 #include "common/TxnStatus.h"
+#include "libData/AccountData/Account.h"
 #include "libData/AccountData/BloomFilter.h"
 #include "libData/AccountData/MBnForwardedTxnEntry.h"
 #include "libData/BlockData/Block.h"
@@ -46,6 +47,20 @@ class ByteArray;
 bool ProtobufByteArrayToSerializable(const ZilliqaMessage::ByteArray& byteArray,
                                      SerializableCrypto& serializable);
 
+/// Entry of a state delta, decoded ahead of applying it to the account
+struct AccountDelta {
+  Address m_address;
+  AccountBase m_base;
+  boost::multiprecision::int256_t m_balanceDelta;
+  /// Empty unless the account is new
+  CodeBytes m_code;
+  CodeBytes m_initData;
+  /// Hash of m_code and m_initData
+  dev::h256 m_codeHash;
+  std::map<std::string, bytes> m_states;
+  std::vector<std::string> m_toDelete;
+};
+
 class Messenger {
  public:
   template <class K, class V>
@@ -107,9 +122,23 @@ class Messenger {
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStore& accountStore,
                                    const bool revertible, bool temp);
+  /// Decodes the entries of a state delta on up to numThreads threads,
+  /// without touching the account store
+  static bool DecodeAccountStoreDelta(const bytes& src,
+                                      const unsigned int offset,
+                                      std::vector<AccountDelta>& deltas,
+                                      unsigned int numThreads);
+  /// Applies the decoded entries in order, as GetAccountStoreDelta does
+  static bool ApplyAccountStoreDelta(const std::vector<AccountDelta>& deltas,
+                                     AccountStore& accountStore,
+                                     const bool revertible, bool temp);
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStoreTemp& accountStoreTemp,
                                    bool temp);
+  /// Merges consecutive state deltas, in order, into one with the same net
+  /// effect on the accounts
+  static bool MergeAccountStoreDeltas(const std::vector<bytes>& stateDeltas,
+                                      bytes& dst);
 
   static bool GetMbInfoHash(const std::vector<MicroBlockInfo>& mbInfos,
                             MBInfoHash& dst);
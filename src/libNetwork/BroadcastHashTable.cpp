@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "BroadcastHashTable.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+BroadcastHashTable::BroadcastHashTable(unsigned int numSlots)
+    : m_numSlots(max(numSlots, 2u)) {
+  for (auto& shard : m_shards) {
+    shard.m_wheel.resize(m_numSlots);
+  }
+}
+
+bool BroadcastHashTable::ToHash(const bytes& src, Hash& hash) {
+  if (src.size() != HASH_SIZE) {
+    LOG_GENERAL(WARNING, "Wrong broadcast hash length " << src.size());
+    return false;
+  }
+  copy(src.begin(), src.end(), hash.begin());
+  return true;
+}
+
+BroadcastHashTable::Shard& BroadcastHashTable::GetShard(const Hash& hash) {
+  // Not the bytes used by HashHasher, to spread each shard over its buckets
+  return m_shards[hash[HASH_SIZE - 1] % NUM_SHARDS];
+}
+
+bool BroadcastHashTable::Insert(const bytes& hash) {
+  Hash key;
+  if (!ToHash(hash, key)) {
+    return false;
+  }
+
+  Shard& shard = GetShard(key);
+  lock_guard<mutex> g(shard.m_mutex);
+  if (!shard.m_hashes.insert(key).second) {
+    return false;
+  }
+  shard.m_wheel[m_currentSlot].emplace_back(key);
+  return true;
+}
+
+bool BroadcastHashTable::Contains(const bytes& hash) {
+  Hash key;
+  if (!ToHash(hash, key)) {
+    return false;
+  }
+
+  Shard& shard = GetShard(key);
+  lock_guard<mutex> g(shard.m_mutex);
+  return shard.m_hashes.find(key) != shard.m_hashes.end();
+}
+
+void BroadcastHashTable::Tick() {
+  // The next slot is emptied before it becomes current, the hashes inserted
+  // meanwhile go to the current one
+  const unsigned int next = (m_currentSlot + 1) % m_numSlots;
+  for (auto& shard : m_shards) {
+    lock_guard<mutex> g(shard.m_mutex);
+    for (const auto& key : shard.m_wheel[next]) {
+      shard.m_hashes.erase(key);
+    }
+    shard.m_wheel[next].clear();
+    shard.m_wheel[next].shrink_to_fit();
+  }
+  m_currentSlot = next;
+}
+
+size_t BroadcastHashTable::Size() {
+  size_t size = 0;
+  for (auto& shard : m_shards) {
+    lock_guard<mutex> g(shard.m_mutex);
+    size += shard.m_hashes.size();
+  }
+  return size;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHTABLE_H_
+#define ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHTABLE_H_
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "common/BaseType.h"
+
+/// Hashes of the broadcast messages recently sent or received, to drop the
+/// copies of a message coming from other peers. The table is split in shards
+/// keyed by the hash. A timing wheel expires the hashes: each tick drops the
+/// hashes inserted one full turn of the wheel earlier.
+class BroadcastHashTable {
+ public:
+  static constexpr unsigned int HASH_SIZE = 32;
+
+  /// A hash stays for numSlots - 1 to numSlots ticks
+  explicit BroadcastHashTable(unsigned int numSlots);
+
+  /// Adds the hash, returns false if it was already there
+  bool Insert(const bytes& hash);
+
+  bool Contains(const bytes& hash);
+
+  /// Moves the wheel to the next slot, dropping the hashes inserted in it
+  void Tick();
+
+  size_t Size();
+
+ private:
+  static constexpr unsigned int NUM_SHARDS = 16;
+
+  using Hash = std::array<unsigned char, HASH_SIZE>;
+
+  /// The hashes are SHA-256 digests, any of their bytes is already uniform
+  struct HashHasher {
+    size_t operator()(const Hash& hash) const {
+      size_t value;
+      std::memcpy(&value, hash.data(), sizeof(value));
+      return value;
+    }
+  };
+
+  struct Shard {
+    std::mutex m_mutex;
+    std::unordered_set<Hash, HashHasher> m_hashes;
+    /// Hashes inserted in each slot of the wheel
+    std::vector<std::vector<Hash>> m_wheel;
+  };
+
+  std::array<Shard, NUM_SHARDS> m_shards;
+  std::atomic<unsigned int> m_currentSlot{0};
+  const unsigned int m_numSlots;
+
+  static bool ToHash(const bytes& src, Hash& hash);
+
+  Shard& GetShard(const Hash& hash);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_BROADCASTHASHTABLE_H_
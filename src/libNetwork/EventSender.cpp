@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <cstring>
+
+#include "EventSender.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+EventSender& EventSender::GetInstance() {
+  static EventSender sender;
+  return sender;
+}
+
+void EventSender::Init(struct event_base* base, ErrorFunc onError) {
+  lock_guard<mutex> g(m_mutex);
+  m_base = base;
+  m_onError = move(onError);
+
+  m_idleTimer = event_new(base, -1, EV_PERSIST, IdleCallback, this);
+  struct timeval tv = {max(P2P_CONNECTION_IDLE_TIMEOUT / 2, 1u), 0};
+  event_add(m_idleTimer, &tv);
+}
+
+void EventSender::Reset() {
+  lock_guard<mutex> g(m_mutex);
+  while (!m_connections.empty()) {
+    Close(*m_connections.begin()->second);
+  }
+  if (m_idleTimer != nullptr) {
+    event_free(m_idleTimer);
+    m_idleTimer = nullptr;
+  }
+  m_base = nullptr;
+}
+
+bool EventSender::IsReady() {
+  lock_guard<mutex> g(m_mutex);
+  return m_base != nullptr;
+}
+
+bool EventSender::Send(const Peer& peer, const vector<Buffer>& message) {
+  lock_guard<mutex> g(m_mutex);
+  if (m_base == nullptr) {
+    m_numDropped++;
+    return false;
+  }
+
+  Connection* conn = GetConnection(peer);
+  if (conn == nullptr) {
+    m_numDropped++;
+    return false;
+  }
+  conn->m_lastUsed = chrono::steady_clock::now();
+
+  struct evbuffer* output = bufferevent_get_output(conn->m_bev);
+  if (conn->m_queue.empty() &&
+      evbuffer_get_length(output) < P2P_SEND_HIGH_WATERMARK_IN_BYTES) {
+    for (const auto& buffer : message) {
+      if (evbuffer_add(output, buffer.first, buffer.second) < 0) {
+        // What was added of the message would corrupt the stream
+        LOG_GENERAL(WARNING, "evbuffer_add failure. IP address: " << peer);
+        m_numDropped++;
+        Close(*conn);
+        return false;
+      }
+    }
+    m_numSent++;
+    return true;
+  }
+
+  if (conn->m_queue.size() >= P2P_SEND_QUEUE_SIZE) {
+    LOG_GENERAL(WARNING, "Send queue full, message dropped. IP address: "
+                             << peer);
+    m_numDropped++;
+    return false;
+  }
+
+  size_t length = 0;
+  for (const auto& buffer : message) {
+    length += buffer.second;
+  }
+  bytes queued;
+  queued.reserve(length);
+  for (const auto& buffer : message) {
+    queued.insert(queued.end(), buffer.first, buffer.first + buffer.second);
+  }
+  conn->m_queuedBytes += length;
+  conn->m_queue.emplace_back(move(queued));
+  m_numQueued++;
+  return true;
+}
+
+EventSender::Connection* EventSender::GetConnection(const Peer& peer) {
+  auto it = m_connections.find(peer);
+  if (it != m_connections.end()) {
+    return it->second.get();
+  }
+
+  // The callbacks run without the lock of the buffer event, as they take
+  // m_mutex that Send holds while writing to it
+  struct bufferevent* bev = bufferevent_socket_new(
+      m_base, -1,
+      BEV_OPT_CLOSE_ON_FREE | BEV_OPT_THREADSAFE | BEV_OPT_DEFER_CALLBACKS |
+          BEV_OPT_UNLOCK_CALLBACKS);
+  if (bev == nullptr) {
+    LOG_GENERAL(WARNING, "bufferevent_socket_new failure.");
+    return nullptr;
+  }
+
+  bufferevent_setcb(bev, ReadCallback, WriteCallback, EventCallback, this);
+  bufferevent_setwatermark(bev, EV_WRITE, P2P_SEND_LOW_WATERMARK_IN_BYTES, 0);
+  // A peer not taking any data for that long is dropped, connecting included
+  struct timeval tv = {SENDJOBPEERS_TIMEOUT, 0};
+  bufferevent_set_timeouts(bev, nullptr, &tv);
+  bufferevent_enable(bev, EV_READ | EV_WRITE);
+
+  struct sockaddr_in serv_addr {};
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+  if (bufferevent_socket_connect(bev, (struct sockaddr*)&serv_addr,
+                                 sizeof(serv_addr)) < 0) {
+    LOG_GENERAL(WARNING, "Socket connect failed. Code = "
+                             << errno << " Desc: " << std::strerror(errno)
+                             << ". IP address: " << peer);
+    bufferevent_free(bev);
+    m_numErrors++;
+    return nullptr;
+  }
+
+  // Messages are written as soon as they are queued
+  int flag = 1;
+  setsockopt(bufferevent_getfd(bev), IPPROTO_TCP, TCP_NODELAY, &flag,
+             sizeof(flag));
+
+  auto conn = make_unique<Connection>();
+  conn->m_peer = peer;
+  conn->m_bev = bev;
+  m_connectionOfBev[bev] = conn.get();
+  return (m_connections[peer] = move(conn)).get();
+}
+
+void EventSender::FillOutput(Connection& conn) {
+  struct evbuffer* output = bufferevent_get_output(conn.m_bev);
+  while (!conn.m_queue.empty() &&
+         evbuffer_get_length(output) < P2P_SEND_HIGH_WATERMARK_IN_BYTES) {
+    const bytes& message = conn.m_queue.front();
+    if (evbuffer_add(output, message.data(), message.size()) < 0) {
+      LOG_GENERAL(WARNING, "evbuffer_add failure. IP address: " << conn.m_peer);
+      Close(conn);
+      return;
+    }
+    conn.m_queuedBytes -= message.size();
+    conn.m_queue.pop_front();
+    m_numSent++;
+  }
+}
+
+void EventSender::Close(Connection& conn) {
+  const Peer peer = conn.m_peer;
+  m_numDropped += conn.m_queue.size();
+  m_connectionOfBev.erase(conn.m_bev);
+  bufferevent_free(conn.m_bev);
+  m_connections.erase(peer);
+}
+
+void EventSender::ReadCallback(struct bufferevent* bev,
+                               [[gnu::unused]] void* ctx) {
+  // Nothing is expected back on these connections
+  struct evbuffer* input = bufferevent_get_input(bev);
+  evbuffer_drain(input, evbuffer_get_length(input));
+}
+
+void EventSender::WriteCallback(struct bufferevent* bev, void* ctx) {
+  EventSender& sender = *static_cast<EventSender*>(ctx);
+  lock_guard<mutex> g(sender.m_mutex);
+  auto it = sender.m_connectionOfBev.find(bev);
+  if (it != sender.m_connectionOfBev.end()) {
+    sender.FillOutput(*it->second);
+  }
+}
+
+void EventSender::EventCallback(struct bufferevent* bev, short events,
+                                void* ctx) {
+  EventSender& sender = *static_cast<EventSender*>(ctx);
+
+  if (events & BEV_EVENT_CONNECTED) {
+    sender.m_numConnects++;
+    return;
+  }
+  if (!(events & (BEV_EVENT_EOF | BEV_EVENT_ERROR | BEV_EVENT_TIMEOUT))) {
+    return;
+  }
+
+  const int error =
+      (events & BEV_EVENT_TIMEOUT) ? ETIMEDOUT : EVUTIL_SOCKET_ERROR();
+  Peer peer;
+  ErrorFunc onError;
+  {
+    lock_guard<mutex> g(sender.m_mutex);
+    auto it = sender.m_connectionOfBev.find(bev);
+    if (it == sender.m_connectionOfBev.end()) {
+      return;
+    }
+    peer = it->second->m_peer;
+    sender.Close(*it->second);
+    onError = sender.m_onError;
+  }
+
+  if (events & BEV_EVENT_EOF) {
+    LOG_GENERAL(INFO, "Connection closed by " << peer);
+    return;
+  }
+
+  sender.m_numErrors++;
+  LOG_GENERAL(WARNING, "Socket error. Code = " << error << " Desc: "
+                                               << std::strerror(error)
+                                               << ". IP address: " << peer);
+  if (onError) {
+    onError(peer, error);
+  }
+}
+
+void EventSender::IdleCallback([[gnu::unused]] evutil_socket_t fd,
+                               [[gnu::unused]] short what, void* ctx) {
+  EventSender& sender = *static_cast<EventSender*>(ctx);
+  const auto expiry = chrono::steady_clock::now() -
+                      chrono::seconds(P2P_CONNECTION_IDLE_TIMEOUT);
+
+  lock_guard<mutex> g(sender.m_mutex);
+  vector<Connection*> idle;
+  for (const auto& entry : sender.m_connections) {
+    const Connection& conn = *entry.second;
+    if (conn.m_lastUsed < expiry && conn.m_queue.empty() &&
+        evbuffer_get_length(bufferevent_get_output(conn.m_bev)) == 0) {
+      idle.emplace_back(entry.second.get());
+    }
+  }
+  for (auto conn : idle) {
+    sender.Close(*conn);
+  }
+}
+
+EventSender::Stats EventSender::GetStats() {
+  Stats stats;
+  stats.m_numSent = m_numSent;
+  stats.m_numQueued = m_numQueued;
+  stats.m_numDropped = m_numDropped;
+  stats.m_numConnects = m_numConnects;
+  stats.m_numErrors = m_numErrors;
+
+  lock_guard<mutex> g(m_mutex);
+  for (const auto& entry : m_connections) {
+    const Connection& conn = *entry.second;
+    PeerStats peerStats;
+    peerStats.m_peer = conn.m_peer;
+    peerStats.m_queueDepth = conn.m_queue.size();
+    peerStats.m_bytesInFlight =
+        conn.m_queuedBytes +
+        evbuffer_get_length(bufferevent_get_output(conn.m_bev));
+    stats.m_peers.emplace_back(peerStats);
+  }
+  return stats;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_EVENTSENDER_H_
+#define ZILLIQA_SRC_LIBNETWORK_EVENTSENDER_H_
+
+#include <event2/util.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Peer.h"
+#include "common/BaseType.h"
+
+struct bufferevent;
+struct event;
+struct event_base;
+
+/// Sends messages to peers from the libevent event base, without blocking the
+/// caller. Each peer has one connection. A message is written to its output
+/// buffer while that holds less than the high watermark, otherwise it waits in
+/// the queue of the peer until the output drains to the low watermark. A slow
+/// or unreachable peer only holds back its own queue.
+class EventSender {
+ public:
+  /// Part of a message to send, the parts are written one after the other
+  using Buffer = std::pair<const unsigned char*, size_t>;
+
+  /// Called from the event base when the connection to a peer fails, with the
+  /// errno of the failure
+  using ErrorFunc = std::function<void(const Peer& peer, int error)>;
+
+  struct PeerStats {
+    Peer m_peer;
+    /// Messages waiting for the output buffer
+    size_t m_queueDepth{0};
+    /// Bytes of the queued messages and in the output buffer
+    size_t m_bytesInFlight{0};
+  };
+
+  struct Stats {
+    uint64_t m_numSent{0};
+    uint64_t m_numQueued{0};
+    uint64_t m_numDropped{0};
+    uint64_t m_numConnects{0};
+    uint64_t m_numErrors{0};
+    std::vector<PeerStats> m_peers;
+  };
+
+  static EventSender& GetInstance();
+
+  /// Starts sending on the event base, which must be dispatched by the caller
+  void Init(struct event_base* base, ErrorFunc onError);
+
+  /// Closes all the connections, to be called before freeing the event base
+  void Reset();
+
+  bool IsReady();
+
+  /// Queues the message to the peer, connecting to it if needed. Returns
+  /// false if the message was dropped.
+  bool Send(const Peer& peer, const std::vector<Buffer>& message);
+
+  Stats GetStats();
+
+ private:
+  struct Connection {
+    Peer m_peer;
+    struct bufferevent* m_bev{nullptr};
+    std::deque<bytes> m_queue;
+    size_t m_queuedBytes{0};
+    std::chrono::steady_clock::time_point m_lastUsed;
+  };
+
+  std::mutex m_mutex;
+  struct event_base* m_base{nullptr};
+  struct event* m_idleTimer{nullptr};
+  ErrorFunc m_onError;
+  std::map<Peer, std::unique_ptr<Connection>> m_connections;
+  /// The callbacks find their connection from the buffer event, which outlives
+  /// the connection while a deferred callback is pending
+  std::unordered_map<struct bufferevent*, Connection*> m_connectionOfBev;
+
+  std::atomic<uint64_t> m_numSent{0};
+  std::atomic<uint64_t> m_numQueued{0};
+  std::atomic<uint64_t> m_numDropped{0};
+  std::atomic<uint64_t> m_numConnects{0};
+  std::atomic<uint64_t> m_numErrors{0};
+
+  EventSender() = default;
+  ~EventSender() = default;
+
+  // Singleton should not implement these
+  EventSender(EventSender const&) = delete;
+  void operator=(EventSender const&) = delete;
+
+  /// Returns the connection to the peer, connecting if there is none
+  Connection* GetConnection(const Peer& peer);
+
+  /// Moves the queued messages to the output buffer up to the high watermark
+  void FillOutput(Connection& conn);
+
+  /// Frees the buffer event and drops the queued messages
+  void Close(Connection& conn);
+
+  static void ReadCallback(struct bufferevent* bev, void* ctx);
+  static void WriteCallback(struct bufferevent* bev, void* ctx);
+  static void EventCallback(struct bufferevent* bev, short events, void* ctx);
+  static void IdleCallback(evutil_socket_t fd, short what, void* ctx);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_EVENTSENDER_H_
@@ -38,7 +38,10 @@
 #include <utility>
 
 #include "Blacklist.h"
+#include "EventSender.h"
 #include "P2PComm.h"
+#include "PeerConnectionPool.h"
+#include "WireCompression.h"
 #include "common/Messages.h"
 #include "libCrypto/Sha2.h"
 #include "libUtils/DataConversion.h"
@@ -55,6 +58,7 @@ const unsigned char START_BYTE_BROADCAST = 0x22;
 const unsigned char START_BYTE_GOSSIP = 0x33;
 const unsigned char START_BYTE_SEED_TO_SEED_REQUEST = 0x44;
 const unsigned char START_BYTE_SEED_TO_SEED_RESPONSE = 0x55;
+const unsigned char START_BYTE_CAPABILITIES = 0x66;
 
 const unsigned int HDR_LEN = 8;
 const unsigned int HASH_LEN = 32;
@@ -82,41 +86,15 @@ static void close_socket(int* cli_sock) {
   }
 }
 
-static bool comparePairSecond(
-    const pair<bytes, chrono::time_point<chrono::system_clock>>& a,
-    const pair<bytes, chrono::time_point<chrono::system_clock>>& b) {
-  return a.second < b.second;
-}
-
-P2PComm::P2PComm() : m_sendQueue(SENDQUEUE_SIZE) {
+P2PComm::P2PComm()
+    : m_broadcastHashes(BROADCAST_EXPIRY / max(BROADCAST_INTERVAL, 1u) + 1),
+      m_sendQueue(SENDQUEUE_SIZE, "SendQueue") {
   // set libevent m_base to NULL
   m_base = NULL;
   auto func = [this]() -> void {
-    bytes emptyHash;
-
     while (true) {
       this_thread::sleep_for(chrono::seconds(BROADCAST_INTERVAL));
-      lock(m_broadcastToRemoveMutex, m_broadcastHashesMutex);
-      lock_guard<mutex> g(m_broadcastToRemoveMutex, adopt_lock);
-      lock_guard<mutex> g2(m_broadcastHashesMutex, adopt_lock);
-
-      if (m_broadcastToRemove.empty() ||
-          m_broadcastToRemove.front().second >
-              chrono::system_clock::now() - chrono::seconds(BROADCAST_EXPIRY)) {
-        continue;
-      }
-
-      auto up = upper_bound(
-          m_broadcastToRemove.begin(), m_broadcastToRemove.end(),
-          make_pair(emptyHash, chrono::system_clock::now() -
-                                   chrono::seconds(BROADCAST_EXPIRY)),
-          comparePairSecond);
-
-      for (auto it = m_broadcastToRemove.begin(); it != up; ++it) {
-        m_broadcastHashes.erase(it->first);
-      }
-
-      m_broadcastToRemove.erase(m_broadcastToRemove.begin(), up);
+      m_broadcastHashes.Tick();
     }
   };
 
@@ -125,7 +103,7 @@ P2PComm::P2PComm() : m_sendQueue(SENDQUEUE_SIZE) {
 
 P2PComm::~P2PComm() {
   SendJob* job = NULL;
-  while (m_sendQueue.pop(job)) {
+  while (m_sendQueue.TryPop(job)) {
     delete job;
   }
   m_base = NULL;
@@ -192,6 +170,41 @@ uint32_t SendJob::writeMsg(const void* buf, int cli_sock, const Peer& from,
   return written_length;
 }
 
+/// Blacklists the peer according to errno, after a failure to connect or
+/// write to it
+static void BlacklistOnSocketError(const Peer& peer) {
+  if (P2PComm::IsHostHavingNetworkIssue()) {
+    if (Blacklist::GetInstance().IsWhitelistedSeed(peer.m_ipAddress)) {
+      LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                               << errno << " (" << std::strerror(errno)
+                               << "). Adding seed "
+                               << peer.GetPrintableIPAddress()
+                               << " as relaxed blacklisted");
+      // Add this seed node to relaxed blacklist even if it is whitelisted
+      // in general.
+      Blacklist::GetInstance().Add(peer.m_ipAddress, false, true);
+    } else {
+      LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                               << errno << " (" << std::strerror(errno)
+                               << "). Adding " << peer.GetPrintableIPAddress()
+                               << " as strictly blacklisted");
+      Blacklist::GetInstance().Add(peer.m_ipAddress);  // strict
+    }
+  } else if (P2PComm::IsNodeNotRunning()) {
+    LOG_GENERAL(WARNING, "[blacklist] Encountered "
+                             << errno << " (" << std::strerror(errno)
+                             << "). Adding " << peer.GetPrintableIPAddress()
+                             << " as relaxed blacklisted");
+    Blacklist::GetInstance().Add(peer.m_ipAddress, false);
+  }
+}
+
+/// Blacklists the peer after the event base failed to send to it
+static void OnSendError(const Peer& peer, int error) {
+  errno = error;
+  BlacklistOnSocketError(peer);
+}
+
 bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
                                     unsigned char start_byte,
                                     const bytes& msg_hash) {
@@ -209,6 +222,77 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
     return true;
   }
 
+  // Transmission format:
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
+  // 0x11 - start byte
+  // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
+  // <message>
+
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
+  // 0x22 - start byte (broadcast)
+  // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
+  // <32-byte hash> <message>
+
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
+  // 0x33 - start byte (report)
+  // 0x00 0x00 0x00 0x01 - 4-byte length of message
+  // 0x00
+  uint32_t length = message.size();
+
+  // A compressed broadcast still carries the hash of its original body
+  const bool isBroadcast =
+      (start_byte & ~START_BYTE_COMPRESSED) == START_BYTE_BROADCAST;
+  if (isBroadcast) {
+    length += HASH_LEN;
+  }
+
+  unsigned char buf[HDR_LEN] = {(unsigned char)(MSG_VERSION & 0xFF),
+                                (unsigned char)((NETWORK_ID >> 8) & 0XFF),
+                                (unsigned char)(NETWORK_ID & 0xFF),
+                                start_byte,
+                                (unsigned char)((length >> 24) & 0xFF),
+                                (unsigned char)((length >> 16) & 0xFF),
+                                (unsigned char)((length >> 8) & 0xFF),
+                                (unsigned char)(length & 0xFF)};
+
+  if (ENABLE_P2P_EVENT_SEND || ENABLE_P2P_CONNECTION_POOL) {
+    // The messages to a peer follow each other on its connection, each one
+    // delimited by the length in its header
+    vector<PeerConnectionPool::Buffer> parts{{buf, HDR_LEN}};
+    if (isBroadcast) {
+      if (msg_hash.size() != HASH_LEN) {
+        LOG_GENERAL(WARNING, "Wrong message hash length.");
+        return true;
+      }
+      parts.emplace_back(msg_hash.data(), HASH_LEN);
+    }
+    parts.emplace_back(message.data(), message.size());
+
+    if (ENABLE_P2P_EVENT_SEND && EventSender::GetInstance().IsReady()) {
+      // Failures are reported later from the event base. A message dropped
+      // for a full queue is not retried, its peer is not keeping up.
+      EventSender::GetInstance().Send(peer, parts);
+      return true;
+    }
+
+    if (ENABLE_P2P_CONNECTION_POOL) {
+      int error = 0;
+      switch (PeerConnectionPool::GetInstance().Send(peer, parts, error)) {
+        case PeerConnectionPool::SENT:
+          return true;
+        case PeerConnectionPool::IN_BACKOFF:
+          return false;
+        default:
+          errno = error;
+          BlacklistOnSocketError(peer);
+          return false;
+      }
+    }
+  }
+
   try {
     int cli_sock = socket(AF_INET, SOCK_STREAM, 0);
     unique_ptr<int, void (*)(int*)> cli_sock_closer(&cli_sock, close_socket);
@@ -235,66 +319,9 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
       LOG_GENERAL(WARNING, "Socket connect failed. Code = "
                                << errno << " Desc: " << std::strerror(errno)
                                << ". IP address: " << peer);
-      if (P2PComm::IsHostHavingNetworkIssue()) {
-        if (Blacklist::GetInstance().IsWhitelistedSeed(peer.m_ipAddress)) {
-          LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                                   << errno << " (" << std::strerror(errno)
-                                   << "). Adding seed "
-                                   << peer.GetPrintableIPAddress()
-                                   << " as relaxed blacklisted");
-          // Add this seed node to relaxed blacklist even if it is whitelisted
-          // in general.
-          Blacklist::GetInstance().Add(peer.m_ipAddress, false, true);
-        } else {
-          LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                                   << errno << " (" << std::strerror(errno)
-                                   << "). Adding "
-                                   << peer.GetPrintableIPAddress()
-                                   << " as strictly blacklisted");
-          Blacklist::GetInstance().Add(peer.m_ipAddress);  // strict
-        }
-      } else if (P2PComm::IsNodeNotRunning()) {
-        LOG_GENERAL(WARNING, "[blacklist] Encountered "
-                                 << errno << " (" << std::strerror(errno)
-                                 << "). Adding " << peer.GetPrintableIPAddress()
-                                 << " as relaxed blacklisted");
-        Blacklist::GetInstance().Add(peer.m_ipAddress, false);
-      }
-
+      BlacklistOnSocketError(peer);
       return false;
     }
-    // Transmission format:
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
-    // 0x11 - start byte
-    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
-    // <message>
-
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
-    // 0x22 - start byte (broadcast)
-    // 0xLL 0xLL 0xLL 0xLL - 4-byte length of hash + message
-    // <32-byte hash> <message>
-
-    // 0x01 ~ 0xFF - version, defined in constant file
-    // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
-    // 0x33 - start byte (report)
-    // 0x00 0x00 0x00 0x01 - 4-byte length of message
-    // 0x00
-    uint32_t length = message.size();
-
-    if (start_byte == START_BYTE_BROADCAST) {
-      length += HASH_LEN;
-    }
-
-    unsigned char buf[HDR_LEN] = {(unsigned char)(MSG_VERSION & 0xFF),
-                                  (unsigned char)((NETWORK_ID >> 8) & 0XFF),
-                                  (unsigned char)(NETWORK_ID & 0xFF),
-                                  start_byte,
-                                  (unsigned char)((length >> 24) & 0xFF),
-                                  (unsigned char)((length >> 16) & 0xFF),
-                                  (unsigned char)((length >> 8) & 0xFF),
-                                  (unsigned char)(length & 0xFF)};
 
     uint32_t written = writeMsg(buf, cli_sock, peer, HDR_LEN);
     if (HDR_LEN != written) {
@@ -302,7 +329,7 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
       return true;
     }
 
-    if (start_byte != START_BYTE_BROADCAST) {
+    if (!isBroadcast) {
       writeMsg(&message.at(0), cli_sock, peer, length);
       return true;
     }
@@ -343,13 +370,37 @@ void SendJob::SendMessageCore(const Peer& peer, const bytes& message,
   }
 }
 
+void SendJob::SendToPeer(const Peer& peer) {
+  if (m_compressible &&
+      WireCompression::IsCompressible(m_message, m_startbyte)) {
+    bool probe = false;
+    const bool capable = WireCompression::IsCapable(peer, probe);
+    if (probe) {
+      P2PComm::GetInstance().SendCapabilities(peer, false);
+    }
+
+    if (capable) {
+      if (m_compressed.empty() &&
+          !WireCompression::Compress(m_message, m_startbyte, m_compressed)) {
+        m_compressible = false;
+      } else {
+        SendMessageCore(peer, m_compressed,
+                        m_startbyte | START_BYTE_COMPRESSED, m_hash);
+        return;
+      }
+    }
+  }
+
+  SendMessageCore(peer, m_message, m_startbyte, m_hash);
+}
+
 void SendJobPeer::DoSend() {
   if (Blacklist::GetInstance().Exist(m_peer.m_ipAddress)) {
     LOG_GENERAL(INFO, m_peer << " is blacklisted - blocking all messages");
     return;
   }
 
-  SendMessageCore(m_peer, m_message, m_startbyte, m_hash);
+  SendToPeer(m_peer);
 }
 
 template <class T>
@@ -361,8 +412,10 @@ void SendJobPeers<T>::DoSend() {
   }
   random_shuffle(indexes.begin(), indexes.end());
 
+  const bool logBroadcast =
+      (m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer());
   string hashStr;
-  if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer())) {
+  if (logBroadcast) {
     if (!DataConversion::Uint8VecToHexStr(m_hash, hashStr)) {
       return;
     }
@@ -382,10 +435,10 @@ void SendJobPeers<T>::DoSend() {
       continue;
     }
 
-    SendMessageCore(peer, m_message, m_startbyte, m_hash);
+    SendToPeer(peer);
   }
 
-  if ((m_startbyte == START_BYTE_BROADCAST) && (m_selfPeer != Peer())) {
+  if (logBroadcast) {
     LOG_STATE("[BROAD][" << std::setw(15) << std::left
                          << m_selfPeer.GetPrintableIPAddress() << "]["
                          << hashStr.substr(0, 6) << "] DONE");
@@ -393,6 +446,13 @@ void SendJobPeers<T>::DoSend() {
 }
 
 void P2PComm::ProcessSendJob(SendJob* job) {
+  if (ENABLE_P2P_EVENT_SEND && EventSender::GetInstance().IsReady()) {
+    // Only queues the messages, the event base writes them
+    job->DoSend();
+    delete job;
+    return;
+  }
+
   auto funcSendMsg = [job]() mutable -> void {
     job->DoSend();
     delete job;
@@ -400,48 +460,36 @@ void P2PComm::ProcessSendJob(SendJob* job) {
   m_SendPool.AddJob(funcSendMsg);
 }
 
-void P2PComm::ClearBroadcastHashAsync(const bytes& message_hash) {
-  LOG_MARKER();
-  lock_guard<mutex> guard(m_broadcastToRemoveMutex);
-  m_broadcastToRemove.emplace_back(message_hash, chrono::system_clock::now());
-}
-
-void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
-  bytes msg_hash(message.begin() + HDR_LEN,
-                 message.begin() + HDR_LEN + HASH_LEN);
+void P2PComm::ProcessBroadCastMsg(InboundMessage& message,
+                                  const Peer& from) {
+  const bytes& msg_hash = message.m_hash;
 
   P2PComm& p2p = P2PComm::GetInstance();
 
   // Check if this message has been received before
-  bool found = false;
-  {
-    lock_guard<mutex> guard(p2p.m_broadcastHashesMutex);
-
-    found =
-        (p2p.m_broadcastHashes.find(msg_hash) != p2p.m_broadcastHashes.end());
-    // While we have the lock, we should quickly add the hash
-    if (!found) {
-      SHA2<HashType::HASH_VARIANT_256> sha256;
-      sha256.Update(message, HDR_LEN + HASH_LEN,
-                    message.size() - HDR_LEN - HASH_LEN);
-      bytes this_msg_hash = sha256.Finalize();
-
-      if (this_msg_hash == msg_hash) {
-        p2p.m_broadcastHashes.insert(this_msg_hash);
-      } else {
-        LOG_GENERAL(WARNING, "Incorrect message hash.");
-        return;
-      }
-    }
-  }
-
-  if (found) {
+  if (p2p.m_broadcastHashes.Contains(msg_hash)) {
     // We already sent and/or received this message before -> discard
     LOG_GENERAL(INFO, "Discarding duplicate");
     return;
   }
 
-  p2p.ClearBroadcastHashAsync(msg_hash);
+  // Only the first copy is decompressed, the hash being of the original
+  if (!DecompressBody(message, from)) {
+    return;
+  }
+
+  SHA2<HashType::HASH_VARIANT_256> sha256;
+  sha256.Update(message.m_body);
+  if (sha256.Finalize() != msg_hash) {
+    LOG_GENERAL(WARNING, "Incorrect message hash.");
+    return;
+  }
+
+  // Another copy may have been verified meanwhile
+  if (!p2p.m_broadcastHashes.Insert(msg_hash)) {
+    LOG_GENERAL(INFO, "Discarding duplicate");
+    return;
+  }
 
   string msgHashStr;
   if (!DataConversion::Uint8VecToHexStr(msg_hash, msgHashStr)) {
@@ -451,34 +499,32 @@ void P2PComm::ProcessBroadCastMsg(bytes& message, const Peer& from) {
   LOG_STATE("[BROAD][" << std::setw(15) << std::left << p2p.m_selfPeer << "]["
                        << msgHashStr.substr(0, 6) << "] RECV");
 
-  // Move the shared_ptr message to raw pointer type
+  // The body goes on to the dispatcher as is
   pair<bytes, std::pair<Peer, const unsigned char>>* raw_message =
       new pair<bytes, std::pair<Peer, const unsigned char>>(
-          bytes(message.begin() + HDR_LEN + HASH_LEN, message.end()),
-          std::make_pair(from, START_BYTE_BROADCAST));
+          move(message.m_body), std::make_pair(from, START_BYTE_BROADCAST));
 
   // Queue the message
   m_dispatcher(raw_message);
 }
 
-/*static*/ void P2PComm::ProcessGossipMsg(bytes& message, Peer& from) {
-  unsigned char gossipMsgTyp = message.at(HDR_LEN);
+/*static*/ void P2PComm::ProcessGossipMsg(const bytes& message, Peer& from) {
+  unsigned char gossipMsgTyp = message.at(0);
 
-  const uint32_t gossipMsgRound =
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN) << 24) +
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + 1) << 16) +
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + 2) << 8) +
-      message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + 3);
+  const uint32_t gossipMsgRound = (message.at(GOSSIP_MSGTYPE_LEN) << 24) +
+                                  (message.at(GOSSIP_MSGTYPE_LEN + 1) << 16) +
+                                  (message.at(GOSSIP_MSGTYPE_LEN + 2) << 8) +
+                                  message.at(GOSSIP_MSGTYPE_LEN + 3);
 
   const uint32_t gossipSenderPort =
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN) << 24) +
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 1) << 16) +
-      (message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 2) << 8) +
-      message.at(HDR_LEN + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 3);
+      (message.at(GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN) << 24) +
+      (message.at(GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 1) << 16) +
+      (message.at(GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 2) << 8) +
+      message.at(GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + 3);
   from.m_listenPortHost = gossipSenderPort;
 
   RumorManager::RawBytes rumor_message(
-      message.begin() + HDR_LEN + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN +
+      message.begin() + GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN +
           GOSSIP_SNDR_LISTNR_PORT_LEN,
       message.end());
 
@@ -615,11 +661,7 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
   }
 
   // Get the IP info
-  int fd = bufferevent_getfd(bev);
-  struct sockaddr_in cli_addr {};
-  socklen_t addr_size = sizeof(struct sockaddr_in);
-  getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-  Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+  Peer from = GetPeerOfBufferEvent(bev);
 
   // Get the data stored in buffer
   struct evbuffer* input = bufferevent_get_input(bev);
@@ -627,22 +669,110 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
     LOG_GENERAL(WARNING, "bufferevent_get_input failure.");
     return;
   }
-  size_t len = evbuffer_get_length(input);
-  if (len == 0) {
-    LOG_GENERAL(WARNING, "evbuffer_get_length failure.");
+  if (!ProcessBufferedMessages(input, from)) {
     return;
   }
-  bytes message(len);
-  if (evbuffer_copyout(input, message.data(), len) !=
-      static_cast<ev_ssize_t>(len)) {
+
+  // The messages are processed as soon as they are read, anything left is an
+  // incomplete one
+  size_t len = evbuffer_get_length(input);
+  if (len > 0) {
+    LOG_GENERAL(WARNING, "Dropping incomplete message of "
+                             << len << " bytes from " << from);
+  }
+}
+
+Peer P2PComm::GetPeerOfBufferEvent(struct bufferevent* bev) {
+  int fd = bufferevent_getfd(bev);
+  struct sockaddr_in cli_addr {};
+  socklen_t addr_size = sizeof(struct sockaddr_in);
+  getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
+  return Peer(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+}
+
+P2PComm::ReadResult P2PComm::ReadMessage(struct evbuffer* input,
+                                         InboundMessage& message) {
+  const size_t len = evbuffer_get_length(input);
+  if (len < HDR_LEN) {
+    return READ_INCOMPLETE;
+  }
+
+  unsigned char header[HDR_LEN];
+  if (evbuffer_copyout(input, header, HDR_LEN) !=
+      static_cast<ev_ssize_t>(HDR_LEN)) {
     LOG_GENERAL(WARNING, "evbuffer_copyout failure.");
-    return;
+    return READ_INVALID;
   }
-  if (evbuffer_drain(input, len) != 0) {
+
+  // Without a valid header the next message cannot be found
+  const uint16_t networkid = (header[1] << 8) + header[2];
+  if (header[0] != (unsigned char)(MSG_VERSION & 0xFF) ||
+      networkid != NETWORK_ID) {
+    LOG_GENERAL(WARNING, "Header version or networkid wrong, received ["
+                             << header[0] - 0x00 << ", " << networkid << "]");
+    return READ_INVALID;
+  }
+
+  const uint32_t messageLength =
+      ((uint32_t)header[4] << 24) + ((uint32_t)header[5] << 16) +
+      ((uint32_t)header[6] << 8) + header[7];
+  // Such a message would never fit in the read buffer of the connection
+  if (messageLength > MAX_READ_WATERMARK_IN_BYTES) {
+    LOG_GENERAL(WARNING, "Message length " << messageLength
+                                           << " over the limit of "
+                                           << MAX_READ_WATERMARK_IN_BYTES);
+    return READ_INVALID;
+  }
+  if (len - HDR_LEN < messageLength) {
+    return READ_INCOMPLETE;
+  }
+  if (evbuffer_drain(input, HDR_LEN) != 0) {
     LOG_GENERAL(WARNING, "evbuffer_drain failure.");
-    return;
+    return READ_INVALID;
+  }
+
+  message.m_startByte = header[3] & ~START_BYTE_COMPRESSED;
+  message.m_compressed = (header[3] & START_BYTE_COMPRESSED) != 0;
+  size_t bodyLength = messageLength;
+  message.m_hash.clear();
+  if (message.m_startByte == START_BYTE_BROADCAST && bodyLength > HASH_LEN) {
+    message.m_hash.resize(HASH_LEN);
+    if (evbuffer_remove(input, message.m_hash.data(), HASH_LEN) !=
+        static_cast<ev_ssize_t>(HASH_LEN)) {
+      LOG_GENERAL(WARNING, "evbuffer_remove failure.");
+      return READ_INVALID;
+    }
+    bodyLength -= HASH_LEN;
+  }
+
+  // The body gets its own buffer, so that the handlers can be given it
+  // without slicing off the header
+  message.m_body = bytes(bodyLength);
+  if (evbuffer_remove(input, message.m_body.data(), bodyLength) !=
+      static_cast<ev_ssize_t>(bodyLength)) {
+    LOG_GENERAL(WARNING, "evbuffer_remove failure.");
+    return READ_INVALID;
   }
+  return READ_OK;
+}
+
+bool P2PComm::ProcessBufferedMessages(struct evbuffer* input,
+                                      const Peer& from) {
+  // Several messages can follow each other on a connection, each one
+  // delimited by the length in its header
+  InboundMessage message;
+  ReadResult result;
+  while ((result = ReadMessage(input, message)) == READ_OK) {
+    ProcessMessage(message, from);
+  }
+  if (result == READ_INVALID) {
+    LOG_GENERAL(WARNING, "Closing the connection from " << from);
+    return false;
+  }
+  return true;
+}
 
+void P2PComm::ProcessMessage(InboundMessage& message, Peer from) {
   // Reception format:
   // 0x01 ~ 0xFF - version, defined in constant file
   // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
@@ -669,80 +799,62 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
   // 0x00 0x00 0x00 0x01 - 4-byte length of message
   // 0x00
 
-  // Check for minimum message size
-  if (message.size() <= HDR_LEN) {
+  // 0x01 ~ 0xFF - version, defined in constant file
+  // 0xLL 0xLL - 2-byte NETWORK_ID, defined in constant file
+  // 0x66 - start byte (capabilities)
+  // 0xLL 0xLL 0xLL 0xLL - 4-byte length of message
+  // <capability bits> <reply flag> <4-byte listen port>
+
+  // The header, and the hash of a broadcast, are already split off by
+  // ReadMessage
+  if (message.m_body.empty()) {
     LOG_GENERAL(WARNING, "Empty message received.");
     return;
   }
 
-  const unsigned char version = message[0];
-
-  // Check for version requirement
-  if (version != (unsigned char)(MSG_VERSION & 0xFF)) {
-    LOG_GENERAL(WARNING, "Header version wrong, received ["
-                             << version - 0x00 << "] while expected ["
-                             << MSG_VERSION << "].");
-    return;
-  }
+  const unsigned char startByte = message.m_startByte;
 
-  const uint16_t networkid = (message[1] << 8) + message[2];
-  if (networkid != NETWORK_ID) {
-    LOG_GENERAL(WARNING, "Header networkid wrong, received ["
-                             << networkid << "] while expected [" << NETWORK_ID
-                             << "].");
+  if (message.m_compressed && startByte != START_BYTE_BROADCAST &&
+      startByte != START_BYTE_NORMAL) {
+    LOG_GENERAL(WARNING, "Compressed message with start byte "
+                             << (int)startByte << " from " << from);
     return;
   }
 
-  const unsigned char startByte = message[3];
-
-  const uint32_t messageLength =
-      (message[4] << 24) + (message[5] << 16) + (message[6] << 8) + message[7];
-
-  {
-    // Check for length consistency
-    uint32_t res;
-
-    if (!SafeMath<uint32_t>::sub(message.size(), HDR_LEN, res)) {
-      LOG_GENERAL(WARNING, "Unexpected subtraction operation!");
-      return;
-    }
-
-    if (messageLength != res) {
-      LOG_GENERAL(WARNING, "Incorrect message length.");
-      return;
-    }
-  }
-
   if (startByte == START_BYTE_BROADCAST) {
-    LOG_PAYLOAD(INFO, "Incoming broadcast " << from, message,
+    LOG_PAYLOAD(INFO, "Incoming broadcast " << from, message.m_body,
                 Logger::MAX_BYTES_TO_DISPLAY);
 
-    if (messageLength <= HASH_LEN) {
+    if (message.m_hash.empty()) {
       LOG_GENERAL(WARNING,
                   "Hash missing or empty broadcast message (messageLength = "
-                      << messageLength << ")");
+                      << message.m_body.size() << ")");
       return;
     }
 
     ProcessBroadCastMsg(message, from);
   } else if (startByte == START_BYTE_NORMAL) {
-    LOG_PAYLOAD(INFO, "Incoming normal " << from, message,
+    if (!DecompressBody(message, from)) {
+      return;
+    }
+
+    LOG_PAYLOAD(INFO, "Incoming normal " << from, message.m_body,
                 Logger::MAX_BYTES_TO_DISPLAY);
 
-    // Move the shared_ptr message to raw pointer type
+    // The body goes on to the dispatcher as is
     pair<bytes, std::pair<Peer, const unsigned char>>* raw_message =
         new pair<bytes, std::pair<Peer, const unsigned char>>(
-            bytes(message.begin() + HDR_LEN, message.end()),
-            std::make_pair(from, START_BYTE_NORMAL));
+            move(message.m_body), std::make_pair(from, START_BYTE_NORMAL));
 
     // Queue the message
     m_dispatcher(raw_message);
   } else if (startByte == START_BYTE_GOSSIP) {
     // Check for the maximum gossiped-message size
-    if (message.size() >= MAX_GOSSIP_MSG_SIZE_IN_BYTES) {
+    if (HDR_LEN + message.m_body.size() >= MAX_GOSSIP_MSG_SIZE_IN_BYTES) {
       LOG_GENERAL(WARNING,
                   "Gossip message received [Size:"
-                      << message.size() << "] is unexpectedly large [ >"
+                      << HDR_LEN + message.m_body.size()
+                      << "] is unexpectedly large [ >"
                       << MAX_GOSSIP_MSG_SIZE_IN_BYTES
                       << " ]. Will be strictly blacklisting the sender");
       Blacklist::GetInstance().Add(
@@ -750,23 +862,60 @@ void P2PComm::EventCallback(struct bufferevent* bev, short events,
                               // sender as well.
       return;
     }
-    if (messageLength <
+    if (message.m_body.size() <
         GOSSIP_MSGTYPE_LEN + GOSSIP_ROUND_LEN + GOSSIP_SNDR_LISTNR_PORT_LEN) {
       LOG_GENERAL(
           WARNING,
           "Gossip Msg Type and/or Gossip Round and/or SNDR LISTNR is missing "
           "(messageLength = "
-              << messageLength << ")");
+              << message.m_body.size() << ")");
       return;
     }
 
-    ProcessGossipMsg(message, from);
+    ProcessGossipMsg(message.m_body, from);
+  } else if (startByte == START_BYTE_CAPABILITIES) {
+    ProcessCapabilities(message.m_body, from);
   } else {
     // Unexpected start byte. Drop this message
     LOG_GENERAL(WARNING, "Incorrect start byte.");
   }
 }
 
+bool P2PComm::DecompressBody(InboundMessage& message, const Peer& from) {
+  if (!message.m_compressed) {
+    return true;
+  }
+
+  bytes body;
+  if (!WireCompression::Decompress(message.m_body, body)) {
+    LOG_GENERAL(WARNING, "Dropping compressed message from " << from);
+    return false;
+  }
+  message.m_body = move(body);
+  message.m_compressed = false;
+  return true;
+}
+
+void P2PComm::ProcessCapabilities(const bytes& body, const Peer& from) {
+  unsigned char capabilities = 0;
+  bool reply = false;
+  uint32_t listenPort = 0;
+  if (!WireCompression::ParseAnnouncement(body, capabilities, reply,
+                                          listenPort)) {
+    LOG_GENERAL(WARNING, "Invalid capabilities from " << from);
+    return;
+  }
+
+  // The connection comes from an ephemeral port, the peer is known by the
+  // one it listens on
+  const Peer peer(from.m_ipAddress, listenPort);
+  LOG_GENERAL(DEBUG, "Capabilities " << (int)capabilities << " from " << peer);
+  WireCompression::SetCapabilities(peer, capabilities);
+  if (!reply) {
+    GetInstance().SendCapabilities(peer, true);
+  }
+}
+
 void P2PComm::EventCbServerSeed(struct bufferevent* bev, short events,
                                 [[gnu::unused]] void* ctx) {
   int fd = bufferevent_getfd(bev);
@@ -810,11 +959,7 @@ void P2PComm::ReadCallback(struct bufferevent* bev, [[gnu::unused]] void* ctx) {
   size_t len = evbuffer_get_length(input);
   if (len >= MAX_READ_WATERMARK_IN_BYTES) {
     // Get the IP info
-    int fd = bufferevent_getfd(bev);
-    struct sockaddr_in cli_addr {};
-    socklen_t addr_size = sizeof(struct sockaddr_in);
-    getpeername(fd, (struct sockaddr*)&cli_addr, &addr_size);
-    Peer from(cli_addr.sin_addr.s_addr, cli_addr.sin_port);
+    Peer from = GetPeerOfBufferEvent(bev);
     LOG_GENERAL(WARNING, "[blacklist] Encountered data of size: "
                              << len << " being received."
                              << " Adding sending node "
@@ -822,6 +967,15 @@ void P2PComm::ReadCallback(struct bufferevent* bev, [[gnu::unused]] void* ctx) {
                              << " as strictly blacklisted");
     Blacklist::GetInstance().Add(from.m_ipAddress);
     bufferevent_free(bev);
+    return;
+  }
+
+  if (len < HDR_LEN) {
+    return;
+  }
+
+  if (!ProcessBufferedMessages(input, GetPeerOfBufferEvent(bev))) {
+    CloseAndFreeBufferEvent(bev);
   }
 }
 
@@ -926,9 +1080,11 @@ void P2PComm::ReadCbServerSeed(struct bufferevent* bev,
     LOG_PAYLOAD(INFO, "Incoming request from ext seed " << from, message,
                 Logger::MAX_BYTES_TO_DISPLAY);
 
+    // Drops the header in place rather than copying the body out
+    message.erase(message.begin(), message.begin() + HDR_LEN);
     pair<bytes, pair<Peer, const unsigned char>>* raw_message =
         new pair<bytes, pair<Peer, const unsigned char>>(
-            bytes(message.begin() + HDR_LEN, message.end()),
+            move(message),
             std::make_pair(from, START_BYTE_SEED_TO_SEED_REQUEST));
 
     string bufKey = from.GetPrintableIPAddress() + ":" +
@@ -1221,10 +1377,10 @@ void P2PComm ::ReadCbClientSeed(struct bufferevent* bev, void* ctx) {
     LOG_PAYLOAD(INFO, "Incoming normal response from server seed " << from,
                 message, Logger::MAX_BYTES_TO_DISPLAY);
 
+    message.erase(message.begin(), message.begin() + HDR_LEN);
     pair<bytes, std::pair<Peer, const unsigned char>>* raw_message =
         new pair<bytes, std::pair<Peer, const unsigned char>>(
-            bytes(message.begin() + HDR_LEN, message.end()),
-            make_pair(from, START_BYTE_SEED_TO_SEED_RESPONSE));
+            move(message), make_pair(from, START_BYTE_SEED_TO_SEED_RESPONSE));
 
     // Queue the message
     m_dispatcher(raw_message);
@@ -1309,10 +1465,8 @@ void P2PComm::StartMessagePump(Dispatcher dispatcher) {
   auto funcCheckSendQueue = [this]() mutable -> void {
     SendJob* job = NULL;
     while (true) {
-      while (m_sendQueue.pop(job)) {
-        ProcessSendJob(job);
-      }
-      std::this_thread::sleep_for(std::chrono::microseconds(1));
+      m_sendQueue.Pop(job);
+      ProcessSendJob(job);
     }
   };
   DetachedFunction(1, funcCheckSendQueue);
@@ -1371,7 +1525,9 @@ void P2PComm::EnableListener(uint32_t listenPort, bool startSeedNodeListener) {
       return;
     }
   }
+  EventSender::GetInstance().Init(m_base, OnSendError);
   event_base_dispatch(m_base);
+  EventSender::GetInstance().Reset();
   evconnlistener_free(listener1);
   if (listener2 != NULL) {
     evconnlistener_free(listener2);
@@ -1392,6 +1548,7 @@ void P2PComm::EnableConnect() {
   */
   evthread_use_pthreads();
   m_base = event_base_new();
+  EventSender::GetInstance().Init(m_base, OnSendError);
   event* e =
       event_new(m_base, -1, EV_TIMEOUT | EV_PERSIST, DummyTimeoutEvent, NULL);
   timeval twoSec = {2, 0};
@@ -1517,7 +1674,7 @@ void P2PComm::SendMessage(const vector<Peer>& peers, const bytes& message,
   job->m_allowSendToRelaxedBlacklist = false;
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
@@ -1541,7 +1698,7 @@ void P2PComm::SendMessage(const deque<Peer>& peers, const bytes& message,
   job->m_allowSendToRelaxedBlacklist = bAllowSendToRelaxedBlacklist;
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
@@ -1559,7 +1716,7 @@ void P2PComm::SendMessage(const Peer& peer, const bytes& message,
   job->m_allowSendToRelaxedBlacklist = false;
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
@@ -1586,7 +1743,7 @@ void P2PComm::SendMessage(const Peer& peer, const Peer& fromPeer,
   job->m_allowSendToRelaxedBlacklist = false;
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
@@ -1612,16 +1769,13 @@ void P2PComm::SendBroadcastMessage(const vector<Peer>& peers,
   job->m_hash = sha256.Finalize();
   job->m_allowSendToRelaxedBlacklist = false;
 
-  bytes hashCopy(job->m_hash);
+  m_broadcastHashes.Insert(job->m_hash);
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
-
-  lock_guard<mutex> guard(m_broadcastHashesMutex);
-  m_broadcastHashes.insert(hashCopy);
 }
 
 void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
@@ -1644,16 +1798,13 @@ void P2PComm::SendBroadcastMessage(const deque<Peer>& peers,
   job->m_hash = sha256.Finalize();
   job->m_allowSendToRelaxedBlacklist = false;
 
-  bytes hashCopy(job->m_hash);
+  m_broadcastHashes.Insert(job->m_hash);
 
   // Queue job
-  if (!m_sendQueue.bounded_push(job)) {
+  if (!m_sendQueue.Push(job)) {
     LOG_GENERAL(WARNING, "SendQueue is full");
     delete job;
   }
-
-  lock_guard<mutex> guard(m_broadcastHashesMutex);
-  m_broadcastHashes.insert(hashCopy);
 }
 
 void P2PComm::SendMessageNoQueue(const Peer& peer, const bytes& message,
@@ -1670,6 +1821,20 @@ void P2PComm::SendMessageNoQueue(const Peer& peer, const bytes& message,
   SendJob::SendMessageCore(peer, message, startByteType, {});
 }
 
+void P2PComm::SendCapabilities(const Peer& peer, bool reply) {
+  if (m_selfPeer.m_listenPortHost == 0) {
+    // Without a listen port to answer to, the peer could not reply
+    return;
+  }
+
+  // On a connection of its own, as older nodes read a single message from
+  // each connection
+  SendMessage(peer,
+              WireCompression::MakeAnnouncement(reply,
+                                                m_selfPeer.m_listenPortHost),
+              START_BYTE_CAPABILITIES);
+}
+
 bool P2PComm::SpreadRumor(const bytes& message) {
   LOG_MARKER();
   return m_rumorManager.AddRumor(message);
@@ -19,26 +19,30 @@
 #define ZILLIQA_SRC_LIBNETWORK_P2PCOMM_H_
 
 #include <event2/util.h>
-#include <boost/lockfree/queue.hpp>
 #include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
 #include <vector>
 
+#include "BroadcastHashTable.h"
 #include "Peer.h"
 #include "RumorManager.h"
 #include "common/BaseType.h"
 #include "common/Constants.h"
+#include "libUtils/BlockingQueue.h"
 #include "libUtils/Logger.h"
 #include "libUtils/ThreadPool.h"
 
+struct evbuffer;
 struct evconnlistener;
 
 extern const unsigned char START_BYTE_NORMAL;
+extern const unsigned char START_BYTE_BROADCAST;
 extern const unsigned char START_BYTE_GOSSIP;
 extern const unsigned char START_BYTE_SEED_TO_SEED_REQUEST;
 extern const unsigned char START_BYTE_SEED_TO_SEED_RESPONSE;
+extern const unsigned char START_BYTE_CAPABILITIES;
 
 class SendJob {
  protected:
@@ -47,6 +51,14 @@ class SendJob {
   static bool SendMessageSocketCore(const Peer& peer, const bytes& message,
                                     unsigned char start_byte,
                                     const bytes& msg_hash);
+  /// Sends the message to the peer, compressed if the peer reads compressed
+  /// bodies. It is compressed once for all the peers it is sent to.
+  void SendToPeer(const Peer& peer);
+
+  /// Compressed form of m_message, made for the first peer reading it
+  bytes m_compressed;
+  /// Cleared once the message turned out not to shrink
+  bool m_compressible{true};
 
  public:
   Peer m_selfPeer;
@@ -77,19 +89,35 @@ class SendJobPeers : public SendJob {
 
 /// Provides network layer functionality.
 class P2PComm {
-  std::set<bytes> m_broadcastHashes;
-  std::mutex m_broadcastHashesMutex;
-  std::deque<
-      std::pair<bytes, std::chrono::time_point<std::chrono::system_clock>>>
-      m_broadcastToRemove;
-  std::mutex m_broadcastToRemoveMutex;
+ public:
+  /// A message read from a connection. Its body is read once out of the
+  /// connection buffer, then moved on to the dispatcher without any copy.
+  struct InboundMessage {
+    unsigned char m_startByte{};
+    /// Hash carried by a broadcast message, empty otherwise
+    bytes m_hash;
+    bytes m_body;
+    /// Body still compressed as it was read, START_BYTE_COMPRESSED being
+    /// cleared from the start byte
+    bool m_compressed{};
+  };
+
+  enum ReadResult : unsigned char { READ_OK, READ_INCOMPLETE, READ_INVALID };
+
+  /// Removes the next message from the buffer if it is complete
+  static ReadResult ReadMessage(struct evbuffer* input,
+                                InboundMessage& message);
+
+ private:
+  friend class P2PCommTest;
+
+  BroadcastHashTable m_broadcastHashes;
   RumorManager m_rumorManager;
 
   const static uint32_t MAXPUMPMESSAGE = 128;
 
   struct event_base* m_base{};
 
-  void ClearBroadcastHashAsync(const bytes& message_hash);
   void SendMsgToSeedNodeOnWire(const Peer& peer, const Peer& fromPeer,
                                const bytes& message,
                                const unsigned char& startByteType);
@@ -114,11 +142,19 @@ class P2PComm {
 
   ThreadPool m_SendPool{MAXSENDMESSAGE, "SendPool"};
 
-  boost::lockfree::queue<SendJob*> m_sendQueue;
+  BlockingQueue<SendJob*> m_sendQueue;
   void ProcessSendJob(SendJob* job);
 
-  static void ProcessBroadCastMsg(bytes& message, const Peer& from);
-  static void ProcessGossipMsg(bytes& message, Peer& from);
+  /// Processes the complete messages read so far on a connection, returns
+  /// false if the connection has to be closed
+  static bool ProcessBufferedMessages(struct evbuffer* input,
+                                      const Peer& from);
+  static void ProcessBroadCastMsg(InboundMessage& message, const Peer& from);
+  static bool DecompressBody(InboundMessage& message, const Peer& from);
+  static void ProcessCapabilities(const bytes& body, const Peer& from);
+  static void ProcessMessage(InboundMessage& message, Peer from);
+  static Peer GetPeerOfBufferEvent(struct bufferevent* bev);
+  static void ProcessGossipMsg(const bytes& message, Peer& from);
 
   static void EventCallback(struct bufferevent* bev, short events, void* ctx);
   static void EventCbServerSeed(struct bufferevent* bev, short events,
@@ -218,6 +254,10 @@ class P2PComm {
       const Peer& peer, const bytes& message,
       const unsigned char& startByteType = START_BYTE_NORMAL);
 
+  /// Announces the capabilities of this node to the peer, asking for its own
+  /// unless replying
+  void SendCapabilities(const Peer& peer, bool reply);
+
   void SetSelfPeer(const Peer& self);
 
   void SetSelfKey(const PairOfKey& self);
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+#include "Blacklist.h"
+#include "PeerConnectionPool.h"
+#include "common/Constants.h"
+#include "libUtils/DetachedFunction.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+PeerConnectionPool::PeerConnectionPool() {
+  auto func = [this]() -> void {
+    const auto interval = chrono::seconds(
+        max(P2P_CONNECTION_IDLE_TIMEOUT / 2, (unsigned int)1));
+    while (true) {
+      this_thread::sleep_for(interval);
+      EvictIdle();
+    }
+  };
+  DetachedFunction(1, func);
+}
+
+PeerConnectionPool::Connection::~Connection() { Close(*this); }
+
+PeerConnectionPool& PeerConnectionPool::GetInstance() {
+  static PeerConnectionPool pool;
+  return pool;
+}
+
+shared_ptr<PeerConnectionPool::Connection> PeerConnectionPool::GetConnection(
+    const Peer& peer) {
+  lock_guard<mutex> g(m_mutexConnections);
+  auto& conn = m_connections[peer];
+  if (!conn) {
+    conn = make_shared<Connection>();
+  }
+  return conn;
+}
+
+PeerConnectionPool::Result PeerConnectionPool::Send(
+    const Peer& peer, const vector<Buffer>& message, int& error) {
+  auto conn = GetConnection(peer);
+  lock_guard<mutex> g(conn->m_mutex);
+
+  const auto now = chrono::steady_clock::now();
+
+  bool reused = false;
+  if (conn->m_sock >= 0) {
+    if (IsClosedByPeer(conn->m_sock)) {
+      Close(*conn);
+    } else {
+      reused = true;
+    }
+  }
+
+  if (!reused) {
+    if (conn->m_numFailures > 0 && now < conn->m_retryAfter) {
+      return IN_BACKOFF;
+    }
+    if (!Connect(peer, *conn, error)) {
+      return CONNECT_FAILED;
+    }
+  }
+
+  if (Write(conn->m_sock, message, error)) {
+    if (reused) {
+      m_numReuses++;
+    }
+  } else {
+    Close(*conn);
+    if (!reused) {
+      m_numWriteFailures++;
+      return WRITE_FAILED;
+    }
+    // The peer may have dropped the connection while it was idle, what was
+    // written of the message is discarded with it so send it again once
+    if (!Connect(peer, *conn, error)) {
+      return CONNECT_FAILED;
+    }
+    if (!Write(conn->m_sock, message, error)) {
+      Close(*conn);
+      m_numWriteFailures++;
+      return WRITE_FAILED;
+    }
+  }
+
+  conn->m_lastUsed = chrono::steady_clock::now();
+  return SENT;
+}
+
+bool PeerConnectionPool::Connect(const Peer& peer, Connection& conn,
+                                 int& error) {
+  conn.m_sock = socket(AF_INET, SOCK_STREAM, 0);
+  if (conn.m_sock < 0) {
+    error = errno;
+    LOG_GENERAL(WARNING, "Socket creation failed. Code = "
+                             << error << " Desc: " << std::strerror(error)
+                             << ". IP address: " << peer);
+    return false;
+  }
+
+  // Messages are written as soon as they are queued
+  int flag = 1;
+  setsockopt(conn.m_sock, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+  struct sockaddr_in serv_addr {};
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_port = htons(peer.m_listenPortHost);
+
+  if (connect(conn.m_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) <
+      0) {
+    error = errno;
+    close(conn.m_sock);
+    conn.m_sock = -1;
+    m_numConnectFailures++;
+
+    // Exponential backoff, capped
+    conn.m_numFailures = min(conn.m_numFailures + 1, 16u);
+    const uint64_t backoffMs =
+        min((uint64_t)MIN_BACKOFF_MS << (conn.m_numFailures - 1),
+            (uint64_t)P2P_CONNECTION_MAX_BACKOFF);
+    conn.m_retryAfter =
+        chrono::steady_clock::now() + chrono::milliseconds(backoffMs);
+
+    LOG_GENERAL(WARNING, "Socket connect failed. Code = "
+                             << error << " Desc: " << std::strerror(error)
+                             << ". IP address: " << peer << ". Retry after "
+                             << backoffMs << " ms");
+    return false;
+  }
+
+  conn.m_numFailures = 0;
+  m_numConnects++;
+  return true;
+}
+
+bool PeerConnectionPool::IsClosedByPeer(int sock) {
+  // Nothing is ever sent back on these connections, anything readable is
+  // either the end of the stream or an error
+  unsigned char c;
+  const ssize_t n = recv(sock, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+}
+
+bool PeerConnectionPool::Write(int sock, const vector<Buffer>& message,
+                               int& error) {
+  for (const auto& buffer : message) {
+    size_t written = 0;
+    while (written < buffer.second) {
+      const ssize_t n = send(sock, buffer.first + written,
+                             buffer.second - written, MSG_NOSIGNAL);
+      if (n <= 0) {
+        error = errno;
+        return false;
+      }
+      written += n;
+    }
+  }
+  return true;
+}
+
+void PeerConnectionPool::Close(Connection& conn) {
+  if (conn.m_sock >= 0) {
+    shutdown(conn.m_sock, SHUT_RDWR);
+    close(conn.m_sock);
+    conn.m_sock = -1;
+  }
+}
+
+void PeerConnectionPool::Evict(const Peer& peer) {
+  shared_ptr<Connection> conn;
+  {
+    lock_guard<mutex> g(m_mutexConnections);
+    auto it = m_connections.find(peer);
+    if (it == m_connections.end()) {
+      return;
+    }
+    conn = it->second;
+    m_connections.erase(it);
+  }
+  lock_guard<mutex> g(conn->m_mutex);
+  Close(*conn);
+}
+
+void PeerConnectionPool::EvictIdle() {
+  const auto expiry = chrono::steady_clock::now() -
+                      chrono::seconds(P2P_CONNECTION_IDLE_TIMEOUT);
+
+  lock_guard<mutex> g(m_mutexConnections);
+  for (auto it = m_connections.begin(); it != m_connections.end();) {
+    // Skip the connections in use
+    unique_lock<mutex> g2(it->second->m_mutex, try_to_lock);
+    if (!g2.owns_lock()) {
+      ++it;
+      continue;
+    }
+
+    Connection& conn = *it->second;
+    const bool blacklisted =
+        Blacklist::GetInstance().Exist(it->first.m_ipAddress);
+    if (conn.m_sock >= 0 && (conn.m_lastUsed < expiry || blacklisted)) {
+      Close(conn);
+      m_numIdleEvictions++;
+    }
+
+    // Keep the peers in backoff to remember their failures
+    if (conn.m_sock < 0 &&
+        (conn.m_numFailures == 0 || conn.m_retryAfter < expiry)) {
+      g2.unlock();
+      it = m_connections.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+PeerConnectionPool::Stats PeerConnectionPool::GetStats() {
+  Stats stats;
+  stats.m_numConnects = m_numConnects;
+  stats.m_numReuses = m_numReuses;
+  stats.m_numConnectFailures = m_numConnectFailures;
+  stats.m_numWriteFailures = m_numWriteFailures;
+  stats.m_numIdleEvictions = m_numIdleEvictions;
+
+  lock_guard<mutex> g(m_mutexConnections);
+  for (const auto& entry : m_connections) {
+    unique_lock<mutex> g2(entry.second->m_mutex, try_to_lock);
+    if (!g2.owns_lock() || entry.second->m_sock >= 0) {
+      stats.m_numOpen++;
+    }
+  }
+  return stats;
+}
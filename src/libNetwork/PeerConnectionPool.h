@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_PEERCONNECTIONPOOL_H_
+#define ZILLIQA_SRC_LIBNETWORK_PEERCONNECTIONPOOL_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Peer.h"
+
+/// Long-lived outbound connections, one per peer, shared by all the messages
+/// sent to that peer. Messages are written back to back on the stream, the
+/// header of each one carrying its length. A connection unused for a while is
+/// closed, and a peer that cannot be connected to is not retried until its
+/// backoff has elapsed.
+class PeerConnectionPool {
+ public:
+  enum Result { SENT, CONNECT_FAILED, WRITE_FAILED, IN_BACKOFF };
+
+  /// Part of a message to write, the parts are written one after the other
+  using Buffer = std::pair<const unsigned char*, size_t>;
+
+  struct Stats {
+    uint64_t m_numConnects{0};
+    uint64_t m_numReuses{0};
+    uint64_t m_numConnectFailures{0};
+    uint64_t m_numWriteFailures{0};
+    uint64_t m_numIdleEvictions{0};
+    size_t m_numOpen{0};
+  };
+
+  static PeerConnectionPool& GetInstance();
+
+  /// Writes the message on the connection to the peer, connecting first if
+  /// needed. On failure error is set to the errno of the failed call.
+  Result Send(const Peer& peer, const std::vector<Buffer>& message,
+              int& error);
+
+  /// Closes the connection to the peer and resets its backoff
+  void Evict(const Peer& peer);
+
+  /// Closes the connections unused for longer than the idle timeout or to
+  /// blacklisted peers
+  void EvictIdle();
+
+  Stats GetStats();
+
+ private:
+  static constexpr unsigned int MIN_BACKOFF_MS = 100;
+
+  struct Connection {
+    std::mutex m_mutex;
+    int m_sock{-1};
+    std::chrono::steady_clock::time_point m_lastUsed;
+    unsigned int m_numFailures{0};
+    std::chrono::steady_clock::time_point m_retryAfter;
+
+    /// Closes the socket if still open
+    ~Connection();
+  };
+
+  std::mutex m_mutexConnections;
+  std::map<Peer, std::shared_ptr<Connection>> m_connections;
+
+  std::atomic<uint64_t> m_numConnects{0};
+  std::atomic<uint64_t> m_numReuses{0};
+  std::atomic<uint64_t> m_numConnectFailures{0};
+  std::atomic<uint64_t> m_numWriteFailures{0};
+  std::atomic<uint64_t> m_numIdleEvictions{0};
+
+  PeerConnectionPool();
+  ~PeerConnectionPool() = default;
+
+  // Singleton should not implement these
+  PeerConnectionPool(PeerConnectionPool const&) = delete;
+  void operator=(PeerConnectionPool const&) = delete;
+
+  std::shared_ptr<Connection> GetConnection(const Peer& peer);
+
+  /// Connects the socket of the connection, sets error on failure
+  bool Connect(const Peer& peer, Connection& conn, int& error);
+
+  /// Whether the other end has closed the connection since it was last used
+  static bool IsClosedByPeer(int sock);
+
+  static bool Write(int sock, const std::vector<Buffer>& message, int& error);
+
+  static void Close(Connection& conn);
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_PEERCONNECTIONPOOL_H_
@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <zlib.h>
+#include <boost/algorithm/string.hpp>
+#include <chrono>
+#include <vector>
+
+#include "P2PComm.h"
+#include "WireCompression.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+const unsigned char START_BYTE_COMPRESSED = 0x80;
+const unsigned char CAPABILITY_COMPRESSION = 0x01;
+
+const unsigned int LENGTH_LEN = 4;
+const unsigned int ANNOUNCEMENT_LEN = 6;
+const unsigned int MAX_KNOWN_PEERS = 65536;
+
+mutex WireCompression::m_mutexPeers;
+map<Peer, WireCompression::PeerCapabilities> WireCompression::m_peers;
+
+atomic<uint64_t> WireCompression::m_numCompressed{0};
+atomic<uint64_t> WireCompression::m_numIncompressible{0};
+atomic<uint64_t> WireCompression::m_numBytesIn{0};
+atomic<uint64_t> WireCompression::m_numBytesOut{0};
+atomic<uint64_t> WireCompression::m_compressMicrosec{0};
+atomic<uint64_t> WireCompression::m_numDecompressed{0};
+atomic<uint64_t> WireCompression::m_decompressMicrosec{0};
+
+namespace {
+
+uint64_t MicrosecSince(const chrono::steady_clock::time_point& start) {
+  return chrono::duration_cast<chrono::microseconds>(
+             chrono::steady_clock::now() - start)
+      .count();
+}
+
+}  // namespace
+
+bool WireCompression::IsCompressible(const bytes& message,
+                                     unsigned char startByte) {
+  if (!ENABLE_WIRE_COMPRESSION ||
+      (startByte != START_BYTE_NORMAL && startByte != START_BYTE_BROADCAST)) {
+    return false;
+  }
+
+  // Larger bodies are refused by the readers whether compressed or not
+  const uint32_t minSize = GetMinSize(message);
+  return minSize != 0 && message.size() >= minSize &&
+         message.size() <= MAX_READ_WATERMARK_IN_BYTES;
+}
+
+bool WireCompression::Compress(const bytes& message, unsigned char startByte,
+                               bytes& compressed) {
+  if (!IsCompressible(message, startByte)) {
+    return false;
+  }
+
+  const auto start = chrono::steady_clock::now();
+  const bool shrunk =
+      CompressBody(message, WIRE_COMPRESSION_LEVEL, compressed) &&
+      compressed.size() < message.size();
+  m_compressMicrosec += MicrosecSince(start);
+
+  if (!shrunk) {
+    m_numIncompressible++;
+    compressed.clear();
+    return false;
+  }
+
+  m_numCompressed++;
+  m_numBytesIn += message.size();
+  m_numBytesOut += compressed.size();
+  LOG_GENERAL(DEBUG, "Compressed message type " << (int)message[0] << "."
+                                                << (int)message[1] << " from "
+                                                << message.size() << " to "
+                                                << compressed.size());
+  return true;
+}
+
+bool WireCompression::Decompress(const bytes& compressed, bytes& message) {
+  if (compressed.size() <= LENGTH_LEN) {
+    LOG_GENERAL(WARNING, "Compressed body too short");
+    return false;
+  }
+
+  const uint32_t length =
+      ((uint32_t)compressed[0] << 24) + ((uint32_t)compressed[1] << 16) +
+      ((uint32_t)compressed[2] << 8) + compressed[3];
+  if (length == 0 || length > MAX_READ_WATERMARK_IN_BYTES) {
+    LOG_GENERAL(WARNING, "Invalid decompressed length " << length);
+    return false;
+  }
+
+  const auto start = chrono::steady_clock::now();
+  message.resize(length);
+  uLongf destLen = length;
+  const int result =
+      uncompress(message.data(), &destLen, compressed.data() + LENGTH_LEN,
+                 compressed.size() - LENGTH_LEN);
+  m_decompressMicrosec += MicrosecSince(start);
+
+  if (result != Z_OK || destLen != length) {
+    LOG_GENERAL(WARNING, "Failed to decompress body, zlib result " << result);
+    message.clear();
+    return false;
+  }
+
+  m_numDecompressed++;
+  return true;
+}
+
+bool WireCompression::CompressBody(const bytes& message, int level,
+                                   bytes& compressed) {
+  if (message.empty()) {
+    return false;
+  }
+
+  uLongf destLen = compressBound(message.size());
+  compressed.resize(LENGTH_LEN + destLen);
+  const uint32_t length = message.size();
+  compressed[0] = (length >> 24) & 0xFF;
+  compressed[1] = (length >> 16) & 0xFF;
+  compressed[2] = (length >> 8) & 0xFF;
+  compressed[3] = length & 0xFF;
+
+  const int result = compress2(compressed.data() + LENGTH_LEN, &destLen,
+                               message.data(), message.size(), level);
+  if (result != Z_OK) {
+    LOG_GENERAL(WARNING, "Failed to compress body, zlib result " << result);
+    compressed.clear();
+    return false;
+  }
+  compressed.resize(LENGTH_LEN + destLen);
+  return true;
+}
+
+uint32_t WireCompression::GetMinSize(const bytes& message) {
+  static const map<uint16_t, uint32_t> minSizes = []() {
+    map<uint16_t, uint32_t> parsed;
+    if (!ParseMessageList(WIRE_COMPRESSION_MESSAGES, WIRE_COMPRESSION_MIN_BYTES,
+                          parsed)) {
+      LOG_GENERAL(WARNING, "Invalid WIRE_COMPRESSION_MESSAGES "
+                               << WIRE_COMPRESSION_MESSAGES
+                               << ", no message will be compressed");
+      parsed.clear();
+    }
+    return parsed;
+  }();
+
+  if (message.size() < 2) {
+    return 0;
+  }
+  const auto it = minSizes.find((message[0] << 8) + message[1]);
+  return it == minSizes.end() ? 0 : it->second;
+}
+
+bool WireCompression::ParseMessageList(const string& list, uint32_t defaultMin,
+                                       map<uint16_t, uint32_t>& minSizes) {
+  vector<string> entries;
+  boost::split(entries, list, boost::is_any_of(","));
+  for (auto& entry : entries) {
+    boost::trim(entry);
+    if (entry.empty()) {
+      continue;
+    }
+
+    try {
+      const auto dot = entry.find('.');
+      const auto colon = entry.find(':');
+      if (dot == string::npos || (colon != string::npos && colon < dot)) {
+        return false;
+      }
+      size_t typeEnd = 0;
+      size_t instEnd = 0;
+      const unsigned long type = stoul(entry.substr(0, dot), &typeEnd, 16);
+      const string inst = entry.substr(dot + 1, colon - dot - 1);
+      const unsigned long instType = stoul(inst, &instEnd, 16);
+      if (typeEnd != dot || instEnd != inst.size() || type > 0xFF ||
+          instType > 0xFF) {
+        return false;
+      }
+
+      uint32_t minSize = defaultMin;
+      if (colon != string::npos) {
+        const string min = entry.substr(colon + 1);
+        size_t minEnd = 0;
+        minSize = stoul(min, &minEnd);
+        if (minEnd != min.size()) {
+          return false;
+        }
+      }
+      minSizes[(type << 8) + instType] = max(minSize, 1u);
+    } catch (const exception&) {
+      return false;
+    }
+  }
+  return true;
+}
+
+WireCompressionStats WireCompression::GetStats() {
+  WireCompressionStats stats;
+  stats.m_numCompressed = m_numCompressed;
+  stats.m_numIncompressible = m_numIncompressible;
+  stats.m_numBytesIn = m_numBytesIn;
+  stats.m_numBytesOut = m_numBytesOut;
+  stats.m_compressMicrosec = m_compressMicrosec;
+  stats.m_numDecompressed = m_numDecompressed;
+  stats.m_decompressMicrosec = m_decompressMicrosec;
+  return stats;
+}
+
+bool WireCompression::IsCapable(const Peer& peer, bool& probe) {
+  const auto now = chrono::steady_clock::now();
+  const chrono::seconds interval(WIRE_COMPRESSION_PROBE_INTERVAL);
+
+  lock_guard<mutex> g(m_mutexPeers);
+  auto it = m_peers.find(peer);
+  if (it == m_peers.end()) {
+    if (m_peers.size() >= MAX_KNOWN_PEERS) {
+      probe = false;
+      return false;
+    }
+    it = m_peers.emplace(peer, PeerCapabilities()).first;
+    it->second.m_probed = now - interval;
+  }
+
+  // Asked again every interval, so that a peer downgraded meanwhile stops
+  // getting compressed bodies
+  auto& capabilities = it->second;
+  probe = now - capabilities.m_probed >= interval;
+  if (probe) {
+    capabilities.m_probed = now;
+  }
+  return (capabilities.m_capabilities & CAPABILITY_COMPRESSION) &&
+         now - capabilities.m_announced < 2 * interval;
+}
+
+void WireCompression::SetCapabilities(const Peer& peer,
+                                      unsigned char capabilities) {
+  lock_guard<mutex> g(m_mutexPeers);
+  auto it = m_peers.find(peer);
+  if (it == m_peers.end()) {
+    if (m_peers.size() >= MAX_KNOWN_PEERS) {
+      LOG_GENERAL(WARNING, "Too many peers known, ignoring capabilities of "
+                               << peer);
+      return;
+    }
+    it = m_peers.emplace(peer, PeerCapabilities()).first;
+  }
+  it->second.m_capabilities = capabilities;
+  it->second.m_announced = chrono::steady_clock::now();
+}
+
+void WireCompression::ClearCapabilities() {
+  lock_guard<mutex> g(m_mutexPeers);
+  m_peers.clear();
+}
+
+bytes WireCompression::MakeAnnouncement(bool reply, uint32_t listenPort) {
+  // Any node of this version reads compressed bodies, whether it sends them
+  // or not
+  return {CAPABILITY_COMPRESSION,
+          (unsigned char)(reply ? 1 : 0),
+          (unsigned char)((listenPort >> 24) & 0xFF),
+          (unsigned char)((listenPort >> 16) & 0xFF),
+          (unsigned char)((listenPort >> 8) & 0xFF),
+          (unsigned char)(listenPort & 0xFF)};
+}
+
+bool WireCompression::ParseAnnouncement(const bytes& body,
+                                        unsigned char& capabilities,
+                                        bool& reply, uint32_t& listenPort) {
+  if (body.size() < ANNOUNCEMENT_LEN) {
+    return false;
+  }
+  capabilities = body[0];
+  reply = body[1] != 0;
+  listenPort = ((uint32_t)body[2] << 24) + ((uint32_t)body[3] << 16) +
+               ((uint32_t)body[4] << 8) + body[5];
+  return listenPort != 0 && listenPort <= 0xFFFF;
+}
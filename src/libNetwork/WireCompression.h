@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBNETWORK_WIRECOMPRESSION_H_
+#define ZILLIQA_SRC_LIBNETWORK_WIRECOMPRESSION_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "Peer.h"
+#include "common/BaseType.h"
+
+/// Set in the start byte of a message whose body is compressed
+extern const unsigned char START_BYTE_COMPRESSED;
+
+/// Capability bit of the nodes reading compressed bodies
+extern const unsigned char CAPABILITY_COMPRESSION;
+
+struct WireCompressionStats {
+  uint64_t m_numCompressed{0};
+  /// Bodies of the listed types left as they were, for not shrinking enough
+  uint64_t m_numIncompressible{0};
+  uint64_t m_numBytesIn{0};
+  uint64_t m_numBytesOut{0};
+  uint64_t m_compressMicrosec{0};
+  uint64_t m_numDecompressed{0};
+  uint64_t m_decompressMicrosec{0};
+};
+
+/// Compresses the bodies of the large normal and broadcast messages on the
+/// wire. A compressed body is the 4-byte length of the original followed by
+/// its zlib stream, and its start byte has START_BYTE_COMPRESSED set. The
+/// hash of a broadcast stays the one of the original body.
+///
+/// Compressed bodies only go to the peers that announced they read them. A
+/// node asks a peer for its capabilities with a START_BYTE_CAPABILITIES
+/// message, of body <capability bits> <reply flag> <4-byte listen port>, and
+/// the peer answers with its own. Older nodes drop the message as having an
+/// incorrect start byte, and keep getting the bodies as they are.
+class WireCompression {
+ public:
+  /// Whether compression is enabled for the type and size of the message
+  static bool IsCompressible(const bytes& message, unsigned char startByte);
+
+  /// Compresses the message if compression is enabled for its type and size,
+  /// and if it shrinks it. Returns false if it goes on the wire as it is.
+  static bool Compress(const bytes& message, unsigned char startByte,
+                       bytes& compressed);
+
+  /// Restores a body received with START_BYTE_COMPRESSED set
+  static bool Decompress(const bytes& compressed, bytes& message);
+
+  /// Compresses without checking the settings, at the given zlib level
+  static bool CompressBody(const bytes& message, int level, bytes& compressed);
+
+  /// Smallest body compressed for the message type and instruction in the
+  /// first two bytes of the message, 0 if never compressed
+  static uint32_t GetMinSize(const bytes& message);
+
+  /// Parses the entries "TYPE.INST[:MIN_BYTES]" of WIRE_COMPRESSION_MESSAGES,
+  /// in hex, keyed by (TYPE << 8) + INST
+  static bool ParseMessageList(const std::string& list, uint32_t defaultMin,
+                               std::map<uint16_t, uint32_t>& minSizes);
+
+  static WireCompressionStats GetStats();
+
+  /// Whether the peer announced it reads compressed bodies, within the last
+  /// two WIRE_COMPRESSION_PROBE_INTERVAL. Sets probe if it is time to ask it
+  /// for its capabilities again.
+  static bool IsCapable(const Peer& peer, bool& probe);
+
+  /// Records the capabilities announced by the peer at its listen port
+  static void SetCapabilities(const Peer& peer, unsigned char capabilities);
+
+  /// Forgets the capabilities of all the peers
+  static void ClearCapabilities();
+
+  /// Body of the message announcing the capabilities of this node
+  static bytes MakeAnnouncement(bool reply, uint32_t listenPort);
+
+  static bool ParseAnnouncement(const bytes& body, unsigned char& capabilities,
+                                bool& reply, uint32_t& listenPort);
+
+ private:
+  struct PeerCapabilities {
+    unsigned char m_capabilities{};
+    std::chrono::steady_clock::time_point m_announced;
+    std::chrono::steady_clock::time_point m_probed;
+  };
+
+  static std::mutex m_mutexPeers;
+  static std::map<Peer, PeerCapabilities> m_peers;
+
+  static std::atomic<uint64_t> m_numCompressed;
+  static std::atomic<uint64_t> m_numIncompressible;
+  static std::atomic<uint64_t> m_numBytesIn;
+  static std::atomic<uint64_t> m_numBytesOut;
+  static std::atomic<uint64_t> m_compressMicrosec;
+  static std::atomic<uint64_t> m_numDecompressed;
+  static std::atomic<uint64_t> m_decompressMicrosec;
+};
+
+#endif  // ZILLIQA_SRC_LIBNETWORK_WIRECOMPRESSION_H_
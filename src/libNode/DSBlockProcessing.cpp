@@ -177,7 +177,7 @@ void Node ::UpdateGovProposalRemainingVoteInfo() {
   lock_guard<mutex> g(m_mutexGovProposal);
   if (m_govProposalInfo.isGovProposalActive) {
     uint64_t curDSEpochNo =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
     if (curDSEpochNo >= m_govProposalInfo.startDSEpoch &&
         curDSEpochNo <= m_govProposalInfo.endDSEpoch &&
         m_govProposalInfo.remainingVoteCount > 1) {
@@ -288,7 +288,7 @@ void Node::StartFirstTxEpoch(bool fbWaitState) {
   uint16_t lastBlockHash = 0;
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash = DataConversion::charArrTo16Bits(
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+        m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes());
   }
 
   {
@@ -327,7 +327,7 @@ void Node::StartFirstTxEpoch(bool fbWaitState) {
                            << m_mediator.m_selfPeer.GetPrintableIPAddress()
                            << "]["
                            << m_mediator.m_txBlockChain.GetLastBlock()
-                                      .GetHeader()
+                                      ->GetHeader()
                                       .GetBlockNum() +
                                   1
                            << "] RECVD SHARDING STRUCTURE");
@@ -423,9 +423,9 @@ bool Node::ProcessVCDSBlocksMessage(
   // Check timestamp (must be greater than timestamp of last Tx block header in
   // the Tx blockchain)
   if (m_mediator.m_txBlockChain.GetBlockCount() > 0) {
-    const TxBlock& lastTxBlock = m_mediator.m_txBlockChain.GetLastBlock();
+    const auto lastTxBlock = m_mediator.m_txBlockChain.GetLastBlock();
     uint64_t thisDSTimestamp = dsblock.GetTimestamp();
-    uint64_t lastTxBlockTimestamp = lastTxBlock.GetTimestamp();
+    uint64_t lastTxBlockTimestamp = lastTxBlock->GetTimestamp();
     if (thisDSTimestamp <= lastTxBlockTimestamp) {
       LOG_GENERAL(WARNING, "Timestamp check failed. Last Tx Block: "
                                << lastTxBlockTimestamp
@@ -467,7 +467,7 @@ bool Node::ProcessVCDSBlocksMessage(
     LOG_GENERAL(WARNING,
                 "ProcessVCDSBlocksMessage CheckWhetherBlockIsLatest failed");
     if (dsblock.GetHeader().GetBlockNum() >
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
             1) {
       if (LOOKUP_NODE_MODE && ARCHIVAL_LOOKUP) {
         // Rejoin from S3
@@ -584,7 +584,7 @@ bool Node::ProcessVCDSBlocksMessage(
       "[DSBLK]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] RECVD DSBLOCK -> DS Diff = "
       << to_string(dsblock.GetHeader().GetDSDifficulty())
       << " Diff = " << to_string(dsblock.GetHeader().GetDifficulty()));
@@ -599,7 +599,7 @@ bool Node::ProcessVCDSBlocksMessage(
   {
     std::lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
     UpdateDSCommitteeComposition(*m_mediator.m_DSCommittee,
-                                 m_mediator.m_dsBlockChain.GetLastBlock(),
+                                 *m_mediator.m_dsBlockChain.GetLastBlock(),
                                  minerInfoDSComm);
   }
 
@@ -607,7 +607,7 @@ bool Node::ProcessVCDSBlocksMessage(
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
         DataConversion::charArrTo16Bits(m_mediator.m_dsBlockChain.GetLastBlock()
-                                            .GetHeader()
+                                            ->GetHeader()
                                             .GetHashForRandom()
                                             .asBytes());
   }
@@ -630,7 +630,7 @@ bool Node::ProcessVCDSBlocksMessage(
 
     // Check if we are a new DS Member and get our index if we are.
     const map<PubKey, Peer> dsPoWWinners =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSPoWWinners();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSPoWWinners();
 
     // Find my new consensus ID.
     DequeOfNode::iterator it;
@@ -798,12 +798,12 @@ bool Node::ProcessVCDSBlocksMessage(
          0) &&  // If limit is 0, skip deletion
         (BlockStorage::GetBlockStorage().GetDiagnosticDataNodesCount() >=
          MAX_ENTRIES_FOR_DIAGNOSTIC_DATA) &&  // Limit reached
-        (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+        (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
          MAX_ENTRIES_FOR_DIAGNOSTIC_DATA)) {  // DS Block number is not below
                                               // limit
 
       const uint64_t oldBlockNum =
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() -
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() -
           MAX_ENTRIES_FOR_DIAGNOSTIC_DATA;
 
       canPutNewEntry =
@@ -822,7 +822,7 @@ bool Node::ProcessVCDSBlocksMessage(
 
     if (canPutNewEntry) {
       BlockStorage::GetBlockStorage().PutDiagnosticDataNodes(
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
           m_mediator.m_ds->m_shards, *m_mediator.m_DSCommittee);
     }
   }
@@ -103,7 +103,7 @@ bool Node::StoreFinalBlock(const TxBlock& txBlock) {
       "[FINBK]["
       << std::setw(15) << std::left
       << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] RECV");
 
   return true;
@@ -324,18 +324,18 @@ void Node::InitiatePoW() {
   }
 
   POW::GetInstance().EthashConfigureClient(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1,
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1,
       FULL_DATASET_MINE);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum, "Start pow ");
   auto func = [this]() mutable -> void {
     auto epochNumber =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
     auto dsBlockRand = m_mediator.m_dsBlockRand;
     auto txBlockRand = m_mediator.m_txBlockRand;
     StartPoW(
         epochNumber,
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty(),
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty(),
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty(),
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty(),
         dsBlockRand, txBlockRand);
   };
 
@@ -360,7 +360,7 @@ void Node::UpdateStateForNextConsensusRound() {
   m_mediator.m_consensusID++;
 
   uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes());
   {
     lock_guard<mutex> g(m_mutexShardMember);
 
@@ -481,7 +481,7 @@ void Node::CallActOnFinalblock() {
   DataSender::GetInstance().SendDataToOthers(
       *m_microblock, *m_myShardMembers, {}, {},
       m_mediator.m_lookup->GetLookupNodes(),
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(), m_consensusMyID,
+      m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(), m_consensusMyID,
       composeMBnForwardTxnMessageForSender, false, SendDataToLookupFuncDefault,
       sendMbnFowardTxnToShardNodes);
 }
@@ -500,8 +500,8 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
     return false;
   }
 
-  const auto& blocknum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  const uint64_t blocknum =
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   {
     const vector<TxnHash>& tx_hashes = m_microblock->GetTranHashes();
     lock_guard<mutex> g(m_mutexProcessedTransactions);
@@ -535,7 +535,7 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
       "[TXBOD]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] BEFORE SENDING MB & FORWARDING TXN BODIES #" << blocknum);
 
   LOG_GENERAL(INFO, "[SendMBnTxn]"
@@ -761,7 +761,7 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
       // Check if I have a latest DS Info (but do it only once in current ds
       // epoch)
       uint64_t latestDSBlockNum =
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
       uint64_t recvdDsBlockNum = txBlock.GetHeader().GetDSBlockNum();
       m_mediator.m_lookup->m_confirmedLatestDSBlock = true;
 
@@ -806,8 +806,9 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
                        << txBlock.GetHeader().GetBlockNum() << "] FRST");
 
   if (LOOKUP_NODE_MODE && LOG_PARAMETERS) {
-    uint64_t timeDiff = txBlock.GetTimestamp() -
-                        m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp();
+    uint64_t timeDiff =
+        txBlock.GetTimestamp() -
+        m_mediator.m_txBlockChain.GetLastBlock()->GetTimestamp();
 
     const double oneMillion = 1000000.0;
 
@@ -836,7 +837,7 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
 
     // Missed some ds block, rejoin
     if (dsBlockNumber >
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum()) {
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum()) {
       if (!LOOKUP_NODE_MODE) {
         RejoinAsNormal();
       } else if (ARCHIVAL_LOOKUP) {
@@ -1030,7 +1031,7 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
     auto writeStateToDisk = [this]() -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
               m_mediator.m_dsBlockChain.GetLastBlock()
-                  .GetHeader()
+                  ->GetHeader()
                   .GetBlockNum())) {
         LOG_GENERAL(WARNING, "MoveUpdatesToDisk() failed, what to do?");
         // return false;
@@ -1054,7 +1055,7 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
           lock_guard<mutex> g(m_mutexUnavailableMicroBlocks);
           if (m_unavailableMicroBlocks.find(
                   m_mediator.m_txBlockChain.GetLastBlock()
-                      .GetHeader()
+                      ->GetHeader()
                       .GetBlockNum()) == m_unavailableMicroBlocks.end()) {
             if (!BlockStorage::GetBlockStorage().PutEpochFin(
                     m_mediator.m_currentEpochNum)) {
@@ -1068,13 +1069,14 @@ bool Node::ProcessFinalBlockCore(uint64_t& dsBlockNumber,
                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
                              << "]["
                              << m_mediator.m_txBlockChain.GetLastBlock()
-                                        .GetHeader()
+                                        ->GetHeader()
                                         .GetBlockNum() +
                                     1
                              << "] FINISH WRITE STATE TO DISK");
         if (ENABLE_ACCOUNTS_POPULATING &&
-            m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
-                PREGEN_ACCOUNT_TIMES) {
+            m_mediator.m_dsBlockChain.GetLastBlock()
+                    ->GetHeader()
+                    .GetBlockNum() < PREGEN_ACCOUNT_TIMES) {
           PopulateAccounts();
         }
       }
@@ -1436,7 +1438,7 @@ bool Node::ProcessMBnForwardTransaction(
       "[TXBOD]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "] RECVD MB & TXN BODIES #"
       << entry.m_microBlock.GetHeader().GetEpochNum() << " shard "
       << entry.m_microBlock.GetHeader().GetShardId());
@@ -1449,7 +1451,7 @@ bool Node::ProcessMBnForwardTransaction(
               << " Txns:" << entry.m_microBlock.GetHeader().GetNumTxs());
   }
 
-  if ((m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+  if ((m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() <
        entry.m_microBlock.GetHeader()
            .GetEpochNum()) || /* Buffer for syncing seed node */
       (LOOKUP_NODE_MODE && ARCHIVAL_LOOKUP &&
@@ -1524,8 +1526,8 @@ bool Node::AddPendingTxn(const HashCodeMap& pendingTxns, const PubKey& pubkey,
     }
   }
 
-  const auto& currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  const uint64_t currentEpochNum =
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   for (const auto& entry : pendingTxns) {
     LOG_GENERAL(INFO, " " << entry.first << " " << entry.second);
@@ -1564,8 +1566,8 @@ bool Node::SendPendingTxnToLookup() {
   }
 
   const auto pendingTxns = GetUnconfirmedTxns();
-  const auto& blocknum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  const uint64_t blocknum =
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   bytes pend_txns_message = {MessageType::NODE,
                              NodeInstructionType::PENDINGTXN};
@@ -1600,8 +1602,8 @@ bool Node::ProcessPendingTxn(const bytes& message, unsigned int cur_offset,
     LOG_GENERAL(WARNING, "Failed to set GetNodePendingTxn");
     return false;
   }
-  const auto& currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  const uint64_t currentEpochNum =
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (currentEpochNum > epochNum + 1) {
     LOG_GENERAL(WARNING,
@@ -1669,7 +1671,7 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
         // Check is states updated
         uint64_t epochNum;
         if (m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetBlockNum() == 1) {
           epochNum = 1;
         } else {
@@ -1682,7 +1684,7 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
         }
         if (AccountStore::GetInstance().GetPrevRootHash() ==
             m_mediator.m_txBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetStateRootHash()) {
           if (!BlockStorage::GetBlockStorage().PutEpochFin(
                   m_mediator.m_currentEpochNum)) {
@@ -1704,15 +1706,15 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
 
       if (ENABLE_WEBSOCKET) {
         // send tx block and attach txhashes
-        const TxBlock& txBlock = m_mediator.m_txBlockChain.GetLastBlock();
+        const auto txBlock = m_mediator.m_txBlockChain.GetLastBlock();
         Json::Value j_txnhashes;
         try {
-          j_txnhashes = LookupServer::GetTransactionsForTxBlock(txBlock);
+          j_txnhashes = LookupServer::GetTransactionsForTxBlock(*txBlock);
         } catch (...) {
           j_txnhashes = Json::arrayValue;
         }
         WebsocketServer::GetInstance().PrepareTxBlockAndTxHashes(
-            JSONConversion::convertTxBlocktoJson(txBlock), j_txnhashes);
+            JSONConversion::convertTxBlocktoJson(*txBlock), j_txnhashes);
 
         // send event logs
         WebsocketServer::GetInstance().SendOutMessages();
@@ -1738,7 +1740,7 @@ void Node::CommitMBnForwardedTransactionBuffer() {
   for (auto it = m_mbnForwardedTxnBuffer.begin();
        it != m_mbnForwardedTxnBuffer.end();) {
     if (it->first <=
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum()) {
+        m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum()) {
       for (const auto& entry : it->second) {
         ProcessMBnForwardTransactionCore(entry);
       }
@@ -284,11 +284,11 @@ bool Node::ProcessMicroBlockConsensusCore(
            [[gnu::unused]] const unsigned int& my_shards_hi) -> void {};
 
     unordered_map<uint32_t, BlockBase> t_blocks;
-    if (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum() ==
+    if (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum() ==
         m_mediator.m_currentEpochNum) {
-      t_blocks.emplace(0, m_mediator.m_dsBlockChain.GetLastBlock());
+      t_blocks.emplace(0, *m_mediator.m_dsBlockChain.GetLastBlock());
     } else {
-      t_blocks.emplace(0, m_mediator.m_txBlockChain.GetLastBlock());
+      t_blocks.emplace(0, *m_mediator.m_txBlockChain.GetLastBlock());
     }
 
     {
@@ -297,13 +297,13 @@ bool Node::ProcessMicroBlockConsensusCore(
       DataSender::GetInstance().SendDataToOthers(
           *m_microblock, *m_myShardMembers, ds_shards, t_blocks,
           m_mediator.m_lookup->GetLookupNodes(),
-          m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+          m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(),
           m_consensusMyID, composeMicroBlockMessageForSender, false, nullptr);
       // To Lookup -> ProcessMBnForwardTxn
       DataSender::GetInstance().SendDataToOthers(
           *m_microblock, *m_myShardMembers, {}, {},
           m_mediator.m_lookup->GetLookupNodes(),
-          m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+          m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash(),
           m_consensusMyID, composeMBnForwardTxnMessageForSender, false,
           SendDataToLookupFuncDefault, sendMbnFowardTxnToShardNodes);
       // pending Txns
@@ -317,7 +317,7 @@ bool Node::ProcessMicroBlockConsensusCore(
         "[MIBLK]["
         << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
         << "]["
-        << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
                1
         << "] AFTER SENDING MIBLK");
 
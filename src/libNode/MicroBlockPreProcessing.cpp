@@ -74,7 +74,7 @@ bool Node::ComposeMicroBlock(const uint64_t& microblock_gas_limit) {
     rewards = m_txnFees;
   }
   BlockHash prevHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetMyHash();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetMyHash();
 
   TxnHash txRootHash, txReceiptHash;
   uint32_t numTxs = 0;
@@ -139,7 +139,7 @@ bool Node::ComposeMicroBlock(const uint64_t& microblock_gas_limit) {
       MicroBlockHeader(
           shardId, gasLimit, gasUsed, rewards, m_mediator.m_currentEpochNum,
           {txRootHash, stateDeltaHash, txReceiptHash}, numTxs, minerPubKey,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
           version, committeeHash, prevHash),
       tranHashes, CoSignatures()));
 
@@ -171,7 +171,7 @@ bool Node::ComposePrePrepMicroBlock(const uint64_t& microblock_gas_limit) {
   const uint64_t gasUsed = 0;
   uint128_t rewards = 0;
   BlockHash prevHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetMyHash();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetMyHash();
 
   const PubKey& minerPubKey = m_mediator.m_selfKey.second;
   CommitteeHash committeeHash;
@@ -199,7 +199,7 @@ bool Node::ComposePrePrepMicroBlock(const uint64_t& microblock_gas_limit) {
 
   const uint32_t numTxs = m_createdTxns.size();
 
-  for (const auto& entry : m_createdTxns.HashIndex) {
+  for (const auto& entry : m_createdTxns.GetHashIndex()) {
     tranHashes.emplace_back(entry.first);
   }
 
@@ -217,7 +217,7 @@ bool Node::ComposePrePrepMicroBlock(const uint64_t& microblock_gas_limit) {
       MicroBlockHeader(
           shardId, gasLimit, gasUsed, rewards, m_mediator.m_currentEpochNum,
           {txRootHash, stateDeltaHash, TxnHash()}, numTxs, minerPubKey,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum(),
           version, committeeHash, prevHash),
       tranHashes, CoSignatures()));
 
@@ -270,9 +270,9 @@ bool Node::OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
     for (const auto& hash : missingTransactions) {
       // LOG_GENERAL(INFO, "Peer " << from << " : " << portNo << " missing txn "
       // << missingTransactions[i])
-      auto found = m_createdTxns.HashIndex.find(hash);
-      if (found != m_createdTxns.HashIndex.end()) {
-        txns.emplace_back(found->second);
+      Transaction t;
+      if (m_createdTxns.get(hash, t)) {
+        txns.emplace_back(move(t));
       } else {
         LOG_GENERAL(INFO, "Leader unable to find txn in own created txns list "
                               << hash);
@@ -361,7 +361,7 @@ void Node::ProcessTransactionWhenShardLeader(
     t_createdTxns = m_createdTxns;
   }
 
-  map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
+  PendingTxnQueue t_pendingTxns(GetPendingTxnOrder());
   t_processedTransactions.clear();
   m_TxnOrder.clear();
 
@@ -381,23 +381,17 @@ void Node::ProcessTransactionWhenShardLeader(
 
   this_thread::sleep_for(chrono::milliseconds(100));
 
-  auto findOneFromAddrNonceTxnMap =
-      [](Transaction& t,
-         map<Address, map<uint64_t, Transaction>>& t_addrNonceTxnMap) -> bool {
-    for (auto it = t_addrNonceTxnMap.begin(); it != t_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          t_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
+  // Applies the txn and makes the queued txn following it executable
+  auto checkCreatedTransaction = [this, &t_pendingTxns](
+                                     const Transaction& t,
+                                     TransactionReceipt& tr,
+                                     TxnStatus& error_code) -> bool {
+    const bool ret =
+        m_mediator.m_validator->CheckCreatedTransaction(t, tr, error_code);
+    t_pendingTxns.UpdateNonce(
+        t.GetSenderAddr(),
+        AccountStore::GetInstance().GetNonceTemp(t.GetSenderAddr()));
+    return ret;
   };
 
   auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
@@ -418,97 +412,29 @@ void Node::ProcessTransactionWhenShardLeader(
 
   LOG_GENERAL(INFO, "microblock_gas_limit = " << microblock_gas_limit);
 
-  while (m_gasUsedTotal < microblock_gas_limit) {
-    if (txnProcTimeout) {
-      LOG_GENERAL(INFO, "txnProcTimeout is set!");
-      break;
-    }
-
-    Transaction t;
-    TransactionReceipt tr;
-
-    // check m_addrNonceTxnMap contains any txn meets right nonce,
-    // if contains, process it
-    if (findOneFromAddrNonceTxnMap(t, t_addrNonceTxnMap)) {
-      count_addrNonceTxnMap++;
-      // check whether m_createdTransaction have transaction with same Addr and
-      // nonce if has and with larger gasPrice then replace with that one.
-      // (*optional step)
-      t_createdTxns.findSameNonceButHigherGas(t);
-
-      if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
-        LOG_GENERAL(WARNING, "Gas limit exceeded = " << t.GetTranID());
-        LOG_GENERAL(WARNING, "m_gasUsedTotal     = " << m_gasUsedTotal);
-        LOG_GENERAL(WARNING, "t.GetGasLimit      = " << t.GetGasLimit());
-        gasLimitExceededTxnBuffer.emplace_back(t);
-        continue;
+  if (ENABLE_PARALLEL_TXN_EXECUTION) {
+    ProcessTransactionsInParallel(microblock_gas_limit, txnProcTimeout,
+                                  t_pendingTxns, gasLimitExceededTxnBuffer,
+                                  droppedTxns);
+  } else {
+    while (m_gasUsedTotal < microblock_gas_limit) {
+      if (txnProcTimeout) {
+        LOG_GENERAL(INFO, "txnProcTimeout is set!");
+        break;
       }
-      TxnStatus error_code;
-      if (m_mediator.m_validator->CheckCreatedTransaction(t, tr, error_code)) {
-        if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
-                                     m_gasUsedTotal)) {
-          LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
-          break;
-        }
-        uint128_t txnFee;
-        if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
-                                      txnFee)) {
-          LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
-          continue;
-        }
-        if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
-          LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
-          break;
-        }
-        appendOne(t, tr);
 
-        continue;
-      } else {
-        droppedTxns.emplace_back(t.GetTranID(), error_code);
-      }
-    }
-    // if no txn in u_map meet right nonce process new come-in transactions
-    else if (t_createdTxns.findOne(t)) {
-      count_createdTxns++;
-      // LOG_GENERAL(INFO, "findOneFromCreated");
+      Transaction t;
+      TransactionReceipt tr;
+
+      // check t_pendingTxns contains any txn meets right nonce,
+      // if contains, process the first one in the order of the queue
+      if (t_pendingTxns.FindOne(t)) {
+        count_addrNonceTxnMap++;
+        // check whether m_createdTransaction have transaction with same Addr
+        // and nonce if has and with larger gasPrice then replace with that
+        // one. (*optional step)
+        t_createdTxns.findSameNonceButHigherGas(t);
 
-      Address senderAddr = t.GetSenderAddr();
-      // check nonce, if nonce larger than expected, put it into
-      // m_addrNonceTxnMap
-      if (t.GetNonce() >
-          AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        LOG_GENERAL(
-            INFO, "High nonce: "
-                      << t.GetNonce() << " cur sender " << senderAddr.hex()
-                      << " nonce: "
-                      << AccountStore::GetInstance().GetNonceTemp(senderAddr));
-        auto it1 = t_addrNonceTxnMap.find(senderAddr);
-        if (it1 != t_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            continue;
-          }
-        }
-        t_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
-      }
-      // if nonce too small, ignore it
-      else if (t.GetNonce() <
-               AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
-        LOG_GENERAL(
-            INFO,
-            "Nonce too small"
-                << " Expected "
-                << AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1
-                << " Found " << t.GetNonce() << " for " << t.GetTranID());
-        droppedTxns.emplace_back(t.GetTranID(), TxnStatus::NONCE_TOO_LOW);
-      }
-      // if nonce correct, process it
-      else {
         if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
           LOG_GENERAL(WARNING, "Gas limit exceeded = " << t.GetTranID());
           LOG_GENERAL(WARNING, "m_gasUsedTotal     = " << m_gasUsedTotal);
@@ -517,8 +443,7 @@ void Node::ProcessTransactionWhenShardLeader(
           continue;
         }
         TxnStatus error_code;
-        if (m_mediator.m_validator->CheckCreatedTransaction(t, tr,
-                                                            error_code)) {
+        if (checkCreatedTransaction(t, tr, error_code)) {
           if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
                                        m_gasUsedTotal)) {
             LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
@@ -535,18 +460,82 @@ void Node::ProcessTransactionWhenShardLeader(
             break;
           }
           appendOne(t, tr);
+
+          continue;
         } else {
           droppedTxns.emplace_back(t.GetTranID(), error_code);
         }
       }
-    } else {
-      LOG_GENERAL(INFO, "Ending txn processing loop");
-      break;
+      // if no txn in t_pendingTxns is ready process new come-in transactions
+      else if (t_createdTxns.findOne(t)) {
+        count_createdTxns++;
+        // LOG_GENERAL(INFO, "findOneFromCreated");
+
+        Address senderAddr = t.GetSenderAddr();
+        // check nonce, if nonce larger than expected, put it into
+        // t_pendingTxns
+        if (t.GetNonce() >
+            AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
+          LOG_GENERAL(INFO,
+                      "High nonce: "
+                          << t.GetNonce() << " cur sender " << senderAddr.hex()
+                          << " nonce: "
+                          << AccountStore::GetInstance().GetNonceTemp(
+                                 senderAddr));
+          t_pendingTxns.Insert(
+              t, AccountStore::GetInstance().GetNonceTemp(senderAddr));
+        }
+        // if nonce too small, ignore it
+        else if (t.GetNonce() <
+                 AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
+          LOG_GENERAL(
+              INFO,
+              "Nonce too small"
+                  << " Expected "
+                  << AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1
+                  << " Found " << t.GetNonce() << " for " << t.GetTranID());
+          droppedTxns.emplace_back(t.GetTranID(), TxnStatus::NONCE_TOO_LOW);
+        }
+        // if nonce correct, process it
+        else {
+          if (m_gasUsedTotal + t.GetGasLimit() > microblock_gas_limit) {
+            LOG_GENERAL(WARNING, "Gas limit exceeded = " << t.GetTranID());
+            LOG_GENERAL(WARNING, "m_gasUsedTotal     = " << m_gasUsedTotal);
+            LOG_GENERAL(WARNING, "t.GetGasLimit      = " << t.GetGasLimit());
+            gasLimitExceededTxnBuffer.emplace_back(t);
+            continue;
+          }
+          TxnStatus error_code;
+          if (checkCreatedTransaction(t, tr, error_code)) {
+            if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
+                                         m_gasUsedTotal)) {
+              LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
+              break;
+            }
+            uint128_t txnFee;
+            if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(),
+                                          txnFee)) {
+              LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
+              continue;
+            }
+            if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
+              LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
+              break;
+            }
+            appendOne(t, tr);
+          } else {
+            droppedTxns.emplace_back(t.GetTranID(), error_code);
+          }
+        }
+      } else {
+        LOG_GENERAL(INFO, "Ending txn processing loop");
+        break;
+      }
     }
-  }
 
-  LOG_GENERAL(INFO, "AddrNonceTxnMap # txns = " << count_addrNonceTxnMap);
-  LOG_GENERAL(INFO, "t_createdTxns   # txns = " << count_createdTxns);
+    LOG_GENERAL(INFO, "AddrNonceTxnMap # txns = " << count_addrNonceTxnMap);
+    LOG_GENERAL(INFO, "t_createdTxns   # txns = " << count_createdTxns);
+  }
   LOG_GENERAL(INFO, "m_gasUsedTotal         = " << m_gasUsedTotal);
 
   AccountStore::GetInstance().ProcessStorageRootUpdateBufferTemp();
@@ -569,7 +558,256 @@ void Node::ProcessTransactionWhenShardLeader(
                                << " Time=" << elaspedTimeMs);
   }
   // Put txns in map back into pool
-  ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer, droppedTxns);
+  ReinstateMemPool(t_pendingTxns.GetTxns(), gasLimitExceededTxnBuffer,
+                   droppedTxns);
+}
+
+void Node::ProcessTransactionsInParallel(
+    const uint64_t& microblock_gas_limit, const bool& txnProcTimeout,
+    PendingTxnQueue& t_pendingTxns,
+    vector<Transaction>& gasLimitExceededTxnBuffer,
+    vector<pair<TxnHash, TxnStatus>>& droppedTxns) {
+  LOG_MARKER();
+
+  // Payments are gathered into a wave assuming each of them succeeds with
+  // NORMAL_TRAN_GAS, so that the selection can go on before they are executed.
+  // Every selection step taken while the wave is not empty is journaled, and
+  // the steps following a wrong assumption are undone and taken again on the
+  // actual states. The outcome is therefore the same as the serial loop.
+  vector<Transaction> wave;
+  vector<size_t> waveUndoMarks;
+  vector<function<void()>> undoLog;
+  unordered_map<Address, uint128_t> predictedNonces;
+  uint64_t predictedGasUsed = m_gasUsedTotal;
+  bool stopProcessing = false;
+  unsigned int count_addrNonceTxnMap = 0;
+  unsigned int count_createdTxns = 0;
+  unsigned int count_waves = 0;
+  unsigned int count_mispredictions = 0;
+
+  auto logUndo = [&wave, &undoLog](function<void()>&& undo) -> void {
+    if (!wave.empty()) {
+      undoLog.emplace_back(move(undo));
+    }
+  };
+
+  auto reinsertToPool = [this](const Transaction& t) -> void {
+    MempoolInsertionStatus status;
+    t_createdTxns.insert(t, status);
+  };
+
+  auto getNonce = [&predictedNonces](const Address& address) -> uint128_t {
+    auto it = predictedNonces.find(address);
+    if (it != predictedNonces.end()) {
+      return it->second;
+    }
+    return AccountStore::GetInstance().GetNonceTemp(address);
+  };
+
+  // Bring the readiness of the queued txns of the sender back in line with
+  // its actual nonce
+  auto resetNonce = [&t_pendingTxns](const Address& address) -> void {
+    t_pendingTxns.UpdateNonce(
+        address, AccountStore::GetInstance().GetNonceTemp(address));
+  };
+
+  auto requeue = [&t_pendingTxns](const Transaction& t) -> void {
+    t_pendingTxns.Insert(
+        t, AccountStore::GetInstance().GetNonceTemp(t.GetSenderAddr()));
+  };
+
+  // Same bookkeeping as the serial loop, returns false if processing has to
+  // stop
+  auto recordResult = [this, &droppedTxns](const Transaction& t,
+                                           const TransactionReceipt& tr,
+                                           const bool success,
+                                           const TxnStatus error_code) -> bool {
+    if (!success) {
+      droppedTxns.emplace_back(t.GetTranID(), error_code);
+      return true;
+    }
+    if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
+                                 m_gasUsedTotal)) {
+      LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
+      return false;
+    }
+    uint128_t txnFee;
+    if (!SafeMath<uint128_t>::mul(tr.GetCumGas(), t.GetGasPrice(), txnFee)) {
+      LOG_GENERAL(WARNING, "txnFee multiplication unsafe!");
+      return true;
+    }
+    if (!SafeMath<uint128_t>::add(m_txnFees, txnFee, m_txnFees)) {
+      LOG_GENERAL(WARNING, "m_txnFees addition unsafe!");
+      return false;
+    }
+    t_processedTransactions.insert(
+        make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
+    m_TxnOrder.push_back(t.GetTranID());
+    return true;
+  };
+
+  // Executes the wave, returns true if an assumption turned out to be wrong,
+  // in which case the selection steps following it have been undone
+  auto flushWave = [&]() -> bool {
+    if (wave.empty()) {
+      return false;
+    }
+    count_waves++;
+
+    size_t mispredicted = wave.size();
+    AccountStore::GetInstance().UpdateAccountsTempInParallel(
+        m_mediator.m_currentEpochNum, getNumShards(),
+        m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE, wave,
+        [&](size_t index, const TxnExecutionResult& result) -> bool {
+          if (!recordResult(wave[index], result.m_receipt, result.m_success,
+                            result.m_errorCode)) {
+            stopProcessing = true;
+          }
+          if (stopProcessing || !result.m_success ||
+              result.m_receipt.GetCumGas() != NORMAL_TRAN_GAS) {
+            mispredicted = index;
+            return false;
+          }
+          return true;
+        });
+
+    const bool misprediction = mispredicted < wave.size();
+    if (misprediction) {
+      count_mispredictions++;
+      while (undoLog.size() > waveUndoMarks[mispredicted]) {
+        undoLog.back()();
+        undoLog.pop_back();
+      }
+    }
+
+    wave.clear();
+    waveUndoMarks.clear();
+    undoLog.clear();
+    predictedNonces.clear();
+    predictedGasUsed = m_gasUsedTotal;
+    return misprediction;
+  };
+
+  // Adds the txn to the wave, or flushes the wave and executes the txn right
+  // away if it cannot be executed speculatively
+  auto processOne = [&](const Transaction& t) -> void {
+    if (predictedGasUsed + t.GetGasLimit() > microblock_gas_limit) {
+      LOG_GENERAL(WARNING, "Gas limit exceeded = " << t.GetTranID());
+      LOG_GENERAL(WARNING, "m_gasUsedTotal     = " << predictedGasUsed);
+      LOG_GENERAL(WARNING, "t.GetGasLimit      = " << t.GetGasLimit());
+      gasLimitExceededTxnBuffer.emplace_back(t);
+      logUndo([&gasLimitExceededTxnBuffer]() -> void {
+        gasLimitExceededTxnBuffer.pop_back();
+      });
+      return;
+    }
+
+    TxnStatus error_code;
+    if (ParallelTxnExecutor::IsParallelizable(t) &&
+        m_mediator.m_validator->PreCheckCreatedTransaction(t, error_code)) {
+      const Address senderAddr = t.GetSenderAddr();
+      const uint128_t nextNonce = getNonce(senderAddr) + 1;
+      predictedNonces[senderAddr] = nextNonce;
+      predictedGasUsed += NORMAL_TRAN_GAS;
+      wave.emplace_back(t);
+      waveUndoMarks.emplace_back(undoLog.size());
+      t_pendingTxns.UpdateNonce(senderAddr, nextNonce);
+      logUndo([resetNonce, senderAddr]() -> void { resetNonce(senderAddr); });
+      if (wave.size() >= PARALLEL_TXN_EXECUTION_WAVE_SIZE) {
+        flushWave();
+      }
+      return;
+    }
+
+    if (flushWave()) {
+      // t was selected on a wrong assumption and is back where it came from
+      return;
+    }
+
+    TransactionReceipt tr;
+    const bool success =
+        m_mediator.m_validator->CheckCreatedTransaction(t, tr, error_code);
+    resetNonce(t.GetSenderAddr());
+    if (!recordResult(t, tr, success, error_code)) {
+      stopProcessing = true;
+    }
+  };
+
+  while (!stopProcessing) {
+    if (txnProcTimeout) {
+      LOG_GENERAL(INFO, "txnProcTimeout is set!");
+      flushWave();
+      break;
+    }
+
+    if (predictedGasUsed >= microblock_gas_limit) {
+      if (flushWave()) {
+        continue;
+      }
+      break;
+    }
+
+    Transaction t;
+
+    // check t_pendingTxns contains any txn meets right nonce,
+    // if contains, process the first one in the order of the queue
+    if (t_pendingTxns.FindOne(t)) {
+      count_addrNonceTxnMap++;
+      logUndo([requeue, t]() -> void { requeue(t); });
+      const TxnHash selectedTranID = t.GetTranID();
+      t_createdTxns.findSameNonceButHigherGas(t);
+      if (t.GetTranID() != selectedTranID) {
+        logUndo([reinsertToPool, t]() -> void { reinsertToPool(t); });
+      }
+      processOne(t);
+    }
+    // if no txn in t_pendingTxns is ready process new come-in transactions
+    else if (t_createdTxns.findOne(t)) {
+      count_createdTxns++;
+      logUndo([reinsertToPool, t]() -> void { reinsertToPool(t); });
+
+      const Address senderAddr = t.GetSenderAddr();
+      const uint128_t expectedNonce = getNonce(senderAddr) + 1;
+      if (t.GetNonce() > expectedNonce) {
+        LOG_GENERAL(INFO, "High nonce: " << t.GetNonce() << " cur sender "
+                                         << senderAddr.hex() << " nonce: "
+                                         << expectedNonce - 1);
+        Transaction queued;
+        if (!t_pendingTxns.Get(senderAddr, t.GetNonce(), queued)) {
+          logUndo([&t_pendingTxns, resetNonce, senderAddr,
+                   nonce = t.GetNonce()]() -> void {
+            t_pendingTxns.Erase(senderAddr, nonce);
+            resetNonce(senderAddr);
+          });
+        } else if (t.GetGasPrice() > queued.GetGasPrice()) {
+          logUndo([&t_pendingTxns, requeue, queued]() -> void {
+            t_pendingTxns.Erase(queued.GetSenderAddr(), queued.GetNonce());
+            requeue(queued);
+          });
+        }
+        t_pendingTxns.Insert(t, expectedNonce - 1);
+      } else if (t.GetNonce() < expectedNonce) {
+        LOG_GENERAL(INFO, "Nonce too small"
+                              << " Expected " << expectedNonce << " Found "
+                              << t.GetNonce() << " for " << t.GetTranID());
+        droppedTxns.emplace_back(t.GetTranID(), TxnStatus::NONCE_TOO_LOW);
+        logUndo([&droppedTxns]() -> void { droppedTxns.pop_back(); });
+      } else {
+        processOne(t);
+      }
+    } else {
+      if (flushWave()) {
+        continue;
+      }
+      LOG_GENERAL(INFO, "Ending txn processing loop");
+      break;
+    }
+  }
+
+  LOG_GENERAL(INFO, "AddrNonceTxnMap # txns = " << count_addrNonceTxnMap);
+  LOG_GENERAL(INFO, "t_createdTxns   # txns = " << count_createdTxns);
+  LOG_GENERAL(INFO, "Waves = " << count_waves
+                               << " mispredicted = " << count_mispredictions);
 }
 
 bool Node::VerifyTxnsOrdering(const vector<TxnHash>& tranHashes,
@@ -664,6 +902,15 @@ void Node::UpdateProcessedTransactions() {
   }
 }
 
+PendingTxnQueue::Order Node::GetPendingTxnOrder() {
+  // Picking by gas price changes the txn order the backups check, so the whole
+  // shard switches at the same DS block
+  return m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
+                 GAS_PRICE_TXN_ORDER_DS_NUM
+             ? PendingTxnQueue::Order::BY_GAS_PRICE
+             : PendingTxnQueue::Order::BY_ADDRESS;
+}
+
 void Node::ProcessTransactionWhenShardBackup(
     const uint64_t& microblock_gas_limit) {
   LOG_MARKER();
@@ -678,7 +925,7 @@ void Node::ProcessTransactionWhenShardBackup(
 
   t_createdTxns = m_createdTxns;
   m_expectedTranOrdering.clear();
-  map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
+  PendingTxnQueue t_pendingTxns(GetPendingTxnOrder());
   t_processedTransactions.clear();
 
   if (LOG_PARAMETERS) {
@@ -698,24 +945,17 @@ void Node::ProcessTransactionWhenShardBackup(
 
   this_thread::sleep_for(chrono::milliseconds(100));
 
-  auto findOneFromAddrNonceTxnMap =
-      [](Transaction& t,
-         std::map<Address, map<uint64_t, Transaction>>& t_addrNonceTxnMap)
-      -> bool {
-    for (auto it = t_addrNonceTxnMap.begin(); it != t_addrNonceTxnMap.end();
-         it++) {
-      if (it->second.begin()->first ==
-          AccountStore::GetInstance().GetNonceTemp(it->first) + 1) {
-        t = move(it->second.begin()->second);
-        it->second.erase(it->second.begin());
-
-        if (it->second.empty()) {
-          t_addrNonceTxnMap.erase(it);
-        }
-        return true;
-      }
-    }
-    return false;
+  // Applies the txn and makes the queued txn following it executable
+  auto checkCreatedTransaction = [this, &t_pendingTxns](
+                                     const Transaction& t,
+                                     TransactionReceipt& tr,
+                                     TxnStatus& error_code) -> bool {
+    const bool ret =
+        m_mediator.m_validator->CheckCreatedTransaction(t, tr, error_code);
+    t_pendingTxns.UpdateNonce(
+        t.GetSenderAddr(),
+        AccountStore::GetInstance().GetNonceTemp(t.GetSenderAddr()));
+    return ret;
   };
 
   auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
@@ -745,9 +985,9 @@ void Node::ProcessTransactionWhenShardBackup(
     Transaction t;
     TransactionReceipt tr;
 
-    // check t_addrNonceTxnMap contains any txn meets right nonce,
-    // if contains, process it
-    if (findOneFromAddrNonceTxnMap(t, t_addrNonceTxnMap)) {
+    // check t_pendingTxns contains any txn meets right nonce,
+    // if contains, process the first one in the order of the queue
+    if (t_pendingTxns.FindOne(t)) {
       count_addrNonceTxnMap++;
       // check whether m_createdTransaction have transaction with same Addr and
       // nonce if has and with larger gasPrice then replace with that one.
@@ -762,7 +1002,7 @@ void Node::ProcessTransactionWhenShardBackup(
         continue;
       }
       TxnStatus error_code;
-      if (m_mediator.m_validator->CheckCreatedTransaction(t, tr, error_code)) {
+      if (checkCreatedTransaction(t, tr, error_code)) {
         if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
                                      m_gasUsedTotal)) {
           LOG_GENERAL(WARNING, "m_gasUsedTotal addition unsafe!");
@@ -787,12 +1027,12 @@ void Node::ProcessTransactionWhenShardBackup(
       }
 
     }
-    // if no txn in u_map meet right nonce process new come-in transactions
+    // if no txn in t_pendingTxns is ready process new come-in transactions
     else if (t_createdTxns.findOne(t)) {
       count_createdTxns++;
       Address senderAddr = t.GetSenderAddr();
       // check nonce, if nonce larger than expected, put it into
-      // t_addrNonceTxnMap
+      // t_pendingTxns
       if (t.GetNonce() >
           AccountStore::GetInstance().GetNonceTemp(senderAddr) + 1) {
         LOG_GENERAL(
@@ -800,19 +1040,8 @@ void Node::ProcessTransactionWhenShardBackup(
                       << t.GetNonce() << " cur sender " << senderAddr.hex()
                       << " nonce: "
                       << AccountStore::GetInstance().GetNonceTemp(senderAddr));
-        auto it1 = t_addrNonceTxnMap.find(senderAddr);
-        if (it1 != t_addrNonceTxnMap.end()) {
-          auto it2 = it1->second.find(t.GetNonce());
-          if (it2 != it1->second.end()) {
-            // found the txn with same addr and same nonce
-            // then compare the gasprice and remains the higher one
-            if (t.GetGasPrice() > it2->second.GetGasPrice()) {
-              it2->second = t;
-            }
-            continue;
-          }
-        }
-        t_addrNonceTxnMap[senderAddr].insert({t.GetNonce(), t});
+        t_pendingTxns.Insert(
+            t, AccountStore::GetInstance().GetNonceTemp(senderAddr));
       }
       // if nonce too small, ignore it
       else if (t.GetNonce() <
@@ -835,8 +1064,7 @@ void Node::ProcessTransactionWhenShardBackup(
           continue;
         }
         TxnStatus error_code;
-        if (m_mediator.m_validator->CheckCreatedTransaction(t, tr,
-                                                            error_code)) {
+        if (checkCreatedTransaction(t, tr, error_code)) {
           if (!SafeMath<uint64_t>::add(m_gasUsedTotal, tr.GetCumGas(),
                                        m_gasUsedTotal)) {
             LOG_GENERAL(WARNING, "m_gasUsedTotal addition overflow!");
@@ -886,7 +1114,8 @@ void Node::ProcessTransactionWhenShardBackup(
                                << " Time=" << elaspedTimeMs);
   }
 
-  ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer, droppedTxns);
+  ReinstateMemPool(t_pendingTxns.GetTxns(), gasLimitExceededTxnBuffer,
+                   droppedTxns);
 }
 
 void Node::PutTxnsInTempDataBase(
@@ -988,7 +1217,7 @@ void Node::PutAllTxnsInUnconfirmedTxns() {
 
   uint count = 0;
 
-  for (const auto& t : m_createdTxns.HashIndex) {
+  for (const auto& t : m_createdTxns.GetHashIndex()) {
     if (m_unconfirmedTxns
             .emplace(t.first, TxnStatus::PRESENT_VALID_CONSENSUS_NOT_REACHED)
             .second) {
@@ -996,7 +1225,7 @@ void Node::PutAllTxnsInUnconfirmedTxns() {
     }
   }
 
-  for (const auto& t : t_createdTxns.HashIndex) {
+  for (const auto& t : t_createdTxns.GetHashIndex()) {
     if (m_unconfirmedTxns
             .emplace(t.first, TxnStatus::PRESENT_VALID_CONSENSUS_NOT_REACHED)
             .second) {
@@ -1201,7 +1430,7 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
 
   // m_consensusID = 0;
   m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                             ->GetHeader()
                              .GetMyHash()
                              .asBytes();
 
@@ -1272,7 +1501,7 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
       "[MICON-BEG]["
       << setw(15) << left << m_mediator.m_selfPeer.GetPrintableIPAddress()
       << "]["
-      << m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1
+      << m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1
       << "][" << m_myshardId << "]");
 
   cl->StartConsensus(preprepMBAnnouncementGeneratorFunc,
@@ -1308,12 +1537,12 @@ bool Node::RunConsensusOnMicroBlockWhenShardBackup() {
   }
 
   if (m_mediator.m_ds->m_mode == DirectoryService::Mode::IDLE &&
-      ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
+      ((m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
         m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     // extra time added for first txepoch for tx distribution
     auto extra_wait_time =
@@ -1335,7 +1564,7 @@ bool Node::RunConsensusOnMicroBlockWhenShardBackup() {
           << m_mediator.m_currentEpochNum);
   // m_consensusID = 0;
   m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                             ->GetHeader()
                              .GetMyHash()
                              .asBytes();
 
@@ -1536,12 +1765,12 @@ unsigned char Node::CheckLegitimacyOfTxnHashes(bytes& errorMsg) {
   }
 
   if (!m_mediator.GetIsVacuousEpoch() &&
-      ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
+      ((m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
         m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     vector<TxnHash> missingTxnHashes;
     if (!VerifyTxnsOrdering(m_microblock->GetTranHashes(), missingTxnHashes)) {
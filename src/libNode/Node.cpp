@@ -44,6 +44,7 @@
 #include "libNetwork/Blacklist.h"
 #include "libNetwork/Guard.h"
 #include "libPOW/pow.h"
+#include "libPersistence/PersistenceDownloader.h"
 #include "libPersistence/Retriever.h"
 #include "libPythonRunner/PythonRunner.h"
 #include "libUtils/DataConversion.h"
@@ -80,7 +81,7 @@ void Node::PopulateAccounts(bool temp) {
     while (getline(keys_file, line) &&
            m_accountPopulated < (NUM_ACCOUNTS_PREGENERATE *
                                  (m_mediator.m_dsBlockChain.GetLastBlock()
-                                      .GetHeader()
+                                      ->GetHeader()
                                       .GetBlockNum() +
                                   1))) {
       m_accountPopulated++;
@@ -164,6 +165,17 @@ bool Node::DownloadPersistenceFromS3() {
     LOG_GENERAL(INFO, "Purge Already Running");
     this_thread::sleep_for(chrono::milliseconds(10));
   }
+  if (ENABLE_NATIVE_PERSISTENCE_DOWNLOAD && !LOOKUP_NODE_MODE) {
+    // The lookups also need the static historical data, still fetched by the
+    // script
+    PersistenceDownloader downloader(
+        PERSISTENCE_DOWNLOAD_URL.empty()
+            ? "http://" + BUCKET_NAME + ".s3.amazonaws.com"
+            : PERSISTENCE_DOWNLOAD_URL,
+        TESTNET_NAME, STORAGE_PATH, true, PERSISTENCE_DOWNLOAD_THREADS,
+        (uint64_t)PERSISTENCE_DOWNLOAD_CHUNK_SIZE_MB * 1024 * 1024);
+    return downloader.Start();
+  }
   string excludembtxns = LOOKUP_NODE_MODE ? "false" : "true";
   return PythonRunner::RunPyFunc("download_incr_DB", "start",
                                  {STORAGE_PATH + "/", excludembtxns},
@@ -188,9 +200,9 @@ bool Node::Install(const SyncType syncType, const bool toRetrieveHistory,
 
     m_synchronizer.InitializeGenesisBlocks(m_mediator.m_dsBlockChain,
                                            m_mediator.m_txBlockChain);
-    const auto& dsBlock = m_mediator.m_dsBlockChain.GetBlock(0);
+    const auto dsBlock = m_mediator.m_dsBlockChain.GetBlockPtr(0);
     m_mediator.m_blocklinkchain.AddBlockLink(0, 0, BlockType::DS,
-                                             dsBlock.GetBlockHash());
+                                             dsBlock->GetBlockHash());
 
     return true;
   }
@@ -268,9 +280,9 @@ void Node::Init() {
 
   m_synchronizer.InitializeGenesisBlocks(m_mediator.m_dsBlockChain,
                                          m_mediator.m_txBlockChain);
-  const auto& dsBlock = m_mediator.m_dsBlockChain.GetBlock(0);
+  const auto dsBlock = m_mediator.m_dsBlockChain.GetBlockPtr(0);
   m_mediator.m_blocklinkchain.AddBlockLink(0, 0, BlockType::DS,
-                                           dsBlock.GetBlockHash());
+                                           dsBlock->GetBlockHash());
 }
 
 void Node::AddGenesisInfo(SyncType syncType) {
@@ -315,7 +327,7 @@ bool Node::CheckIntegrity(const bool fromValidateDBBinary) {
     }
     latestTxBlock = *latestTxBlockPtr;
   } else {
-    latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock();
+    latestTxBlock = *m_mediator.m_txBlockChain.GetLastBlock();
   }
 
   const uint64_t& latestTxBlockNum = latestTxBlock.GetHeader().GetBlockNum();
@@ -648,12 +660,12 @@ bool Node::ValidateDB() {
 void Node::Prepare(bool runInitializeGenesisBlocks) {
   LOG_MARKER();
   m_mediator.m_currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
   m_mediator.UpdateDSBlockRand(runInitializeGenesisBlocks);
   m_mediator.UpdateTxBlockRand(runInitializeGenesisBlocks);
   SetState(POW_SUBMISSION);
   POW::GetInstance().EthashConfigureClient(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1,
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1,
       FULL_DATASET_MINE);
 }
 
@@ -900,7 +912,9 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
       m_mediator.m_lookup->m_skipAddStateDeltaToAccountStore = false;
       do {
         m_mediator.m_lookup->GetStateDeltaFromSeedNodes(
-            m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum());
+            m_mediator.m_txBlockChain.GetLastBlock()
+                ->GetHeader()
+                .GetBlockNum());
         LOG_GENERAL(INFO,
                     "Retrieve final block state delta from lookup node, please "
                     "wait...");
@@ -921,10 +935,10 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
   if (!LOOKUP_NODE_MODE &&
       SyncType::NO_SYNC == m_mediator.m_lookup->GetSyncType() &&
       SyncType::RECOVERY_ALL_SYNC != syncType &&
-      (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+      (m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() <
            NUM_FINAL_BLOCK_PER_POW ||
        m_mediator.GetIsVacuousEpoch(
-           m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+           m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
            1))) {
     LOG_GENERAL(WARNING,
                 "Node recovery with vacuous epoch or in first DS epoch, apply "
@@ -936,25 +950,28 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
   /// However, if the last tx block is one from vacaous epoch, its already too
   /// late and coinbase info is of no use. so skip saving coinbase
   if (bDS &&
-      (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1) %
-              NUM_FINAL_BLOCK_PER_POW !=
+      (m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
+       1) % NUM_FINAL_BLOCK_PER_POW !=
           0) {
-    for (uint64_t blockNum =
-             m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+    for (uint64_t blockNum = m_mediator.m_dsBlockChain.GetLastBlock()
+                                 ->GetHeader()
+                                 .GetEpochNum();
          blockNum <=
-         m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+         m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
          ++blockNum) {
       LOG_GENERAL(INFO, "Update coin base for finalblock with blockNum: "
                             << blockNum << ", reward: "
-                            << m_mediator.m_txBlockChain.GetBlock(blockNum)
-                                   .GetHeader()
+                            << m_mediator.m_txBlockChain.GetBlockPtr(blockNum)
+                                   ->GetHeader()
                                    .GetRewards());
       m_mediator.m_ds->SaveCoinbase(
-          m_mediator.m_txBlockChain.GetBlock(blockNum).GetB1(),
-          m_mediator.m_txBlockChain.GetBlock(blockNum).GetB2(),
+          m_mediator.m_txBlockChain.GetBlockPtr(blockNum)->GetB1(),
+          m_mediator.m_txBlockChain.GetBlockPtr(blockNum)->GetB2(),
           CoinbaseReward::FINALBLOCK_REWARD, blockNum + 1);
-      m_mediator.m_ds->m_totalTxnFees +=
-          m_mediator.m_txBlockChain.GetBlock(blockNum).GetHeader().GetRewards();
+      m_mediator.m_ds->m_totalTxnFees += m_mediator.m_txBlockChain
+                                             .GetBlockPtr(blockNum)
+                                             ->GetHeader()
+                                             .GetRewards();
     }
   }
 
@@ -1041,14 +1058,16 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
   /// However, if the last tx block is one from vacaous epoch, its already too
   /// late and coinbase info is of no use. so skip saving coinbase
   if (bDS &&
-      (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1) %
-              NUM_FINAL_BLOCK_PER_POW !=
+      (m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
+       1) % NUM_FINAL_BLOCK_PER_POW !=
           0) {
     m_mediator.m_ds->SetState(DirectoryService::DirState::SYNC);
     std::list<MicroBlockSharedPtr> microBlocks;
     if (BlockStorage::GetBlockStorage().GetRangeMicroBlocks(
-            m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum(),
-            m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+            m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetEpochNum(),
+            m_mediator.m_txBlockChain.GetLastBlock()
+                    ->GetHeader()
+                    .GetBlockNum() +
                 1,
             0, m_mediator.m_ds->m_shards.size(), microBlocks)) {
       for (const auto& microBlock : microBlocks) {
@@ -1075,15 +1094,16 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
     std::map<uint64_t, std::map<int32_t, std::vector<PubKey>>>
         coinbaseRewardeesTmp;
     m_mediator.m_ds->GetCoinbaseRewardees(coinbaseRewardeesTmp);
-    for (auto blockNum =
-             m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+    for (auto blockNum = m_mediator.m_dsBlockChain.GetLastBlock()
+                             ->GetHeader()
+                             .GetEpochNum();
          blockNum <=
-         m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+         m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
          blockNum++) {
       const auto& it = coinbaseRewardeesTmp.find(blockNum);
       if (it == coinbaseRewardeesTmp.end() ||
-          (it->second.size() <= m_mediator.m_txBlockChain.GetBlock(blockNum)
-                                    .GetMicroBlockInfos()
+          (it->second.size() <= m_mediator.m_txBlockChain.GetBlockPtr(blockNum)
+                                    ->GetMicroBlockInfos()
                                     .size())) {
         m_mediator.m_lookup->ComposeAndSendGetCosigsRewardsFromSeed(blockNum);
         this_thread::sleep_for(chrono::milliseconds(100));
@@ -1104,7 +1124,7 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
   if ((bDS && SyncType::NEW_SYNC == syncType) ||
       SyncType::RECOVERY_ALL_SYNC == syncType) {
     m_mediator.m_currentEpochNum =
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
     m_mediator.IncreaseEpochNum();
 
     m_consensusLeaderID = 0;
@@ -1211,7 +1231,7 @@ void Node::WakeupAtTxEpoch() {
 
   m_consensusLeaderID =
       DataConversion::charArrTo16Bits(
-          m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes()) %
+          m_mediator.m_txBlockChain.GetLastBlock()->GetBlockHash().asBytes()) %
       m_myShardMembers->size();
 
   if (DirectoryService::IDLE != m_mediator.m_ds->m_mode) {
@@ -1305,7 +1325,7 @@ void Node::StartSynchronization() {
       m_synchronizer.FetchLatestTxBlockSeed(
           m_mediator.m_lookup,
           // m_mediator.m_txBlockChain.GetBlockCount());
-          m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+          m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
               1);
       this_thread::sleep_for(chrono::seconds(m_mediator.m_lookup->m_startedPoW
                                                  ? POW_WINDOW_IN_SECONDS
@@ -1650,7 +1670,7 @@ bool Node::ProcessTxnPacketFromLookup(
     if (((m_mediator.m_currentEpochNum % NUM_FINAL_BLOCK_PER_POW == 0) &&
          (m_mediator.m_consensusID != 0)) ||
         ((m_mediator.m_currentEpochNum == 1) &&
-         (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() ==
+         (m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() ==
           0))) {
       SHA2<HashType::HASH_VARIANT_256> sha256;
       sha256.Update(message);  // message hash
@@ -1782,11 +1802,11 @@ bool Node::ProcessTxnPacketFromLookupCore(const bytes& message,
   }
 
   if (dsBlockNum !=
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum()) {
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum()) {
     LOG_GENERAL(WARNING, "Wrong DS block num ("
                              << dsBlockNum << "), expected ("
                              << m_mediator.m_dsBlockChain.GetLastBlock()
-                                    .GetHeader()
+                                    ->GetHeader()
                                     .GetBlockNum()
                              << ")");
     return false;
@@ -2348,7 +2368,7 @@ bool Node::ComposeAndSendRemoveNodeFromBlacklist(const RECEIVERTYPE receiver) {
                    NodeInstructionType::REMOVENODEFROMBLACKLIST};
 
   uint64_t curDSEpochNo =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (!Messenger::SetNodeRemoveFromBlacklist(
           message, MessageOffset::BODY, m_mediator.m_selfKey,
@@ -2437,7 +2457,7 @@ bool Node::ProcessRemoveNodeFromBlacklist(
   // dsepoch.
   if (!LOOKUP_NODE_MODE) {
     uint64_t currentDSEpochNumber =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
     if (dsEpochNumber != currentDSEpochNumber) {
       LOG_CHECK_FAIL("DS Epoch", dsEpochNumber, currentDSEpochNumber);
       return false;
@@ -2534,7 +2554,7 @@ bool Node::UpdateShardNodeIdentity() {
       MessageType::NODE, NodeInstructionType::NEWSHARDNODEIDENTITY};
 
   uint64_t curDSEpochNo =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (!Messenger::SetNodeNewShardNodeNetworkInfo(
           updateShardNodeIdentitymessage, MessageOffset::BODY, curDSEpochNo,
@@ -2610,7 +2630,7 @@ bool Node::ProcessNewShardNodeNetworkInfo(
   }
 
   uint64_t currentDSEpochNumber =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
 
   if (dsEpochNumber != currentDSEpochNumber) {
     LOG_GENERAL(
@@ -2766,7 +2786,7 @@ void Node::QueryLookupForDSGuardNetworkInfoUpdate() {
       MessageType::LOOKUP,
       LookupInstructionType::GETGUARDNODENETWORKINFOUPDATE};
   uint64_t dsEpochNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   LOG_GENERAL(INFO,
               "Querying the lookup for any ds guard node network info change "
@@ -3185,7 +3205,7 @@ void Node::CleanLocalRawStores() {
 
   uint64_t key_txepoch = m_mediator.m_currentEpochNum - NUM_FINAL_BLOCK_PER_POW;
   uint64_t key_dsepoch =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() - 1;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() - 1;
 
   // Clear VCStore
   {
@@ -34,6 +34,7 @@
 #include "libData/AccountData/MBnForwardedTxnEntry.h"
 #include "libData/AccountData/Transaction.h"
 #include "libData/AccountData/TransactionReceipt.h"
+#include "libData/AccountData/PendingTxnQueue.h"
 #include "libData/AccountData/TxnPool.h"
 #include "libData/BlockData/Block.h"
 #include "libLookup/Synchronizer.h"
@@ -633,7 +634,16 @@ class Node : public Executable {
 
   void StartTxnProcessingThread();
   void ProcessTransactionWhenShardLeader(const uint64_t& microblock_gas_limit);
+  // Selection loop of ProcessTransactionWhenShardLeader executing payments
+  // concurrently, see ENABLE_PARALLEL_TXN_EXECUTION
+  void ProcessTransactionsInParallel(
+      const uint64_t& microblock_gas_limit, const bool& txnProcTimeout,
+      PendingTxnQueue& t_pendingTxns,
+      std::vector<Transaction>& gasLimitExceededTxnBuffer,
+      std::vector<std::pair<TxnHash, TxnStatus>>& droppedTxns);
   void ProcessTransactionWhenShardBackup(const uint64_t& microblock_gas_limit);
+  // Order of the queued txns ready to run, the same on leader and backups
+  PendingTxnQueue::Order GetPendingTxnOrder();
   bool ComposePrePrepMicroBlock(const uint64_t& microblock_gas_limit);
   bool ComposeMicroBlock(const uint64_t& microblock_gas_limit);
   bool CheckMicroBlockValidity(bytes& errorMsg,
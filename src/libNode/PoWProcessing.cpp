@@ -54,7 +54,8 @@ bool Node::GetLatestDSBlock() {
          counter <= FETCH_LOOKUP_MSG_MAX_RETRY) {
     m_synchronizer.FetchLatestDSBlocksSeed(
         m_mediator.m_lookup,
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1);
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() +
+            1);
     {
       unique_lock<mutex> lock(
           m_mediator.m_lookup->m_mutexLatestDSBlockUpdation);
@@ -168,7 +169,7 @@ bool Node::StartPoW(const uint64_t& block_num, uint8_t ds_difficulty,
 
         if (m_mediator.m_currentEpochNum ==
             m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+                ->GetHeader()
                 .GetEpochNum()) {
           LOG_GENERAL(WARNING, "DS was processed just now, ignore time out");
           return;
@@ -306,7 +307,7 @@ bool Node::CheckIfGovProposalActive() {
 #endif
 
   uint64_t curDSEpochNo =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   curDSEpochNo++;
   if (curDSEpochNo >= m_govProposalInfo.startDSEpoch &&
       curDSEpochNo <= m_govProposalInfo.endDSEpoch) {
@@ -357,7 +358,7 @@ bool Node::SendPoWResultToDSComm(const uint64_t& block_num,
   PairOfNode dsLeader;
   if (!m_mediator.m_DSCommittee->empty()) {
     if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
-                          m_mediator.m_dsBlockChain.GetLastBlock(),
+                          *m_mediator.m_dsBlockChain.GetLastBlock(),
                           *m_mediator.m_DSCommittee, dsLeader)) {
       peerList.push_back(dsLeader.second);
     }
@@ -503,7 +504,7 @@ bool Node::ProcessStartPoW(const bytes& message, unsigned int offset,
   LOG_MARKER();
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlock()
-                                         .GetHeader()
+                                         ->GetHeader()
                                          .GetBlockNum() +
                                      1);
 
@@ -530,11 +531,11 @@ bool Node::ProcessStartPoW(const bytes& message, unsigned int offset,
 
   if (m_mediator.m_isRetrievedHistory) {
     block_num =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum() + 1;
     dsDifficulty =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDSDifficulty();
     difficulty =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty();
     rand1 = m_mediator.m_dsBlockRand;
     rand2 = m_mediator.m_txBlockRand;
   }
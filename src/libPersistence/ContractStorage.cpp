@@ -445,9 +445,9 @@ bool ContractStorage::FetchExternalStateValue(
     return true;
   } else if (query.name() == "_code") {
     // Get the code directly from the account storage.
-    bytes code = account->GetCode();
+    const CodeBytes code = account->GetCode();
     ProtoScillaVal value;
-    value.set_bval(&code[0], code.size());
+    value.set_bval(code->data(), code->size());
     SerializeToArray(value, dst, 0);
     foundVal = true;
     return true;
@@ -0,0 +1,960 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#include "PersistenceDownloader.h"
+#include "common/Constants.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+namespace {
+
+const string PERSISTENCE_SNAPSHOT_NAME = "incremental";
+const string STATEDELTA_DIFF_NAME = "statedelta";
+const string PART_SUFFIX = ".part";
+const string JOURNAL_SUFFIX = ".part.chunks";
+/// Part size used by upload_incr_DB.py, which the ETags depend on
+const uint64_t S3_MULTIPART_CHUNK_SIZE = 8 * 1024 * 1024;
+const unsigned int MAX_FETCH_ATTEMPTS = 4;
+const unsigned int MAX_LIST_KEYS = 1000;
+const long CONNECT_TIMEOUT_SEC = 30;
+/// Aborts a transfer stalled for this long
+const long LOW_SPEED_TIME_SEC = 60;
+const size_t TAR_BLOCK_SIZE = 512;
+
+size_t WriteString(void* contents, size_t size, size_t nmemb, void* userp) {
+  ((string*)userp)->append((char*)contents, size * nmemb);
+  return size * nmemb;
+}
+
+/// Writes the body of a ranged request at its offset in the partial file
+struct ChunkWriter {
+  int m_fd;
+  uint64_t m_offset;
+  uint64_t m_length;
+  uint64_t m_written;
+};
+
+size_t WriteChunk(void* contents, size_t size, size_t nmemb, void* userp) {
+  auto* writer = (ChunkWriter*)userp;
+  const size_t len = size * nmemb;
+  if (writer->m_written + len > writer->m_length) {
+    // The range was not honoured
+    return 0;
+  }
+  const char* data = (const char*)contents;
+  size_t done = 0;
+  while (done < len) {
+    const ssize_t n = pwrite(writer->m_fd, data + done, len - done,
+                             writer->m_offset + writer->m_written + done);
+    if (n <= 0) {
+      return 0;
+    }
+    done += n;
+  }
+  writer->m_written += len;
+  return len;
+}
+
+size_t ReadETagHeader(char* buffer, size_t size, size_t nitems,
+                      void* userp) {
+  const size_t len = size * nitems;
+  const string line(buffer, len);
+  const string name = "etag:";
+  if (line.size() > name.size() &&
+      equal(name.begin(), name.end(), line.begin(),
+            [](char a, char b) { return a == tolower(b); })) {
+    string value = line.substr(name.size());
+    value.erase(0, value.find_first_not_of(" \t"));
+    value.erase(value.find_last_not_of(" \t\r\n") + 1);
+    *(string*)userp = value;
+  }
+  return len;
+}
+
+string StripQuotes(const string& etag) {
+  string result = etag;
+  result.erase(remove(result.begin(), result.end(), '"'), result.end());
+  return result;
+}
+
+string ToHex(const unsigned char* data, unsigned int len) {
+  static const char* digits = "0123456789abcdef";
+  string hex;
+  for (unsigned int i = 0; i < len; i++) {
+    hex += digits[data[i] >> 4];
+    hex += digits[data[i] & 0x0f];
+  }
+  return hex;
+}
+
+bool EndsWith(const string& str, const string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool IsExcluded(const string& key, bool excludeTxnBodies) {
+  if (key.empty() || key[0] == '.' || key.back() == '/' ||
+      key.find("diff_persistence") != string::npos) {
+    return true;
+  }
+  if (!excludeTxnBodies) {
+    return false;
+  }
+  for (const char* name : {"txEpochs", "txBodies", "microBlock", "minerInfo"}) {
+    if (key.find(name) != string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadFull(gzFile gz, void* buffer, size_t len) {
+  size_t done = 0;
+  while (done < len) {
+    const int n = gzread(gz, (char*)buffer + done, len - done);
+    if (n <= 0) {
+      return false;
+    }
+    done += n;
+  }
+  return true;
+}
+
+bool Skip(gzFile gz, uint64_t len) {
+  char buffer[TAR_BLOCK_SIZE];
+  while (len > 0) {
+    const size_t n = min<uint64_t>(len, sizeof(buffer));
+    if (!ReadFull(gz, buffer, n)) {
+      return false;
+    }
+    len -= n;
+  }
+  return true;
+}
+
+uint64_t ParseOctal(const unsigned char* field, size_t len) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < len && field[i] != '\0'; i++) {
+    if (field[i] >= '0' && field[i] <= '7') {
+      value = value * 8 + (field[i] - '0');
+    }
+  }
+  return value;
+}
+
+string ParseString(const unsigned char* field, size_t len) {
+  const char* str = (const char*)field;
+  return string(str, strnlen(str, len));
+}
+
+/// Returns the path of an archive entry relative to destDir, or false if it
+/// would land outside it
+bool GetEntryPath(const string& name, const string& stripPrefix,
+                  string& relPath, bool& skip) {
+  string path = name;
+  while (path.compare(0, 2, "./") == 0) {
+    path.erase(0, 2);
+  }
+  skip = false;
+  if (!stripPrefix.empty()) {
+    if (path == stripPrefix || path == stripPrefix + "/") {
+      path.clear();
+    } else if (path.compare(0, stripPrefix.size() + 1, stripPrefix + "/") ==
+               0) {
+      path.erase(0, stripPrefix.size() + 1);
+    } else {
+      skip = true;
+      return true;
+    }
+  }
+  if (!path.empty() && path[0] == '/') {
+    return false;
+  }
+  for (const auto& part : fs::path(path)) {
+    if (part == "..") {
+      return false;
+    }
+  }
+  relPath = path;
+  return true;
+}
+
+}  // namespace
+
+struct PersistenceDownloader::Download {
+  RemoteObject m_object;
+  string m_url;
+  string m_path;
+  uint64_t m_numChunks{0};
+  /// Set if the object is already in place
+  bool m_complete{false};
+  int m_fd{-1};
+  FILE* m_journal{nullptr};
+
+  mutex m_mutex;
+  vector<bool> m_chunkDone;
+  bool m_failed{false};
+};
+
+PersistenceDownloader::PersistenceDownloader(const string& baseUrl,
+                                             const string& testnetName,
+                                             const string& storagePath,
+                                             bool excludeTxnBodies,
+                                             unsigned int numThreads,
+                                             uint64_t chunkSize)
+    : m_baseUrl(baseUrl),
+      m_testnetName(testnetName),
+      m_storagePath(storagePath),
+      m_excludeTxnBodies(excludeTxnBodies),
+      m_numThreads(max(numThreads, 1u)),
+      m_chunkSize(max<uint64_t>(chunkSize, 1)) {
+  curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+PersistenceDownloader::~PersistenceDownloader() { curl_global_cleanup(); }
+
+bool PersistenceDownloader::IsLocal() const {
+  return m_baseUrl.compare(0, 7, "file://") == 0;
+}
+
+string PersistenceDownloader::GetUrl(const string& key) const {
+  return m_baseUrl + "/" + key;
+}
+
+bool PersistenceDownloader::Fetch(const string& url, string& body) {
+  unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(),
+                                                      &curl_easy_cleanup);
+  if (!curl) {
+    LOG_GENERAL(WARNING, "curl initialization fail!");
+    return false;
+  }
+  body.clear();
+  curl_easy_setopt(curl.get(), CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl.get(), CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_FAILONERROR, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_SEC);
+  curl_easy_setopt(curl.get(), CURLOPT_WRITEFUNCTION, WriteString);
+  curl_easy_setopt(curl.get(), CURLOPT_WRITEDATA, &body);
+  return curl_easy_perform(curl.get()) == CURLE_OK;
+}
+
+bool PersistenceDownloader::StatObject(const string& folder,
+                                       RemoteObject& object) {
+  const string key = folder + "/" + m_testnetName + "/" + object.m_key;
+
+  if (IsLocal()) {
+    boost::system::error_code ec;
+    const fs::path path(m_baseUrl.substr(7) + "/" + key);
+    if (!fs::is_regular_file(path, ec)) {
+      return false;
+    }
+    object.m_size = fs::file_size(path, ec);
+    object.m_etag.clear();
+    return !ec;
+  }
+
+  unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(),
+                                                      &curl_easy_cleanup);
+  if (!curl) {
+    LOG_GENERAL(WARNING, "curl initialization fail!");
+    return false;
+  }
+  string etag;
+  curl_easy_setopt(curl.get(), CURLOPT_URL, GetUrl(key).c_str());
+  curl_easy_setopt(curl.get(), CURLOPT_NOBODY, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_NOSIGNAL, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_FAILONERROR, 1L);
+  curl_easy_setopt(curl.get(), CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_SEC);
+  curl_easy_setopt(curl.get(), CURLOPT_HEADERFUNCTION, ReadETagHeader);
+  curl_easy_setopt(curl.get(), CURLOPT_HEADERDATA, &etag);
+  curl_off_t size = -1;
+  if (curl_easy_perform(curl.get()) != CURLE_OK ||
+      curl_easy_getinfo(curl.get(), CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+                        &size) != CURLE_OK ||
+      size < 0) {
+    return false;
+  }
+  object.m_size = size;
+  object.m_etag = etag;
+  return true;
+}
+
+bool PersistenceDownloader::IsUploadLocked() {
+  RemoteObject lock;
+  lock.m_key = ".lock";
+  return StatObject(PERSISTENCE_SNAPSHOT_NAME, lock);
+}
+
+bool PersistenceDownloader::GetCurrentTxBlkNum(uint64_t& txBlkNum) {
+  string body;
+  if (!Fetch(GetUrl(PERSISTENCE_SNAPSHOT_NAME + "/" + m_testnetName +
+                    "/.currentTxBlk"),
+             body)) {
+    return false;
+  }
+  try {
+    txBlkNum = stoull(body);
+  } catch (exception& e) {
+    LOG_GENERAL(WARNING, "Invalid .currentTxBlk: " << body);
+    return false;
+  }
+  return true;
+}
+
+bool PersistenceDownloader::ParseListObjects(const string& xml,
+                                             vector<RemoteObject>& objects,
+                                             bool& isTruncated) {
+  using boost::property_tree::ptree;
+
+  ptree pt;
+  try {
+    istringstream iss(xml);
+    read_xml(iss, pt);
+    const ptree& result = pt.get_child("ListBucketResult");
+    isTruncated = result.get<string>("IsTruncated", "false") == "true";
+    for (const auto& node : result) {
+      if (node.first != "Contents") {
+        continue;
+      }
+      RemoteObject object;
+      object.m_key = node.second.get<string>("Key");
+      object.m_size = node.second.get<uint64_t>("Size");
+      object.m_etag = node.second.get<string>("ETag", "");
+      objects.emplace_back(move(object));
+    }
+  } catch (exception& e) {
+    LOG_GENERAL(WARNING, "Invalid ListObjects response: " << e.what());
+    return false;
+  }
+  return true;
+}
+
+bool PersistenceDownloader::ListObjects(const string& folder,
+                                        vector<RemoteObject>& objects) {
+  const string prefix = folder + "/" + m_testnetName;
+  objects.clear();
+
+  if (IsLocal()) {
+    const fs::path root(m_baseUrl.substr(7) + "/" + prefix);
+    boost::system::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+      LOG_GENERAL(WARNING, "Missing " << root.string());
+      return false;
+    }
+    for (fs::recursive_directory_iterator it(root, ec), end; it != end && !ec;
+         it.increment(ec)) {
+      if (!fs::is_regular_file(it->path())) {
+        continue;
+      }
+      RemoteObject object;
+      object.m_key = it->path().lexically_relative(root).generic_string();
+      object.m_size = fs::file_size(it->path());
+      if (!IsExcluded(object.m_key, m_excludeTxnBodies)) {
+        objects.emplace_back(move(object));
+      }
+    }
+    return !ec;
+  }
+
+  unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(curl_easy_init(),
+                                                      &curl_easy_cleanup);
+  if (!curl) {
+    LOG_GENERAL(WARNING, "curl initialization fail!");
+    return false;
+  }
+  auto escape = [&curl](const string& str) {
+    char* escaped = curl_easy_escape(curl.get(), str.c_str(), str.size());
+    const string result(escaped != nullptr ? escaped : "");
+    curl_free(escaped);
+    return result;
+  };
+
+  string marker;
+  bool isTruncated = true;
+  while (isTruncated) {
+    string xml;
+    const string url = m_baseUrl + "/?prefix=" + escape(prefix) +
+                       "&max-keys=" + to_string(MAX_LIST_KEYS) +
+                       "&marker=" + escape(marker);
+    vector<RemoteObject> page;
+    if (!Fetch(url, xml) || !ParseListObjects(xml, page, isTruncated)) {
+      LOG_GENERAL(WARNING, "Failed to list " << prefix);
+      return false;
+    }
+    if (page.empty()) {
+      break;
+    }
+    marker = page.back().m_key;
+    for (auto& object : page) {
+      if (object.m_key.compare(0, prefix.size() + 1, prefix + "/") != 0) {
+        continue;
+      }
+      object.m_key.erase(0, prefix.size() + 1);
+      if (!IsExcluded(object.m_key, m_excludeTxnBodies)) {
+        objects.emplace_back(move(object));
+      }
+    }
+  }
+  return true;
+}
+
+bool PersistenceDownloader::PrepareDownload(Download& download) {
+  const RemoteObject& object = download.m_object;
+  boost::system::error_code ec;
+  fs::create_directories(fs::path(download.m_path).parent_path(), ec);
+
+  if (fs::is_regular_file(download.m_path, ec) &&
+      fs::file_size(download.m_path, ec) == object.m_size &&
+      (object.m_etag.empty() ||
+       StripQuotes(ComputeETag(download.m_path, S3_MULTIPART_CHUNK_SIZE)) ==
+           StripQuotes(object.m_etag))) {
+    download.m_complete = true;
+    m_numSkippedObjects++;
+    return true;
+  }
+
+  download.m_numChunks = (object.m_size + m_chunkSize - 1) / m_chunkSize;
+  download.m_chunkDone.assign(download.m_numChunks, false);
+  const string partPath = download.m_path + PART_SUFFIX;
+  const string journalPath = download.m_path + JOURNAL_SUFFIX;
+  const string header = to_string(object.m_size) + " " +
+                        StripQuotes(object.m_etag) + " " +
+                        to_string(m_chunkSize);
+
+  // Picks up the chunks journaled by an earlier run for the same object
+  bool resume = false;
+  if (fs::is_regular_file(partPath, ec) &&
+      fs::file_size(partPath, ec) == object.m_size) {
+    ifstream journal(journalPath);
+    string line;
+    if (getline(journal, line) && line == header) {
+      resume = true;
+      uint64_t index = 0;
+      while (journal >> index) {
+        if (index < download.m_numChunks && !download.m_chunkDone[index]) {
+          download.m_chunkDone[index] = true;
+          m_numResumedChunks++;
+        }
+      }
+    }
+  }
+
+  download.m_fd =
+      open(partPath.c_str(), O_RDWR | O_CREAT | (resume ? 0 : O_TRUNC), 0644);
+  if (download.m_fd < 0 || ftruncate(download.m_fd, object.m_size) != 0) {
+    LOG_GENERAL(WARNING, "Failed to create " << partPath);
+    return false;
+  }
+  download.m_journal = fopen(journalPath.c_str(), resume ? "a" : "w");
+  if (download.m_journal == nullptr) {
+    LOG_GENERAL(WARNING, "Failed to create " << journalPath);
+    return false;
+  }
+  if (!resume) {
+    fprintf(download.m_journal, "%s\n", header.c_str());
+    fflush(download.m_journal);
+  }
+  return true;
+}
+
+void PersistenceDownloader::FetchChunk(CURL* curl, Download& download,
+                                       uint64_t index) {
+  const uint64_t offset = index * m_chunkSize;
+  const uint64_t length =
+      min(m_chunkSize, download.m_object.m_size - offset);
+  const string range =
+      to_string(offset) + "-" + to_string(offset + length - 1);
+
+  for (unsigned int attempt = 1; attempt <= MAX_FETCH_ATTEMPTS; attempt++) {
+    ChunkWriter writer{download.m_fd, offset, length, 0};
+    curl_easy_reset(curl);
+    curl_easy_setopt(curl, CURLOPT_URL, download.m_url.c_str());
+    curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_SEC);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, LOW_SPEED_TIME_SEC);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteChunk);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &writer);
+    const CURLcode res = curl_easy_perform(curl);
+
+    long responseCode = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &responseCode);
+    const bool rangeHonoured =
+        IsLocal() || responseCode == 206 ||
+        (responseCode == 200 && length == download.m_object.m_size);
+    if (res == CURLE_OK && rangeHonoured && writer.m_written == length) {
+      lock_guard<mutex> g(download.m_mutex);
+      download.m_chunkDone[index] = true;
+      fprintf(download.m_journal, "%lu\n", (unsigned long)index);
+      fflush(download.m_journal);
+      m_numBytes += length;
+      m_numChunks++;
+      return;
+    }
+
+    LOG_GENERAL(WARNING, "[Attempt: " << attempt
+                                      << "] Failed to download bytes "
+                                      << range << " of " << download.m_url
+                                      << ": " << curl_easy_strerror(res));
+    if (attempt < MAX_FETCH_ATTEMPTS) {
+      m_numRetries++;
+      this_thread::sleep_for(chrono::seconds(attempt));
+    }
+  }
+
+  lock_guard<mutex> g(download.m_mutex);
+  download.m_failed = true;
+}
+
+bool PersistenceDownloader::FinishDownload(Download& download) {
+  if (download.m_complete) {
+    return true;
+  }
+  if (download.m_fd >= 0) {
+    close(download.m_fd);
+    download.m_fd = -1;
+  }
+  if (download.m_journal != nullptr) {
+    fclose(download.m_journal);
+    download.m_journal = nullptr;
+  }
+  if (download.m_failed ||
+      find(download.m_chunkDone.begin(), download.m_chunkDone.end(), false) !=
+          download.m_chunkDone.end()) {
+    // The partial file and its journal are kept for the next attempt
+    return false;
+  }
+
+  const string partPath = download.m_path + PART_SUFFIX;
+  const string journalPath = download.m_path + JOURNAL_SUFFIX;
+  boost::system::error_code ec;
+  if (!download.m_object.m_etag.empty()) {
+    const string etag = ComputeETag(partPath, S3_MULTIPART_CHUNK_SIZE);
+    if (StripQuotes(etag) != StripQuotes(download.m_object.m_etag)) {
+      LOG_GENERAL(WARNING, "md5 checksum mismatch for "
+                               << download.m_path
+                               << ". Expected: " << download.m_object.m_etag
+                               << ", Actual: " << etag);
+      fs::remove(partPath, ec);
+      fs::remove(journalPath, ec);
+      return false;
+    }
+  }
+  fs::rename(partPath, download.m_path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to move " << partPath << ": " << ec.message());
+    return false;
+  }
+  fs::remove(journalPath, ec);
+  LOG_GENERAL(INFO, "Downloaded " << download.m_path);
+  return true;
+}
+
+bool PersistenceDownloader::DownloadObjects(
+    const string& folder, const vector<RemoteObject>& objects,
+    const string& destDir) {
+  vector<unique_ptr<Download>> downloads;
+  vector<pair<Download*, uint64_t>> tasks;
+  bool result = true;
+
+  for (const auto& object : objects) {
+    unique_ptr<Download> download(new Download());
+    download->m_object = object;
+    download->m_url = GetUrl(folder + "/" + m_testnetName + "/" + object.m_key);
+    download->m_path = destDir + "/" + object.m_key;
+    if (!PrepareDownload(*download)) {
+      result = false;
+    } else if (!download->m_complete) {
+      for (uint64_t i = 0; i < download->m_numChunks; i++) {
+        if (!download->m_chunkDone[i]) {
+          tasks.emplace_back(download.get(), i);
+        }
+      }
+    }
+    downloads.emplace_back(move(download));
+  }
+
+  if (result) {
+    // Chunks of all the objects are spread over the connections, so that
+    // large files do not leave them idle
+    atomic<size_t> next{0};
+    vector<thread> workers;
+    const size_t numWorkers = min<size_t>(m_numThreads, tasks.size());
+    for (size_t w = 0; w < numWorkers; w++) {
+      workers.emplace_back([this, &tasks, &next]() {
+        unique_ptr<CURL, decltype(&curl_easy_cleanup)> curl(
+            curl_easy_init(), &curl_easy_cleanup);
+        if (!curl) {
+          LOG_GENERAL(WARNING, "curl initialization fail!");
+          return;
+        }
+        size_t t;
+        while ((t = next++) < tasks.size()) {
+          FetchChunk(curl.get(), *tasks[t].first, tasks[t].second);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  }
+
+  for (auto& download : downloads) {
+    if (!FinishDownload(*download)) {
+      result = false;
+    }
+  }
+  return result;
+}
+
+void PersistenceDownloader::RemoveStaleFiles(
+    const string& dir, const vector<RemoteObject>& objects) {
+  unordered_set<string> keep;
+  for (const auto& object : objects) {
+    const string path =
+        (fs::path(m_storagePath) / object.m_key).lexically_normal().string();
+    keep.insert(path);
+    keep.insert(path + PART_SUFFIX);
+    keep.insert(path + JOURNAL_SUFFIX);
+  }
+
+  boost::system::error_code ec;
+  vector<fs::path> stale;
+  for (fs::recursive_directory_iterator it(dir, ec), end; it != end && !ec;
+       it.increment(ec)) {
+    if (fs::is_regular_file(it->path()) &&
+        keep.find(it->path().lexically_normal().string()) == keep.end()) {
+      stale.emplace_back(it->path());
+    }
+  }
+  for (const auto& path : stale) {
+    fs::remove(path, ec);
+  }
+}
+
+bool PersistenceDownloader::DownloadDiff(const string& folder,
+                                         const string& name,
+                                         const string& destDir,
+                                         const string& stripPrefix) {
+  RemoteObject object;
+  object.m_key = name;
+  if (!StatObject(folder, object)) {
+    LOG_GENERAL(INFO, "No " << name << " uploaded");
+    return true;
+  }
+  const string diffDir = m_storagePath + "/persistenceDiff";
+  if (!DownloadObjects(folder, {object}, diffDir) ||
+      !ExtractTarGz(diffDir + "/" + name, destDir, stripPrefix)) {
+    return false;
+  }
+  boost::system::error_code ec;
+  fs::remove(diffDir + "/" + name, ec);
+  return true;
+}
+
+bool PersistenceDownloader::Start() {
+  LOG_MARKER();
+
+  const string stateDeltaDir = m_storagePath + "/StateDeltaFromS3";
+  const string diffDir = m_storagePath + "/persistenceDiff";
+  boost::system::error_code ec;
+
+  while (true) {
+    uint64_t currTxBlk = 0;
+    if (IsUploadLocked() || !GetCurrentTxBlkNum(currTxBlk)) {
+      this_thread::sleep_for(chrono::seconds(1));
+      continue;
+    }
+
+    LOG_GENERAL(INFO, "Started downloading entire persistence");
+    vector<RemoteObject> objects;
+    if (!ListObjects(PERSISTENCE_SNAPSHOT_NAME, objects) || objects.empty()) {
+      return false;
+    }
+    // Unlike a fresh download, the files of an earlier attempt are kept and
+    // only the ones gone from the bucket are removed
+    RemoveStaleFiles(m_storagePath + "/persistence", objects);
+    if (!DownloadObjects(PERSISTENCE_SNAPSHOT_NAME, objects, m_storagePath)) {
+      return false;
+    }
+
+    LOG_GENERAL(INFO, "Started downloading State-Delta");
+    if (!ListObjects(STATEDELTA_DIFF_NAME, objects) ||
+        !DownloadObjects(STATEDELTA_DIFF_NAME, objects, diffDir)) {
+      return false;
+    }
+    fs::remove_all(stateDeltaDir, ec);
+    fs::create_directories(stateDeltaDir, ec);
+    for (const auto& object : objects) {
+      const string path = diffDir + "/" + object.m_key;
+      if (EndsWith(object.m_key, ".tar.gz") &&
+          !ExtractTarGz(path, stateDeltaDir)) {
+        return false;
+      }
+      fs::remove(path, ec);
+    }
+
+    uint64_t newTxBlk = 0;
+    if (!GetCurrentTxBlkNum(newTxBlk)) {
+      return false;
+    }
+    if (currTxBlk >= newTxBlk) {
+      break;
+    }
+    // New files were uploaded in the meantime
+    while (IsUploadLocked()) {
+      this_thread::sleep_for(chrono::seconds(1));
+    }
+    if (newTxBlk %
+            (INCRDB_DSNUMS_WITH_STATEDELTAS * NUM_FINAL_BLOCK_PER_POW) ==
+        0) {
+      // New base persistence already, so start again
+      continue;
+    }
+
+    for (uint64_t blockNum = currTxBlk + 1; blockNum <= newTxBlk; blockNum++) {
+      LOG_GENERAL(INFO, "Fetching persistence diff and statedelta for block = "
+                            << blockNum);
+      const string diffName = "diff_persistence_" + to_string(blockNum);
+      if (!DownloadDiff(PERSISTENCE_SNAPSHOT_NAME, diffName + ".tar.gz",
+                        m_storagePath + "/persistence", diffName) ||
+          !DownloadDiff(STATEDELTA_DIFF_NAME,
+                        "stateDelta_" + to_string(blockNum) + ".tar.gz",
+                        stateDeltaDir, "")) {
+        return false;
+      }
+    }
+    break;
+  }
+
+  fs::remove_all(diffDir, ec);
+  const auto stats = GetStats();
+  LOG_GENERAL(INFO, "Downloaded " << stats.m_numBytes << " bytes in "
+                                  << stats.m_numChunks << " chunks, resumed "
+                                  << stats.m_numResumedChunks
+                                  << " chunks, retried "
+                                  << stats.m_numRetries);
+  return true;
+}
+
+PersistenceDownloadStats PersistenceDownloader::GetStats() const {
+  PersistenceDownloadStats stats;
+  stats.m_numBytes = m_numBytes;
+  stats.m_numChunks = m_numChunks;
+  stats.m_numResumedChunks = m_numResumedChunks;
+  stats.m_numRetries = m_numRetries;
+  stats.m_numSkippedObjects = m_numSkippedObjects;
+  return stats;
+}
+
+bool PersistenceDownloader::ExtractTarGz(const string& path,
+                                         const string& destDir,
+                                         const string& stripPrefix) {
+  unique_ptr<gzFile_s, decltype(&gzclose)> gz(gzopen(path.c_str(), "rb"),
+                                              &gzclose);
+  if (!gz) {
+    LOG_GENERAL(WARNING, "Failed to open " << path);
+    return false;
+  }
+
+  // Names of the next entry from GNU and pax extension headers
+  string longName;
+  string paxPath;
+  unsigned char header[TAR_BLOCK_SIZE];
+  vector<char> buffer(1 << 16);
+
+  while (true) {
+    if (!ReadFull(gz.get(), header, TAR_BLOCK_SIZE)) {
+      LOG_GENERAL(WARNING, "Truncated archive " << path);
+      return false;
+    }
+    if (all_of(header, header + TAR_BLOCK_SIZE,
+               [](unsigned char c) { return c == 0; })) {
+      return true;
+    }
+
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < TAR_BLOCK_SIZE; i++) {
+      checksum += (i >= 148 && i < 156) ? ' ' : header[i];
+    }
+    if (checksum != ParseOctal(header + 148, 8)) {
+      LOG_GENERAL(WARNING, "Corrupted archive " << path);
+      return false;
+    }
+
+    const uint64_t size = ParseOctal(header + 124, 12);
+    const uint64_t padding = (TAR_BLOCK_SIZE - size % TAR_BLOCK_SIZE) %
+                             TAR_BLOCK_SIZE;
+    const char type = header[156];
+
+    if (type == 'L' || type == 'x') {
+      string data(size, '\0');
+      if (!ReadFull(gz.get(), &data[0], size) || !Skip(gz.get(), padding)) {
+        LOG_GENERAL(WARNING, "Truncated archive " << path);
+        return false;
+      }
+      if (type == 'L') {
+        longName = data.c_str();
+        continue;
+      }
+      // Records of "<length> <key>=<value>\n"
+      size_t pos = 0;
+      while (pos < data.size()) {
+        const size_t space = data.find(' ', pos);
+        const size_t len = strtoull(data.c_str() + pos, nullptr, 10);
+        if (space == string::npos || len == 0 || pos + len > data.size()) {
+          break;
+        }
+        const string record = data.substr(space + 1, pos + len - space - 2);
+        if (record.compare(0, 5, "path=") == 0) {
+          paxPath = record.substr(5);
+        }
+        pos += len;
+      }
+      continue;
+    }
+
+    string name;
+    if (!paxPath.empty()) {
+      name = paxPath;
+    } else if (!longName.empty()) {
+      name = longName;
+    } else {
+      name = ParseString(header, 100);
+      const string prefix = ParseString(header + 345, 155);
+      if (memcmp(header + 257, "ustar", 5) == 0 && !prefix.empty()) {
+        name = prefix + "/" + name;
+      }
+    }
+    paxPath.clear();
+    longName.clear();
+
+    string relPath;
+    bool skip = false;
+    if (!GetEntryPath(name, stripPrefix, relPath, skip)) {
+      LOG_GENERAL(WARNING, "Unsafe path " << name << " in " << path);
+      return false;
+    }
+    const bool isFile = type == '0' || type == '\0' || type == '7';
+    if (type != '5' && !isFile) {
+      LOG_GENERAL(INFO, "Skipped entry " << name << " of type " << type);
+      skip = true;
+    }
+    if (skip || relPath.empty()) {
+      if (!Skip(gz.get(), size + padding)) {
+        LOG_GENERAL(WARNING, "Truncated archive " << path);
+        return false;
+      }
+      continue;
+    }
+
+    const fs::path target = fs::path(destDir) / relPath;
+    boost::system::error_code ec;
+    if (type == '5') {
+      fs::create_directories(target, ec);
+      if (!Skip(gz.get(), size + padding)) {
+        LOG_GENERAL(WARNING, "Truncated archive " << path);
+        return false;
+      }
+      continue;
+    }
+
+    fs::create_directories(target.parent_path(), ec);
+    ofstream out(target.string(), ios::binary | ios::trunc);
+    if (!out) {
+      LOG_GENERAL(WARNING, "Failed to create " << target.string());
+      return false;
+    }
+    uint64_t left = size;
+    while (left > 0) {
+      const size_t n = min<uint64_t>(left, buffer.size());
+      if (!ReadFull(gz.get(), buffer.data(), n)) {
+        LOG_GENERAL(WARNING, "Truncated archive " << path);
+        return false;
+      }
+      out.write(buffer.data(), n);
+      left -= n;
+    }
+    if (!out || !Skip(gz.get(), padding)) {
+      LOG_GENERAL(WARNING, "Failed to extract " << target.string());
+      return false;
+    }
+  }
+}
+
+string PersistenceDownloader::ComputeETag(const string& path,
+                                          uint64_t partSize) {
+  ifstream in(path, ios::binary);
+  if (!in) {
+    return "";
+  }
+
+  unique_ptr<EVP_MD_CTX, decltype(&EVP_MD_CTX_free)> ctx(EVP_MD_CTX_new(),
+                                                         &EVP_MD_CTX_free);
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  unsigned int digestLen = 0;
+  string digests;
+  uint64_t numParts = 0;
+  vector<char> buffer(1 << 16);
+
+  do {
+    EVP_DigestInit_ex(ctx.get(), EVP_md5(), nullptr);
+    uint64_t left = partSize;
+    uint64_t numRead = 0;
+    while (left > 0 && in) {
+      in.read(buffer.data(), min<uint64_t>(left, buffer.size()));
+      EVP_DigestUpdate(ctx.get(), buffer.data(), in.gcount());
+      left -= in.gcount();
+      numRead += in.gcount();
+    }
+    if (numRead == 0 && numParts > 0) {
+      break;
+    }
+    EVP_DigestFinal_ex(ctx.get(), digest, &digestLen);
+    digests.append((const char*)digest, digestLen);
+    numParts++;
+  } while (in);
+
+  if (numParts == 1) {
+    return "\"" + ToHex(digest, digestLen) + "\"";
+  }
+  EVP_DigestInit_ex(ctx.get(), EVP_md5(), nullptr);
+  EVP_DigestUpdate(ctx.get(), digests.data(), digests.size());
+  EVP_DigestFinal_ex(ctx.get(), digest, &digestLen);
+  return "\"" + ToHex(digest, digestLen) + "-" + to_string(numParts) + "\"";
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBPERSISTENCE_PERSISTENCEDOWNLOADER_H_
+#define ZILLIQA_SRC_LIBPERSISTENCE_PERSISTENCEDOWNLOADER_H_
+
+#include <curl/curl.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+/// Object in the bucket, keyed by its path under the testnet folder
+struct RemoteObject {
+  std::string m_key;
+  uint64_t m_size{0};
+  /// As listed by S3, empty if unknown
+  std::string m_etag;
+};
+
+struct PersistenceDownloadStats {
+  uint64_t m_numBytes{0};
+  uint64_t m_numChunks{0};
+  /// Chunks already in the partial downloads of an earlier run
+  uint64_t m_numResumedChunks{0};
+  uint64_t m_numRetries{0};
+  /// Objects already downloaded and verified
+  uint64_t m_numSkippedObjects{0};
+};
+
+/// Downloads the incremental persistence uploaded by upload_incr_DB.py, as
+/// download_incr_DB.py does. The objects are fetched in ranged chunks by a
+/// pool of connections into partial files, along with a journal of the
+/// chunks written so far, so that an interrupted download resumes where it
+/// stopped. Each object is checked against its S3 ETag before it is moved in
+/// place, and the tarballs are unpacked straight into their directories.
+class PersistenceDownloader {
+ public:
+  /// baseUrl is the bucket, e.g. http://bucket.s3.amazonaws.com, or a local
+  /// mirror of it as file:///path
+  PersistenceDownloader(const std::string& baseUrl,
+                        const std::string& testnetName,
+                        const std::string& storagePath, bool excludeTxnBodies,
+                        unsigned int numThreads, uint64_t chunkSize);
+  ~PersistenceDownloader();
+
+  /// Downloads the persistence and the state deltas into storagePath, then
+  /// the diffs uploaded meanwhile
+  bool Start();
+
+  /// Lists the objects under folder/testnetName
+  bool ListObjects(const std::string& folder,
+                   std::vector<RemoteObject>& objects);
+
+  /// Downloads the objects under folder/testnetName into destDir, keeping
+  /// their relative paths
+  bool DownloadObjects(const std::string& folder,
+                       const std::vector<RemoteObject>& objects,
+                       const std::string& destDir);
+
+  PersistenceDownloadStats GetStats() const;
+
+  /// Unpacks a .tar.gz into destDir. Entries outside stripPrefix are skipped,
+  /// and the prefix is removed from the others.
+  static bool ExtractTarGz(const std::string& path, const std::string& destDir,
+                           const std::string& stripPrefix = "");
+
+  /// ETag of an S3 upload in parts of partSize: the MD5 of a file in one
+  /// part, or else the MD5 of the MD5s of the parts followed by their number
+  static std::string ComputeETag(const std::string& path, uint64_t partSize);
+
+  /// Parses a page of the S3 ListObjects response, keeping the full keys
+  static bool ParseListObjects(const std::string& xml,
+                               std::vector<RemoteObject>& objects,
+                               bool& isTruncated);
+
+ private:
+  struct Download;
+
+  bool IsLocal() const;
+  std::string GetUrl(const std::string& key) const;
+  bool Fetch(const std::string& url, std::string& body);
+  bool StatObject(const std::string& folder, RemoteObject& object);
+  bool IsUploadLocked();
+  bool GetCurrentTxBlkNum(uint64_t& txBlkNum);
+  void RemoveStaleFiles(const std::string& dir,
+                        const std::vector<RemoteObject>& objects);
+  bool DownloadDiff(const std::string& folder, const std::string& name,
+                    const std::string& destDir,
+                    const std::string& stripPrefix);
+
+  bool PrepareDownload(Download& download);
+  void FetchChunk(CURL* curl, Download& download, uint64_t index);
+  bool FinishDownload(Download& download);
+
+  const std::string m_baseUrl;
+  const std::string m_testnetName;
+  const std::string m_storagePath;
+  const bool m_excludeTxnBodies;
+  const unsigned int m_numThreads;
+  const uint64_t m_chunkSize;
+
+  std::atomic<uint64_t> m_numBytes{0};
+  std::atomic<uint64_t> m_numChunks{0};
+  std::atomic<uint64_t> m_numResumedChunks{0};
+  std::atomic<uint64_t> m_numRetries{0};
+  std::atomic<uint64_t> m_numSkippedObjects{0};
+};
+
+#endif  // ZILLIQA_SRC_LIBPERSISTENCE_PERSISTENCEDOWNLOADER_H_
@@ -20,10 +20,12 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <exception>
+#include <thread>
 #include <vector>
 
 #include "libData/AccountData/AccountStore.h"
 #include "libData/AccountData/Transaction.h"
+#include "libMessage/Messenger.h"
 #include "libPersistence/BlockStorage.h"
 #include "libUtils/CommonUtils.h"
 #include "libUtils/DataConversion.h"
@@ -154,39 +156,47 @@ bool Retriever::ConstructFromStateDeltas(const uint64_t& lastBlockNum,
           }
 
           // generate state now for NUM_FINAL_BLOCK_PER_POW statedeltas
-          for (uint64_t j = firstStateDeltaIndex; j <= i; j++) {
-            bytes stateDelta;
-            LOG_GENERAL(
-                INFO,
-                "Try fetching statedelta and deserializing to state for txnBlk:"
-                    << j);
-            if (BlockStorage::GetBlockStorage().GetStateDelta(j, stateDelta)) {
-              if (!AccountStore::GetInstance().DeserializeDelta(stateDelta,
-                                                                0)) {
-                LOG_GENERAL(
-                    WARNING,
-                    "AccountStore::GetInstance().DeserializeDelta failed");
-                return false;
-              }
-
-              if (j % RELEASE_CACHE_INTERVAL == 0 || j == i) {
-                DetachedFunction(1, CommonUtils::ReleaseSTLMemoryCache);
-              }
-
-              TxBlockSharedPtr txBlockPerDelta;
-              if (!BlockStorage::GetBlockStorage().GetTxBlock(
-                      j, txBlockPerDelta)) {
-                LOG_GENERAL(WARNING, "GetTxBlock failed for " << j);
-                return false;
-              }
-
-              if (AccountStore::GetInstance().GetStateRootHash() !=
-                  txBlockPerDelta->GetHeader().GetStateRootHash()) {
-                LOG_GENERAL(
-                    WARNING,
-                    "StateRoot in TxBlock(BlockNum: "
-                        << j << ") : does not match retrieved stateroot hash");
-                return false;
+          if (MERGE_STATEDELTAS_ON_RESTART) {
+            if (!ApplyMergedStateDeltas(firstStateDeltaIndex, i)) {
+              return false;
+            }
+          } else {
+            for (uint64_t j = firstStateDeltaIndex; j <= i; j++) {
+              bytes stateDelta;
+              LOG_GENERAL(INFO,
+                          "Try fetching statedelta and deserializing to state "
+                          "for txnBlk:"
+                              << j);
+              if (BlockStorage::GetBlockStorage().GetStateDelta(j,
+                                                                stateDelta)) {
+                if (!AccountStore::GetInstance().DeserializeDelta(stateDelta,
+                                                                  0)) {
+                  LOG_GENERAL(
+                      WARNING,
+                      "AccountStore::GetInstance().DeserializeDelta failed");
+                  return false;
+                }
+
+                if (j % RELEASE_CACHE_INTERVAL == 0 || j == i) {
+                  DetachedFunction(1, CommonUtils::ReleaseSTLMemoryCache);
+                }
+
+                TxBlockSharedPtr txBlockPerDelta;
+                if (!BlockStorage::GetBlockStorage().GetTxBlock(
+                        j, txBlockPerDelta)) {
+                  LOG_GENERAL(WARNING, "GetTxBlock failed for " << j);
+                  return false;
+                }
+
+                if (AccountStore::GetInstance().GetStateRootHash() !=
+                    txBlockPerDelta->GetHeader().GetStateRootHash()) {
+                  LOG_GENERAL(WARNING,
+                              "StateRoot in TxBlock(BlockNum: "
+                                  << j
+                                  << ") : does not match retrieved stateroot "
+                                     "hash");
+                  return false;
+                }
               }
             }
           }
@@ -232,9 +242,19 @@ bool Retriever::ConstructFromStateDeltas(const uint64_t& lastBlockNum,
     }
   } else {
     /// Put extra state delta from last DS epoch
+    if (MERGE_STATEDELTAS_ON_RESTART && !extraStateDeltas.empty()) {
+      bytes mergedStateDelta;
+      if (!Messenger::MergeAccountStoreDeltas(extraStateDeltas,
+                                              mergedStateDelta) ||
+          !AccountStore::GetInstance().DeserializeDelta(mergedStateDelta, 0)) {
+        LOG_GENERAL(WARNING, "Failed to apply the merged extra state deltas");
+        return false;
+      }
+    }
     uint64_t extra_delta_index = lastBlockNum - extra_txblocks + 1;
     for (const auto& stateDelta : extraStateDeltas) {
-      if (!AccountStore::GetInstance().DeserializeDelta(stateDelta, 0)) {
+      if (!MERGE_STATEDELTAS_ON_RESTART &&
+          !AccountStore::GetInstance().DeserializeDelta(stateDelta, 0)) {
         LOG_GENERAL(WARNING,
                     "AccountStore::GetInstance().DeserializeDelta failed");
         return false;
@@ -250,6 +270,121 @@ bool Retriever::ConstructFromStateDeltas(const uint64_t& lastBlockNum,
   return true;
 }
 
+bool Retriever::MergeStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                                 unsigned int numThreads,
+                                 const StateDeltaGetter& getStateDelta,
+                                 bytes& mergedStateDelta,
+                                 uint64_t& lastBlockNum,
+                                 unsigned int& numStateDeltas) {
+  if (lowBlockNum > highBlockNum) {
+    return false;
+  }
+  const uint64_t numBlocks = highBlockNum - lowBlockNum + 1;
+  const uint64_t numSlices =
+      std::min<uint64_t>(std::max(numThreads, 1u), numBlocks);
+  const uint64_t sliceSize = (numBlocks + numSlices - 1) / numSlices;
+
+  struct Slice {
+    bytes m_merged;
+    uint64_t m_lastBlockNum{0};
+    unsigned int m_numStateDeltas{0};
+    bool m_result{true};
+  };
+  std::vector<Slice> slices(numSlices);
+
+  auto mergeSlice = [&](uint64_t s) {
+    Slice& slice = slices[s];
+    const uint64_t low = lowBlockNum + s * sliceSize;
+    const uint64_t high = std::min(low + sliceSize - 1, highBlockNum);
+    std::vector<bytes> stateDeltas;
+    for (uint64_t blockNum = low; blockNum <= high; blockNum++) {
+      bytes stateDelta;
+      if (getStateDelta(blockNum, stateDelta)) {
+        stateDeltas.emplace_back(std::move(stateDelta));
+        slice.m_lastBlockNum = blockNum;
+      }
+    }
+    slice.m_numStateDeltas = stateDeltas.size();
+    if (!stateDeltas.empty()) {
+      slice.m_result =
+          Messenger::MergeAccountStoreDeltas(stateDeltas, slice.m_merged);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (uint64_t s = 1; s < numSlices; s++) {
+    workers.emplace_back(mergeSlice, s);
+  }
+  mergeSlice(0);
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // The merge is associative, so the slices merge in order as the deltas do
+  std::vector<bytes> merged;
+  numStateDeltas = 0;
+  for (auto& slice : slices) {
+    if (!slice.m_result) {
+      return false;
+    }
+    if (slice.m_numStateDeltas > 0) {
+      merged.emplace_back(std::move(slice.m_merged));
+      lastBlockNum = slice.m_lastBlockNum;
+      numStateDeltas += slice.m_numStateDeltas;
+    }
+  }
+  mergedStateDelta.clear();
+  if (merged.size() == 1) {
+    mergedStateDelta = std::move(merged.front());
+    return true;
+  }
+  return merged.empty() ||
+         Messenger::MergeAccountStoreDeltas(merged, mergedStateDelta);
+}
+
+bool Retriever::ApplyMergedStateDeltas(uint64_t lowBlockNum,
+                                       uint64_t highBlockNum) {
+  bytes mergedStateDelta;
+  uint64_t lastBlockNum = 0;
+  unsigned int numStateDeltas = 0;
+  if (!MergeStateDeltas(lowBlockNum, highBlockNum, STATEDELTA_REPLAY_THREADS,
+                        [](uint64_t blockNum, bytes& stateDelta) {
+                          return BlockStorage::GetBlockStorage().GetStateDelta(
+                              blockNum, stateDelta);
+                        },
+                        mergedStateDelta, lastBlockNum, numStateDeltas)) {
+    LOG_GENERAL(WARNING, "Failed to merge the statedeltas of txnBlks "
+                             << lowBlockNum << " - " << highBlockNum);
+    return false;
+  }
+  if (numStateDeltas == 0) {
+    return true;
+  }
+
+  LOG_GENERAL(INFO, "Deserializing " << numStateDeltas
+                                     << " statedeltas merged for txnBlks "
+                                     << lowBlockNum << " - " << highBlockNum);
+  if (!AccountStore::GetInstance().DeserializeDelta(mergedStateDelta, 0)) {
+    LOG_GENERAL(WARNING, "AccountStore::GetInstance().DeserializeDelta failed");
+    return false;
+  }
+  DetachedFunction(1, CommonUtils::ReleaseSTLMemoryCache);
+
+  TxBlockSharedPtr txBlock;
+  if (!BlockStorage::GetBlockStorage().GetTxBlock(lastBlockNum, txBlock)) {
+    LOG_GENERAL(WARNING, "GetTxBlock failed for " << lastBlockNum);
+    return false;
+  }
+  if (AccountStore::GetInstance().GetStateRootHash() !=
+      txBlock->GetHeader().GetStateRootHash()) {
+    LOG_GENERAL(WARNING, "StateRoot in TxBlock(BlockNum: "
+                             << lastBlockNum
+                             << ") : does not match retrieved stateroot hash");
+    return false;
+  }
+  return true;
+}
+
 bool Retriever::RetrieveBlockLink() {
   std::list<BlockLink> blocklinks;
 
@@ -375,7 +510,9 @@ bool Retriever::ValidateStates() {
     return true;
   }
 
-  if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetStateRootHash() ==
+  if (m_mediator.m_txBlockChain.GetLastBlock()
+          ->GetHeader()
+          .GetStateRootHash() ==
       AccountStore::GetInstance().GetStateRootHash()) {
     LOG_GENERAL(INFO, "ValidateStates passed.");
     return true;
@@ -383,11 +520,11 @@ bool Retriever::ValidateStates() {
     LOG_GENERAL(WARNING, "ValidateStates failed.");
     LOG_GENERAL(INFO, "StateRoot in FinalBlock(BlockNum: "
                           << m_mediator.m_txBlockChain.GetLastBlock()
-                                 .GetHeader()
+                                 ->GetHeader()
                                  .GetBlockNum()
                           << "): "
                           << m_mediator.m_txBlockChain.GetLastBlock()
-                                 .GetHeader()
+                                 ->GetHeader()
                                  .GetStateRootHash()
                           << '\n'
                           << "Retrieved StateRoot: "
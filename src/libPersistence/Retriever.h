@@ -18,6 +18,7 @@
 #ifndef ZILLIQA_SRC_LIBPERSISTENCE_RETRIEVER_H_
 #define ZILLIQA_SRC_LIBPERSISTENCE_RETRIEVER_H_
 
+#include <functional>
 #include <list>
 #include <map>
 #include <unordered_map>
@@ -46,7 +47,24 @@ class Retriever {
                                 std::vector<bytes>& extraStateDeltas,
                                 bool trimIncompletedBlocks);
 
+  using StateDeltaGetter =
+      std::function<bool(uint64_t blockNum, bytes& stateDelta)>;
+
+  /// Reads the state deltas of the blocks from lowBlockNum to highBlockNum on
+  /// numThreads threads, each merging its share of the range, and merges the
+  /// results in order. Blocks without a state delta are skipped, lastBlockNum
+  /// is the last block that has one.
+  static bool MergeStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum,
+                               unsigned int numThreads,
+                               const StateDeltaGetter& getStateDelta,
+                               bytes& mergedStateDelta, uint64_t& lastBlockNum,
+                               unsigned int& numStateDeltas);
+
  private:
+  /// Applies the state deltas of the blocks as one, checking the state root
+  /// against the last block only
+  bool ApplyMergedStateDeltas(uint64_t lowBlockNum, uint64_t highBlockNum);
+
   Mediator& m_mediator;
 };
 
@@ -500,14 +500,14 @@ Json::Value IsolatedServer::GetTransactionsForTxBlock(
     throw JsonRpcException(RPC_INVALID_PARAMETER, e.what());
   }
 
-  auto const& txBlock = m_mediator.m_txBlockChain.GetBlock(txNum);
+  const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(txNum);
 
-  if (txBlock.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
-      txBlock.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
+  if (txBlock->GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
+      txBlock->GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_INVALID_PARAMS, "TxBlock does not exist");
   }
 
-  auto microBlockInfos = txBlock.GetMicroBlockInfos();
+  const auto& microBlockInfos = txBlock->GetMicroBlockInfos();
   Json::Value _json = Json::arrayValue;
   bool hasTransactions = false;
 
@@ -429,6 +429,15 @@ LookupServer::LookupServer(Mediator& mediator,
   m_TxBlockCountSumPair.second = 0;
   random_device rd;
   m_eng = mt19937(rd());
+
+  if (LOOKUP_NODE_MODE && !ISOLATED_SERVER && TXN_INGRESS_THREADS > 0) {
+    m_txnIngressPipeline = make_unique<TxnIngressPipeline>(
+        TXN_INGRESS_THREADS, TXN_INGRESS_QUEUE_SIZE, TXN_INGRESS_BATCH_SIZE,
+        [this](const vector<pair<Transaction, uint32_t>>& txns,
+               vector<bool>& added) {
+          m_mediator.m_lookup->AddToTxnShardMap(txns, added);
+        });
+  }
 }
 
 string LookupServer::GetNetworkId() {
@@ -643,11 +652,7 @@ bool ValidateTxn(const Transaction& tx, const Address& fromAddr,
   return true;
 }
 
-Json::Value LookupServer::CreateTransaction(
-    const Json::Value& _json, const unsigned int num_shards,
-    const uint128_t& gasPrice, const CreateTransactionTargetFunc& targetFunc) {
-  LOG_MARKER();
-
+Transaction LookupServer::ParseTransaction(const Json::Value& _json) {
   if (!LOOKUP_NODE_MODE) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
@@ -657,125 +662,143 @@ Json::Value LookupServer::CreateTransaction(
     throw JsonRpcException(RPC_MISC_ERROR, "Unable to Process");
   }
 
-  try {
-    if (!JSONConversion::checkJsonTx(_json)) {
-      throw JsonRpcException(RPC_PARSE_ERROR, "Invalid Transaction JSON");
-    }
-
-    Transaction tx = JSONConversion::convertJsontoTx(_json);
+  if (!JSONConversion::checkJsonTx(_json)) {
+    throw JsonRpcException(RPC_PARSE_ERROR, "Invalid Transaction JSON");
+  }
 
-    Json::Value ret;
+  return JSONConversion::convertJsontoTx(_json);
+}
 
-    const Address fromAddr = tx.GetSenderAddr();
+Json::Value LookupServer::PrecheckTransaction(const Transaction& tx,
+                                              const unsigned int num_shards,
+                                              const uint128_t& gasPrice,
+                                              bool priority,
+                                              uint32_t& mapIndex) {
+  Json::Value ret;
 
-    bool toAccountExist;
-    bool toAccountIsContract;
+  const Address fromAddr = tx.GetSenderAddr();
 
-    {
-      shared_lock<shared_timed_mutex> lock(
-          AccountStore::GetInstance().GetPrimaryMutex());
+  bool toAccountExist;
+  bool toAccountIsContract;
 
-      const Account* sender =
-          AccountStore::GetInstance().GetAccount(fromAddr, true);
-      const Account* toAccount =
-          AccountStore::GetInstance().GetAccount(tx.GetToAddr(), true);
+  {
+    shared_lock<shared_timed_mutex> lock(
+        AccountStore::GetInstance().GetPrimaryMutex());
 
-      if (!ValidateTxn(tx, fromAddr, sender, gasPrice)) {
-        return ret;
-      }
+    const Account* sender =
+        AccountStore::GetInstance().GetAccount(fromAddr, true);
+    const Account* toAccount =
+        AccountStore::GetInstance().GetAccount(tx.GetToAddr(), true);
 
-      toAccountExist = (toAccount != nullptr);
-      toAccountIsContract = toAccountExist && toAccount->isContract();
+    if (!ValidateTxn(tx, fromAddr, sender, gasPrice)) {
+      throw JsonRpcException(RPC_VERIFY_REJECTED, "Unable to validate txn");
     }
 
-    const unsigned int shard = Transaction::GetShardIndex(fromAddr, num_shards);
-    unsigned int mapIndex = shard;
-    switch (Transaction::GetTransactionType(tx)) {
-      case Transaction::ContractType::NON_CONTRACT:
-        if (ARCHIVAL_LOOKUP) {
-          mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
-        }
-        if (toAccountExist) {
-          if (toAccountIsContract) {
-            throw JsonRpcException(ServerBase::RPC_INVALID_PARAMETER,
-                                   "Contract account won't accept normal txn");
-            return false;
-          }
+    toAccountExist = (toAccount != nullptr);
+    toAccountIsContract = toAccountExist && toAccount->isContract();
+  }
+
+  const unsigned int shard = Transaction::GetShardIndex(fromAddr, num_shards);
+  mapIndex = shard;
+  switch (Transaction::GetTransactionType(tx)) {
+    case Transaction::ContractType::NON_CONTRACT:
+      if (ARCHIVAL_LOOKUP) {
+        mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
+      }
+      if (toAccountExist) {
+        if (toAccountIsContract) {
+          throw JsonRpcException(ServerBase::RPC_INVALID_PARAMETER,
+                                 "Contract account won't accept normal txn");
+          return false;
         }
+      }
 
-        ret["Info"] = "Non-contract txn, sent to shard";
-        break;
-      case Transaction::ContractType::CONTRACT_CREATION:
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      ret["Info"] = "Non-contract txn, sent to shard";
+      break;
+    case Transaction::ContractType::CONTRACT_CREATION:
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
+      if (ARCHIVAL_LOOKUP) {
+        mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
+      }
+      ret["Info"] = "Contract Creation txn, sent to shard";
+      ret["ContractAddress"] =
+          Account::GetAddressForContract(fromAddr, tx.GetNonce() - 1).hex();
+      break;
+    case Transaction::ContractType::CONTRACT_CALL: {
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
+
+      if (!toAccountExist) {
+        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "To addr is null");
+      }
+
+      else if (!toAccountIsContract) {
+        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                               "Non - contract address called");
+      }
+
+      unsigned int to_shard =
+          Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
+      // Sent to DS if m_sendSCCallsToDS is set or the txn has priority
+      const bool sendToDs = m_mediator.m_lookup->m_sendSCCallsToDS || priority;
+      if ((to_shard == shard) && !sendToDs) {
+        if (tx.GetGasLimit() > SHARD_MICROBLOCK_GAS_LIMIT) {
+          throw JsonRpcException(
+              RPC_INVALID_PARAMETER,
+              "txn gas limit exceeding shard maximum limit");
         }
         if (ARCHIVAL_LOOKUP) {
           mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
         }
-        ret["Info"] = "Contract Creation txn, sent to shard";
-        ret["ContractAddress"] =
-            Account::GetAddressForContract(fromAddr, tx.GetNonce() - 1).hex();
-        break;
-      case Transaction::ContractType::CONTRACT_CALL: {
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
-        }
-
-        if (!toAccountExist) {
-          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "To addr is null");
-        }
-
-        else if (!toAccountIsContract) {
-          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                                 "Non - contract address called");
-        }
-
-        unsigned int to_shard =
-            Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
-        // Use m_sendSCCallsToDS as initial setting
-        bool sendToDs = m_mediator.m_lookup->m_sendSCCallsToDS;
-        if (_json.isMember("priority")) {
-          sendToDs = sendToDs || _json["priority"].asBool();
+        ret["Info"] =
+            "Contract Txn, Shards Match of the sender "
+            "and receiver";
+      } else {
+        if (tx.GetGasLimit() > DS_MICROBLOCK_GAS_LIMIT) {
+          throw JsonRpcException(RPC_INVALID_PARAMETER,
+                                 "txn gas limit exceeding ds maximum limit");
         }
-        if ((to_shard == shard) && !sendToDs) {
-          if (tx.GetGasLimit() > SHARD_MICROBLOCK_GAS_LIMIT) {
-            throw JsonRpcException(
-                RPC_INVALID_PARAMETER,
-                "txn gas limit exceeding shard maximum limit");
-          }
-          if (ARCHIVAL_LOOKUP) {
-            mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
-          }
-          ret["Info"] =
-              "Contract Txn, Shards Match of the sender "
-              "and receiver";
+        if (ARCHIVAL_LOOKUP) {
+          mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
         } else {
-          if (tx.GetGasLimit() > DS_MICROBLOCK_GAS_LIMIT) {
-            throw JsonRpcException(RPC_INVALID_PARAMETER,
-                                   "txn gas limit exceeding ds maximum limit");
-          }
-          if (ARCHIVAL_LOOKUP) {
-            mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
-          } else {
-            mapIndex = num_shards;
-          }
-          ret["Info"] = "Contract Txn, Sent To Ds";
+          mapIndex = num_shards;
         }
-      } break;
-      case Transaction::ContractType::ERROR:
-        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                               "Code is empty and To addr is null");
-        break;
-      default:
-        throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
-    }
-    if (m_mediator.m_lookup->m_sendAllToDS) {
-      if (ARCHIVAL_LOOKUP) {
-        mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
-      } else {
-        mapIndex = num_shards;
+        ret["Info"] = "Contract Txn, Sent To Ds";
       }
+    } break;
+    case Transaction::ContractType::ERROR:
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Code is empty and To addr is null");
+      break;
+    default:
+      throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
+  }
+  if (m_mediator.m_lookup->m_sendAllToDS) {
+    if (ARCHIVAL_LOOKUP) {
+      mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
+    } else {
+      mapIndex = num_shards;
     }
+  }
+  return ret;
+}
+
+Json::Value LookupServer::CreateTransaction(
+    const Json::Value& _json, const unsigned int num_shards,
+    const uint128_t& gasPrice, const CreateTransactionTargetFunc& targetFunc) {
+  LOG_MARKER();
+
+  try {
+    Transaction tx = ParseTransaction(_json);
+    const bool priority =
+        _json.isMember("priority") && _json["priority"].asBool();
+
+    uint32_t mapIndex = 0;
+    Json::Value ret =
+        PrecheckTransaction(tx, num_shards, gasPrice, priority, mapIndex);
     if (!targetFunc(tx, mapIndex)) {
       throw JsonRpcException(RPC_DATABASE_ERROR,
                              "Txn could not be added as database exceeded "
@@ -792,6 +815,39 @@ Json::Value LookupServer::CreateTransaction(
   }
 }
 
+Json::Value LookupServer::CreateTransactionStaged(const Json::Value& _json,
+                                                  const unsigned int num_shards,
+                                                  const uint128_t& gasPrice) {
+  LOG_MARKER();
+
+  try {
+    Transaction tx = ParseTransaction(_json);
+    const bool priority =
+        _json.isMember("priority") && _json["priority"].asBool();
+
+    return m_txnIngressPipeline->Process(
+        tx, [this, &tx, num_shards, gasPrice,
+             priority](uint32_t& mapIndex) -> Json::Value {
+          return PrecheckTransaction(tx, num_shards, gasPrice, priority,
+                                     mapIndex);
+        });
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO,
+                "[Error]" << e.what() << " Input: " << _json.toStyledString());
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable to Process");
+  }
+}
+
+Json::Value LookupServer::GetTxnIngressStats() {
+  if (m_txnIngressPipeline == nullptr) {
+    throw JsonRpcException(RPC_INVALID_REQUEST,
+                           "Txn ingress pipeline not enabled");
+  }
+  return m_txnIngressPipeline->GetStats();
+}
+
 Json::Value LookupServer::GetTransaction(const string& transactionHash) {
   LOG_MARKER();
 
@@ -862,13 +918,13 @@ Json::Value LookupServer::GetDsBlock(const string& blockNum, bool verbose) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     auto _json = JSONConversion::convertDSblocktoJson(
-        m_mediator.m_dsBlockChain.GetBlock(BlockNum), verbose);
+        *m_mediator.m_dsBlockChain.GetBlockPtr(BlockNum), verbose);
     if (verbose) {
       // also add last ds block hash
       BlockHash prevDSHash;
       if (BlockNum > 1) {
         prevDSHash =
-            m_mediator.m_dsBlockChain.GetBlock(BlockNum - 1).GetBlockHash();
+            m_mediator.m_dsBlockChain.GetBlockPtr(BlockNum - 1)->GetBlockHash();
       }
       _json["PrevDSHash"] = prevDSHash.hex();
     }
@@ -898,7 +954,7 @@ Json::Value LookupServer::GetTxBlock(const string& blockNum, bool verbose) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertTxBlocktoJson(
-        m_mediator.m_txBlockChain.GetBlock(BlockNum), verbose);
+        *m_mediator.m_txBlockChain.GetBlockPtr(BlockNum), verbose);
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -922,7 +978,7 @@ string LookupServer::GetMinimumGasPrice() {
   }
 
   return m_mediator.m_dsBlockChain.GetLastBlock()
-      .GetHeader()
+      ->GetHeader()
       .GetGasPrice()
       .str();
 }
@@ -933,7 +989,7 @@ Json::Value LookupServer::GetLatestDsBlock() {
   }
 
   LOG_MARKER();
-  DSBlock Latest = m_mediator.m_dsBlockChain.GetLastBlock();
+  DSBlock Latest = *m_mediator.m_dsBlockChain.GetLastBlock();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "BlockNum " << Latest.GetHeader().GetBlockNum()
@@ -949,7 +1005,7 @@ Json::Value LookupServer::GetLatestTxBlock() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
-  TxBlock Latest = m_mediator.m_txBlockChain.GetLastBlock();
+  TxBlock Latest = *m_mediator.m_txBlockChain.GetLastBlock();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "BlockNum " << Latest.GetHeader().GetBlockNum()
@@ -965,10 +1021,7 @@ Json::Value LookupServer::GetBalance(const string& address) {
 
   try {
     Address addr{ToBase16AddrHelper(address)};
-    shared_lock<shared_timed_mutex> lock(
-        AccountStore::GetInstance().GetPrimaryMutex());
-
-    const Account* account = AccountStore::GetInstance().GetAccount(addr, true);
+    const auto account = AccountStore::GetInstance().GetCommittedAccount(addr);
 
     Json::Value ret;
     if (account != nullptr) {
@@ -999,7 +1052,7 @@ string LookupServer::GetEthCall(const Json::Value& _json) {
   LOG_MARKER();
   LOG_GENERAL(DEBUG, "GetEthCall:" << _json);
   const auto& addr = JSONConversion::checkJsonGetEthCall(_json);
-  bytes code{};
+  CodeBytes code;
   auto ret{false};
   {
     shared_lock<shared_timed_mutex> lock(
@@ -1033,7 +1086,7 @@ string LookupServer::GetEthCall(const Json::Value& _json) {
     }
     EvmCallParameters params{addr.hex(),
                              fromAddr.hex(),
-                             DataConversion::CharArrayToString(code),
+                             DataConversion::CharArrayToString(*code),
                              _json["data"].asString(),
                              gasRemained,
                              amount};
@@ -1131,10 +1184,7 @@ Json::Value LookupServer::GetSmartContractState(const string& address,
 
   try {
     Address addr{ToBase16AddrHelper(address)};
-    shared_lock<shared_timed_mutex> lock(
-        AccountStore::GetInstance().GetPrimaryMutex());
-
-    const Account* account = AccountStore::GetInstance().GetAccount(addr, true);
+    const auto account = AccountStore::GetInstance().GetCommittedAccount(addr);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -1170,14 +1220,11 @@ Json::Value LookupServer::GetSmartContractInit(const string& address) {
 
   try {
     Address addr{ToBase16AddrHelper(address)};
-    bytes initData;
+    CodeBytes initData;
 
     {
-      shared_lock<shared_timed_mutex> lock(
-          AccountStore::GetInstance().GetPrimaryMutex());
-
-      const Account* account =
-          AccountStore::GetInstance().GetAccount(addr, true);
+      const auto account =
+          AccountStore::GetInstance().GetCommittedAccount(addr);
 
       if (account == nullptr) {
         throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -1191,7 +1238,7 @@ Json::Value LookupServer::GetSmartContractInit(const string& address) {
       initData = account->GetInitData();
     }
 
-    string initDataStr = DataConversion::CharArrayToString(initData);
+    string initDataStr = DataConversion::CharArrayToString(*initData);
     Json::Value initDataJson;
     if (!JSONUtils::GetInstance().convertStrtoJson(initDataStr, initDataJson)) {
       throw JsonRpcException(RPC_PARSE_ERROR,
@@ -1215,10 +1262,7 @@ Json::Value LookupServer::GetSmartContractCode(const string& address) {
 
   try {
     Address addr{ToBase16AddrHelper(address)};
-    shared_lock<shared_timed_mutex> lock(
-        AccountStore::GetInstance().GetPrimaryMutex());
-
-    const Account* account = AccountStore::GetInstance().GetAccount(addr, true);
+    const auto account = AccountStore::GetInstance().GetCommittedAccount(addr);
 
     if (account == nullptr) {
       throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
@@ -1231,7 +1275,7 @@ Json::Value LookupServer::GetSmartContractCode(const string& address) {
     }
 
     Json::Value _json;
-    _json["code"] = DataConversion::CharArrayToString(account->GetCode());
+    _json["code"] = DataConversion::CharArrayToString(*account->GetCode());
     return _json;
   } catch (const JsonRpcException& je) {
     throw je;
@@ -1367,14 +1411,14 @@ string LookupServer::GetNumTransactions() {
   lock_guard<mutex> g(m_mutexBlockTxPair);
 
   uint64_t currBlock =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   if (currBlock == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_IN_WARMUP, "No Tx blocks");
   }
   if (m_BlockTxPair.first < currBlock) {
     for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
       m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+          m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
     }
   }
   m_BlockTxPair.first = currBlock;
@@ -1388,7 +1432,7 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
   }
 
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   if (currBlockNum == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_IN_WARMUP, "No Tx blocks");
@@ -1401,7 +1445,7 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
   size_t i, res = 0;
 
   for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+    res += m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
   }
 
   return res;
@@ -1414,7 +1458,7 @@ double LookupServer::GetTransactionRate() {
   }
 
   uint64_t refBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
 
   uint64_t refTimeTx = 0;
 
@@ -1436,8 +1480,8 @@ double LookupServer::GetTransactionRate() {
   LOG_GENERAL(INFO, "Num Txns: " << numTxns);
 
   try {
-    TxBlock tx = m_mediator.m_txBlockChain.GetBlock(refBlockNum);
-    refTimeTx = tx.GetTimestamp();
+    refTimeTx =
+        m_mediator.m_txBlockChain.GetBlockPtr(refBlockNum)->GetTimestamp();
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (const char* msg) {
@@ -1448,7 +1492,7 @@ double LookupServer::GetTransactionRate() {
   }
 
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - refTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlock()->GetTimestamp() - refTimeTx;
 
   if (TimeDiff == 0 || refTimeTx == 0) {
     // something went wrong
@@ -1478,8 +1522,7 @@ double LookupServer::GetDSBlockRate() {
   {
     try {
       // Refernce time chosen to be the first block's timestamp
-      DSBlock dsb = m_mediator.m_dsBlockChain.GetBlock(1);
-      m_StartTimeDs = dsb.GetTimestamp();
+      m_StartTimeDs = m_mediator.m_dsBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const JsonRpcException& je) {
       throw je;
     } catch (const char* msg) {
@@ -1490,7 +1533,7 @@ double LookupServer::GetDSBlockRate() {
     }
   }
   uint64_t TimeDiff =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeDs;
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetTimestamp() - m_StartTimeDs;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -1517,8 +1560,7 @@ double LookupServer::GetTxBlockRate() {
   if (m_StartTimeTx == 0) {
     try {
       // Reference Time chosen to be first block's timestamp
-      TxBlock txb = m_mediator.m_txBlockChain.GetBlock(1);
-      m_StartTimeTx = txb.GetTimestamp();
+      m_StartTimeTx = m_mediator.m_txBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const char* msg) {
       if (string(msg) == "Blocknumber Absent") {
         LOG_GENERAL(INFO, "No TxBlock has been mined yet");
@@ -1527,7 +1569,7 @@ double LookupServer::GetTxBlockRate() {
     }
   }
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlock()->GetTimestamp() - m_StartTimeTx;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -1571,7 +1613,7 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   uint64_t currBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   Json::Value _json;
 
   uint maxPages = (currBlockNum / PAGE_SIZE) + 1;
@@ -1587,7 +1629,8 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
   if (m_DSBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      DSBlockHeader dshead = m_mediator.m_dsBlockChain.GetBlock(0).GetHeader();
+      DSBlockHeader dshead =
+          m_mediator.m_dsBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       dshead.Serialize(vec, 0);
@@ -1608,14 +1651,15 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
   if (currBlockNum > m_DSBlockCache.first) {
     for (uint64_t i = m_DSBlockCache.first + 1; i < currBlockNum; i++) {
       m_DSBlockCache.second.insert_new(m_DSBlockCache.second.size(),
-                                       m_mediator.m_dsBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
+                                       m_mediator.m_dsBlockChain
+                                           .GetBlockPtr(i + 1)
+                                           ->GetHeader()
                                            .GetPrevHash()
                                            .hex());
     }
     // for the latest block
     DSBlockHeader dshead =
-        m_mediator.m_dsBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     dshead.Serialize(vec, 0);
@@ -1650,8 +1694,9 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_dsBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
+      tmpJson["Hash"] = m_mediator.m_dsBlockChain
+                            .GetBlockPtr(currBlockNum - i + 1)
+                            ->GetHeader()
                             .GetPrevHash()
                             .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
@@ -1668,7 +1713,7 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   Json::Value _json;
 
   if (currBlockNum == INIT_BLOCK_NUMBER) {
@@ -1684,7 +1729,8 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
   if (m_TxBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      TxBlockHeader txhead = m_mediator.m_txBlockChain.GetBlock(0).GetHeader();
+      TxBlockHeader txhead =
+          m_mediator.m_txBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HashType::HASH_VARIANT_256> sha2;
       bytes vec;
       txhead.Serialize(vec, 0);
@@ -1705,14 +1751,15 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
   if (currBlockNum > m_TxBlockCache.first) {
     for (uint64_t i = m_TxBlockCache.first + 1; i < currBlockNum; i++) {
       m_TxBlockCache.second.insert_new(m_TxBlockCache.second.size(),
-                                       m_mediator.m_txBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
+                                       m_mediator.m_txBlockChain
+                                           .GetBlockPtr(i + 1)
+                                           ->GetHeader()
                                            .GetPrevHash()
                                            .hex());
     }
     // for the latest block
     TxBlockHeader txhead =
-        m_mediator.m_txBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HashType::HASH_VARIANT_256> sha2;
     bytes vec;
     txhead.Serialize(vec, 0);
@@ -1748,8 +1795,9 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
+      tmpJson["Hash"] = m_mediator.m_txBlockChain
+                            .GetBlockPtr(currBlockNum - i + 1)
+                            ->GetHeader()
                             .GetPrevHash()
                             .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
@@ -1840,7 +1888,7 @@ string LookupServer::GetNumTxnsTxEpoch() {
   }
   try {
     return to_string(
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetNumTxs());
+        m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetNumTxs());
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (exception& e) {
@@ -1855,7 +1903,7 @@ string LookupServer::GetNumTxnsDSEpoch() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   try {
-    auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock().GetHeader();
+    auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock()->GetHeader();
     auto latestTxBlockNum = latestTxBlock.GetBlockNum();
     auto latestDSBlockNum = latestTxBlock.GetDSBlockNum();
 
@@ -1863,12 +1911,12 @@ string LookupServer::GetNumTxnsDSEpoch() {
 
     if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
       // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
+      if (m_mediator.m_txBlockChain.GetBlockPtr(m_TxBlockCountSumPair.first)
+              ->GetHeader()
               .GetDSBlockNum() == latestDSBlockNum) {
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
       // Case if DS Epoch Changed
@@ -1876,13 +1924,13 @@ string LookupServer::GetNumTxnsDSEpoch() {
         m_TxBlockCountSumPair.second = 0;
 
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
+          if (m_mediator.m_txBlockChain.GetBlockPtr(i)
+                  ->GetHeader()
                   .GetDSBlockNum() < latestDSBlockNum) {
             break;
           }
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
 
@@ -1915,9 +1963,9 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const string& txBlockNum,
     throw JsonRpcException(RPC_INVALID_PARAMETER, e.what());
   }
 
-  auto const& txBlock = m_mediator.m_txBlockChain.GetBlock(txNum);
+  const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(txNum);
 
-  return GetTransactionsForTxBlock(txBlock, pageNum);
+  return GetTransactionsForTxBlock(*txBlock, pageNum);
 }
 
 Json::Value LookupServer::GetTxnBodiesForTxBlock(const string& txBlockNum,
@@ -1942,10 +1990,10 @@ Json::Value LookupServer::GetTxnBodiesForTxBlock(const string& txBlockNum,
 
   uint32_t numTransactions = 0;
   try {
-    auto const& txBlock = m_mediator.m_txBlockChain.GetBlock(txNum);
-    numTransactions = txBlock.GetHeader().GetNumTxs();
+    const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(txNum);
+    numTransactions = txBlock->GetHeader().GetNumTxs();
 
-    auto const& hashes = GetTransactionsForTxBlock(txBlock, pageNum);
+    auto const& hashes = GetTransactionsForTxBlock(*txBlock, pageNum);
 
     if (pageNumber != "") {
       if (hashes["Transactions"].empty()) {
@@ -2207,10 +2255,10 @@ Json::Value LookupServer::GetMinerInfo(const std::string& blockNum) {
   }
 
   try {
-    const DSBlock& latest = m_mediator.m_dsBlockChain.GetLastBlock();
+    const auto latest = m_mediator.m_dsBlockChain.GetLastBlock();
     const uint64_t requestedDSBlockNum = stoull(blockNum);
 
-    if (latest.GetHeader().GetBlockNum() < requestedDSBlockNum) {
+    if (latest->GetHeader().GetBlockNum() < requestedDSBlockNum) {
       throw JsonRpcException(RPC_MISC_ERROR, "Requested data not found");
     }
 
@@ -2237,11 +2285,11 @@ Json::Value LookupServer::GetMinerInfo(const std::string& blockNum) {
       currDSBlockNum++;
 
       // Retrieve the dsBlocks database entry for the current block number
-      const DSBlock& currDSBlock =
-          m_mediator.m_dsBlockChain.GetBlock(currDSBlockNum);
+      const auto currDSBlock =
+          m_mediator.m_dsBlockChain.GetBlockPtr(currDSBlockNum);
 
       // Add the public keys of the PoWWinners in that entry to the DS committee
-      for (const auto& winner : currDSBlock.GetHeader().GetDSPoWWinners()) {
+      for (const auto& winner : currDSBlock->GetHeader().GetDSPoWWinners()) {
         minerInfoDSComm.m_dsNodes.emplace_front(winner.first);
       }
 
@@ -2385,13 +2433,13 @@ Json::Value LookupServer::GetStateProof(const string& address,
       throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
     }
 
-    if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+    if (m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() <
         requestedTxBlockNum) {
       throw JsonRpcException(RPC_MISC_ERROR, "Requested txBlock not mined yet");
     }
 
     const uint64_t& earliestTrieDSEpoch = m_mediator.GetEarliestTrieDSEpoch(
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() /
+        m_mediator.m_txBlockChain.GetLastBlock()->GetHeader().GetBlockNum() /
         NUM_FINAL_BLOCK_PER_POW);
 
     if ((requestedTxBlockNum / NUM_FINAL_BLOCK_PER_POW) < earliestTrieDSEpoch) {
@@ -2402,8 +2450,8 @@ Json::Value LookupServer::GetStateProof(const string& address,
                   (earliestTrieDSEpoch)*NUM_FINAL_BLOCK_PER_POW));
     }
 
-    rootHash = m_mediator.m_txBlockChain.GetBlock(requestedTxBlockNum)
-                   .GetHeader()
+    rootHash = m_mediator.m_txBlockChain.GetBlockPtr(requestedTxBlockNum)
+                   ->GetHeader()
                    .GetStateRootHash();
   }
 
@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBSERVER_LOOKUPSERVER_H_
 
 #include "Server.h"
+#include "TxnIngressPipeline.h"
 
 class Mediator;
 
@@ -46,6 +47,17 @@ class LookupServer : public Server,
     return m_mediator.m_lookup->AddToTxnShardMap(tx, shardId);
   };
 
+  /// set if TXN_INGRESS_THREADS, CreateTransaction then goes through it
+  std::unique_ptr<TxnIngressPipeline> m_txnIngressPipeline;
+
+  Transaction ParseTransaction(const Json::Value& _json);
+  /// Validates the txn and finds the shard map it goes to, throws if the txn
+  /// is rejected
+  Json::Value PrecheckTransaction(const Transaction& tx,
+                                  const unsigned int num_shards,
+                                  const uint128_t& gasPrice, bool priority,
+                                  uint32_t& mapIndex);
+
   Json::Value GetTransactionsForTxBlock(const std::string& txBlockNum,
                                         const std::string& pageNumber);
 
@@ -61,9 +73,15 @@ class LookupServer : public Server,
 
   inline virtual void CreateTransactionI(const Json::Value& request,
                                          Json::Value& response) {
+    if (m_txnIngressPipeline) {
+      response = CreateTransactionStaged(
+          request[0u], m_mediator.m_lookup->GetShardPeers().size(),
+          m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetGasPrice());
+      return;
+    }
     response = CreateTransaction(
         request[0u], m_mediator.m_lookup->GetShardPeers().size(),
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice(),
+        m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetGasPrice(),
         m_createTransactionTarget);
   }
 
@@ -438,6 +456,11 @@ class LookupServer : public Server,
                                 const unsigned int num_shards,
                                 const uint128_t& gasPrice,
                                 const CreateTransactionTargetFunc& targetFunc);
+  Json::Value CreateTransactionStaged(const Json::Value& _json,
+                                      const unsigned int num_shards,
+                                      const uint128_t& gasPrice);
+  /// Queue depths and per stage latencies of the txn ingress pipeline
+  Json::Value GetTxnIngressStats();
   Json::Value GetStateProof(const std::string& address,
                             const Json::Value& request,
                             const uint64_t& blockNum);
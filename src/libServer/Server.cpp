@@ -57,7 +57,7 @@ string Server::GetCurrentDSEpoch() {
   LOG_MARKER();
 
   return to_string(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum());
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum());
 }
 
 string Server::GetNodeType() {
@@ -77,9 +77,11 @@ string Server::GetNodeType() {
 }
 
 uint8_t Server::GetPrevDSDifficulty() {
-  return m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
+  return m_mediator.m_dsBlockChain.GetLastBlock()
+      ->GetHeader()
+      .GetDSDifficulty();
 }
 
 uint8_t Server::GetPrevDifficulty() {
-  return m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
+  return m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetDifficulty();
 }
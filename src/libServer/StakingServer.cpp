@@ -48,7 +48,7 @@ Json::Value StakingServer::GetRawDSBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertRawDSBlocktoJson(
-        m_mediator.m_dsBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_dsBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -76,7 +76,7 @@ Json::Value StakingServer::GetRawTxBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertRawTxBlocktoJson(
-        m_mediator.m_txBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_txBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
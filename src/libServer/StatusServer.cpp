@@ -17,7 +17,11 @@
 
 #include "StatusServer.h"
 #include "JSONConversion.h"
+#include "LookupServer.h"
+#include "libData/AccountData/AccountStore.h"
 #include "libNetwork/Blacklist.h"
+#include "libNetwork/EventSender.h"
+#include "libNetwork/WireCompression.h"
 #include "libRemoteStorageDB/RemoteStorageDB.h"
 
 using namespace jsonrpc;
@@ -137,6 +141,26 @@ StatusServer::StatusServer(Mediator& mediator,
       jsonrpc::Procedure("GetSendAllToDS", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_STRING, NULL),
       &StatusServer::GetSendAllToDSI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetTxnIngressStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetTxnIngressStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetStateTrieCacheStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetStateTrieCacheStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetP2PSendStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetP2PSendStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetMsgQueueStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetMsgQueueStatsI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetStateDeltaSyncStats", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_OBJECT, NULL),
+      &StatusServer::GetStateDeltaSyncStatsI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("DisablePoW", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_OBJECT, NULL),
@@ -531,6 +555,113 @@ bool StatusServer::GetSendAllToDS() {
   return m_mediator.m_lookup->m_sendAllToDS;
 }
 
+Json::Value StatusServer::GetTxnIngressStats() {
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST,
+                           "Not to be queried on non-lookup");
+  }
+  auto lookupServer = m_mediator.m_lookup->GetLookupServer();
+  if (!lookupServer) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Lookup server not running");
+  }
+  return lookupServer->GetTxnIngressStats();
+}
+
+Json::Value StatusServer::GetStateTrieCacheStats() {
+  const auto stats = AccountStore::GetInstance().GetNodeCacheStats();
+  const uint64_t lookups = stats.hits + stats.misses;
+
+  Json::Value ret;
+  ret["Hits"] = Json::UInt64(stats.hits);
+  ret["Misses"] = Json::UInt64(stats.misses);
+  ret["HitRatio"] = lookups == 0 ? 0.0 : (double)stats.hits / lookups;
+  ret["Evictions"] = Json::UInt64(stats.evictions);
+  ret["Entries"] = Json::UInt64(stats.entries);
+  ret["Bytes"] = Json::UInt64(stats.bytes);
+  ret["CapacityBytes"] = Json::UInt64(stats.capacity);
+  return ret;
+}
+
+Json::Value StatusServer::GetP2PSendStats() {
+  const auto stats = EventSender::GetInstance().GetStats();
+
+  Json::Value ret;
+  ret["Sent"] = Json::UInt64(stats.m_numSent);
+  ret["Queued"] = Json::UInt64(stats.m_numQueued);
+  ret["Dropped"] = Json::UInt64(stats.m_numDropped);
+  ret["Connects"] = Json::UInt64(stats.m_numConnects);
+  ret["Errors"] = Json::UInt64(stats.m_numErrors);
+  ret["Peers"] = Json::arrayValue;
+  for (const auto& peerStats : stats.m_peers) {
+    Json::Value _json;
+    _json["IP"] = peerStats.m_peer.GetPrintableIPAddress();
+    _json["Port"] = peerStats.m_peer.m_listenPortHost;
+    _json["QueueDepth"] = Json::UInt64(peerStats.m_queueDepth);
+    _json["BytesInFlight"] = Json::UInt64(peerStats.m_bytesInFlight);
+    ret["Peers"].append(_json);
+  }
+
+  const auto compression = WireCompression::GetStats();
+  Json::Value _json;
+  _json["Compressed"] = Json::UInt64(compression.m_numCompressed);
+  _json["Incompressible"] = Json::UInt64(compression.m_numIncompressible);
+  _json["BytesIn"] = Json::UInt64(compression.m_numBytesIn);
+  _json["BytesOut"] = Json::UInt64(compression.m_numBytesOut);
+  // The two counters are not read at once
+  _json["BytesSaved"] = Json::UInt64(
+      compression.m_numBytesIn -
+      min(compression.m_numBytesIn, compression.m_numBytesOut));
+  _json["CompressMicrosec"] = Json::UInt64(compression.m_compressMicrosec);
+  _json["Decompressed"] = Json::UInt64(compression.m_numDecompressed);
+  _json["DecompressMicrosec"] = Json::UInt64(compression.m_decompressMicrosec);
+  ret["Compression"] = _json;
+  return ret;
+}
+
+Json::Value StatusServer::GetMsgQueueStats() {
+  if (!m_msgQueueStatsFunc) {
+    throw JsonRpcException(RPC_INTERNAL_ERROR, "Message queue not set");
+  }
+
+  Json::Value ret;
+  ret["Lanes"] = Json::arrayValue;
+  for (const auto& laneStats : m_msgQueueStatsFunc()) {
+    Json::Value _json;
+    _json["Name"] = laneStats.m_name;
+    _json["Capacity"] = Json::UInt64(laneStats.m_capacity);
+    _json["Weight"] = laneStats.m_weight;
+    _json["Size"] = Json::UInt64(laneStats.m_size);
+    _json["Pushed"] = Json::UInt64(laneStats.m_numPushed);
+    _json["Dropped"] = Json::UInt64(laneStats.m_numDropped);
+    _json["WaitLatency"] = laneStats.m_waitLatency;
+    ret["Lanes"].append(_json);
+  }
+  return ret;
+}
+
+Json::Value StatusServer::GetStateDeltaSyncStats() {
+  StateDeltaSyncStats total;
+  StateDeltaSyncStats last;
+  m_mediator.m_lookup->GetStateDeltaSyncStats(total, last);
+
+  auto toJson = [](const StateDeltaSyncStats& stats) {
+    Json::Value _json;
+    _json["Blocks"] = Json::UInt64(stats.m_numBlocks);
+    _json["Chunks"] = Json::UInt64(stats.m_numChunks);
+    _json["Retries"] = Json::UInt64(stats.m_numRetries);
+    _json["SyncTimeSec"] = stats.m_syncTimeSec;
+    _json["BlocksPerSec"] = stats.m_syncTimeSec == 0
+                                ? 0.0
+                                : stats.m_numBlocks / stats.m_syncTimeSec;
+    return _json;
+  };
+
+  Json::Value ret;
+  ret["Total"] = toJson(total);
+  ret["Last"] = toJson(last);
+  return ret;
+}
+
 bool StatusServer::DisablePoW() {
   if (LOOKUP_NODE_MODE) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Not to be queried on lookup");
@@ -19,6 +19,7 @@
 #define ZILLIQA_SRC_LIBSERVER_STATUSSERVER_H_
 
 #include "Server.h"
+#include "libUtils/LaneQueue.h"
 
 class StatusServer : public Server,
                      public jsonrpc::AbstractServer<StatusServer> {
@@ -121,6 +122,31 @@ class StatusServer : public Server,
     (void)request;
     response = this->GetSendAllToDS();
   }
+  inline virtual void GetTxnIngressStatsI(const Json::Value& request,
+                                          Json::Value& response) {
+    (void)request;
+    response = this->GetTxnIngressStats();
+  }
+  inline virtual void GetStateTrieCacheStatsI(const Json::Value& request,
+                                              Json::Value& response) {
+    (void)request;
+    response = this->GetStateTrieCacheStats();
+  }
+  inline virtual void GetP2PSendStatsI(const Json::Value& request,
+                                       Json::Value& response) {
+    (void)request;
+    response = this->GetP2PSendStats();
+  }
+  inline virtual void GetMsgQueueStatsI(const Json::Value& request,
+                                        Json::Value& response) {
+    (void)request;
+    response = this->GetMsgQueueStats();
+  }
+  inline virtual void GetStateDeltaSyncStatsI(const Json::Value& request,
+                                              Json::Value& response) {
+    (void)request;
+    response = this->GetStateDeltaSyncStats();
+  }
   inline virtual void ToggleSendAllToDSI(const Json::Value& request,
                                          Json::Value& response) {
     (void)request;
@@ -203,6 +229,11 @@ class StatusServer : public Server,
   bool GetSendSCCallsToDS();
   bool ToggleSendAllToDS();
   bool GetSendAllToDS();
+  Json::Value GetTxnIngressStats();
+  Json::Value GetStateTrieCacheStats();
+  Json::Value GetP2PSendStats();
+  Json::Value GetMsgQueueStats();
+  Json::Value GetStateDeltaSyncStats();
   bool DisablePoW();
   bool ToggleDisableTxns();
   std::string SetValidateDB();
@@ -220,6 +251,15 @@ class StatusServer : public Server,
   bool ToggleGetPendingTxns();
   bool EnableJsonRpcPort();
   bool DisableJsonRpcPort();
+
+  using MsgQueueStatsFunc = std::function<std::vector<LaneStats>()>;
+  /// Sets where GetMsgQueueStats gets the lanes of the incoming message queue
+  void SetMsgQueueStatsFunc(const MsgQueueStatsFunc& func) {
+    m_msgQueueStatsFunc = func;
+  }
+
+ private:
+  MsgQueueStatsFunc m_msgQueueStatsFunc;
 };
 
 #endif  // ZILLIQA_SRC_LIBSERVER_STATUSSERVER_H_
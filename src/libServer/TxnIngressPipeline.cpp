@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "TxnIngressPipeline.h"
+
+#include "Server.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace jsonrpc;
+
+namespace {
+uint64_t NowMs() {
+  return chrono::duration_cast<chrono::milliseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+Json::Value LatencyToJson(const LatencyHistogram& histogram) {
+  Json::Value ret;
+  ret["Count"] = Json::UInt64(histogram.GetCount());
+  ret["P50"] = Json::UInt64(histogram.GetPercentile(0.5));
+  ret["P90"] = Json::UInt64(histogram.GetPercentile(0.9));
+  ret["P99"] = Json::UInt64(histogram.GetPercentile(0.99));
+  return ret;
+}
+
+/// Response of the txns still queued when the pipeline stops
+JsonRpcException StoppedError() {
+  return JsonRpcException(ServerBase::RPC_MISC_ERROR,
+                          "Txn ingress stopped, retry later");
+}
+}  // namespace
+
+TxnIngressPipeline::TxnIngressPipeline(unsigned int numWorkers,
+                                       size_t queueSize, size_t batchSize,
+                                       InsertBatchFunc insertBatch)
+    : m_queueSize(queueSize),
+      m_batchSize(max<size_t>(1, batchSize)),
+      m_insertBatch(move(insertBatch)) {
+  for (unsigned int i = 0; i < numWorkers; i++) {
+    m_threads.emplace_back([this]() { PrecheckWorker(); });
+  }
+  m_threads.emplace_back([this]() { Inserter(); });
+}
+
+TxnIngressPipeline::~TxnIngressPipeline() {
+  m_stopped = true;
+  {
+    lock_guard<mutex> g(m_mutexPrecheck);
+    cv_precheck.notify_all();
+  }
+  {
+    lock_guard<mutex> g(m_mutexInsert);
+    cv_insert.notify_all();
+    cv_insertSpace.notify_all();
+  }
+  for (auto& thread : m_threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+
+  // The RPC threads waiting for these txns get an error instead of a broken
+  // promise
+  {
+    lock_guard<mutex> g(m_mutexPrecheck);
+    for (auto& job : m_precheckQueue) {
+      job->m_response.set_exception(make_exception_ptr(StoppedError()));
+    }
+    m_precheckQueue.clear();
+  }
+  {
+    lock_guard<mutex> g(m_mutexInsert);
+    for (auto& job : m_insertQueue) {
+      job->m_response.set_exception(make_exception_ptr(StoppedError()));
+    }
+    m_insertQueue.clear();
+  }
+}
+
+Json::Value TxnIngressPipeline::Process(const Transaction& tx,
+                                        PrecheckFunc precheck) {
+  auto job = make_unique<Job>();
+  job->m_tx = tx;
+  job->m_precheck = move(precheck);
+  job->m_enqueuedMs = NowMs();
+  future<Json::Value> response = job->m_response.get_future();
+
+  {
+    lock_guard<mutex> g(m_mutexPrecheck);
+    if (m_stopped) {
+      throw StoppedError();
+    }
+    if (m_precheckQueue.size() >= m_queueSize) {
+      m_numRejectedFull++;
+      throw JsonRpcException(ServerBase::RPC_MISC_ERROR,
+                             "Too many pending txns, retry later");
+    }
+    m_precheckQueue.emplace_back(move(job));
+    // Notified under the lock, the pipeline may be stopping
+    cv_precheck.notify_one();
+  }
+
+  // The RPC server answers from the thread of the request, so it waits here
+  return response.get();
+}
+
+void TxnIngressPipeline::PrecheckWorker() {
+  while (true) {
+    unique_ptr<Job> job;
+    {
+      unique_lock<mutex> lock(m_mutexPrecheck);
+      cv_precheck.wait(
+          lock, [this] { return m_stopped || !m_precheckQueue.empty(); });
+      if (m_stopped) {
+        return;
+      }
+      job = move(m_precheckQueue.front());
+      m_precheckQueue.pop_front();
+    }
+
+    const uint64_t startMs = NowMs();
+    m_precheckWaitLatency.Record(startMs - job->m_enqueuedMs);
+    try {
+      job->m_precheckResponse = job->m_precheck(job->m_mapIndex);
+    } catch (...) {
+      m_precheckLatency.Record(NowMs() - startMs);
+      job->m_response.set_exception(current_exception());
+      continue;
+    }
+    job->m_enqueuedMs = NowMs();
+    m_precheckLatency.Record(job->m_enqueuedMs - startMs);
+
+    {
+      unique_lock<mutex> lock(m_mutexInsert);
+      cv_insertSpace.wait(lock, [this] {
+        return m_stopped || m_insertQueue.size() < m_queueSize;
+      });
+      if (m_stopped) {
+        job->m_response.set_exception(make_exception_ptr(StoppedError()));
+        return;
+      }
+      m_insertQueue.emplace_back(move(job));
+    }
+    cv_insert.notify_one();
+  }
+}
+
+void TxnIngressPipeline::Inserter() {
+  while (true) {
+    vector<unique_ptr<Job>> batch;
+    {
+      unique_lock<mutex> lock(m_mutexInsert);
+      cv_insert.wait(lock,
+                     [this] { return m_stopped || !m_insertQueue.empty(); });
+      if (m_stopped) {
+        return;
+      }
+      while (!m_insertQueue.empty() && batch.size() < m_batchSize) {
+        batch.emplace_back(move(m_insertQueue.front()));
+        m_insertQueue.pop_front();
+      }
+    }
+    cv_insertSpace.notify_all();
+
+    const uint64_t startMs = NowMs();
+    vector<pair<Transaction, uint32_t>> txns;
+    txns.reserve(batch.size());
+    for (auto& job : batch) {
+      m_insertWaitLatency.Record(startMs - job->m_enqueuedMs);
+      txns.emplace_back(move(job->m_tx), job->m_mapIndex);
+    }
+
+    vector<bool> added;
+    try {
+      m_insertBatch(txns, added);
+    } catch (...) {
+      for (auto& job : batch) {
+        job->m_response.set_exception(current_exception());
+      }
+      continue;
+    }
+    m_insertLatency.Record(NowMs() - startMs);
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      if (i < added.size() && added[i]) {
+        Json::Value ret = move(batch[i]->m_precheckResponse);
+        ret["TranID"] = txns[i].first.GetTranID().hex();
+        batch[i]->m_response.set_value(move(ret));
+      } else {
+        batch[i]->m_response.set_exception(make_exception_ptr(
+            JsonRpcException(ServerBase::RPC_DATABASE_ERROR,
+                             "Txn could not be added as database exceeded "
+                             "limit or the txn was already present")));
+      }
+    }
+  }
+}
+
+Json::Value TxnIngressPipeline::GetStats() {
+  Json::Value ret;
+  {
+    lock_guard<mutex> g(m_mutexPrecheck);
+    ret["PrecheckQueueDepth"] = Json::UInt64(m_precheckQueue.size());
+  }
+  {
+    lock_guard<mutex> g(m_mutexInsert);
+    ret["InsertQueueDepth"] = Json::UInt64(m_insertQueue.size());
+  }
+  ret["RejectedQueueFull"] = Json::UInt64(m_numRejectedFull);
+  ret["PrecheckWaitMs"] = LatencyToJson(m_precheckWaitLatency);
+  ret["PrecheckMs"] = LatencyToJson(m_precheckLatency);
+  ret["InsertWaitMs"] = LatencyToJson(m_insertWaitLatency);
+  ret["InsertMs"] = LatencyToJson(m_insertLatency);
+  return ret;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBSERVER_TXNINGRESSPIPELINE_H_
+#define ZILLIQA_SRC_LIBSERVER_TXNINGRESSPIPELINE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <json/json.h>
+
+#include "libData/AccountData/Transaction.h"
+#include "libUtils/LatencyHistogram.h"
+
+/// Staged handling of the txns submitted to the lookup. The prechecks
+/// (signature, nonce, balance and routing) of a txn run on a pool of workers,
+/// and the accepted txns are added to the txn shard map in batches by a single
+/// inserter. Both queues are bounded, a txn arriving when the precheck queue
+/// is full is rejected right away.
+///
+/// The RPC thread of a txn still waits for its response. What the pipeline
+/// saves is the insertion: inline, each of the RPC threads takes the shard
+/// map lock and counts the pending txns for its own txn, while the inserter
+/// does it once per batch. The prechecks also use TXN_INGRESS_THREADS cores
+/// at most, instead of one per RPC thread.
+class TxnIngressPipeline {
+ public:
+  /// Returns the response for the txn and sets the index of the shard map to
+  /// add it to, throws a JsonRpcException if it is rejected
+  using PrecheckFunc = std::function<Json::Value(uint32_t& mapIndex)>;
+
+  /// Adds the txns to the shard maps, sets whether each one has been added
+  using InsertBatchFunc = std::function<void(
+      const std::vector<std::pair<Transaction, uint32_t>>& txns,
+      std::vector<bool>& added)>;
+
+  TxnIngressPipeline(unsigned int numWorkers, size_t queueSize,
+                     size_t batchSize, InsertBatchFunc insertBatch);
+  ~TxnIngressPipeline();
+
+  /// Runs the txn through the pipeline and waits for the response, throws a
+  /// JsonRpcException if the txn is rejected, the pipeline is full or it
+  /// stops before the txn is inserted
+  Json::Value Process(const Transaction& tx, PrecheckFunc precheck);
+
+  /// Queue depths and per stage latencies
+  Json::Value GetStats();
+
+ private:
+  struct Job {
+    Transaction m_tx;
+    PrecheckFunc m_precheck;
+    std::promise<Json::Value> m_response;
+    Json::Value m_precheckResponse;
+    uint32_t m_mapIndex{0};
+    uint64_t m_enqueuedMs{0};
+  };
+
+  const size_t m_queueSize;
+  const size_t m_batchSize;
+  InsertBatchFunc m_insertBatch;
+
+  std::mutex m_mutexPrecheck;
+  std::condition_variable cv_precheck;
+  std::deque<std::unique_ptr<Job>> m_precheckQueue;
+
+  std::mutex m_mutexInsert;
+  std::condition_variable cv_insert;
+  std::condition_variable cv_insertSpace;
+  std::deque<std::unique_ptr<Job>> m_insertQueue;
+
+  std::atomic<bool> m_stopped{false};
+  std::vector<std::thread> m_threads;
+
+  std::atomic<uint64_t> m_numRejectedFull{0};
+  LatencyHistogram m_precheckWaitLatency;
+  LatencyHistogram m_precheckLatency;
+  LatencyHistogram m_insertWaitLatency;
+  LatencyHistogram m_insertLatency;
+
+  void PrecheckWorker();
+  void Inserter();
+};
+
+#endif  // ZILLIQA_SRC_LIBSERVER_TXNINGRESSPIPELINE_H_
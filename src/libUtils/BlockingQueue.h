@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_BLOCKINGQUEUE_H_
+#define ZILLIQA_SRC_LIBUTILS_BLOCKINGQUEUE_H_
+
+#include <atomic>
+#include <boost/lockfree/queue.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "libUtils/LatencyHistogram.h"
+#include "libUtils/Logger.h"
+
+/// Bounded multi-producer multi-consumer queue whose consumers block while it
+/// is empty. A consumer spins briefly before parking on a condition variable,
+/// and producers only take the lock to wake it when one is parked, so a busy
+/// queue stays lock-free. Keeps histograms of the queue length seen by each
+/// push and of the time items wait in the queue.
+template <class T>
+class BlockingQueue {
+ public:
+  BlockingQueue(size_t capacity, const std::string& name)
+      : m_queue(capacity), m_name(name), m_lastStatsLogUs(Now()) {}
+
+  /// Adds the item, returns false if the queue is full
+  bool Push(const T& item) {
+    const size_t size = ++m_size;
+    if (!m_queue.bounded_push({item, Now()})) {
+      m_size--;
+      return false;
+    }
+    m_lengths.Record(size);
+
+    // Either the consumer about to park sees the item, or it is counted here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_numParked > 0) {
+      std::lock_guard<std::mutex> g(m_mutex);
+      m_cv.notify_one();
+    }
+    return true;
+  }
+
+  /// Removes an item if there is one
+  bool TryPop(T& item) {
+    Entry entry;
+    if (!m_queue.pop(entry)) {
+      return false;
+    }
+    m_size--;
+    item = entry.m_item;
+    RecordWait(entry.m_enqueuedUs);
+    return true;
+  }
+
+  /// Removes an item, waiting for one if the queue is empty
+  void Pop(T& item) {
+    for (unsigned int i = 0; i < SPIN_COUNT; i++) {
+      if (TryPop(item)) {
+        return;
+      }
+      if (i >= SPIN_COUNT / 2) {
+        std::this_thread::yield();
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_numParked++;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_cv.wait(lock, [this, &item]() { return TryPop(item); });
+    m_numParked--;
+  }
+
+  size_t Size() const { return m_size; }
+
+  const LatencyHistogram& GetLengths() const { return m_lengths; }
+
+  const LatencyHistogram& GetWaitLatency() const { return m_waitLatency; }
+
+ private:
+  static constexpr unsigned int SPIN_COUNT = 200;
+  static constexpr unsigned int STATS_LOG_INTERVAL_IN_SECONDS = 60;
+
+  /// Trivially copyable, as the lock-free queue requires
+  struct Entry {
+    T m_item;
+    uint64_t m_enqueuedUs;
+  };
+
+  boost::lockfree::queue<Entry> m_queue;
+  const std::string m_name;
+  std::atomic<size_t> m_size{0};
+  std::atomic<unsigned int> m_numParked{0};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  LatencyHistogram m_lengths{"items"};
+  LatencyHistogram m_waitLatency{"us"};
+  std::atomic<uint64_t> m_lastStatsLogUs;
+
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void RecordWait(uint64_t enqueuedUs) {
+    const uint64_t now = Now();
+    m_waitLatency.Record(now - enqueuedUs);
+
+    // Logs the backlog now and then, from the one consumer winning the swap
+    uint64_t lastLog = m_lastStatsLogUs;
+    if (now - lastLog >= STATS_LOG_INTERVAL_IN_SECONDS * 1000000ULL &&
+        m_lastStatsLogUs.compare_exchange_strong(lastLog, now)) {
+      LOG_GENERAL(INFO, m_name << " size " << m_size << ", length "
+                               << m_lengths.ToString() << ", wait "
+                               << m_waitLatency.ToString());
+    }
+  }
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_BLOCKINGQUEUE_H_
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_LANEQUEUE_H_
+#define ZILLIQA_SRC_LIBUTILS_LANEQUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "libUtils/BlockingQueue.h"
+
+struct LaneConfig {
+  std::string m_name;
+  size_t m_capacity;
+  /// Items popped from the lane in a row while it has any
+  unsigned int m_weight;
+};
+
+struct LaneStats {
+  std::string m_name;
+  size_t m_capacity;
+  unsigned int m_weight;
+  size_t m_size;
+  uint64_t m_numPushed;
+  uint64_t m_numDropped;
+  std::string m_waitLatency;
+};
+
+/// Queue split into lanes, each bounded on its own so that a flood in one
+/// lane does not hold back the others. Consumers take turns between the
+/// non-empty lanes by weighted round robin, and block while all are empty.
+template <class T>
+class LaneQueue {
+ public:
+  explicit LaneQueue(const std::vector<LaneConfig>& configs) {
+    size_t totalCapacity = 0;
+    for (const auto& config : configs) {
+      m_lanes.emplace_back(new Lane(config));
+      totalCapacity += config.m_capacity;
+    }
+    m_ready.reset(new BlockingQueue<unsigned char>(totalCapacity, "Lanes"));
+    m_credit = m_lanes.empty() ? 0 : m_lanes[0]->m_config.m_weight;
+  }
+
+  /// Adds the item to the lane, returns false if the lane is full
+  bool Push(unsigned int lane, const T& item) {
+    if (lane >= m_lanes.size()) {
+      return false;
+    }
+    Lane& l = *m_lanes[lane];
+    if (!l.m_queue.Push(item)) {
+      l.m_numDropped++;
+      return false;
+    }
+    l.m_numPushed++;
+    // One token per item, pushed after it so that a consumer holding a token
+    // always finds an item
+    m_ready->Push(lane);
+    return true;
+  }
+
+  /// Removes the next item by weight, waiting for one if all lanes are empty
+  void Pop(T& item) {
+    unsigned char token = 0;
+    m_ready->Pop(token);
+
+    std::lock_guard<std::mutex> g(m_mutexSchedule);
+    while (true) {
+      Lane& l = *m_lanes[m_currentLane];
+      if (m_credit > 0 && l.m_queue.TryPop(item)) {
+        m_credit--;
+        return;
+      }
+      // The lane used its turn or ran dry, the next one starts a new turn
+      m_currentLane = (m_currentLane + 1) % m_lanes.size();
+      m_credit = m_lanes[m_currentLane]->m_config.m_weight;
+    }
+  }
+
+  /// Removes an item from any lane if there is one, ignoring the weights
+  bool TryPop(T& item) {
+    unsigned char token = 0;
+    if (!m_ready->TryPop(token)) {
+      return false;
+    }
+    for (const auto& l : m_lanes) {
+      if (l->m_queue.TryPop(item)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<LaneStats> GetStats() const {
+    std::vector<LaneStats> stats;
+    for (const auto& l : m_lanes) {
+      stats.push_back({l->m_config.m_name, l->m_config.m_capacity,
+                       l->m_config.m_weight, l->m_queue.Size(),
+                       l->m_numPushed, l->m_numDropped,
+                       l->m_queue.GetWaitLatency().ToString()});
+    }
+    return stats;
+  }
+
+ private:
+  struct Lane {
+    explicit Lane(const LaneConfig& config)
+        : m_config{config.m_name, config.m_capacity,
+                   std::max(config.m_weight, 1u)},
+          m_queue(config.m_capacity, config.m_name) {}
+
+    const LaneConfig m_config;
+    BlockingQueue<T> m_queue;
+    std::atomic<uint64_t> m_numPushed{0};
+    std::atomic<uint64_t> m_numDropped{0};
+  };
+
+  std::vector<std::unique_ptr<Lane>> m_lanes;
+  /// Holds one token per queued item, for the consumers to block on
+  std::unique_ptr<BlockingQueue<unsigned char>> m_ready;
+
+  std::mutex m_mutexSchedule;
+  unsigned int m_currentLane{0};
+  unsigned int m_credit{0};
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_LANEQUEUE_H_
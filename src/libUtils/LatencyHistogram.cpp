@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+LatencyHistogram::LatencyHistogram(const std::string& unit) : m_unit(unit) {}
+
+void LatencyHistogram::Record(uint64_t latencyMs) {
+  unsigned int bucket = 0;
+  while (bucket < NUM_BUCKETS - 1 && latencyMs > (1ULL << bucket)) {
+    bucket++;
+  }
+  m_buckets[bucket]++;
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  uint64_t count = 0;
+  for (const auto& bucket : m_buckets) {
+    count += bucket;
+  }
+  return count;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double fraction) const {
+  const uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+
+  const uint64_t target = std::max<uint64_t>(1, std::ceil(fraction * count));
+  uint64_t cumulative = 0;
+  for (unsigned int bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+    cumulative += m_buckets[bucket];
+    if (cumulative >= target) {
+      return 1ULL << bucket;
+    }
+  }
+  return 1ULL << (NUM_BUCKETS - 1);
+}
+
+std::string LatencyHistogram::ToString() const {
+  std::ostringstream oss;
+  oss << "count " << GetCount() << " p50 <= " << GetPercentile(0.5) << " "
+      << m_unit << " p90 <= " << GetPercentile(0.9) << " " << m_unit
+      << " p99 <= " << GetPercentile(0.99) << " " << m_unit;
+  return oss.str();
+}
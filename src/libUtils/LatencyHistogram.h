@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ZILLIQA_SRC_LIBUTILS_LATENCYHISTOGRAM_H_
+#define ZILLIQA_SRC_LIBUTILS_LATENCYHISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// Histogram of latencies in ms, or in the given unit, the upper bounds of the
+/// buckets double from 1
+class LatencyHistogram {
+ public:
+  static constexpr unsigned int NUM_BUCKETS = 24;
+
+  explicit LatencyHistogram(const std::string& unit = "ms");
+
+  void Record(uint64_t latencyMs);
+
+  uint64_t GetCount() const;
+
+  /// upper bound of the bucket that the given fraction of the samples
+  /// stays within
+  uint64_t GetPercentile(double fraction) const;
+
+  std::string ToString() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_buckets{};
+  const std::string m_unit;
+};
+
+#endif  // ZILLIQA_SRC_LIBUTILS_LATENCYHISTOGRAM_H_
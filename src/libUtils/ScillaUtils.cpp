@@ -17,6 +17,7 @@
 
 #include "ScillaUtils.h"
 
+#include <atomic>
 #include <boost/filesystem.hpp>
 
 #include "Logger.h"
@@ -41,6 +42,16 @@ bool ScillaUtils::PrepareRootPathWVersion(const uint32_t& scilla_version,
   return true;
 }
 
+string ScillaUtils::NewFilesFolder() {
+  static atomic<unsigned int> numFolders{0};
+  const unsigned int index = numFolders++;
+  return index == 0 ? SCILLA_FILES : SCILLA_FILES + '.' + to_string(index);
+}
+
+string ScillaUtils::GetFilePath(const string& folder, const string& file) {
+  return folder + '/' + boost::filesystem::path(file).filename().string();
+}
+
 Json::Value ScillaUtils::GetBlockStateJson(const uint64_t& BlockNum) {
   Json::Value root;
   Json::Value blockItem;
@@ -53,19 +64,19 @@ Json::Value ScillaUtils::GetBlockStateJson(const uint64_t& BlockNum) {
 }
 
 Json::Value ScillaUtils::GetContractCheckerJson(const string& root_w_version,
-                                                bool is_library,
+                                                const string& code_path,
+                                                const string& init_path,
                                                 const uint64_t& available_gas) {
   Json::Value ret;
   ret["argv"].append("-init");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INIT_JSON);
+                     init_path);
   ret["argv"].append("-libdir");
   ret["argv"].append(root_w_version + '/' + SCILLA_LIB + ":" +
                      boost::filesystem::current_path().string() + '/' +
                      EXTLIB_FOLDER);
-  ret["argv"].append(
-      boost::filesystem::current_path().string() + '/' + INPUT_CODE +
-      (is_library ? LIBRARY_CODE_EXTENSION : CONTRACT_FILE_EXTENSION));
+  ret["argv"].append(boost::filesystem::current_path().string() + '/' +
+                     code_path);
   ret["argv"].append("-gaslimit");
   ret["argv"].append(to_string(available_gas));
   ret["argv"].append("-contractinfo");
@@ -74,25 +85,26 @@ Json::Value ScillaUtils::GetContractCheckerJson(const string& root_w_version,
 }
 
 Json::Value ScillaUtils::GetCreateContractJson(const string& root_w_version,
-                                               bool is_library,
+                                               const string& files_folder,
+                                               const string& code_path,
+                                               const string& init_path,
                                                const uint64_t& available_gas,
                                                const uint128_t& balance) {
   Json::Value ret;
   ret["argv"].append("-init");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INIT_JSON);
+                     init_path);
   ret["argv"].append("-ipcaddress");
   ret["argv"].append(SCILLA_IPC_SOCKET_PATH);
   ret["argv"].append("-iblockchain");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INPUT_BLOCKCHAIN_JSON);
+                     GetFilePath(files_folder, INPUT_BLOCKCHAIN_JSON));
   ret["argv"].append("-o");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     OUTPUT_JSON);
+                     GetFilePath(files_folder, OUTPUT_JSON));
   ret["argv"].append("-i");
-  ret["argv"].append(
-      boost::filesystem::current_path().string() + '/' + INPUT_CODE +
-      (is_library ? LIBRARY_CODE_EXTENSION : CONTRACT_FILE_EXTENSION));
+  ret["argv"].append(boost::filesystem::current_path().string() + '/' +
+                     code_path);
   ret["argv"].append("-gaslimit");
   ret["argv"].append(to_string(available_gas));
   ret["argv"].append("-balance");
@@ -107,26 +119,29 @@ Json::Value ScillaUtils::GetCreateContractJson(const string& root_w_version,
 }
 
 Json::Value ScillaUtils::GetCallContractJson(const string& root_w_version,
+                                             const string& files_folder,
+                                             const string& code_path,
+                                             const string& init_path,
                                              const uint64_t& available_gas,
                                              const uint128_t& balance) {
   Json::Value ret;
   ret["argv"].append("-init");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INIT_JSON);
+                     init_path);
   ret["argv"].append("-ipcaddress");
   ret["argv"].append(SCILLA_IPC_SOCKET_PATH);
   ret["argv"].append("-iblockchain");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INPUT_BLOCKCHAIN_JSON);
+                     GetFilePath(files_folder, INPUT_BLOCKCHAIN_JSON));
   ret["argv"].append("-imessage");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INPUT_MESSAGE_JSON);
+                     GetFilePath(files_folder, INPUT_MESSAGE_JSON));
   ret["argv"].append("-o");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     OUTPUT_JSON);
+                     GetFilePath(files_folder, OUTPUT_JSON));
   ret["argv"].append("-i");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INPUT_CODE + CONTRACT_FILE_EXTENSION);
+                     code_path);
   ret["argv"].append("-gaslimit");
   ret["argv"].append(to_string(available_gas));
   ret["argv"].append("-balance");
@@ -142,19 +157,21 @@ Json::Value ScillaUtils::GetCallContractJson(const string& root_w_version,
   return ret;
 }
 
-Json::Value ScillaUtils::GetDisambiguateJson() {
+Json::Value ScillaUtils::GetDisambiguateJson(const string& files_folder,
+                                             const string& code_path,
+                                             const string& init_path) {
   Json::Value ret;
   ret["argv"].append("-iinit");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INIT_JSON);
+                     init_path);
   ret["argv"].append("-ipcaddress");
   ret["argv"].append(SCILLA_IPC_SOCKET_PATH);
   ret["argv"].append("-oinit");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     OUTPUT_JSON);
+                     GetFilePath(files_folder, OUTPUT_JSON));
   ret["argv"].append("-i");
   ret["argv"].append(boost::filesystem::current_path().string() + '/' +
-                     INPUT_CODE + CONTRACT_FILE_EXTENSION);
+                     code_path);
 
   return ret;
 }
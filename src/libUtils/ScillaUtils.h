@@ -27,27 +27,42 @@ class ScillaUtils {
   static bool PrepareRootPathWVersion(const uint32_t& scilla_version,
                                       std::string& root_w_version);
 
+  /// get a folder for the input and output files of one caller of the
+  /// interpreter, the first one gets SCILLA_FILES and the next ones
+  /// SCILLA_FILES.<n>
+  static std::string NewFilesFolder();
+
+  /// get the path in the folder of the given file of SCILLA_FILES
+  static std::string GetFilePath(const std::string& folder,
+                                 const std::string& file);
+
   /// get the json format file for the current blocknum
   static Json::Value GetBlockStateJson(const uint64_t& BlockNum);
 
   /// get the command for invoking the scilla_checker while deploying
   static Json::Value GetContractCheckerJson(const std::string& root_w_version,
-                                            bool is_library,
+                                            const std::string& code_path,
+                                            const std::string& init_path,
                                             const uint64_t& available_gas);
 
   /// get the command for invoking the scilla_runner while deploying
   static Json::Value GetCreateContractJson(
-      const std::string& root_w_version, bool is_library,
+      const std::string& root_w_version, const std::string& files_folder,
+      const std::string& code_path, const std::string& init_path,
       const uint64_t& available_gas,
       const boost::multiprecision::uint128_t& balance);
 
   /// get the command for invoking the scilla_runner while calling
   static Json::Value GetCallContractJson(
-      const std::string& root_w_version, const uint64_t& available_gas,
+      const std::string& root_w_version, const std::string& files_folder,
+      const std::string& code_path, const std::string& init_path,
+      const uint64_t& available_gas,
       const boost::multiprecision::uint128_t& balance);
 
   /// get the command for invoking disambiguate_state_json while calling
-  static Json::Value GetDisambiguateJson();
+  static Json::Value GetDisambiguateJson(const std::string& files_folder,
+                                         const std::string& code_path,
+                                         const std::string& init_path);
 };
 
 #endif  // ZILLIQA_SRC_LIBUTILS_SCILLAUTILS_H_
\ No newline at end of file
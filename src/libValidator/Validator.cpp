@@ -55,6 +55,21 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx,
                 "called from LookUp node.");
     return true;
   }
+
+  if (!PreCheckCreatedTransaction(tx, error_code)) {
+    return false;
+  }
+
+  receipt.SetEpochNum(m_mediator.m_currentEpochNum);
+
+  return AccountStore::GetInstance().UpdateAccountsTemp(
+      m_mediator.m_currentEpochNum, m_mediator.m_node->getNumShards(),
+      m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE, tx, receipt,
+      error_code);
+}
+
+bool Validator::PreCheckCreatedTransaction(const Transaction& tx,
+                                           TxnStatus& error_code) const {
   error_code = TxnStatus::NOT_PRESENT;
 
   if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
@@ -108,12 +123,7 @@ bool Validator::CheckCreatedTransaction(const Transaction& tx,
     return false;
   }
 
-  receipt.SetEpochNum(m_mediator.m_currentEpochNum);
-
-  return AccountStore::GetInstance().UpdateAccountsTemp(
-      m_mediator.m_currentEpochNum, m_mediator.m_node->getNumShards(),
-      m_mediator.m_ds->m_mode != DirectoryService::Mode::IDLE, tx, receipt,
-      error_code);
+  return true;
 }
 
 bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx,
@@ -207,12 +217,12 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx,
   }
 
   if (tx.GetGasPrice() <
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice()) {
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetGasPrice()) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "GasPrice " << tx.GetGasPrice()
                           << " lower than minimum allowable "
                           << m_mediator.m_dsBlockChain.GetLastBlock()
-                                 .GetHeader()
+                                 ->GetHeader()
                                  .GetGasPrice());
     // Should be checked at lookup also
     error_code = TxnStatus::INSUFFICIENT_GAS;
@@ -321,10 +331,10 @@ bool Validator::CheckDirBlocks(
   bool ret = true;
 
   uint64_t prevdsblocknum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetBlockNum();
   uint64_t totalIndex = index_num;
   ShardingHash prevShardingHash =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetShardingHash();
+      m_mediator.m_dsBlockChain.GetLastBlock()->GetHeader().GetShardingHash();
   BlockHash prevHash = get<BlockLinkIndex::BLOCKHASH>(
       m_mediator.m_blocklinkchain.GetLatestBlockLink());
 
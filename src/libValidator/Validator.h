@@ -41,6 +41,11 @@ class Validator {
                                TransactionReceipt& receipt,
                                TxnStatus& error_code) const;
 
+  /// checks of CheckCreatedTransaction that only depend on the committed
+  /// states, i.e. everything except applying the txn onto AccountStoreTemp
+  bool PreCheckCreatedTransaction(const Transaction& tx,
+                                  TxnStatus& error_code) const;
+
   bool CheckCreatedTransactionFromLookup(const Transaction& tx,
                                          TxnStatus& error_code);
 
@@ -139,7 +139,11 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
       m_ds(m_mediator),
       m_lookup(m_mediator, syncType, multiplierSyncMode, std::move(extSeedKey)),
       m_n(m_mediator, syncType, toRetrieveHistory),
-      m_msgQueue(MSGQUEUE_SIZE)
+      m_msgQueue({{"Consensus", CONSENSUS_MSGQUEUE_SIZE,
+                   CONSENSUS_MSGQUEUE_WEIGHT},
+                  {"Block", BLOCK_MSGQUEUE_SIZE, BLOCK_MSGQUEUE_WEIGHT},
+                  {"Lookup", LOOKUP_MSGQUEUE_SIZE, LOOKUP_MSGQUEUE_WEIGHT},
+                  {"Txn", TXN_MSGQUEUE_SIZE, TXN_MSGQUEUE_WEIGHT}})
 
 {
   LOG_MARKER();
@@ -148,20 +152,17 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
     LOG_STATE("[IDENT] " << string(key.second).substr(0, 8));
   }
 
-  // Launch the thread that reads messages from the queue
-  auto funcCheckMsgQueue = [this]() mutable -> void {
+  // Launch the threads that process the messages. Each one only takes a
+  // message once it is free, so the backlog waits in the lanes where the
+  // consensus messages get ahead of the others.
+  auto funcProcessMsgQueue = [this]() mutable -> void {
     pair<bytes, std::pair<Peer, const unsigned char>>* message = NULL;
     while (true) {
-      while (m_msgQueue.pop(message)) {
-        // For now, we use a thread pool to handle this message
-        // Eventually processing will be single-threaded
-        m_queuePool.AddJob(
-            [this, message]() mutable -> void { ProcessMessage(message); });
-      }
-      std::this_thread::sleep_for(std::chrono::microseconds(1));
+      m_msgQueue.Pop(message);
+      ProcessMessage(message);
     }
   };
-  DetachedFunction(1, funcCheckMsgQueue);
+  DetachedFunction(MAXRECVMESSAGE, funcProcessMsgQueue);
 
   m_validator = make_shared<Validator>(m_mediator);
 
@@ -453,6 +454,8 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
       if (m_statusServer == nullptr) {
         LOG_GENERAL(WARNING, "m_statusServer NULL");
       } else {
+        m_statusServer->SetMsgQueueStatsFunc(
+            [this]() { return m_msgQueue.GetStats(); });
         if (m_statusServer->StartListening()) {
           LOG_GENERAL(INFO, "Status Server started successfully");
         } else {
@@ -487,8 +490,8 @@ Zilliqa::Zilliqa(const PairOfKey& key, const Peer& peer, SyncType syncType,
 }
 
 Zilliqa::~Zilliqa() {
-  pair<bytes, Peer>* message = NULL;
-  while (m_msgQueue.pop(message)) {
+  pair<bytes, std::pair<Peer, const unsigned char>>* message = NULL;
+  while (m_msgQueue.TryPop(message)) {
     delete message;
   }
 }
@@ -498,8 +501,55 @@ void Zilliqa::Dispatch(
   // LOG_MARKER();
 
   // Queue message
-  if (!m_msgQueue.bounded_push(message)) {
-    LOG_GENERAL(WARNING, "Input MsgQueue is full");
+  const MessageLane lane = GetMessageLane(message->first);
+  if (!m_msgQueue.Push(lane, message)) {
+    // Counted in the lane stats. The sender is not blacklisted for a backlog
+    // of this node, which would also cut it off from a committee peer.
+    LOG_GENERAL(WARNING, "Input MsgQueue lane " << (unsigned int)lane
+                                                << " is full, dropping from "
+                                                << message->second.first);
     delete message;
   }
 }
+
+/*static*/ Zilliqa::MessageLane Zilliqa::GetMessageLane(const bytes& message) {
+  if (message.size() < MessageOffset::BODY) {
+    return BLOCK_LANE;
+  }
+
+  const unsigned char ins_byte = message.at(MessageOffset::INST);
+  switch (message.at(MessageOffset::TYPE)) {
+    case MessageType::DIRECTORY:
+      switch (ins_byte) {
+        case DSInstructionType::DSBLOCKCONSENSUS:
+        case DSInstructionType::FINALBLOCKCONSENSUS:
+        case DSInstructionType::VIEWCHANGECONSENSUS:
+          return CONSENSUS_LANE;
+        default:
+          return BLOCK_LANE;
+      }
+    case MessageType::NODE:
+      switch (ins_byte) {
+        case NodeInstructionType::MICROBLOCKCONSENSUS:
+          return CONSENSUS_LANE;
+        case NodeInstructionType::SUBMITTRANSACTION:
+        case NodeInstructionType::FORWARDTXNPACKET:
+        case NodeInstructionType::PENDINGTXN:
+          return TXN_LANE;
+        default:
+          return BLOCK_LANE;
+      }
+    case MessageType::LOOKUP:
+      switch (ins_byte) {
+        case LookupInstructionType::FORWARDTXN:
+        case LookupInstructionType::GETTXNFROMLOOKUP:
+        case LookupInstructionType::SETTXNFROMLOOKUP:
+        case LookupInstructionType::GETTXNSFROML2LDATAPROVIDER:
+          return TXN_LANE;
+        default:
+          return LOOKUP_LANE;
+      }
+    default:
+      return BLOCK_LANE;
+  }
+}
@@ -28,7 +28,7 @@
 #include "libServer/LookupServer.h"
 #include "libServer/StakingServer.h"
 #include "libServer/StatusServer.h"
-#include "libUtils/ThreadPool.h"
+#include "libUtils/LaneQueue.h"
 
 /// Main Zilliqa class.
 class Zilliqa {
@@ -39,8 +39,7 @@ class Zilliqa {
   Node m_n;
   // ConsensusUser m_cu; // Note: This is just a test class to demo Consensus
   // usage
-  boost::lockfree::queue<
-      std::pair<bytes, std::pair<Peer, const unsigned char>>*>
+  LaneQueue<std::pair<bytes, std::pair<Peer, const unsigned char>>*>
       m_msgQueue;
 
   std::shared_ptr<LookupServer> m_lookupServer;
@@ -50,12 +49,17 @@ class Zilliqa {
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_stakingServerConnector;
   std::unique_ptr<jsonrpc::AbstractServerConnector> m_statusServerConnector;
 
-  ThreadPool m_queuePool{MAXRECVMESSAGE, "QueuePool"};
-
   void ProcessMessage(
       std::pair<bytes, std::pair<Peer, const unsigned char>>* message);
 
  public:
+  /// Lanes of the incoming message queue, in the order they take turns
+  enum MessageLane : unsigned char {
+    CONSENSUS_LANE = 0,
+    BLOCK_LANE,
+    LOOKUP_LANE,
+    TXN_LANE
+  };
   /// Constructor.
   Zilliqa(const PairOfKey& key, const Peer& peer,
           SyncType syncType = SyncType::NO_SYNC, bool toRetrieveHistory = false,
@@ -73,6 +77,9 @@ class Zilliqa {
 
   static std::string FormatMessageName(unsigned char msgType,
                                        unsigned char instruction);
+
+  /// Picks the lane of a message by its type and instruction
+  static MessageLane GetMessageLane(const bytes& message);
 };
 
 #endif  // ZILLIQA_SRC_LIBZILLIQA_ZILLIQA_H_
@@ -59,7 +59,7 @@ BOOST_AUTO_TEST_CASE(testInit) {
   BOOST_CHECK_EQUAL(acc1.GetInitJson(), Json::arrayValue);
   BOOST_CHECK_EQUAL(true, acc1.GetRawStorage(dev::h256(), true).empty());
   BOOST_CHECK_EQUAL(acc1.GetStateJson(true), Json::arrayValue);
-  BOOST_CHECK_EQUAL(0, acc1.GetCode().size());
+  BOOST_CHECK_EQUAL(0, acc1.GetCode()->size());
 
   // Not contract
   vector<StateEntry> entries;
@@ -85,7 +85,7 @@ BOOST_AUTO_TEST_CASE(testInit) {
   BOOST_CHECK_EQUAL(false,
                     acc1.InitContract(code, data, addr1, 0, scilla_version));
 
-  BOOST_CHECK_EQUAL(false, code == acc1.GetCode());
+  BOOST_CHECK_EQUAL(false, code == *acc1.GetCode());
   BOOST_CHECK_EQUAL(false, addr1 == acc1.GetAddress());
 
   std::string message =
@@ -96,7 +96,7 @@ BOOST_AUTO_TEST_CASE(testInit) {
   BOOST_CHECK_EQUAL(false,
                     acc1.InitContract(code, data, addr1, 0, scilla_version));
 
-  BOOST_CHECK_EQUAL(true, code == acc1.GetCode());
+  BOOST_CHECK_EQUAL(true, code == *acc1.GetCode());
   BOOST_CHECK_EQUAL(true, addr1 == acc1.GetAddress());
 
   acc1.GetStorageJson(roots, true);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#define BOOST_TEST_MODULE accountstoredeltatest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/AccountStore.h"
+#include "libMessage/Messenger.h"
+#include "libMessage/ZilliqaMessage.pb.h"
+#include "libPersistence/ContractStorage.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace boost::multiprecision;
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(accountstoredeltatest)
+
+const uint128_t INITIAL_BALANCE = PRECISION_MIN_VALUE * 1000000;
+/// One account in CONTRACT_EVERY is a contract
+const unsigned int CONTRACT_EVERY = 10;
+
+/// State delta creating numAccounts accounts, some of them contracts with a
+/// state each. Half the contracts carry their states without a storage root,
+/// as merged deltas do, along with an entry to delete, so that they are
+/// applied.
+bytes GenerateStateDelta(unsigned int numAccounts) {
+  AccountStore::GetInstance().Init();
+
+  const bytes code(2048, 'c');
+  AccountStoreTemp accountStoreTemp(AccountStore::GetInstance());
+  for (unsigned int i = 0; i < numAccounts; i++) {
+    const Address addr = Address::random();
+    Account account(INITIAL_BALANCE + i, i);
+    if (i % CONTRACT_EVERY == 0) {
+      BOOST_REQUIRE(account.SetImmutable(
+          code, DataConversion::StringToCharArray(to_string(i))));
+      const string key =
+          Contract::ContractStorage::GenerateStorageKey(addr, "counter", {});
+      BOOST_REQUIRE(account.UpdateStates(
+          addr, {{key, DataConversion::StringToCharArray(to_string(i))}}, {},
+          true));
+    }
+    accountStoreTemp.AddAccount(addr, account);
+  }
+
+  bytes stateDelta;
+  BOOST_REQUIRE(Messenger::SetAccountStoreDelta(
+      stateDelta, 0, accountStoreTemp, AccountStore::GetInstance()));
+
+  ZilliqaMessage::ProtoAccountStore protoDelta;
+  BOOST_REQUIRE(
+      protoDelta.ParseFromArray(stateDelta.data(), stateDelta.size()));
+  unsigned int numContracts = 0;
+  for (auto& entry : *protoDelta.mutable_entries()) {
+    auto* account = entry.mutable_account();
+    if (account->code().empty() || numContracts++ % 2 == 0) {
+      continue;
+    }
+    Address addr;
+    copy(entry.address().begin(), entry.address().end(),
+         addr.asArray().begin());
+    account->mutable_base()->clear_storageroot();
+    account->add_todelete(
+        Contract::ContractStorage::GenerateStorageKey(addr, "removed", {}));
+  }
+  stateDelta.resize(protoDelta.ByteSize());
+  BOOST_REQUIRE(
+      protoDelta.SerializeToArray(stateDelta.data(), stateDelta.size()));
+  return stateDelta;
+}
+
+/// Applies the delta to an empty store one entry at a time, as it was before
+/// the entries were decoded ahead. Returns the resulting state root.
+dev::h256 ApplyPerEntry(const bytes& stateDelta) {
+  AccountStore::GetInstance().Init();
+
+  ZilliqaMessage::ProtoAccountStore protoDelta;
+  BOOST_REQUIRE(
+      protoDelta.ParseFromArray(stateDelta.data(), stateDelta.size()));
+  for (const auto& entry : protoDelta.entries()) {
+    const auto& protoAccount = entry.account();
+    Address addr;
+    copy(entry.address().begin(), entry.address().end(),
+         addr.asArray().begin());
+
+    bytes protoBase(protoAccount.base().ByteSize());
+    BOOST_REQUIRE(protoAccount.base().SerializeToArray(protoBase.data(),
+                                                       protoBase.size()));
+    AccountBase base;
+    BOOST_REQUIRE(base.Deserialize(protoBase, 0));
+
+    const Account* oriAccount = AccountStore::GetInstance().GetAccount(addr);
+    Account account = oriAccount != nullptr ? *oriAccount : Account(0, 0);
+    const int256_t balance = base.GetBalance().convert_to<int256_t>();
+    BOOST_REQUIRE(
+        account.ChangeBalance(protoAccount.numbersign() ? balance : -balance));
+    BOOST_REQUIRE(account.IncreaseNonceBy(base.GetNonce()));
+
+    if (!protoAccount.code().empty() || account.isContract()) {
+      if (oriAccount == nullptr) {
+        BOOST_REQUIRE(account.SetImmutable(
+            DataConversion::StringToCharArray(protoAccount.code()),
+            DataConversion::StringToCharArray(protoAccount.initdata())));
+        BOOST_CHECK_EQUAL(account.GetCodeHash(), base.GetCodeHash());
+      }
+      if (base.GetStorageRoot() == dev::h256()) {
+        map<string, bytes> states;
+        for (const auto& state : protoAccount.storage2()) {
+          states.emplace(state.key(),
+                         DataConversion::StringToCharArray(state.data()));
+        }
+        const vector<string> toDelete(protoAccount.todelete().begin(),
+                                      protoAccount.todelete().end());
+        BOOST_REQUIRE(account.UpdateStates(addr, states, toDelete, false));
+      }
+    }
+    AccountStore::GetInstance().AddAccount(addr, account, true);
+  }
+
+  BOOST_REQUIRE(AccountStore::GetInstance().UpdateStateTrieAll());
+  return AccountStore::GetInstance().GetStateRootHash();
+}
+
+/// Applies the delta, decoded on numThreads threads, to an empty store.
+/// Returns the resulting state root.
+dev::h256 ApplyStateDelta(const bytes& stateDelta, unsigned int numThreads,
+                          double& decodeSec, double& applySec) {
+  using Clock = chrono::steady_clock;
+  AccountStore::GetInstance().Init();
+
+  auto start = Clock::now();
+  vector<AccountDelta> deltas;
+  BOOST_REQUIRE(
+      Messenger::DecodeAccountStoreDelta(stateDelta, 0, deltas, numThreads));
+  decodeSec = chrono::duration<double>(Clock::now() - start).count();
+
+  start = Clock::now();
+  BOOST_REQUIRE(Messenger::ApplyAccountStoreDelta(
+      deltas, AccountStore::GetInstance(), false, false));
+  applySec = chrono::duration<double>(Clock::now() - start).count();
+
+  BOOST_REQUIRE(AccountStore::GetInstance().UpdateStateTrieAll());
+  return AccountStore::GetInstance().GetStateRootHash();
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_decode) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes stateDelta = GenerateStateDelta(1000);
+
+  vector<AccountDelta> expected;
+  BOOST_REQUIRE(
+      Messenger::DecodeAccountStoreDelta(stateDelta, 0, expected, 1));
+  BOOST_REQUIRE_EQUAL(expected.size(), 1000);
+  BOOST_CHECK(any_of(expected.begin(), expected.end(),
+                     [](const AccountDelta& delta) {
+                       return !delta.m_states.empty() &&
+                              !delta.m_toDelete.empty();
+                     }));
+
+  for (unsigned int numThreads : {2, 3, 8}) {
+    vector<AccountDelta> deltas;
+    BOOST_REQUIRE(Messenger::DecodeAccountStoreDelta(stateDelta, 0, deltas,
+                                                     numThreads));
+    BOOST_REQUIRE_EQUAL(deltas.size(), expected.size());
+    for (unsigned int i = 0; i < deltas.size(); i++) {
+      BOOST_CHECK_EQUAL(deltas[i].m_address, expected[i].m_address);
+      BOOST_CHECK(deltas[i].m_balanceDelta == expected[i].m_balanceDelta);
+      BOOST_CHECK_EQUAL(deltas[i].m_base.GetNonce(),
+                        expected[i].m_base.GetNonce());
+      BOOST_CHECK(deltas[i].m_code == expected[i].m_code);
+      BOOST_CHECK(deltas[i].m_initData == expected[i].m_initData);
+      BOOST_CHECK_EQUAL(deltas[i].m_codeHash, expected[i].m_codeHash);
+      BOOST_CHECK(deltas[i].m_states == expected[i].m_states);
+      BOOST_CHECK(deltas[i].m_toDelete == expected[i].m_toDelete);
+    }
+  }
+
+  // A malformed delta fails before anything is applied
+  vector<AccountDelta> deltas;
+  BOOST_CHECK(!Messenger::DecodeAccountStoreDelta(
+      bytes(stateDelta.begin(), stateDelta.begin() + stateDelta.size() / 2),
+      0, deltas, 4));
+}
+
+BOOST_AUTO_TEST_CASE(test_same_state) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes stateDelta = GenerateStateDelta(500);
+
+  const dev::h256 expectedRoot = ApplyPerEntry(stateDelta);
+  BOOST_REQUIRE_NE(expectedRoot, dev::h256());
+
+  double decodeSec = 0;
+  double applySec = 0;
+  for (unsigned int numThreads : {1, 4}) {
+    BOOST_CHECK_EQUAL(
+        ApplyStateDelta(stateDelta, numThreads, decodeSec, applySec),
+        expectedRoot);
+  }
+
+  // As the account store applies it
+  AccountStore::GetInstance().Init();
+  BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDelta(stateDelta, 0));
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetStateRootHash(),
+                    expectedRoot);
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_benchmark) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_ACCOUNTS = 20000;
+  const unsigned int NUM_THREADS = 4;
+  const bytes stateDelta = GenerateStateDelta(NUM_ACCOUNTS);
+
+  double serialDecodeSec = 0;
+  double serialApplySec = 0;
+  const dev::h256 expectedRoot =
+      ApplyStateDelta(stateDelta, 1, serialDecodeSec, serialApplySec);
+
+  double parallelDecodeSec = 0;
+  double parallelApplySec = 0;
+  BOOST_CHECK_EQUAL(ApplyStateDelta(stateDelta, NUM_THREADS,
+                                    parallelDecodeSec, parallelApplySec),
+                    expectedRoot);
+
+  LOG_GENERAL(INFO, "State delta of "
+                        << NUM_ACCOUNTS << " accounts: decode "
+                        << serialDecodeSec * 1000 << " ms on 1 thread, "
+                        << parallelDecodeSec * 1000 << " ms on "
+                        << NUM_THREADS << " threads, then "
+                        << parallelApplySec * 1000 << " ms applied");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
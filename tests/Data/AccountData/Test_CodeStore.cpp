@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE codestoretest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/CodeStore.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+#include "libUtils/MemoryStats.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(codestoretest)
+
+const unsigned int NUM_CONTRACTS = 10000;
+const unsigned int CODE_SIZE = 4096;
+
+bytes GenerateInitData(unsigned int i) {
+  return DataConversion::StringToCharArray(
+      R"([{"vname":"_scilla_version","type":"Uint32","value":"0"},)"
+      R"({"vname":"owner","type":"ByStr20","value":")" +
+      to_string(i) + R"("}])");
+}
+
+BOOST_AUTO_TEST_CASE(test_add) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes code(CODE_SIZE, 'a');
+  size_t numEntries = 0;
+  uint64_t numBytes = 0;
+  {
+    const CodeBytes first = CodeStore::GetInstance().Add(code);
+    const CodeBytes second = CodeStore::GetInstance().Add(code);
+    const CodeBytes other = CodeStore::GetInstance().Add(bytes(10, 'b'));
+    BOOST_CHECK(first == second);
+    BOOST_CHECK(first != other);
+    BOOST_CHECK(*first == code);
+    BOOST_CHECK(CodeStore::GetInstance().Add({}) == CodeStore::Empty());
+    BOOST_CHECK(CodeStore::Empty()->empty());
+
+    CodeStore::GetInstance().GetStats(numEntries, numBytes);
+    BOOST_CHECK_EQUAL(numEntries, 2);
+    BOOST_CHECK_EQUAL(numBytes, CODE_SIZE + 10);
+  }
+
+  // Dropped with the last handle
+  CodeStore::GetInstance().GetStats(numEntries, numBytes);
+  BOOST_CHECK_EQUAL(numEntries, 0);
+  BOOST_CHECK_EQUAL(numBytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_account_copy) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes code(CODE_SIZE, 'c');
+  Account account(0, 0);
+  BOOST_REQUIRE(account.SetImmutable(code, GenerateInitData(0)));
+  BOOST_CHECK(*account.GetCode() == code);
+  BOOST_CHECK(*account.GetInitData() == GenerateInitData(0));
+
+  // The copies share the code of the account
+  const Account copy = account;
+  BOOST_CHECK(copy.GetCode() == account.GetCode());
+  BOOST_CHECK(copy.GetInitData() == account.GetInitData());
+
+  // As does another contract with the same code
+  Account other(0, 0);
+  BOOST_REQUIRE(other.SetImmutable(code, GenerateInitData(1)));
+  BOOST_CHECK(other.GetCode() == account.GetCode());
+  BOOST_CHECK(other.GetInitData() != account.GetInitData());
+  BOOST_CHECK(other.GetCodeHash() != account.GetCodeHash());
+
+  // Not a contract
+  BOOST_CHECK(Account(0, 0).GetCode()->empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_memory) {
+  INIT_STDOUT_LOGGER();
+
+  // Contracts deployed from the same code, each held along with a copy as
+  // in the temporary account store
+  const bytes code(CODE_SIZE, 'd');
+  int64_t sharedMB = 0;
+  {
+    const int64_t startMB = DisplayPhysicalMemoryStats("Before shared");
+    vector<Account> accounts(NUM_CONTRACTS);
+    for (unsigned int i = 0; i < NUM_CONTRACTS; i++) {
+      BOOST_REQUIRE(accounts[i].SetImmutable(code, GenerateInitData(i)));
+    }
+    const vector<Account> copies = accounts;
+    sharedMB = DisplayPhysicalMemoryStats("Shared code", startMB) - startMB;
+
+    size_t numEntries = 0;
+    uint64_t numBytes = 0;
+    CodeStore::GetInstance().GetStats(numEntries, numBytes);
+    BOOST_CHECK_EQUAL(numEntries, NUM_CONTRACTS + 1);
+  }
+
+  // As the accounts held their own code and init data before
+  struct OwnedContract {
+    bytes m_code;
+    bytes m_initData;
+  };
+  int64_t ownedMB = 0;
+  {
+    const int64_t startMB = DisplayPhysicalMemoryStats("Before owned");
+    vector<OwnedContract> contracts(NUM_CONTRACTS);
+    for (unsigned int i = 0; i < NUM_CONTRACTS; i++) {
+      contracts[i] = {code, GenerateInitData(i)};
+    }
+    const vector<OwnedContract> copies = contracts;
+    ownedMB = DisplayPhysicalMemoryStats("Owned code", startMB) - startMB;
+  }
+
+  BOOST_CHECK_LT(sharedMB, ownedMB);
+  LOG_GENERAL(INFO, "Resident size of " << NUM_CONTRACTS
+                                        << " contracts and their copies: "
+                                        << sharedMB << " MB shared, "
+                                        << ownedMB << " MB owned");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
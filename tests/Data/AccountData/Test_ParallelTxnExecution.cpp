@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <vector>
+
+#define BOOST_TEST_MODULE paralleltxnexecutiontest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/AccountStore.h"
+#include "libData/AccountData/Address.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(paralleltxnexecutiontest)
+
+const unsigned int NUM_SENDERS = 200;
+const unsigned int NUM_TXNS_PER_SENDER = 5;
+const unsigned int WAVE_SIZE = 100;
+
+vector<Transaction> GenerateTxns(const vector<PairOfKey>& senders,
+                                 const vector<Address>& senderAddrs) {
+  vector<Address> recipients;
+  for (unsigned int i = 0; i < 10; i++) {
+    recipients.emplace_back(
+        Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second));
+  }
+
+  vector<Transaction> txns;
+  for (unsigned int nonce = 1; nonce <= NUM_TXNS_PER_SENDER; nonce++) {
+    for (unsigned int i = 0; i < senders.size(); i++) {
+      // Mix of payments to a few shared recipients, to other senders and to
+      // accounts that do not exist yet
+      Address toAddr;
+      switch (i % 3) {
+        case 0:
+          toAddr = recipients[i % recipients.size()];
+          break;
+        case 1:
+          toAddr = senderAddrs[(i + 1) % senderAddrs.size()];
+          break;
+        default:
+          toAddr =
+              Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+          break;
+      }
+      // The last senders cannot afford all their txns
+      const uint128_t amount = (i + 10 >= senders.size()) ? 400 : 1 + i % 7;
+      txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1), nonce, toAddr,
+                        senders[i], amount, PRECISION_MIN_VALUE,
+                        NORMAL_TRAN_GAS);
+    }
+  }
+  return txns;
+}
+
+BOOST_AUTO_TEST_CASE(test_same_outcome_as_serial) {
+  INIT_STDOUT_LOGGER();
+
+  AccountStore::GetInstance().Init();
+
+  vector<PairOfKey> senders;
+  vector<Address> senderAddrs;
+  for (unsigned int i = 0; i < NUM_SENDERS; i++) {
+    senders.emplace_back(Schnorr::GenKeyPair());
+    senderAddrs.emplace_back(
+        Account::GetAddressFromPublicKey(senders.back().second));
+    const uint128_t balance =
+        (i + 10 >= NUM_SENDERS) ? 1000 : PRECISION_MIN_VALUE * 1000000;
+    AccountStore::GetInstance().AddAccount(senderAddrs.back(), {balance, 0});
+  }
+  AccountStore::GetInstance().UpdateStateTrieAll();
+
+  const vector<Transaction> txns = GenerateTxns(senders, senderAddrs);
+
+  AccountStore::GetInstance().InitTemp();
+  vector<TxnExecutionResult> serialResults(txns.size());
+  auto startTime = chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    serialResults[i].m_receipt.SetEpochNum(1);
+    serialResults[i].m_success = AccountStore::GetInstance().UpdateAccountsTemp(
+        1, 1, false, txns[i], serialResults[i].m_receipt,
+        serialResults[i].m_errorCode);
+  }
+  const double serialTimeMs = chrono::duration<double, milli>(
+                                  chrono::high_resolution_clock::now() -
+                                  startTime)
+                                  .count();
+  BOOST_CHECK(AccountStore::GetInstance().SerializeDelta());
+  bytes serialDelta;
+  AccountStore::GetInstance().GetSerializedDelta(serialDelta);
+
+  AccountStore::GetInstance().InitTemp();
+  vector<TxnExecutionResult> parallelResults(txns.size());
+  startTime = chrono::high_resolution_clock::now();
+  for (unsigned int begin = 0; begin < txns.size(); begin += WAVE_SIZE) {
+    vector<Transaction> wave(
+        txns.begin() + begin,
+        txns.begin() + min<size_t>(begin + WAVE_SIZE, txns.size()));
+    AccountStore::GetInstance().UpdateAccountsTempInParallel(
+        1, 1, false, wave,
+        [&parallelResults, begin](size_t index,
+                                  const TxnExecutionResult& result) -> bool {
+          parallelResults[begin + index] = result;
+          return true;
+        });
+  }
+  const double parallelTimeMs = chrono::duration<double, milli>(
+                                    chrono::high_resolution_clock::now() -
+                                    startTime)
+                                    .count();
+  BOOST_CHECK(AccountStore::GetInstance().SerializeDelta());
+  bytes parallelDelta;
+  AccountStore::GetInstance().GetSerializedDelta(parallelDelta);
+
+  LOG_GENERAL(INFO, "Executed " << txns.size() << " txns, serial: "
+                                << serialTimeMs << " ms, parallel: "
+                                << parallelTimeMs << " ms");
+
+  BOOST_CHECK(serialDelta == parallelDelta);
+  unsigned int numFailed = 0;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    BOOST_CHECK_EQUAL(serialResults[i].m_success, parallelResults[i].m_success);
+    BOOST_CHECK(serialResults[i].m_errorCode == parallelResults[i].m_errorCode);
+    BOOST_CHECK_EQUAL(serialResults[i].m_receipt.GetCumGas(),
+                      parallelResults[i].m_receipt.GetCumGas());
+    if (!serialResults[i].m_success) {
+      numFailed++;
+    }
+  }
+  // Failed txns have been exercised as well
+  BOOST_CHECK(numFailed > 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_stop_on_result) {
+  INIT_STDOUT_LOGGER();
+
+  AccountStore::GetInstance().Init();
+
+  PairOfKey sender = Schnorr::GenKeyPair();
+  Address senderAddr = Account::GetAddressFromPublicKey(sender.second);
+  AccountStore::GetInstance().AddAccount(senderAddr,
+                                         {PRECISION_MIN_VALUE * 1000000, 0});
+  AccountStore::GetInstance().UpdateStateTrieAll();
+  AccountStore::GetInstance().InitTemp();
+
+  Address toAddr =
+      Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second);
+  vector<Transaction> wave;
+  for (unsigned int nonce = 1; nonce <= 10; nonce++) {
+    wave.emplace_back(DataConversion::Pack(CHAIN_ID, 1), nonce, toAddr, sender,
+                      1, PRECISION_MIN_VALUE, NORMAL_TRAN_GAS);
+  }
+
+  // Txns after the one rejected by the callback must be left unapplied
+  unsigned int numResults = 0;
+  AccountStore::GetInstance().UpdateAccountsTempInParallel(
+      1, 1, false, wave,
+      [&numResults](size_t index, const TxnExecutionResult& result) -> bool {
+        BOOST_CHECK(result.m_success);
+        numResults++;
+        return index < 3;
+      });
+
+  BOOST_CHECK_EQUAL(numResults, 4);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetNonceTemp(senderAddr), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,219 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#define BOOST_TEST_MODULE pendingtxnqueuetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/PendingTxnQueue.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace boost::multiprecision;
+
+Transaction createTransaction(const PubKey& senderPubKey,
+                              const uint64_t& nonce,
+                              const uint128_t& gasPrice) {
+  return Transaction(1, nonce, Address().random(), senderPubKey, 1, gasPrice,
+                     1, {}, {}, TestUtils::GenerateRandomSignature());
+}
+
+BOOST_AUTO_TEST_SUITE(pendingtxnqueuetest)
+
+BOOST_AUTO_TEST_CASE(test_ready_order) {
+  INIT_STDOUT_LOGGER();
+
+  PubKey sender1 = TestUtils::GenerateRandomPubKey();
+  PubKey sender2 = TestUtils::GenerateRandomPubKey();
+  Address addr1 = Account::GetAddressFromPublicKey(sender1);
+  Address addr2 = Account::GetAddressFromPublicKey(sender2);
+
+  PendingTxnQueue queue(PendingTxnQueue::Order::BY_GAS_PRICE);
+  Transaction t;
+
+  // Nonces ahead of the current ones are not executable
+  queue.Insert(createTransaction(sender1, 2, 10), 0);
+  queue.Insert(createTransaction(sender1, 3, 30), 0);
+  queue.Insert(createTransaction(sender2, 2, 20), 0);
+  BOOST_CHECK(!queue.FindOne(t));
+
+  queue.UpdateNonce(addr1, 1);
+  queue.UpdateNonce(addr2, 1);
+  BOOST_CHECK_EQUAL(queue.NumReady(), 2);
+
+  // Highest gas price first
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetSenderAddr(), addr2);
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetSenderAddr(), addr1);
+  BOOST_CHECK_EQUAL(t.GetNonce(), 2);
+
+  // Next nonce only becomes executable once its predecessor is applied
+  BOOST_CHECK(!queue.FindOne(t));
+  queue.UpdateNonce(addr1, 2);
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetNonce(), 3);
+  BOOST_CHECK(queue.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_address_order) {
+  PubKey sender1 = TestUtils::GenerateRandomPubKey();
+  PubKey sender2 = TestUtils::GenerateRandomPubKey();
+  Address addr1 = Account::GetAddressFromPublicKey(sender1);
+  Address addr2 = Account::GetAddressFromPublicKey(sender2);
+  if (addr2 < addr1) {
+    swap(sender1, sender2);
+    swap(addr1, addr2);
+  }
+
+  PendingTxnQueue queue(PendingTxnQueue::Order::BY_ADDRESS);
+  Transaction t;
+
+  // Until the upgrade, the lowest address goes first whatever the gas price
+  queue.Insert(createTransaction(sender1, 2, 10), 1);
+  queue.Insert(createTransaction(sender1, 3, 10), 1);
+  queue.Insert(createTransaction(sender2, 2, 30), 1);
+
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetSenderAddr(), addr1);
+  queue.UpdateNonce(addr1, 2);
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetSenderAddr(), addr1);
+  BOOST_CHECK_EQUAL(t.GetNonce(), 3);
+  BOOST_CHECK(queue.FindOne(t));
+  BOOST_CHECK_EQUAL(t.GetSenderAddr(), addr2);
+  BOOST_CHECK(queue.Empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_same_nonce) {
+  PubKey sender = TestUtils::GenerateRandomPubKey();
+  Address addr = Account::GetAddressFromPublicKey(sender);
+
+  PendingTxnQueue queue(PendingTxnQueue::Order::BY_GAS_PRICE);
+  Transaction t;
+
+  Transaction lowGas = createTransaction(sender, 2, 10);
+  Transaction highGas = createTransaction(sender, 2, 20);
+
+  // The higher gas price is kept, including for the ready txn
+  queue.Insert(lowGas, 1);
+  queue.Insert(highGas, 1);
+  queue.Insert(lowGas, 1);
+  BOOST_CHECK(queue.Get(addr, 2, t));
+  BOOST_CHECK(t == highGas);
+  BOOST_CHECK_EQUAL(queue.NumReady(), 1);
+
+  queue.Erase(addr, 2);
+  BOOST_CHECK_EQUAL(queue.NumReady(), 0);
+  BOOST_CHECK(queue.Empty());
+  BOOST_CHECK(!queue.FindOne(t));
+}
+
+BOOST_AUTO_TEST_CASE(test_performance) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_SENDERS = 50000;
+  const unsigned int NUM_BASELINE_PICKS = 2000;
+
+  // Every sender holds nonces 2, 3 and 5, leaving 1 and 4 missing
+  vector<Address> senders;
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < NUM_SENDERS; i++) {
+    PubKey sender = TestUtils::GenerateRandomPubKey();
+    senders.emplace_back(Account::GetAddressFromPublicKey(sender));
+    for (const uint64_t nonce : {2, 3, 5}) {
+      txns.emplace_back(
+          createTransaction(sender, nonce, TestUtils::DistUint64() % 1000));
+    }
+  }
+
+  // Queue, in the order of the scan
+  PendingTxnQueue queue(PendingTxnQueue::Order::BY_ADDRESS);
+  vector<TxnHash> queuePicks;
+  unordered_map<Address, uint128_t> nonces;
+  for (const auto& txn : txns) {
+    queue.Insert(txn, 0);
+  }
+
+  auto startTime = chrono::high_resolution_clock::now();
+  for (const auto& sender : senders) {
+    nonces[sender] = 1;
+    queue.UpdateNonce(sender, 1);
+  }
+  unsigned int numPicked = 0;
+  Transaction t;
+  while (queue.FindOne(t)) {
+    if (queuePicks.size() < NUM_BASELINE_PICKS) {
+      queuePicks.emplace_back(t.GetTranID());
+    }
+    const Address sender = t.GetSenderAddr();
+    nonces[sender] = t.GetNonce();
+    queue.UpdateNonce(sender, nonces[sender]);
+    numPicked++;
+  }
+  const double queueTimeMs = chrono::duration<double, milli>(
+                                 chrono::high_resolution_clock::now() -
+                                 startTime)
+                                 .count();
+  BOOST_CHECK_EQUAL(numPicked, NUM_SENDERS * 2);
+  BOOST_CHECK_EQUAL(queue.GetTxns().size(), NUM_SENDERS);
+
+  // Linear scan over every sender as done before, for a limited number of
+  // picks as it is quadratic. It picks the same txns as the queue.
+  map<Address, map<uint64_t, Transaction>> addrNonceTxnMap;
+  for (const auto& txn : txns) {
+    addrNonceTxnMap[txn.GetSenderAddr()].emplace(txn.GetNonce(), txn);
+  }
+  for (const auto& sender : senders) {
+    nonces[sender] = 1;
+  }
+
+  startTime = chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < NUM_BASELINE_PICKS; i++) {
+    for (auto it = addrNonceTxnMap.begin(); it != addrNonceTxnMap.end();
+         it++) {
+      if (it->second.begin()->first == nonces[it->first] + 1) {
+        t = move(it->second.begin()->second);
+        it->second.erase(it->second.begin());
+        if (it->second.empty()) {
+          addrNonceTxnMap.erase(it);
+        }
+        nonces[t.GetSenderAddr()] = t.GetNonce();
+        BOOST_CHECK_EQUAL(t.GetTranID(), queuePicks[i]);
+        break;
+      }
+    }
+  }
+  const double scanTimeMs = chrono::duration<double, milli>(
+                                chrono::high_resolution_clock::now() -
+                                startTime)
+                                .count();
+
+  LOG_GENERAL(INFO, "Senders: " << NUM_SENDERS);
+  LOG_GENERAL(INFO, "Ready queue: " << numPicked << " picks in " << queueTimeMs
+                                    << " ms");
+  LOG_GENERAL(INFO, "Linear scan: " << NUM_BASELINE_PICKS << " picks in "
+                                    << scanTimeMs << " ms");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
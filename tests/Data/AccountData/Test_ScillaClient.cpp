@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <future>
+
+#include "libData/AccountData/ScillaClient.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE scillaclienttest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+/// Reaches the bookkeeping of ScillaClient without launching an interpreter
+class ScillaClientTest {
+ public:
+  using Interpreter = ScillaClient::Interpreter;
+
+  static unique_lock<mutex> AcquireInterpreter(Interpreter& interpreter) {
+    return ScillaClient::GetInstance().AcquireInterpreter(interpreter);
+  }
+
+  static void OnCall(Interpreter& interpreter, const dev::h256& codeHash) {
+    ScillaClient::OnCall(interpreter, codeHash);
+  }
+
+  static bool RestartServer(Interpreter& interpreter, uint64_t numRestarts) {
+    return ScillaClient::GetInstance().RestartServer(0, interpreter,
+                                                     numRestarts);
+  }
+};
+
+using Interpreter = ScillaClientTest::Interpreter;
+
+BOOST_AUTO_TEST_SUITE(scillaclienttest)
+
+BOOST_AUTO_TEST_CASE(test_queue_depth) {
+  INIT_STDOUT_LOGGER();
+
+  auto& client = ScillaClient::GetInstance();
+  Interpreter interpreter;
+
+  // A call waits for the one the interpreter is serving
+  auto busy = ScillaClientTest::AcquireInterpreter(interpreter);
+  auto waiting = async(launch::async, [&interpreter]() {
+    ScillaClientTest::AcquireInterpreter(interpreter);
+  });
+  BOOST_CHECK(waiting.wait_for(chrono::milliseconds(100)) ==
+              future_status::timeout);
+  BOOST_CHECK(client.GetStats().find("queue depth: 1") != string::npos);
+
+  busy.unlock();
+  waiting.get();
+  BOOST_CHECK(client.GetStats().find("queue depth: 0") != string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_warm_calls) {
+  Interpreter interpreter;
+  const dev::h256 codeHash = dev::h256::random();
+
+  // The second call of a contract finds it parsed, a call without code hash
+  // is not tracked
+  ScillaClientTest::OnCall(interpreter, codeHash);
+  ScillaClientTest::OnCall(interpreter, codeHash);
+  ScillaClientTest::OnCall(interpreter, dev::h256());
+  BOOST_CHECK_EQUAL(interpreter.m_numCalls.load(), 3);
+  BOOST_CHECK_EQUAL(interpreter.m_numWarmCalls.load(), 1);
+
+  // The contracts parsed are gone with the restarted process
+  interpreter.m_numRestarts++;
+  ScillaClientTest::OnCall(interpreter, codeHash);
+  BOOST_CHECK_EQUAL(interpreter.m_numWarmCalls.load(), 1);
+  ScillaClientTest::OnCall(interpreter, codeHash);
+  BOOST_CHECK_EQUAL(interpreter.m_numWarmCalls.load(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_restart_once) {
+  Interpreter interpreter;
+
+  // A call cut by the restart done for its timeout fails without asking for
+  // another one
+  const uint64_t numRestarts = interpreter.m_numRestarts;
+  interpreter.m_numRestarts++;
+  BOOST_CHECK(ScillaClientTest::RestartServer(interpreter, numRestarts));
+  BOOST_CHECK_EQUAL(interpreter.m_numRestarts.load(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
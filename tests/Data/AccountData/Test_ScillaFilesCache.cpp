@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#define BOOST_TEST_MODULE scillafilescachetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "common/Constants.h"
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/ScillaFilesCache.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(scillafilescachetest)
+
+bytes GenerateInitData(const string& owner) {
+  return DataConversion::StringToCharArray(
+      R"([{"vname":"_scilla_version","type":"Uint32","value":"0"},)"
+      R"({"vname":"owner","type":"ByStr20","value":")" +
+      owner + R"("}])");
+}
+
+string ReadFile(const string& path) {
+  ifstream is(path);
+  stringstream ss;
+  ss << is.rdbuf();
+  return ss.str();
+}
+
+struct Stats {
+  uint64_t m_numHits{0};
+  uint64_t m_numMisses{0};
+  uint64_t m_numEvicted{0};
+  size_t m_numEntries{0};
+
+  Stats() {
+    ScillaFilesCache::GetInstance().GetStats(m_numHits, m_numMisses,
+                                             m_numEvicted, m_numEntries);
+  }
+};
+
+/// Exports the files of the contract, returning whether it was a hit
+bool Export(const Account& contract, string& codePath, string& initPath) {
+  const uint64_t numHits = Stats().m_numHits;
+  BOOST_REQUIRE(ScillaFilesCache::GetInstance().Export(
+      contract.GetCodeHash(), CONTRACT_FILE_EXTENSION, *contract.GetCode(),
+      *contract.GetInitData(), codePath, initPath));
+  BOOST_CHECK_EQUAL(ReadFile(codePath), DataConversion::CharArrayToString(
+                                            *contract.GetCode()));
+  BOOST_CHECK_EQUAL(ReadFile(initPath), DataConversion::CharArrayToString(
+                                            *contract.GetInitData()));
+  return Stats().m_numHits > numHits;
+}
+
+BOOST_AUTO_TEST_CASE(test_hit_and_miss) {
+  INIT_STDOUT_LOGGER();
+  ScillaFilesCache::GetInstance().Clear();
+
+  const bytes code = DataConversion::StringToCharArray("scilla_version 0");
+  Account contract(0, 0);
+  BOOST_REQUIRE(contract.SetImmutable(code, GenerateInitData("0x1")));
+
+  string codePath, initPath;
+  BOOST_CHECK(!Export(contract, codePath, initPath));
+  BOOST_CHECK(Export(contract, codePath, initPath));
+  BOOST_CHECK_EQUAL(Stats().m_numMisses, 1);
+
+  // The same code with other init data is not served the first init file
+  Account other(0, 0);
+  BOOST_REQUIRE(other.SetImmutable(code, GenerateInitData("0x2")));
+  string otherCodePath, otherInitPath;
+  BOOST_CHECK(!Export(other, otherCodePath, otherInitPath));
+  BOOST_CHECK_NE(otherInitPath, initPath);
+  BOOST_CHECK_EQUAL(ReadFile(initPath), DataConversion::CharArrayToString(
+                                            GenerateInitData("0x1")));
+
+  // Nor is other code with the same init data
+  Account changed(0, 0);
+  BOOST_REQUIRE(changed.SetImmutable(
+      DataConversion::StringToCharArray("scilla_version 1"),
+      GenerateInitData("0x1")));
+  string changedCodePath, changedInitPath;
+  BOOST_CHECK(!Export(changed, changedCodePath, changedInitPath));
+  BOOST_CHECK_NE(changedCodePath, codePath);
+  BOOST_CHECK_EQUAL(Stats().m_numEntries, 3);
+
+  // A file deleted behind the cache is written again
+  boost::filesystem::remove(initPath);
+  BOOST_CHECK(!Export(contract, codePath, initPath));
+}
+
+BOOST_AUTO_TEST_CASE(test_prune) {
+  INIT_STDOUT_LOGGER();
+  ScillaFilesCache::GetInstance().Clear();
+
+  const unsigned int NUM_CONTRACTS = 10;
+  const size_t CAPACITY = 4;
+  const bytes code = DataConversion::StringToCharArray("scilla_version 0");
+  vector<Account> contracts(NUM_CONTRACTS);
+  vector<string> codePaths(NUM_CONTRACTS), initPaths(NUM_CONTRACTS);
+  for (unsigned int i = 0; i < NUM_CONTRACTS; i++) {
+    BOOST_REQUIRE(
+        contracts[i].SetImmutable(code, GenerateInitData(to_string(i))));
+    Export(contracts[i], codePaths[i], initPaths[i]);
+  }
+
+  // The files used since the previous prune are kept past the capacity
+  ScillaFilesCache::GetInstance().Prune(CAPACITY);
+  BOOST_CHECK_EQUAL(Stats().m_numEntries, NUM_CONTRACTS);
+
+  // Then only the most recently used are
+  BOOST_CHECK(Export(contracts[0], codePaths[0], initPaths[0]));
+  ScillaFilesCache::GetInstance().Prune(CAPACITY);
+  const Stats stats;
+  BOOST_CHECK_EQUAL(stats.m_numEntries, CAPACITY);
+  BOOST_CHECK_EQUAL(stats.m_numEvicted, NUM_CONTRACTS - CAPACITY);
+  BOOST_CHECK(boost::filesystem::exists(initPaths[0]));
+  for (unsigned int i = 1; i < NUM_CONTRACTS; i++) {
+    BOOST_CHECK_EQUAL(boost::filesystem::exists(initPaths[i]),
+                      i >= NUM_CONTRACTS - CAPACITY + 1);
+    BOOST_CHECK_EQUAL(boost::filesystem::exists(codePaths[i]),
+                      i >= NUM_CONTRACTS - CAPACITY + 1);
+  }
+
+  // An evicted contract is exported again
+  BOOST_CHECK(!Export(contracts[1], codePaths[1], initPaths[1]));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -17,6 +17,7 @@
 
 #include <Schnorr.h>
 #include <array>
+#include <chrono>
 #include <string>
 #include <vector>
 #include "libCrypto/Sha2.h"
@@ -205,4 +206,58 @@ BOOST_AUTO_TEST_CASE(coveragembnforwardedtxnentry) {
   test << mf << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_batch_signature_verification) {
+  INIT_STDOUT_LOGGER();
+  LOG_MARKER();
+
+  // Signing dominates the setup, so a set of distinct txns is repeated
+  const unsigned int NUM_DISTINCT_TXNS = 1000;
+  vector<Transaction> distinctTxns;
+  for (unsigned int i = 0; i < NUM_DISTINCT_TXNS; i++) {
+    distinctTxns.emplace_back(
+        DataConversion::Pack(CHAIN_ID, 1), i + 1, Address().random(),
+        TestUtils::GenerateRandomKeyPair(), 1, PRECISION_MIN_VALUE,
+        NORMAL_TRAN_GAS);
+  }
+
+  for (const unsigned int numTxns : {1000, 10000, 100000}) {
+    vector<Transaction> txns;
+    for (unsigned int i = 0; i < numTxns; i++) {
+      txns.emplace_back(distinctTxns[i % NUM_DISTINCT_TXNS]);
+    }
+
+    auto startTime = chrono::high_resolution_clock::now();
+    bool allSigned = true;
+    for (const auto& txn : txns) {
+      allSigned = txn.IsSigned() && allSigned;
+    }
+    const double serialTimeMs = chrono::duration<double, milli>(
+                                    chrono::high_resolution_clock::now() -
+                                    startTime)
+                                    .count();
+    BOOST_CHECK(allSigned);
+
+    vector<size_t> invalidIndexes;
+    startTime = chrono::high_resolution_clock::now();
+    BOOST_CHECK(Transaction::VerifySignatures(txns, invalidIndexes));
+    const double batchTimeMs = chrono::duration<double, milli>(
+                                   chrono::high_resolution_clock::now() -
+                                   startTime)
+                                   .count();
+    BOOST_CHECK(invalidIndexes.empty());
+
+    LOG_GENERAL(INFO, numTxns << " signatures, per txn: "
+                              << numTxns * 1000 / serialTimeMs
+                              << " /s, batched: "
+                              << numTxns * 1000 / batchTimeMs << " /s");
+
+    // The bad signatures are pinpointed
+    const size_t badIndex = numTxns / 3;
+    txns[badIndex].SetSignature(txns[badIndex + 1].GetSignature());
+    txns.back().SetSignature(txns.front().GetSignature());
+    BOOST_CHECK(!Transaction::VerifySignatures(txns, invalidIndexes));
+    BOOST_CHECK(invalidIndexes == vector<size_t>({badIndex, numTxns - 1}));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
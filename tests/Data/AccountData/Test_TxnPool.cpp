@@ -209,4 +209,37 @@ BOOST_AUTO_TEST_CASE(txnpool_status) {
   BOOST_CHECK_EQUAL(status.second, txn.GetTranID());
 }
 
+BOOST_AUTO_TEST_CASE(txnpool_snapshot) {
+  TxnPool tp;
+
+  MempoolInsertionStatus status;
+  std::vector<Transaction> transaction_v;
+  generateUniqueTransactionVector(transaction_v, 10);
+  for (const auto& t : transaction_v) {
+    BOOST_CHECK_EQUAL(true, tp.insert(t, status));
+  }
+
+  // Draining the snapshot leaves the original untouched
+  TxnPool snapshot = tp;
+  Transaction tran;
+  while (snapshot.findOne(tran)) {
+    BOOST_CHECK_EQUAL(true, tp.exist(tran.GetTranID()));
+  }
+  BOOST_CHECK_EQUAL(0, snapshot.size());
+  BOOST_CHECK_EQUAL(transaction_v.size(), tp.size());
+
+  // Inserting into the original leaves the snapshot untouched
+  snapshot = tp;
+  Transaction newTxn = generateUniqueTransaction();
+  BOOST_CHECK_EQUAL(true, tp.insert(newTxn, status));
+  BOOST_CHECK_EQUAL(true, tp.exist(newTxn.GetTranID()));
+  BOOST_CHECK_EQUAL(false, snapshot.exist(newTxn.GetTranID()));
+  BOOST_CHECK_EQUAL(transaction_v.size(), snapshot.size());
+
+  for (const auto& t : transaction_v) {
+    BOOST_CHECK_EQUAL(true, snapshot.get(t.GetTranID(), tran));
+    BOOST_CHECK_EQUAL(true, tran == t);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,7 +16,10 @@
  */
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "libCrypto/Sha2.h"
@@ -156,7 +159,7 @@ void test_BlockChain(T1& blockChain, T2& block_0, T2& block_1, T2& block_last,
           to_string(block_0.GetHeader().GetBlockNum()) +
           " lover than in the last "
           " added header " +
-          to_string(blockChain.GetLastBlock().GetHeader().GetBlockNum() - 1) +
+          to_string(blockChain.GetLastBlock()->GetHeader().GetBlockNum() - 1) +
           ".\n");
   // Causes segfault since BlockStorage is empty
   uint64_t blocknum_overwritten = 0;
@@ -172,7 +175,7 @@ void test_BlockChain(T1& blockChain, T2& block_0, T2& block_1, T2& block_last,
                           to_string(blockChain.GetBlockCount()) +
                           " != " + to_string(1) + ".\n");
   BOOST_CHECK_MESSAGE(
-      blockChain.GetLastBlock() == block_last,
+      *blockChain.GetLastBlock() == block_last,
       "GetLastBlock returned block different from block added last.\n");
 }
 
@@ -233,4 +236,78 @@ BOOST_AUTO_TEST_CASE(TxBlockChain_test) {
   test_BlockChain(txbc, txb_0, txb_1, lastBlock, txb_empty);
 }
 
+BOOST_AUTO_TEST_CASE(BlockChain_shared_blocks_test) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  const uint64_t NUM_BLOCKS = 10;
+  const unsigned int NUM_MICROBLOCKS = 500;
+  TxBlockChain txbc;
+  vector<TxBlock> blocks;
+  for (uint64_t i = 0; i < NUM_BLOCKS; i++) {
+    blocks.emplace_back(TestUtils::createTxBlockHeader(i),
+                        vector<MicroBlockInfo>(NUM_MICROBLOCKS),
+                        CoSignatures());
+    BOOST_CHECK(txbc.AddBlock(blocks.back()) == 1);
+  }
+
+  // Readers share the stored block instead of getting a copy of it
+  const auto block = txbc.GetBlockPtr(1);
+  BOOST_CHECK(*block == blocks[1]);
+  BOOST_CHECK_MESSAGE(txbc.GetBlockPtr(1) == block,
+                      "GetBlockPtr returned a different handle on the same "
+                      "block.\n");
+  BOOST_CHECK(*txbc.GetBlockPtr(NUM_BLOCKS) == TxBlock());
+
+  // A handle stays valid once the chain moved past its block
+  TxBlock overwriting(TestUtils::createTxBlockHeader(BLOCKCHAIN_SIZE + 1),
+                      vector<MicroBlockInfo>(), CoSignatures());
+  BOOST_CHECK(txbc.AddBlock(overwriting) == 1);
+  BOOST_CHECK(*txbc.GetBlockPtr(BLOCKCHAIN_SIZE + 1) == overwriting);
+  BOOST_CHECK(*block == blocks[1]);
+
+  TxBlockChain readChain;
+  for (const auto& b : blocks) {
+    readChain.AddBlock(b);
+  }
+
+  // Concurrent readers, getting each block as a copy then as a handle
+  const unsigned int NUM_THREADS = 4;
+  const unsigned int NUM_READS = 20000;
+  atomic<unsigned int> numMismatches{0};
+  auto run = [&](bool copy) {
+    const auto start = chrono::steady_clock::now();
+    vector<thread> readers;
+    for (unsigned int t = 0; t < NUM_THREADS; t++) {
+      readers.emplace_back([&, t]() {
+        for (unsigned int i = 0; i < NUM_READS; i++) {
+          const uint64_t blockNum = (i + t) % NUM_BLOCKS;
+          const size_t numInfos =
+              copy ? readChain.GetBlock(blockNum).GetMicroBlockInfos().size()
+                   : readChain.GetBlockPtr(blockNum)
+                         ->GetMicroBlockInfos()
+                         .size();
+          if (numInfos != NUM_MICROBLOCKS) {
+            numMismatches++;
+          }
+        }
+      });
+    }
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    return chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                           start)
+        .count();
+  };
+
+  const double copyMs = run(true);
+  const double sharedMs = run(false);
+  BOOST_CHECK_EQUAL(numMismatches, 0);
+  LOG_GENERAL(INFO, NUM_THREADS << " readers x " << NUM_READS
+                                << " blocks: copies " << copyMs
+                                << " ms, shared " << sharedMs << " ms");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
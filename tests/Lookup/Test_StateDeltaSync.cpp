@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libLookup/StateDeltaSync.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE statedeltasync
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+/// Answers the requests from its own threads, as the upstream nodes do
+class Upstream {
+ public:
+  /// Delay of the answers to the requests for the chunks, by their number
+  using DelayFunc = function<chrono::milliseconds(uint64_t, unsigned int)>;
+
+  explicit Upstream(DelayFunc delay) : m_delay(move(delay)) {}
+
+  ~Upstream() {
+    for (auto& t : m_threads) {
+      t.join();
+    }
+  }
+
+  void SetSync(StateDeltaSync* sync) { m_sync = sync; }
+
+  void Request(uint64_t lowBlockNum, uint64_t highBlockNum) {
+    lock_guard<mutex> g(m_mutex);
+    const unsigned int attempt = ++m_numRequests[lowBlockNum];
+    const auto delay = m_delay(lowBlockNum, attempt);
+    if (delay.count() < 0) {
+      // Lost
+      return;
+    }
+    m_threads.emplace_back([this, lowBlockNum, highBlockNum, delay]() {
+      this_thread::sleep_for(delay);
+      vector<bytes> stateDeltas;
+      for (uint64_t i = lowBlockNum; i <= highBlockNum; i++) {
+        stateDeltas.emplace_back(bytes{(unsigned char)i});
+      }
+      m_sync->AddChunk(lowBlockNum, highBlockNum, move(stateDeltas));
+    });
+  }
+
+  StateDeltaSync::RequestFunc GetRequestFunc() {
+    return [this](uint64_t lowBlockNum, uint64_t highBlockNum) {
+      Request(lowBlockNum, highBlockNum);
+    };
+  }
+
+  unsigned int GetNumRequests(uint64_t lowBlockNum) {
+    lock_guard<mutex> g(m_mutex);
+    return m_numRequests[lowBlockNum];
+  }
+
+ private:
+  DelayFunc m_delay;
+  StateDeltaSync* m_sync{nullptr};
+  mutex m_mutex;
+  map<uint64_t, unsigned int> m_numRequests;
+  vector<thread> m_threads;
+};
+
+/// Runs a sync, applying each chunk for applyPerBlock per block. Returns the
+/// blocks in the order they were applied.
+vector<uint64_t> RunSync(StateDeltaSync& sync, Upstream& upstream,
+                         chrono::microseconds applyPerBlock = {}) {
+  upstream.SetSync(&sync);
+  vector<uint64_t> applied;
+  uint64_t lowBlockNum = 0;
+  vector<bytes> stateDeltas;
+  while (sync.GetNextChunk(lowBlockNum, stateDeltas)) {
+    for (uint64_t i = 0; i < stateDeltas.size(); i++) {
+      BOOST_CHECK_EQUAL(stateDeltas[i][0], (unsigned char)(lowBlockNum + i));
+      applied.emplace_back(lowBlockNum + i);
+    }
+    this_thread::sleep_for(applyPerBlock * stateDeltas.size());
+  }
+  return applied;
+}
+
+BOOST_AUTO_TEST_SUITE(statedeltasync)
+
+BOOST_AUTO_TEST_CASE(test_in_order) {
+  INIT_STDOUT_LOGGER();
+
+  // Later chunks answered first
+  Upstream upstream([](uint64_t lowBlockNum, unsigned int) {
+    return chrono::milliseconds(50 - lowBlockNum);
+  });
+  StateDeltaSync sync(
+      5, 41, 10, 4, chrono::milliseconds(1000), 3, upstream.GetRequestFunc());
+  const auto applied = RunSync(sync, upstream);
+
+  BOOST_REQUIRE_EQUAL(applied.size(), 37);
+  for (uint64_t i = 0; i < applied.size(); i++) {
+    BOOST_CHECK_EQUAL(applied[i], 5 + i);
+  }
+  BOOST_CHECK(sync.IsComplete());
+  const auto stats = sync.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_numBlocks, 37);
+  BOOST_CHECK_EQUAL(stats.m_numChunks, 4);
+  BOOST_CHECK_EQUAL(stats.m_numRetries, 0);
+
+  // Nothing left awaited
+  BOOST_CHECK(!sync.AddChunk(5, 14, vector<bytes>(10)));
+}
+
+BOOST_AUTO_TEST_CASE(test_chunk_retry) {
+  INIT_STDOUT_LOGGER();
+
+  // The first answer for blocks 20-29 is lost
+  Upstream upstream([](uint64_t lowBlockNum, unsigned int attempt) {
+    return lowBlockNum == 20 && attempt == 1 ? chrono::milliseconds(-1)
+                                             : chrono::milliseconds(5);
+  });
+  StateDeltaSync sync(
+      0, 59, 10, 3, chrono::milliseconds(100), 3, upstream.GetRequestFunc());
+  const auto applied = RunSync(sync, upstream);
+
+  BOOST_CHECK_EQUAL(applied.size(), 60);
+  BOOST_CHECK(sync.IsComplete());
+  BOOST_CHECK_EQUAL(sync.GetStats().m_numRetries, 1);
+  // Only the lost chunk is requested again
+  BOOST_CHECK_EQUAL(upstream.GetNumRequests(20), 2);
+  for (uint64_t low : {0, 10, 30, 40, 50}) {
+    BOOST_CHECK_EQUAL(upstream.GetNumRequests(low), 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_chunk_failed) {
+  INIT_STDOUT_LOGGER();
+
+  Upstream upstream([](uint64_t lowBlockNum, unsigned int) {
+    return lowBlockNum == 10 ? chrono::milliseconds(-1)
+                             : chrono::milliseconds(5);
+  });
+  StateDeltaSync sync(
+      0, 29, 10, 2, chrono::milliseconds(50), 3, upstream.GetRequestFunc());
+  const auto applied = RunSync(sync, upstream);
+
+  BOOST_CHECK_EQUAL(applied.size(), 10);
+  BOOST_CHECK(!sync.IsComplete());
+  BOOST_CHECK_EQUAL(upstream.GetNumRequests(10), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_catch_up_rate) {
+  INIT_STDOUT_LOGGER();
+
+  // A seed behind by some hundreds of blocks, with one answer lost
+  const uint64_t NUM_BLOCKS = 300;
+  const auto TIMEOUT = chrono::milliseconds(300);
+  const auto APPLY_PER_BLOCK = chrono::microseconds(1000);
+  auto delay = [](uint64_t numBlocks) {
+    // Round trip, then transfer
+    return chrono::milliseconds(20 + numBlocks);
+  };
+
+  auto run = [&](uint64_t chunkSize, unsigned int window) {
+    const uint64_t lostChunk = (NUM_BLOCKS / chunkSize / 2) * chunkSize;
+    Upstream upstream([&](uint64_t lowBlockNum, unsigned int attempt) {
+      return lowBlockNum == lostChunk && attempt == 1
+                 ? chrono::milliseconds(-1)
+                 : delay(chunkSize);
+    });
+    StateDeltaSync sync(0, NUM_BLOCKS - 1, chunkSize, window, TIMEOUT, 3,
+                        upstream.GetRequestFunc());
+    const auto applied = RunSync(sync, upstream, APPLY_PER_BLOCK);
+
+    // Every block applied once and in order, the lost chunk asked again. A
+    // slow answer may time out as well, so the retries are not counted
+    // exactly.
+    BOOST_REQUIRE_EQUAL(applied.size(), NUM_BLOCKS);
+    for (uint64_t i = 0; i < applied.size(); i++) {
+      BOOST_CHECK_EQUAL(applied[i], i);
+    }
+    BOOST_CHECK(sync.IsComplete());
+    const auto stats = sync.GetStats();
+    BOOST_CHECK_EQUAL(stats.m_numBlocks, NUM_BLOCKS);
+    BOOST_CHECK_GE(stats.m_numRetries, 1);
+    BOOST_CHECK_GE(upstream.GetNumRequests(lostChunk), 2);
+    return stats.m_numBlocks / stats.m_syncTimeSec;
+  };
+
+  // As before, the whole range in one request. The rates depend on the load
+  // of the machine, they are only logged.
+  const double wholeRate = run(NUM_BLOCKS, 1);
+  const double pipelinedRate = run(10, 8);
+
+  LOG_GENERAL(INFO, "Catch-up of " << NUM_BLOCKS << " blocks: " << pipelinedRate
+                                   << " blocks/s pipelined, " << wholeRate
+                                   << " blocks/s in one range");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
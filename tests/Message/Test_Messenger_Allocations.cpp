@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include "libMessage/Messenger.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE messengerallocations
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+const unsigned int NUM_DS_WINNERS = 100;
+const unsigned int NUM_ROUNDS = 100;
+
+atomic<uint64_t> g_numAllocations{0};
+
+void* operator new(size_t size) {
+  g_numAllocations++;
+  void* p = malloc(size);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+/// DS block electing NUM_DS_WINNERS new DS nodes
+DSBlock GenerateDSBlock() {
+  map<PubKey, Peer> powDSWinners;
+  vector<PubKey> removeDSNodePubkeys;
+  for (unsigned int i = 0; i < NUM_DS_WINNERS; i++) {
+    powDSWinners.emplace(TestUtils::GenerateRandomPubKey(),
+                         TestUtils::GenerateRandomPeer());
+    removeDSNodePubkeys.emplace_back(TestUtils::GenerateRandomPubKey());
+  }
+
+  DSBlockHeader header(5, 3, TestUtils::GenerateRandomPubKey(), 1000, 100000,
+                       PRECISION_MIN_VALUE, SWInfo(), powDSWinners,
+                       removeDSNodePubkeys, DSBlockHashSet(),
+                       GovDSShardVotesMap(), 1);
+  return DSBlock(header, TestUtils::GenerateRandomCoSignatures());
+}
+
+BOOST_AUTO_TEST_SUITE(messengerallocations)
+
+BOOST_AUTO_TEST_CASE(init) {
+  INIT_STDOUT_LOGGER();
+  TestUtils::Initialize();
+}
+
+BOOST_AUTO_TEST_CASE(test_dsblock_round_trip) {
+  const DSBlock dsBlock = GenerateDSBlock();
+
+  using Clock = chrono::steady_clock;
+  uint64_t numSetAllocations = 0;
+  uint64_t numGetAllocations = 0;
+  double setSec = 0;
+  double getSec = 0;
+  for (unsigned int i = 0; i < NUM_ROUNDS; i++) {
+    bytes dst;
+    g_numAllocations = 0;
+    auto start = Clock::now();
+    BOOST_REQUIRE(Messenger::SetDSBlock(dst, 0, dsBlock));
+    setSec += chrono::duration<double>(Clock::now() - start).count();
+    numSetAllocations += g_numAllocations;
+
+    DSBlock deserialized;
+    g_numAllocations = 0;
+    start = Clock::now();
+    BOOST_REQUIRE(Messenger::GetDSBlock(dst, 0, deserialized));
+    getSec += chrono::duration<double>(Clock::now() - start).count();
+    numGetAllocations += g_numAllocations;
+
+    BOOST_CHECK(deserialized == dsBlock);
+  }
+
+  LOG_GENERAL(INFO, "DS block with " << NUM_DS_WINNERS << " winners: "
+                                     << numSetAllocations / NUM_ROUNDS
+                                     << " allocations and "
+                                     << setSec * 1000000 / NUM_ROUNDS
+                                     << " us per SetDSBlock, "
+                                     << numGetAllocations / NUM_ROUNDS
+                                     << " allocations and "
+                                     << getSec * 1000000 / NUM_ROUNDS
+                                     << " us per GetDSBlock");
+}
+
+BOOST_AUTO_TEST_CASE(test_sharding_structure_round_trip) {
+  // 465 nodes in 30 shards
+  const DequeOfShard shards = TestUtils::GenerateDequeueOfShard(30);
+
+  bytes dst;
+  g_numAllocations = 0;
+  BOOST_REQUIRE(Messenger::ShardStructureToArray(dst, 0, 2, shards));
+  const uint64_t numSetAllocations = g_numAllocations;
+
+  uint32_t version = 0;
+  DequeOfShard deserialized;
+  g_numAllocations = 0;
+  BOOST_REQUIRE(
+      Messenger::ArrayToShardStructure(dst, 0, version, deserialized));
+  const uint64_t numGetAllocations = g_numAllocations;
+
+  BOOST_CHECK_EQUAL(version, 2);
+  BOOST_CHECK(deserialized == shards);
+  LOG_GENERAL(INFO, "Sharding structure of " << dst.size() << " bytes: "
+                                             << numSetAllocations
+                                             << " allocations to serialize, "
+                                             << numGetAllocations
+                                             << " to deserialize");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
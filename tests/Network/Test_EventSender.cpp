@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <event2/event.h>
+#include <event2/thread.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "libNetwork/EventSender.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE eventsender
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+const unsigned int HDR_LEN = 8;
+
+/// Loopback receiver counting the messages read from each connection
+class LoopbackServer {
+  int m_listenSock;
+  uint16_t m_port{0};
+  thread m_acceptThread;
+  mutex m_mutexReaders;
+  vector<int> m_socks;
+  vector<thread> m_readers;
+
+  void ReadConnection(int sock) {
+    unsigned char header[HDR_LEN];
+    while (true) {
+      while (m_paused) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+      }
+      if (!ReadAll(sock, header, HDR_LEN)) {
+        break;
+      }
+      const uint32_t length = ((uint32_t)header[4] << 24) +
+                              ((uint32_t)header[5] << 16) +
+                              ((uint32_t)header[6] << 8) + header[7];
+      vector<unsigned char> message(length);
+      if (!ReadAll(sock, message.data(), length)) {
+        break;
+      }
+      // The messages carry their sequence number
+      if (length >= 4) {
+        const uint32_t seq = ((uint32_t)message[0] << 24) +
+                             ((uint32_t)message[1] << 16) +
+                             ((uint32_t)message[2] << 8) + message[3];
+        if (seq != m_numMessages) {
+          m_outOfOrder = true;
+        }
+      }
+      m_numMessages++;
+    }
+  }
+
+  static bool ReadAll(int sock, unsigned char* buf, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+      const ssize_t n = read(sock, buf + done, length - done);
+      if (n <= 0) {
+        return false;
+      }
+      done += n;
+    }
+    return true;
+  }
+
+ public:
+  atomic<uint64_t> m_numConnections{0};
+  atomic<uint64_t> m_numMessages{0};
+  atomic<bool> m_outOfOrder{false};
+  atomic<bool> m_paused{false};
+
+  LoopbackServer() {
+    m_listenSock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(m_listenSock, (struct sockaddr*)&addr, sizeof(addr));
+    listen(m_listenSock, 1024);
+    socklen_t len = sizeof(addr);
+    getsockname(m_listenSock, (struct sockaddr*)&addr, &len);
+    m_port = ntohs(addr.sin_port);
+
+    m_acceptThread = thread([this]() {
+      while (true) {
+        const int sock = accept(m_listenSock, nullptr, nullptr);
+        if (sock < 0) {
+          return;
+        }
+        m_numConnections++;
+        lock_guard<mutex> g(m_mutexReaders);
+        m_socks.emplace_back(sock);
+        m_readers.emplace_back(&LoopbackServer::ReadConnection, this, sock);
+      }
+    });
+  }
+
+  ~LoopbackServer() {
+    m_paused = false;
+    shutdown(m_listenSock, SHUT_RDWR);
+    close(m_listenSock);
+    m_acceptThread.join();
+    for (int sock : m_socks) {
+      shutdown(sock, SHUT_RDWR);
+    }
+    for (auto& reader : m_readers) {
+      reader.join();
+    }
+    for (int sock : m_socks) {
+      close(sock);
+    }
+  }
+
+  Peer GetPeer() const { return Peer(htonl(INADDR_LOOPBACK), m_port); }
+
+  bool WaitForMessages(uint64_t num) {
+    for (unsigned int i = 0; i < 10000 && m_numMessages < num; i++) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return m_numMessages == num;
+  }
+};
+
+/// Runs the event base of the sender for the duration of a test
+struct EventBaseFixture {
+  struct event_base* m_base;
+  thread m_loop;
+  atomic<uint64_t> m_numErrors{0};
+  atomic<int> m_lastError{0};
+
+  EventBaseFixture() {
+    INIT_STDOUT_LOGGER();
+    evthread_use_pthreads();
+    m_base = event_base_new();
+    EventSender::GetInstance().Init(m_base, [this](const Peer&, int error) {
+      m_lastError = error;
+      m_numErrors++;
+    });
+    m_loop = thread(
+        [this]() { event_base_loop(m_base, EVLOOP_NO_EXIT_ON_EMPTY); });
+  }
+
+  ~EventBaseFixture() {
+    event_base_loopbreak(m_base);
+    m_loop.join();
+    EventSender::GetInstance().Reset();
+    event_base_free(m_base);
+  }
+};
+
+/// Message of the given length after its header, starting with its sequence
+/// number
+vector<unsigned char> MakeMessage(uint32_t seq, size_t length) {
+  vector<unsigned char> message(HDR_LEN + length, 0xAB);
+  message[3] = 0x11;
+  message[4] = (length >> 24) & 0xFF;
+  message[5] = (length >> 16) & 0xFF;
+  message[6] = (length >> 8) & 0xFF;
+  message[7] = length & 0xFF;
+  message[HDR_LEN] = (seq >> 24) & 0xFF;
+  message[HDR_LEN + 1] = (seq >> 16) & 0xFF;
+  message[HDR_LEN + 2] = (seq >> 8) & 0xFF;
+  message[HDR_LEN + 3] = seq & 0xFF;
+  return message;
+}
+
+bool Send(const Peer& peer, const vector<unsigned char>& message) {
+  return EventSender::GetInstance().Send(peer,
+                                         {{message.data(), message.size()}});
+}
+
+EventSender::PeerStats GetPeerStats(const Peer& peer) {
+  for (const auto& peerStats : EventSender::GetInstance().GetStats().m_peers) {
+    if (peerStats.m_peer == peer) {
+      return peerStats;
+    }
+  }
+  return {};
+}
+
+BOOST_FIXTURE_TEST_SUITE(eventsender, EventBaseFixture)
+
+BOOST_AUTO_TEST_CASE(test_messages_in_order) {
+  LoopbackServer server;
+
+  const unsigned int NUM_MESSAGES = 1000;
+  for (unsigned int i = 0; i < NUM_MESSAGES; i++) {
+    BOOST_CHECK(Send(server.GetPeer(), MakeMessage(i, 100)));
+  }
+
+  BOOST_CHECK(server.WaitForMessages(NUM_MESSAGES));
+  BOOST_CHECK(!server.m_outOfOrder);
+  BOOST_CHECK_EQUAL(server.m_numConnections, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_slow_peer_does_not_block) {
+  LoopbackServer slow;
+  LoopbackServer fast;
+  slow.m_paused = true;
+
+  // Far more than the socket buffers and the high watermark take
+  const unsigned int NUM_LARGE = 64;
+  const auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_LARGE; i++) {
+    BOOST_CHECK(Send(slow.GetPeer(), MakeMessage(i, 1024 * 1024)));
+  }
+  for (unsigned int i = 0; i < 100; i++) {
+    BOOST_CHECK(Send(fast.GetPeer(), MakeMessage(i, 100)));
+  }
+  BOOST_CHECK(fast.WaitForMessages(100));
+  const double elapsedMs = chrono::duration<double, milli>(
+                               chrono::steady_clock::now() - start)
+                               .count();
+
+  const auto slowStats = GetPeerStats(slow.GetPeer());
+  BOOST_CHECK_GT(slowStats.m_queueDepth, 0);
+  BOOST_CHECK_GE(slowStats.m_bytesInFlight,
+                 slowStats.m_queueDepth * 1024 * 1024);
+  LOG_GENERAL(INFO, "Fast peer served in " << elapsedMs << " ms, slow peer "
+                                           << slowStats.m_queueDepth
+                                           << " queued, "
+                                           << slowStats.m_bytesInFlight
+                                           << " bytes in flight");
+
+  // The queue of the slow peer drains once it reads again
+  slow.m_paused = false;
+  BOOST_CHECK(slow.WaitForMessages(NUM_LARGE));
+  BOOST_CHECK(!slow.m_outOfOrder);
+  BOOST_CHECK_EQUAL(GetPeerStats(slow.GetPeer()).m_queueDepth, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_unreachable_peer) {
+  // Nothing listens on the port once the server is gone
+  Peer peer;
+  {
+    LoopbackServer server;
+    peer = server.GetPeer();
+  }
+
+  BOOST_CHECK(Send(peer, MakeMessage(0, 100)));
+  for (unsigned int i = 0; i < 5000 && m_numErrors == 0; i++) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(m_numErrors, 1);
+  BOOST_CHECK_EQUAL(m_lastError, ECONNREFUSED);
+  BOOST_CHECK(EventSender::GetInstance().GetStats().m_peers.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_throughput) {
+  const unsigned int NUM_PEERS = 50;
+  const unsigned int NUM_MESSAGES = 200;
+  vector<unique_ptr<LoopbackServer>> servers;
+  for (unsigned int i = 0; i < NUM_PEERS; i++) {
+    servers.emplace_back(make_unique<LoopbackServer>());
+  }
+
+  const auto start = chrono::steady_clock::now();
+  for (unsigned int i = 0; i < NUM_MESSAGES; i++) {
+    const auto message = MakeMessage(i, 1024);
+    for (const auto& server : servers) {
+      BOOST_REQUIRE(Send(server->GetPeer(), message));
+    }
+  }
+  const double queuedSeconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  for (const auto& server : servers) {
+    BOOST_CHECK(server->WaitForMessages(NUM_MESSAGES));
+  }
+  const double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  LOG_GENERAL(INFO, NUM_PEERS << " peers: queued "
+                              << NUM_PEERS * NUM_MESSAGES / queuedSeconds
+                              << " messages/s, delivered "
+                              << NUM_PEERS * NUM_MESSAGES / seconds
+                              << " messages/s");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
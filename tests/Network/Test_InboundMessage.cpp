@@ -0,0 +1,290 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <event2/buffer.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/Constants.h"
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/WireCompression.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE inboundmessage
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+const unsigned int HDR_LEN = 8;
+const unsigned int HASH_LEN = 32;
+const size_t LARGE_MESSAGE_SIZE = 4 * 1024 * 1024;
+
+/// Allocations of at least LARGE_MESSAGE_SIZE bytes, i.e. of message bodies
+atomic<unsigned int> g_numLargeAllocations{0};
+
+void* operator new(size_t size) {
+  if (size >= LARGE_MESSAGE_SIZE) {
+    g_numLargeAllocations++;
+  }
+  void* p = malloc(size);
+  if (p == nullptr) {
+    throw bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+using Dispatched = pair<bytes, pair<Peer, const unsigned char>>;
+
+/// Gives the tests the processing of the messages read on a connection
+class P2PCommTest {
+ public:
+  static bool ProcessBufferedMessages(struct evbuffer* input,
+                                      const Peer& from) {
+    return P2PComm::ProcessBufferedMessages(input, from);
+  }
+};
+
+/// Adds the header of a message to the buffer
+void AddHeader(struct evbuffer* buf, unsigned char startByte, uint32_t length,
+               unsigned char version = MSG_VERSION & 0xFF,
+               uint16_t networkId = NETWORK_ID) {
+  const unsigned char header[HDR_LEN] = {
+      version,
+      (unsigned char)((networkId >> 8) & 0xFF),
+      (unsigned char)(networkId & 0xFF),
+      startByte,
+      (unsigned char)((length >> 24) & 0xFF),
+      (unsigned char)((length >> 16) & 0xFF),
+      (unsigned char)((length >> 8) & 0xFF),
+      (unsigned char)(length & 0xFF)};
+  evbuffer_add(buf, header, HDR_LEN);
+}
+
+/// Adds a message to the buffer, framed as SendMessageSocketCore does
+void AddMessage(struct evbuffer* buf, unsigned char startByte,
+                const bytes& hash, const bytes& body) {
+  AddHeader(buf, startByte, hash.size() + body.size());
+  evbuffer_add(buf, hash.data(), hash.size());
+  evbuffer_add(buf, body.data(), body.size());
+}
+
+BOOST_AUTO_TEST_SUITE(inboundmessage)
+
+BOOST_AUTO_TEST_CASE(test_read_messages) {
+  INIT_STDOUT_LOGGER();
+
+  struct evbuffer* buf = evbuffer_new();
+  const bytes hash(HASH_LEN, 0xAB);
+  AddMessage(buf, START_BYTE_NORMAL, {}, {1, 2, 3});
+  AddMessage(buf, START_BYTE_BROADCAST, hash, {4, 5});
+
+  P2PComm::InboundMessage message;
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK_EQUAL(message.m_startByte, START_BYTE_NORMAL);
+  BOOST_CHECK(message.m_hash.empty());
+  BOOST_CHECK(message.m_body == bytes({1, 2, 3}));
+
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK_EQUAL(message.m_startByte, START_BYTE_BROADCAST);
+  BOOST_CHECK(message.m_hash == hash);
+  BOOST_CHECK(message.m_body == bytes({4, 5}));
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), 0);
+
+  // Nothing is removed until the whole message is there
+  struct evbuffer* whole = evbuffer_new();
+  AddMessage(whole, START_BYTE_NORMAL, {}, bytes(100, 0x11));
+  evbuffer_remove_buffer(whole, buf, 60);
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message),
+                    P2PComm::READ_INCOMPLETE);
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), 60);
+  evbuffer_add_buffer(buf, whole);
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK(message.m_body == bytes(100, 0x11));
+
+  const unsigned char badHeader[HDR_LEN] = {0xFF, 0xFF, 0xFF, 0x11,
+                                            0,    0,    0,    1};
+  evbuffer_add(buf, badHeader, HDR_LEN);
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message),
+                    P2PComm::READ_INVALID);
+
+  evbuffer_free(whole);
+  evbuffer_free(buf);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_split) {
+  INIT_STDOUT_LOGGER();
+
+  struct evbuffer* whole = evbuffer_new();
+  AddMessage(whole, START_BYTE_NORMAL, {}, bytes(20, 0x22));
+  AddMessage(whole, START_BYTE_NORMAL, {}, {0x33});
+
+  // The header arrives in two parts, then the body and the next message
+  struct evbuffer* buf = evbuffer_new();
+  P2PComm::InboundMessage message;
+  for (const size_t part : {3u, HDR_LEN - 3, 10u}) {
+    evbuffer_remove_buffer(whole, buf, part);
+    BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message),
+                      P2PComm::READ_INCOMPLETE);
+  }
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), HDR_LEN + 10);
+  evbuffer_add_buffer(buf, whole);
+
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK(message.m_body == bytes(20, 0x22));
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK(message.m_body == bytes({0x33}));
+  BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message),
+                    P2PComm::READ_INCOMPLETE);
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), 0);
+
+  evbuffer_free(whole);
+  evbuffer_free(buf);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_invalid) {
+  INIT_STDOUT_LOGGER();
+
+  P2PComm::InboundMessage message;
+  auto read = [&message](unsigned char version, uint16_t networkId,
+                         uint32_t length) {
+    struct evbuffer* buf = evbuffer_new();
+    AddHeader(buf, START_BYTE_NORMAL, length, version, networkId);
+    const P2PComm::ReadResult result = P2PComm::ReadMessage(buf, message);
+    evbuffer_free(buf);
+    return result;
+  };
+  const unsigned char version = MSG_VERSION & 0xFF;
+
+  BOOST_CHECK_EQUAL(read(version + 1, NETWORK_ID, 1), P2PComm::READ_INVALID);
+  BOOST_CHECK_EQUAL(read(version, NETWORK_ID + 1, 1), P2PComm::READ_INVALID);
+
+  // A length over the limit is refused without waiting for the body
+  BOOST_CHECK_EQUAL(read(version, NETWORK_ID, MAX_READ_WATERMARK_IN_BYTES),
+                    P2PComm::READ_INCOMPLETE);
+  BOOST_CHECK_EQUAL(
+      read(version, NETWORK_ID, MAX_READ_WATERMARK_IN_BYTES + 1),
+      P2PComm::READ_INVALID);
+  BOOST_CHECK_EQUAL(read(version, NETWORK_ID, 0xFFFFFFFF),
+                    P2PComm::READ_INVALID);
+}
+
+BOOST_AUTO_TEST_CASE(test_process_buffered) {
+  INIT_STDOUT_LOGGER();
+
+  // Capability announcements, recorded for the listen port each one gives
+  const uint128_t ipAddress = 0x0100007F;
+  const vector<uint32_t> ports = {30303, 30304, 30305};
+  auto announce = [](struct evbuffer* buf, uint32_t port) {
+    AddMessage(buf, START_BYTE_CAPABILITIES, {},
+               WireCompression::MakeAnnouncement(true, port));
+  };
+  auto isCapable = [&ipAddress](uint32_t port) {
+    bool probe = false;
+    return WireCompression::IsCapable(Peer(ipAddress, port), probe);
+  };
+  WireCompression::ClearCapabilities();
+
+  // All the messages of a read are processed, the incomplete one is kept
+  struct evbuffer* buf = evbuffer_new();
+  for (const auto& port : ports) {
+    announce(buf, port);
+  }
+  AddHeader(buf, START_BYTE_CAPABILITIES, 6);
+  const Peer from(ipAddress, 51234);
+  BOOST_CHECK(P2PCommTest::ProcessBufferedMessages(buf, from));
+  for (const auto& port : ports) {
+    BOOST_CHECK(isCapable(port));
+  }
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), HDR_LEN);
+  evbuffer_drain(buf, HDR_LEN);
+
+  // The messages before an invalid header still are, then the connection
+  // is closed
+  WireCompression::ClearCapabilities();
+  announce(buf, ports[0]);
+  AddHeader(buf, START_BYTE_CAPABILITIES, 6, MSG_VERSION + 1);
+  announce(buf, ports[1]);
+  BOOST_CHECK(!P2PCommTest::ProcessBufferedMessages(buf, from));
+  BOOST_CHECK(isCapable(ports[0]));
+  BOOST_CHECK(!isCapable(ports[1]));
+
+  evbuffer_drain(buf, evbuffer_get_length(buf));
+  announce(buf, ports[2]);
+  AddHeader(buf, START_BYTE_CAPABILITIES, MAX_READ_WATERMARK_IN_BYTES + 1);
+  BOOST_CHECK(!P2PCommTest::ProcessBufferedMessages(buf, from));
+  BOOST_CHECK(isCapable(ports[2]));
+
+  WireCompression::ClearCapabilities();
+  evbuffer_free(buf);
+}
+
+BOOST_AUTO_TEST_CASE(test_body_not_copied) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes body(LARGE_MESSAGE_SIZE, 0x5A);
+  const bytes hash(HASH_LEN, 0xAB);
+  struct evbuffer* buf = evbuffer_new();
+
+  for (const unsigned char startByte :
+       {START_BYTE_NORMAL, START_BYTE_BROADCAST}) {
+    AddMessage(buf, startByte,
+               startByte == START_BYTE_BROADCAST ? hash : bytes(), body);
+
+    // From the connection buffer to the handler, as ProcessMessage and the
+    // dispatcher hand it over
+    g_numLargeAllocations = 0;
+    P2PComm::InboundMessage message;
+    BOOST_CHECK_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+    const unsigned char* data = message.m_body.data();
+    Dispatched* dispatched = new Dispatched(
+        move(message.m_body), make_pair(Peer(), message.m_startByte));
+    const bytes& handled = dispatched->first;
+
+    BOOST_CHECK_EQUAL(g_numLargeAllocations, 1);
+    BOOST_CHECK(handled.data() == data);
+    BOOST_CHECK(handled == body);
+    delete dispatched;
+  }
+
+  // As before: the whole message copied out, then the body sliced off it
+  AddMessage(buf, START_BYTE_NORMAL, {}, body);
+  g_numLargeAllocations = 0;
+  const size_t len = evbuffer_get_length(buf);
+  bytes copied(len);
+  evbuffer_remove(buf, copied.data(), len);
+  Dispatched* dispatched =
+      new Dispatched(bytes(copied.begin() + HDR_LEN, copied.end()),
+                     make_pair(Peer(), START_BYTE_NORMAL));
+  const unsigned int numCopiedAllocations = g_numLargeAllocations;
+  BOOST_CHECK(dispatched->first == body);
+  delete dispatched;
+
+  LOG_GENERAL(INFO, "Allocations per " << LARGE_MESSAGE_SIZE
+                                       << " byte message: 1, was "
+                                       << numCopiedAllocations);
+  evbuffer_free(buf);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
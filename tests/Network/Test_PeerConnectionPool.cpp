@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "libNetwork/PeerConnectionPool.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE peerconnectionpool
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+const unsigned int HDR_LEN = 8;
+
+/// Loopback receiver counting the messages read from each connection
+class LoopbackServer {
+  int m_listenSock;
+  uint16_t m_port{0};
+  vector<thread> m_threads;
+
+  void ReadConnection(int sock) {
+    unsigned char header[HDR_LEN];
+    while (ReadAll(sock, header, HDR_LEN)) {
+      const uint32_t length = ((uint32_t)header[4] << 24) +
+                              ((uint32_t)header[5] << 16) +
+                              ((uint32_t)header[6] << 8) + header[7];
+      vector<unsigned char> message(length);
+      if (!ReadAll(sock, message.data(), length)) {
+        break;
+      }
+      m_numMessages++;
+      if (m_closeAfterEach) {
+        break;
+      }
+    }
+    close(sock);
+  }
+
+  static bool ReadAll(int sock, unsigned char* buf, size_t length) {
+    size_t done = 0;
+    while (done < length) {
+      const ssize_t n = read(sock, buf + done, length - done);
+      if (n <= 0) {
+        return false;
+      }
+      done += n;
+    }
+    return true;
+  }
+
+ public:
+  atomic<uint64_t> m_numConnections{0};
+  atomic<uint64_t> m_numMessages{0};
+  atomic<bool> m_closeAfterEach{false};
+
+  LoopbackServer() {
+    m_listenSock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(m_listenSock, (struct sockaddr*)&addr, sizeof(addr));
+    listen(m_listenSock, 1024);
+    socklen_t len = sizeof(addr);
+    getsockname(m_listenSock, (struct sockaddr*)&addr, &len);
+    m_port = ntohs(addr.sin_port);
+
+    m_threads.emplace_back([this]() {
+      while (true) {
+        const int sock = accept(m_listenSock, nullptr, nullptr);
+        if (sock < 0) {
+          return;
+        }
+        m_numConnections++;
+        thread(&LoopbackServer::ReadConnection, this, sock).detach();
+      }
+    });
+  }
+
+  ~LoopbackServer() {
+    shutdown(m_listenSock, SHUT_RDWR);
+    close(m_listenSock);
+    for (auto& t : m_threads) {
+      t.join();
+    }
+  }
+
+  Peer GetPeer() const { return Peer(htonl(INADDR_LOOPBACK), m_port); }
+
+  bool WaitForMessages(uint64_t num) {
+    for (unsigned int i = 0; i < 5000 && m_numMessages < num; i++) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    return m_numMessages == num;
+  }
+};
+
+vector<unsigned char> MakeMessage(size_t length) {
+  vector<unsigned char> message(HDR_LEN + length, 0xAB);
+  message[3] = 0x11;
+  message[4] = (length >> 24) & 0xFF;
+  message[5] = (length >> 16) & 0xFF;
+  message[6] = (length >> 8) & 0xFF;
+  message[7] = length & 0xFF;
+  return message;
+}
+
+/// Sends on a new connection as without the pool
+bool SendOnNewConnection(const Peer& peer,
+                         const vector<unsigned char>& message) {
+  const int sock = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+  addr.sin_port = htons(peer.m_listenPortHost);
+  bool ret = connect(sock, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+             write(sock, message.data(), message.size()) ==
+                 (ssize_t)message.size();
+  shutdown(sock, SHUT_RDWR);
+  close(sock);
+  return ret;
+}
+
+BOOST_AUTO_TEST_SUITE(peerconnectionpool)
+
+BOOST_AUTO_TEST_CASE(test_connection_reused) {
+  INIT_STDOUT_LOGGER();
+
+  LoopbackServer server;
+  const auto message = MakeMessage(100);
+  auto& pool = PeerConnectionPool::GetInstance();
+  const auto before = pool.GetStats();
+
+  int error = 0;
+  for (unsigned int i = 0; i < 10; i++) {
+    BOOST_CHECK_EQUAL(
+        pool.Send(server.GetPeer(), {{message.data(), message.size()}}, error),
+        PeerConnectionPool::SENT);
+  }
+
+  BOOST_CHECK(server.WaitForMessages(10));
+  BOOST_CHECK_EQUAL(server.m_numConnections, 1);
+  BOOST_CHECK_EQUAL(pool.GetStats().m_numConnects - before.m_numConnects, 1);
+  BOOST_CHECK_EQUAL(pool.GetStats().m_numReuses - before.m_numReuses, 9);
+
+  pool.Evict(server.GetPeer());
+}
+
+BOOST_AUTO_TEST_CASE(test_reconnect_after_peer_closes) {
+  INIT_STDOUT_LOGGER();
+
+  LoopbackServer server;
+  server.m_closeAfterEach = true;
+  const auto message = MakeMessage(100);
+  auto& pool = PeerConnectionPool::GetInstance();
+
+  int error = 0;
+  for (unsigned int i = 0; i < 5; i++) {
+    BOOST_CHECK_EQUAL(
+        pool.Send(server.GetPeer(), {{message.data(), message.size()}}, error),
+        PeerConnectionPool::SENT);
+    BOOST_CHECK(server.WaitForMessages(i + 1));
+    // Let the close reach this end
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  BOOST_CHECK_EQUAL(server.m_numConnections, 5);
+
+  pool.Evict(server.GetPeer());
+}
+
+BOOST_AUTO_TEST_CASE(test_backoff) {
+  INIT_STDOUT_LOGGER();
+
+  // Nothing listens on the port once the server is gone
+  Peer peer;
+  {
+    LoopbackServer server;
+    peer = server.GetPeer();
+  }
+  const auto message = MakeMessage(100);
+  auto& pool = PeerConnectionPool::GetInstance();
+
+  int error = 0;
+  BOOST_CHECK_EQUAL(pool.Send(peer, {{message.data(), message.size()}}, error),
+                    PeerConnectionPool::CONNECT_FAILED);
+  BOOST_CHECK_EQUAL(error, ECONNREFUSED);
+  BOOST_CHECK_EQUAL(pool.Send(peer, {{message.data(), message.size()}}, error),
+                    PeerConnectionPool::IN_BACKOFF);
+
+  // Evicting resets the backoff
+  pool.Evict(peer);
+  BOOST_CHECK_EQUAL(pool.Send(peer, {{message.data(), message.size()}}, error),
+                    PeerConnectionPool::CONNECT_FAILED);
+  pool.Evict(peer);
+}
+
+BOOST_AUTO_TEST_CASE(test_throughput) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_MESSAGES = 5000;
+  const auto message = MakeMessage(1024);
+
+  // Sends the messages one by one, logs the rate and the p99 send latency
+  auto run = [&message](const function<bool(const Peer&)>& send,
+                        const string& name) {
+    LoopbackServer server;
+    vector<double> latencies;
+    latencies.reserve(NUM_MESSAGES);
+
+    const auto start = chrono::steady_clock::now();
+    for (unsigned int i = 0; i < NUM_MESSAGES; i++) {
+      const auto sendStart = chrono::steady_clock::now();
+      BOOST_REQUIRE(send(server.GetPeer()));
+      latencies.emplace_back(chrono::duration<double, micro>(
+                                 chrono::steady_clock::now() - sendStart)
+                                 .count());
+    }
+    BOOST_CHECK(server.WaitForMessages(NUM_MESSAGES));
+    const double seconds =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    sort(latencies.begin(), latencies.end());
+    LOG_GENERAL(INFO, name << ": " << NUM_MESSAGES / seconds
+                           << " messages/s, p99 send "
+                           << latencies[latencies.size() * 99 / 100]
+                           << " us, connections " << server.m_numConnections);
+    PeerConnectionPool::GetInstance().Evict(server.GetPeer());
+  };
+
+  run(
+      [&message](const Peer& peer) {
+        int error = 0;
+        return PeerConnectionPool::GetInstance().Send(
+                   peer, {{message.data(), message.size()}}, error) ==
+               PeerConnectionPool::SENT;
+      },
+      "Pooled connection");
+  run([&message](
+          const Peer& peer) { return SendOnNewConnection(peer, message); },
+      "Connection per message");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
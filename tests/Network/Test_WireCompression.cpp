@@ -0,0 +1,402 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <arpa/inet.h>
+#include <event2/buffer.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "common/Constants.h"
+#include "common/Messages.h"
+#include "libData/AccountData/Account.h"
+#include "libData/AccountData/TransactionReceipt.h"
+#include "libCrypto/Sha2.h"
+#include "libData/BlockData/Block/MicroBlock.h"
+#include "libMessage/Messenger.h"
+#include "libNetwork/P2PComm.h"
+#include "libNetwork/WireCompression.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE wirecompression
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+const unsigned int HDR_LEN = 8;
+const unsigned int NUM_TXNS = 2000;
+
+/// Transactions between a few hundred accounts, as in a busy epoch
+vector<Transaction> GenerateTransactions() {
+  vector<PairOfKey> senders;
+  for (unsigned int i = 0; i < 20; i++) {
+    senders.emplace_back(Schnorr::GenKeyPair());
+  }
+  vector<Address> recipients;
+  for (unsigned int i = 0; i < 200; i++) {
+    recipients.emplace_back(
+        Account::GetAddressFromPublicKey(Schnorr::GenKeyPair().second));
+  }
+
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < NUM_TXNS; i++) {
+    txns.emplace_back(DataConversion::Pack(CHAIN_ID, 1),
+                      i / senders.size() + 1,
+                      recipients[(i * 7) % recipients.size()],
+                      senders[i % senders.size()], 1000000 + i % 100,
+                      PRECISION_MIN_VALUE, 50);
+  }
+  return txns;
+}
+
+using Dispatched = pair<bytes, pair<Peer, const unsigned char>>;
+
+/// Gives the tests the socket send used for every peer
+struct TestSendJob : public SendJob {
+  using SendJob::SendMessageSocketCore;
+};
+
+/// Gives the tests the processing of the messages read on a connection
+class P2PCommTest {
+ public:
+  static bool ProcessBufferedMessages(struct evbuffer* input,
+                                      const Peer& from) {
+    return P2PComm::ProcessBufferedMessages(input, from);
+  }
+};
+
+/// Accepts one connection on the loopback and reads it to its end
+class LoopbackReceiver {
+ public:
+  LoopbackReceiver() : m_buf(evbuffer_new()) {
+    m_sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    socklen_t addrLen = sizeof(addr);
+    BOOST_REQUIRE(bind(m_sock, (struct sockaddr*)&addr, addrLen) == 0);
+    BOOST_REQUIRE(listen(m_sock, 1) == 0);
+    BOOST_REQUIRE(getsockname(m_sock, (struct sockaddr*)&addr, &addrLen) == 0);
+    m_peer = Peer(addr.sin_addr.s_addr, ntohs(addr.sin_port));
+
+    m_thread = thread([this]() {
+      const int conn = accept(m_sock, nullptr, nullptr);
+      unsigned char chunk[65536];
+      ssize_t n;
+      while ((n = read(conn, chunk, sizeof(chunk))) > 0) {
+        evbuffer_add(m_buf, chunk, n);
+      }
+      close(conn);
+    });
+  }
+
+  ~LoopbackReceiver() {
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+    close(m_sock);
+    evbuffer_free(m_buf);
+  }
+
+  /// Everything written on the connection, once the sender closed it
+  struct evbuffer* Wait() {
+    m_thread.join();
+    return m_buf;
+  }
+
+  const Peer& GetPeer() const { return m_peer; }
+
+ private:
+  int m_sock;
+  Peer m_peer;
+  struct evbuffer* m_buf;
+  thread m_thread;
+};
+
+/// Microblock and transaction bodies, as sent after a final block
+bytes GenerateMBnForwardMessage(const vector<Transaction>& txns) {
+  vector<TransactionWithReceipt> txnsWithReceipt;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    TransactionReceipt receipt;
+    receipt.SetResult(true);
+    receipt.SetCumGas(50 * (i + 1));
+    receipt.SetEpochNum(1000);
+    receipt.update();
+    txnsWithReceipt.emplace_back(txns[i], receipt);
+  }
+
+  bytes message = {MessageType::NODE,
+                   NodeInstructionType::MBNFORWARDTRANSACTION};
+  BOOST_REQUIRE(Messenger::SetNodeMBnForwardTransaction(
+      message, MessageOffset::BODY, MicroBlock(), txnsWithReceipt));
+  return message;
+}
+
+/// Transaction packet forwarded by a lookup to a shard
+bytes GenerateTxnPacketMessage(const vector<Transaction>& txns) {
+  deque<pair<Transaction, uint32_t>> txnsCurrent;
+  deque<pair<Transaction, uint32_t>> txnsGenerated;
+  for (const auto& txn : txns) {
+    txnsCurrent.emplace_back(txn, 0);
+  }
+
+  bytes message = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
+  BOOST_REQUIRE(Messenger::SetNodeForwardTxnBlock(
+      message, MessageOffset::BODY, 1000, 10, 0, Schnorr::GenKeyPair(),
+      txnsCurrent, txnsGenerated));
+  return message;
+}
+
+BOOST_AUTO_TEST_SUITE(wirecompression)
+
+BOOST_AUTO_TEST_CASE(test_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  bytes message = {MessageType::NODE, NodeInstructionType::FINALBLOCK};
+  for (unsigned int i = 0; i < 100000; i++) {
+    message.push_back(i % 7);
+  }
+
+  bytes compressed;
+  BOOST_REQUIRE(WireCompression::CompressBody(message, 1, compressed));
+  BOOST_CHECK_LT(compressed.size(), message.size() / 10);
+  bytes decompressed;
+  BOOST_REQUIRE(WireCompression::Decompress(compressed, decompressed));
+  BOOST_CHECK(decompressed == message);
+
+  // Truncated, corrupted, or claiming a body larger than any read
+  bytes truncated(compressed.begin(), compressed.end() - 10);
+  BOOST_CHECK(!WireCompression::Decompress(truncated, decompressed));
+  bytes corrupted = compressed;
+  corrupted[10] ^= 0xFF;
+  BOOST_CHECK(!WireCompression::Decompress(corrupted, decompressed));
+  bytes oversized = compressed;
+  oversized[0] = 0xFF;
+  BOOST_CHECK(!WireCompression::Decompress(oversized, decompressed));
+  BOOST_CHECK(!WireCompression::Decompress({0, 0, 0}, decompressed));
+}
+
+BOOST_AUTO_TEST_CASE(test_message_list) {
+  INIT_STDOUT_LOGGER();
+
+  map<uint16_t, uint32_t> minSizes;
+  BOOST_REQUIRE(WireCompression::ParseMessageList(" 02.04, 04.1A:1024,", 65536,
+                                                  minSizes));
+  BOOST_CHECK_EQUAL(minSizes.size(), 2);
+  BOOST_CHECK_EQUAL(minSizes[0x0204], 65536);
+  BOOST_CHECK_EQUAL(minSizes[0x041A], 1024);
+
+  BOOST_CHECK(WireCompression::ParseMessageList("", 65536, minSizes));
+  for (const auto& invalid : {"02", "02.", "0204", "02.04:", "02.04:1k",
+                              "102.04", "02.100", "x.04"}) {
+    BOOST_CHECK(!WireCompression::ParseMessageList(invalid, 65536, minSizes));
+  }
+
+  // Every default entry is valid
+  minSizes.clear();
+  BOOST_REQUIRE(WireCompression::ParseMessageList(
+      WIRE_COMPRESSION_MESSAGES, WIRE_COMPRESSION_MIN_BYTES, minSizes));
+  const uint16_t finalBlock =
+      (MessageType::NODE << 8) + NodeInstructionType::FINALBLOCK;
+  BOOST_CHECK_EQUAL(minSizes.count(finalBlock), 1);
+
+  // Nothing but the normal and broadcast messages listed, when enabled
+  const bytes large(1000000, MessageType::NODE);
+  bytes compressed;
+  BOOST_CHECK(!WireCompression::Compress(large, START_BYTE_GOSSIP, compressed));
+  if (!ENABLE_WIRE_COMPRESSION) {
+    BOOST_CHECK(
+        !WireCompression::Compress(large, START_BYTE_NORMAL, compressed));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_read_compressed) {
+  INIT_STDOUT_LOGGER();
+
+  const bytes body(200000, 0x42);
+  bytes compressed;
+  BOOST_REQUIRE(WireCompression::CompressBody(body, 1, compressed));
+
+  const uint32_t length = compressed.size();
+  const unsigned char header[HDR_LEN] = {
+      (unsigned char)(MSG_VERSION & 0xFF),
+      (unsigned char)((NETWORK_ID >> 8) & 0xFF),
+      (unsigned char)(NETWORK_ID & 0xFF),
+      (unsigned char)(START_BYTE_NORMAL | START_BYTE_COMPRESSED),
+      (unsigned char)((length >> 24) & 0xFF),
+      (unsigned char)((length >> 16) & 0xFF),
+      (unsigned char)((length >> 8) & 0xFF),
+      (unsigned char)(length & 0xFF)};
+  struct evbuffer* buf = evbuffer_new();
+  evbuffer_add(buf, header, HDR_LEN);
+  evbuffer_add(buf, compressed.data(), compressed.size());
+
+  P2PComm::InboundMessage message;
+  BOOST_REQUIRE_EQUAL(P2PComm::ReadMessage(buf, message), P2PComm::READ_OK);
+  BOOST_CHECK_EQUAL(message.m_startByte, START_BYTE_NORMAL);
+  BOOST_CHECK(message.m_compressed);
+  BOOST_CHECK(message.m_body == compressed);
+  bytes decompressed;
+  BOOST_REQUIRE(WireCompression::Decompress(message.m_body, decompressed));
+  BOOST_CHECK(decompressed == body);
+  evbuffer_free(buf);
+}
+
+BOOST_AUTO_TEST_CASE(test_compressed_broadcast) {
+  INIT_STDOUT_LOGGER();
+
+  vector<Dispatched> dispatched;
+  P2PComm::GetInstance().StartMessagePump([&dispatched](Dispatched* message) {
+    dispatched.emplace_back(move(*message));
+    delete message;
+  });
+
+  bytes body = {MessageType::NODE, NodeInstructionType::FINALBLOCK};
+  body.resize(200000, 0x42);
+  SHA2<HashType::HASH_VARIANT_256> sha256;
+  sha256.Update(body);
+  const bytes hash = sha256.Finalize();
+  bytes compressed;
+  BOOST_REQUIRE(WireCompression::CompressBody(body, 1, compressed));
+
+  // Framed and sent as for any peer, the hash ahead of the compressed body
+  LoopbackReceiver receiver;
+  BOOST_REQUIRE(TestSendJob::SendMessageSocketCore(
+      receiver.GetPeer(), compressed,
+      START_BYTE_BROADCAST | START_BYTE_COMPRESSED, hash));
+  struct evbuffer* buf = receiver.Wait();
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf),
+                    HDR_LEN + hash.size() + compressed.size());
+
+  // Read back, checked against its hash once decompressed, then dispatched
+  BOOST_REQUIRE(
+      P2PCommTest::ProcessBufferedMessages(buf, receiver.GetPeer()));
+  BOOST_CHECK_EQUAL(evbuffer_get_length(buf), 0);
+  BOOST_REQUIRE_EQUAL(dispatched.size(), 1);
+  BOOST_CHECK(dispatched[0].first == body);
+  BOOST_CHECK_EQUAL(dispatched[0].second.second, START_BYTE_BROADCAST);
+}
+
+BOOST_AUTO_TEST_CASE(test_capabilities) {
+  INIT_STDOUT_LOGGER();
+
+  WireCompression::ClearCapabilities();
+  const Peer peer(inet_addr("127.0.0.1"), 30303);
+
+  // Asked once per interval, and not sent compressed bodies until answering
+  bool probe = false;
+  BOOST_CHECK(!WireCompression::IsCapable(peer, probe));
+  BOOST_CHECK(probe);
+  BOOST_CHECK(!WireCompression::IsCapable(peer, probe));
+  BOOST_CHECK(!probe);
+
+  const bytes announcement = WireCompression::MakeAnnouncement(true, 30303);
+  unsigned char capabilities = 0;
+  bool reply = false;
+  uint32_t listenPort = 0;
+  BOOST_REQUIRE(WireCompression::ParseAnnouncement(announcement, capabilities,
+                                                   reply, listenPort));
+  BOOST_CHECK_EQUAL(capabilities, CAPABILITY_COMPRESSION);
+  BOOST_CHECK(reply);
+  BOOST_CHECK_EQUAL(listenPort, 30303);
+  BOOST_CHECK(!WireCompression::ParseAnnouncement({CAPABILITY_COMPRESSION, 0},
+                                                  capabilities, reply,
+                                                  listenPort));
+  BOOST_CHECK(!WireCompression::ParseAnnouncement(
+      WireCompression::MakeAnnouncement(false, 0), capabilities, reply,
+      listenPort));
+
+  // A peer announcing no capability stays sent the bodies as they are
+  WireCompression::SetCapabilities(peer, 0);
+  BOOST_CHECK(!WireCompression::IsCapable(peer, probe));
+
+  // Received from an ephemeral port, recorded for the listen port announced
+  struct evbuffer* buf = evbuffer_new();
+  const uint32_t length = announcement.size();
+  const unsigned char header[HDR_LEN] = {
+      (unsigned char)(MSG_VERSION & 0xFF),
+      (unsigned char)((NETWORK_ID >> 8) & 0xFF),
+      (unsigned char)(NETWORK_ID & 0xFF),
+      START_BYTE_CAPABILITIES,
+      (unsigned char)((length >> 24) & 0xFF),
+      (unsigned char)((length >> 16) & 0xFF),
+      (unsigned char)((length >> 8) & 0xFF),
+      (unsigned char)(length & 0xFF)};
+  evbuffer_add(buf, header, HDR_LEN);
+  evbuffer_add(buf, announcement.data(), announcement.size());
+  BOOST_REQUIRE(P2PCommTest::ProcessBufferedMessages(
+      buf, Peer(peer.m_ipAddress, 51234)));
+  evbuffer_free(buf);
+
+  BOOST_CHECK(WireCompression::IsCapable(peer, probe));
+  BOOST_CHECK(!probe);
+  BOOST_CHECK(
+      !WireCompression::IsCapable(Peer(peer.m_ipAddress, 51234), probe));
+
+  WireCompression::ClearCapabilities();
+  BOOST_CHECK(!WireCompression::IsCapable(peer, probe));
+}
+
+BOOST_AUTO_TEST_CASE(test_block_messages) {
+  INIT_STDOUT_LOGGER();
+
+  const auto txns = GenerateTransactions();
+  const vector<pair<string, bytes>> messages = {
+      {"MBNFORWARDTRANSACTION", GenerateMBnForwardMessage(txns)},
+      {"FORWARDTXNPACKET", GenerateTxnPacketMessage(txns)}};
+
+  using Clock = chrono::steady_clock;
+  for (const auto& message : messages) {
+    const double size = message.second.size();
+    for (const int level : {1, 6, 9}) {
+      auto start = Clock::now();
+      bytes compressed;
+      BOOST_REQUIRE(
+          WireCompression::CompressBody(message.second, level, compressed));
+      const double compressSec =
+          chrono::duration<double>(Clock::now() - start).count();
+
+      start = Clock::now();
+      bytes decompressed;
+      BOOST_REQUIRE(WireCompression::Decompress(compressed, decompressed));
+      const double decompressSec =
+          chrono::duration<double>(Clock::now() - start).count();
+      BOOST_CHECK(decompressed == message.second);
+      BOOST_CHECK_LT(compressed.size(), size);
+
+      // Worth it if the bytes saved take longer to send than to compress
+      LOG_GENERAL(INFO, message.first
+                            << " of " << size << " bytes, level " << level
+                            << ": " << 100 * compressed.size() / size
+                            << "% of the size, "
+                            << (size - compressed.size()) / 1024
+                            << " KB saved, compressed at "
+                            << size / compressSec / 1000000
+                            << " MB/s, decompressed at "
+                            << size / decompressSec / 1000000 << " MB/s");
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <zlib.h>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libPersistence/PersistenceDownloader.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE persistencedownloader
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+const string TESTNET = "testnet";
+const uint64_t CHUNK_SIZE = 64 * 1024;
+
+/// Temporary directory removed at the end of the test case
+struct TempDir {
+  TempDir() : m_path(fs::temp_directory_path() / fs::unique_path()) {
+    fs::create_directories(m_path);
+  }
+  ~TempDir() { fs::remove_all(m_path); }
+  string Path(const string& rel = "") const {
+    return rel.empty() ? m_path.string() : (m_path / rel).string();
+  }
+  const fs::path m_path;
+};
+
+void WriteFile(const string& path, const string& content) {
+  fs::create_directories(fs::path(path).parent_path());
+  ofstream out(path, ios::binary | ios::trunc);
+  out << content;
+}
+
+string ReadFile(const string& path) {
+  ifstream in(path, ios::binary);
+  stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+string RandomContent(size_t size, unsigned int seed) {
+  mt19937 gen(seed);
+  string content(size, '\0');
+  for (auto& c : content) {
+    c = (char)(gen() & 0xff);
+  }
+  return content;
+}
+
+/// Writes a .tar.gz of (name, content) entries, names ending in '/' are
+/// directories
+void WriteTarGz(const string& path,
+                const vector<pair<string, string>>& entries) {
+  fs::create_directories(fs::path(path).parent_path());
+  gzFile gz = gzopen(path.c_str(), "wb");
+  BOOST_REQUIRE(gz != nullptr);
+  for (const auto& entry : entries) {
+    const bool isDir = entry.first.back() == '/';
+    char header[512] = {};
+    strncpy(header, entry.first.c_str(), 99);
+    snprintf(header + 100, 8, "%07o", isDir ? 0755 : 0644);
+    snprintf(header + 108, 8, "%07o", 0);
+    snprintf(header + 116, 8, "%07o", 0);
+    snprintf(header + 124, 12, "%011lo", (unsigned long)entry.second.size());
+    snprintf(header + 136, 12, "%011o", 0);
+    header[156] = isDir ? '5' : '0';
+    memcpy(header + 257, "ustar", 6);
+    memcpy(header + 263, "00", 2);
+    memset(header + 148, ' ', 8);
+    unsigned int checksum = 0;
+    for (unsigned char c : header) {
+      checksum += c;
+    }
+    snprintf(header + 148, 8, "%06o", checksum);
+    gzwrite(gz, header, sizeof(header));
+    gzwrite(gz, entry.second.data(), entry.second.size());
+    const string padding((512 - entry.second.size() % 512) % 512, '\0');
+    gzwrite(gz, padding.data(), padding.size());
+  }
+  const string end(1024, '\0');
+  gzwrite(gz, end.data(), end.size());
+  gzclose(gz);
+}
+
+/// Local mirror of the bucket, with the objects under folder/testnet
+struct Mirror {
+  void Add(const string& folder, const string& key, const string& content) {
+    WriteFile(m_dir.Path(folder + "/" + TESTNET + "/" + key), content);
+  }
+  string Url() const { return "file://" + m_dir.Path(); }
+  TempDir m_dir;
+};
+
+BOOST_AUTO_TEST_SUITE(persistencedownloader)
+
+BOOST_AUTO_TEST_CASE(test_etag) {
+  INIT_STDOUT_LOGGER();
+
+  TempDir dir;
+  WriteFile(dir.Path("empty"), "");
+  WriteFile(dir.Path("abc"), "abc");
+  WriteFile(dir.Path("abcd"), "abcd");
+  WriteFile(dir.Path("abcde"), "abcde");
+
+  BOOST_CHECK_EQUAL(PersistenceDownloader::ComputeETag(dir.Path("empty"), 2),
+                    "\"d41d8cd98f00b204e9800998ecf8427e\"");
+  // One part
+  BOOST_CHECK_EQUAL(PersistenceDownloader::ComputeETag(dir.Path("abc"), 8),
+                    "\"900150983cd24fb0d6963f7d28e17f72\"");
+  // Parts of "ab", "cd" and then "e"
+  BOOST_CHECK_EQUAL(PersistenceDownloader::ComputeETag(dir.Path("abcd"), 2),
+                    "\"e700b3f8d01367198b7ee8450c5bec97-2\"");
+  BOOST_CHECK_EQUAL(PersistenceDownloader::ComputeETag(dir.Path("abcde"), 2),
+                    "\"b5d55eef9b6106b14530433c1a359920-3\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_list_objects) {
+  INIT_STDOUT_LOGGER();
+
+  const string xml =
+      "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+      "<ListBucketResult xmlns=\"http://s3.amazonaws.com/doc/2006-03-01/\">"
+      "<Name>bucket</Name><Prefix>incremental/testnet</Prefix><Marker>"
+      "</Marker><MaxKeys>1000</MaxKeys><IsTruncated>true</IsTruncated>"
+      "<Contents><Key>incremental/testnet/persistence/state/000005.ldb</Key>"
+      "<LastModified>2019-10-01T00:00:00.000Z</LastModified>"
+      "<ETag>&quot;e700b3f8d01367198b7ee8450c5bec97-2&quot;</ETag>"
+      "<Size>9437184</Size><StorageClass>STANDARD</StorageClass></Contents>"
+      "<Contents><Key>incremental/testnet/persistence/state/CURRENT</Key>"
+      "<ETag>&quot;900150983cd24fb0d6963f7d28e17f72&quot;</ETag>"
+      "<Size>16</Size></Contents>"
+      "</ListBucketResult>";
+
+  vector<RemoteObject> objects;
+  bool isTruncated = false;
+  BOOST_REQUIRE(
+      PersistenceDownloader::ParseListObjects(xml, objects, isTruncated));
+  BOOST_CHECK(isTruncated);
+  BOOST_REQUIRE_EQUAL(objects.size(), 2);
+  BOOST_CHECK_EQUAL(objects[0].m_key,
+                    "incremental/testnet/persistence/state/000005.ldb");
+  BOOST_CHECK_EQUAL(objects[0].m_size, 9437184);
+  BOOST_CHECK_EQUAL(objects[0].m_etag,
+                    "\"e700b3f8d01367198b7ee8450c5bec97-2\"");
+  BOOST_CHECK_EQUAL(objects[1].m_size, 16);
+
+  BOOST_CHECK(!PersistenceDownloader::ParseListObjects("<Error>", objects,
+                                                       isTruncated));
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_download) {
+  INIT_STDOUT_LOGGER();
+
+  Mirror mirror;
+  const string ldb = RandomContent(CHUNK_SIZE * 10 + 123, 1);
+  mirror.Add("incremental", "persistence/state/000005.ldb", ldb);
+  mirror.Add("incremental", "persistence/state/CURRENT", "MANIFEST-000004\n");
+  mirror.Add("incremental", "persistence/state/LOCK", "");
+  mirror.Add("incremental", "persistence/txBodies/000001.ldb", "skipped");
+  mirror.Add("incremental", "persistence/microBlocks/000001.ldb", "skipped");
+
+  TempDir storage;
+  PersistenceDownloader downloader(mirror.Url(), TESTNET, storage.Path(), true,
+                                   8, CHUNK_SIZE);
+  vector<RemoteObject> objects;
+  BOOST_REQUIRE(downloader.ListObjects("incremental", objects));
+  BOOST_CHECK_EQUAL(objects.size(), 3);
+  BOOST_REQUIRE(
+      downloader.DownloadObjects("incremental", objects, storage.Path()));
+
+  BOOST_CHECK(ReadFile(storage.Path("persistence/state/000005.ldb")) == ldb);
+  BOOST_CHECK_EQUAL(ReadFile(storage.Path("persistence/state/CURRENT")),
+                    "MANIFEST-000004\n");
+  BOOST_CHECK(fs::exists(storage.Path("persistence/state/LOCK")));
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/txBodies")));
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/state/000005.ldb.part")));
+  BOOST_CHECK(
+      !fs::exists(storage.Path("persistence/state/000005.ldb.part.chunks")));
+
+  auto stats = downloader.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_numChunks, 12);
+  BOOST_CHECK_EQUAL(stats.m_numBytes, ldb.size() + 16);
+  BOOST_CHECK_EQUAL(stats.m_numRetries, 0);
+
+  // Already in place
+  BOOST_REQUIRE(
+      downloader.DownloadObjects("incremental", objects, storage.Path()));
+  stats = downloader.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_numChunks, 12);
+  BOOST_CHECK_EQUAL(stats.m_numSkippedObjects, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_resume) {
+  INIT_STDOUT_LOGGER();
+
+  Mirror mirror;
+  const string ldb = RandomContent(CHUNK_SIZE * 8, 2);
+  mirror.Add("incremental", "persistence/state/000005.ldb", ldb);
+  RemoteObject object{"persistence/state/000005.ldb", ldb.size(), ""};
+
+  // An earlier run wrote chunks 0, 1 and 5 before it stopped
+  TempDir storage;
+  const string path = storage.Path("persistence/state/000005.ldb");
+  string part(ldb.size(), '\0');
+  for (uint64_t i : {0, 1, 5}) {
+    part.replace(i * CHUNK_SIZE, CHUNK_SIZE, ldb, i * CHUNK_SIZE, CHUNK_SIZE);
+  }
+  WriteFile(path + ".part", part);
+  WriteFile(path + ".part.chunks",
+            to_string(ldb.size()) + "  " + to_string(CHUNK_SIZE) + "\n0\n1\n5\n");
+
+  PersistenceDownloader downloader(mirror.Url(), TESTNET, storage.Path(), true,
+                                   4, CHUNK_SIZE);
+  BOOST_REQUIRE(
+      downloader.DownloadObjects("incremental", {object}, storage.Path()));
+  BOOST_CHECK(ReadFile(path) == ldb);
+  auto stats = downloader.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_numResumedChunks, 3);
+  BOOST_CHECK_EQUAL(stats.m_numChunks, 5);
+
+  // A journal of another chunk size is not trusted
+  fs::remove(path);
+  WriteFile(path + ".part", part);
+  WriteFile(path + ".part.chunks",
+            to_string(ldb.size()) + "  " + to_string(CHUNK_SIZE / 2) + "\n0\n");
+  PersistenceDownloader restart(mirror.Url(), TESTNET, storage.Path(), true, 4,
+                                CHUNK_SIZE);
+  BOOST_REQUIRE(
+      restart.DownloadObjects("incremental", {object}, storage.Path()));
+  BOOST_CHECK(ReadFile(path) == ldb);
+  stats = restart.GetStats();
+  BOOST_CHECK_EQUAL(stats.m_numResumedChunks, 0);
+  BOOST_CHECK_EQUAL(stats.m_numChunks, 8);
+}
+
+BOOST_AUTO_TEST_CASE(test_integrity_check) {
+  INIT_STDOUT_LOGGER();
+
+  Mirror mirror;
+  const string ldb = RandomContent(CHUNK_SIZE * 3, 3);
+  mirror.Add("incremental", "persistence/state/000005.ldb", ldb);
+  mirror.Add("incremental", "persistence/state/CURRENT", "abc");
+  TempDir storage;
+  PersistenceDownloader downloader(mirror.Url(), TESTNET, storage.Path(), true,
+                                   4, CHUNK_SIZE);
+
+  // ETag of the upload in parts of 8 MB
+  RemoteObject good{"persistence/state/CURRENT", 3,
+                    "\"900150983cd24fb0d6963f7d28e17f72\""};
+  RemoteObject bad{"persistence/state/000005.ldb", ldb.size(),
+                   "\"900150983cd24fb0d6963f7d28e17f72\""};
+  BOOST_CHECK(
+      !downloader.DownloadObjects("incremental", {good, bad}, storage.Path()));
+  BOOST_CHECK_EQUAL(ReadFile(storage.Path("persistence/state/CURRENT")),
+                    "abc");
+  // The corrupted download is dropped
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/state/000005.ldb")));
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/state/000005.ldb.part")));
+
+  // Missing from the bucket
+  RemoteObject missing{"persistence/state/000006.ldb", 10, ""};
+  BOOST_CHECK(
+      !downloader.DownloadObjects("incremental", {missing}, storage.Path()));
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/state/000006.ldb")));
+}
+
+BOOST_AUTO_TEST_CASE(test_extract_tar_gz) {
+  INIT_STDOUT_LOGGER();
+
+  TempDir dir;
+  const string content = RandomContent(100000, 4);
+  WriteTarGz(dir.Path("diff.tar.gz"),
+             {{"diff_persistence_7/", ""},
+              {"diff_persistence_7/state/", ""},
+              {"diff_persistence_7/state/000007.ldb", content},
+              {"diff_persistence_7/state/CURRENT", "MANIFEST-000006\n"},
+              {"other/file", "skipped"}});
+
+  BOOST_REQUIRE(PersistenceDownloader::ExtractTarGz(
+      dir.Path("diff.tar.gz"), dir.Path("persistence"), "diff_persistence_7"));
+  BOOST_CHECK(ReadFile(dir.Path("persistence/state/000007.ldb")) == content);
+  BOOST_CHECK_EQUAL(ReadFile(dir.Path("persistence/state/CURRENT")),
+                    "MANIFEST-000006\n");
+  BOOST_CHECK(!fs::exists(dir.Path("persistence/other")));
+  BOOST_CHECK(!fs::exists(dir.Path("persistence/diff_persistence_7")));
+
+  // Without a prefix everything is kept as is
+  BOOST_REQUIRE(PersistenceDownloader::ExtractTarGz(dir.Path("diff.tar.gz"),
+                                                    dir.Path("all")));
+  BOOST_CHECK_EQUAL(ReadFile(dir.Path("all/other/file")), "skipped");
+
+  WriteTarGz(dir.Path("evil.tar.gz"), {{"../evil", "x"}});
+  BOOST_CHECK(!PersistenceDownloader::ExtractTarGz(dir.Path("evil.tar.gz"),
+                                                   dir.Path("evil")));
+  BOOST_CHECK(!fs::exists(dir.Path("evil")));
+
+  // Truncated
+  const string tarGz = ReadFile(dir.Path("diff.tar.gz"));
+  WriteFile(dir.Path("cut.tar.gz"), tarGz.substr(0, tarGz.size() / 2));
+  BOOST_CHECK(!PersistenceDownloader::ExtractTarGz(dir.Path("cut.tar.gz"),
+                                                   dir.Path("cut")));
+}
+
+BOOST_AUTO_TEST_CASE(test_start) {
+  INIT_STDOUT_LOGGER();
+
+  Mirror mirror;
+  const string ldb = RandomContent(CHUNK_SIZE * 5 + 7, 5);
+  mirror.Add("incremental", ".currentTxBlk", "7\n");
+  mirror.Add("incremental", "persistence/state/000005.ldb", ldb);
+  mirror.Add("incremental", "persistence/state/CURRENT", "MANIFEST-000004\n");
+  mirror.Add("incremental", "diff_persistence_7.tar.gz", "skipped");
+  WriteTarGz(mirror.m_dir.Path("statedelta/" + TESTNET + "/stateDelta_7.tar.gz"),
+             {{"stateDelta_7", "delta"}});
+
+  // Left over from an earlier snapshot
+  TempDir storage;
+  WriteFile(storage.Path("persistence/state/000001.ldb"), "stale");
+  WriteFile(storage.Path("StateDeltaFromS3/stateDelta_1"), "stale");
+
+  PersistenceDownloader downloader(mirror.Url(), TESTNET, storage.Path(), true,
+                                   8, CHUNK_SIZE);
+  BOOST_REQUIRE(downloader.Start());
+  BOOST_CHECK(ReadFile(storage.Path("persistence/state/000005.ldb")) == ldb);
+  BOOST_CHECK(!fs::exists(storage.Path("persistence/state/000001.ldb")));
+  BOOST_CHECK_EQUAL(ReadFile(storage.Path("StateDeltaFromS3/stateDelta_7")),
+                    "delta");
+  BOOST_CHECK(!fs::exists(storage.Path("StateDeltaFromS3/stateDelta_1")));
+  BOOST_CHECK(!fs::exists(storage.Path("diff_persistence_7.tar.gz")));
+  BOOST_CHECK(!fs::exists(storage.Path("persistenceDiff")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+#define BOOST_TEST_MODULE statedeltareplay
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libData/AccountData/AccountStore.h"
+#include "libCrypto/Sha2.h"
+#include "libData/AccountData/Address.h"
+#include "libMessage/Messenger.h"
+#include "libMessage/ZilliqaMessage.pb.h"
+#include "libPersistence/ContractStorage.h"
+#include "libPersistence/Retriever.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+using namespace Contract;
+
+BOOST_AUTO_TEST_SUITE(statedeltareplay)
+
+const uint128_t INITIAL_BALANCE = PRECISION_MIN_VALUE * 1000000;
+const unsigned int NUM_ACCOUNTS = 100;
+const uint64_t NUM_BLOCKS = 100;
+
+/// Resets the states to the accounts with their initial balance
+void ResetAccounts(const vector<Address>& addrs) {
+  AccountStore::GetInstance().Init();
+  for (const auto& addr : addrs) {
+    AccountStore::GetInstance().AddAccount(addr, {INITIAL_BALANCE, 0});
+  }
+  AccountStore::GetInstance().UpdateStateTrieAll();
+  AccountStore::GetInstance().MoveUpdatesToDisk();
+}
+
+/// Each sender pays the next accounts in turn, one state delta per block
+vector<bytes> GenerateStateDeltas(const vector<PairOfKey>& keys,
+                                  const vector<Address>& addrs) {
+  vector<bytes> stateDeltas;
+  for (uint64_t blockNum = 0; blockNum < NUM_BLOCKS; blockNum++) {
+    AccountStore::GetInstance().InitTemp();
+    for (unsigned int i = 0; i < keys.size(); i++) {
+      Transaction tx(DataConversion::Pack(CHAIN_ID, 1), blockNum + 1,
+                     addrs[(i + 1 + blockNum) % addrs.size()], keys[i],
+                     1 + blockNum, PRECISION_MIN_VALUE, NORMAL_TRAN_GAS);
+      TransactionReceipt tr;
+      TxnStatus error_code;
+      AccountStore::GetInstance().UpdateAccountsTemp(blockNum, 1, false, tx,
+                                                     tr, error_code);
+    }
+    AccountStore::GetInstance().SerializeDelta();
+    stateDeltas.emplace_back();
+    AccountStore::GetInstance().GetSerializedDelta(stateDeltas.back());
+    AccountStore::GetInstance().CommitTemp();
+  }
+  AccountStore::GetInstance().InitTemp();
+  return stateDeltas;
+}
+
+BOOST_AUTO_TEST_CASE(test_merged_replay) {
+  INIT_STDOUT_LOGGER();
+
+  vector<PairOfKey> keys;
+  vector<Address> addrs;
+  for (unsigned int i = 0; i < NUM_ACCOUNTS; i++) {
+    keys.emplace_back(Schnorr::GenKeyPair());
+    addrs.emplace_back(Account::GetAddressFromPublicKey(keys.back().second));
+  }
+  ResetAccounts(addrs);
+  const auto stateDeltas = GenerateStateDeltas(keys, addrs);
+  const auto expectedRoot = AccountStore::GetInstance().GetStateRootHash();
+
+  auto getStateDelta = [&stateDeltas](uint64_t blockNum, bytes& stateDelta) {
+    if (blockNum >= stateDeltas.size()) {
+      return false;
+    }
+    stateDelta = stateDeltas[blockNum];
+    return true;
+  };
+  using Clock = chrono::steady_clock;
+
+  // One delta at a time, as before
+  ResetAccounts(addrs);
+  auto start = Clock::now();
+  for (const auto& stateDelta : stateDeltas) {
+    BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDelta(stateDelta, 0));
+  }
+  const double sequentialSec =
+      chrono::duration<double>(Clock::now() - start).count();
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetStateRootHash(),
+                    expectedRoot);
+
+  ResetAccounts(addrs);
+  start = Clock::now();
+  bytes merged;
+  uint64_t lastBlockNum = 0;
+  unsigned int numStateDeltas = 0;
+  BOOST_REQUIRE(Retriever::MergeStateDeltas(0, NUM_BLOCKS - 1, 4,
+                                            getStateDelta, merged,
+                                            lastBlockNum, numStateDeltas));
+  BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDelta(merged, 0));
+  const double mergedSec =
+      chrono::duration<double>(Clock::now() - start).count();
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetStateRootHash(),
+                    expectedRoot);
+  BOOST_CHECK_EQUAL(lastBlockNum, NUM_BLOCKS - 1);
+  BOOST_CHECK_EQUAL(numStateDeltas, NUM_BLOCKS);
+  for (const auto& addr : addrs) {
+    BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetAccount(addr)->GetNonce(),
+                      NUM_BLOCKS);
+  }
+
+  LOG_GENERAL(INFO, "Replay of " << NUM_BLOCKS << " state deltas: "
+                                 << sequentialSec * 1000 << " ms one by one, "
+                                 << mergedSec * 1000 << " ms merged");
+}
+
+BOOST_AUTO_TEST_CASE(test_merge_slices) {
+  INIT_STDOUT_LOGGER();
+
+  vector<PairOfKey> keys;
+  vector<Address> addrs;
+  for (unsigned int i = 0; i < 10; i++) {
+    keys.emplace_back(Schnorr::GenKeyPair());
+    addrs.emplace_back(Account::GetAddressFromPublicKey(keys.back().second));
+  }
+  ResetAccounts(addrs);
+  const auto stateDeltas = GenerateStateDeltas(keys, addrs);
+
+  // The last blocks have no state delta
+  auto getStateDelta = [&stateDeltas](uint64_t blockNum, bytes& stateDelta) {
+    if (blockNum >= stateDeltas.size() - 3) {
+      return false;
+    }
+    stateDelta = stateDeltas[blockNum];
+    return true;
+  };
+
+  bytes expected;
+  BOOST_REQUIRE(Messenger::MergeAccountStoreDeltas(
+      vector<bytes>(stateDeltas.begin(), stateDeltas.end() - 3), expected));
+
+  // Same result whatever the split between the threads
+  for (unsigned int numThreads : {1, 3, 8, 200}) {
+    bytes merged;
+    uint64_t lastBlockNum = 0;
+    unsigned int numStateDeltas = 0;
+    BOOST_REQUIRE(Retriever::MergeStateDeltas(0, NUM_BLOCKS - 1, numThreads,
+                                              getStateDelta, merged,
+                                              lastBlockNum, numStateDeltas));
+    BOOST_CHECK(merged == expected);
+    BOOST_CHECK_EQUAL(lastBlockNum, NUM_BLOCKS - 4);
+    BOOST_CHECK_EQUAL(numStateDeltas, NUM_BLOCKS - 3);
+  }
+
+  // A range without any state delta
+  bytes merged;
+  uint64_t lastBlockNum = 0;
+  unsigned int numStateDeltas = 0;
+  BOOST_REQUIRE(Retriever::MergeStateDeltas(NUM_BLOCKS, NUM_BLOCKS + 9, 4,
+                                            getStateDelta, merged,
+                                            lastBlockNum, numStateDeltas));
+  BOOST_CHECK(merged.empty());
+  BOOST_CHECK_EQUAL(numStateDeltas, 0);
+}
+
+/// Storage key of an entry of the field of the contract
+string StateKey(const Address& addr, const string& index) {
+  return ContractStorage::GenerateStorageKey(addr, "field", {index});
+}
+
+/// Adds to the delta the entry of a contract, deployed with the code if not
+/// empty, writing and deleting the given entries of its field
+void AddContractEntry(ZilliqaMessage::ProtoAccountStore& delta,
+                      const Address& addr, int balance, const string& code,
+                      const dev::h256& storageRoot,
+                      const map<string, string>& states,
+                      const vector<string>& toDelete) {
+  const string initData = "init of " + addr.hex();
+  AccountBase base(abs(balance), 0, ACCOUNT_VERSION);
+  if (!code.empty()) {
+    SHA2<HashType::HASH_VARIANT_256> sha2;
+    sha2.Update(DataConversion::StringToCharArray(code));
+    sha2.Update(DataConversion::StringToCharArray(initData));
+    base.SetCodeHash(dev::h256(sha2.Finalize()));
+  }
+  base.SetStorageRoot(storageRoot);
+  bytes protoBase;
+  BOOST_REQUIRE(base.Serialize(protoBase, 0));
+
+  auto* entry = delta.add_entries();
+  entry->set_address(addr.data(), addr.size);
+  auto* account = entry->mutable_account();
+  BOOST_REQUIRE(account->mutable_base()->ParseFromArray(protoBase.data(),
+                                                        protoBase.size()));
+  account->set_numbersign(balance >= 0);
+  if (!code.empty()) {
+    account->set_code(code);
+    account->set_initdata(initData);
+  }
+  for (const auto& state : states) {
+    auto* storage = account->add_storage2();
+    storage->set_key(StateKey(addr, state.first));
+    storage->set_data(state.second);
+  }
+  for (const auto& index : toDelete) {
+    account->add_todelete(StateKey(addr, index));
+  }
+}
+
+bytes SerializeDelta(const ZilliqaMessage::ProtoAccountStore& delta) {
+  bytes dst(delta.ByteSize());
+  BOOST_REQUIRE(delta.SerializeToArray(dst.data(), dst.size()));
+  return dst;
+}
+
+/// Storage roots and states of the contracts, after a replay
+struct ContractStates {
+  dev::h256 m_stateRoot;
+  vector<dev::h256> m_storageRoots;
+  vector<map<string, bytes>> m_states;
+};
+
+ContractStates GetContractStates(const vector<Address>& contracts) {
+  ContractStates result;
+  result.m_stateRoot = AccountStore::GetInstance().GetStateRootHash();
+  for (const auto& addr : contracts) {
+    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+    BOOST_REQUIRE(account != nullptr);
+    BOOST_CHECK(account->isContract());
+    result.m_storageRoots.emplace_back(account->GetStorageRoot());
+    result.m_states.emplace_back();
+    ContractStorage::GetContractStorage().FetchStateDataForContract(
+        result.m_states.back(), addr, "", {}, false);
+  }
+  return result;
+}
+
+BOOST_AUTO_TEST_CASE(test_contract_replay) {
+  INIT_STDOUT_LOGGER();
+
+  const vector<Address> contracts = {Address::random(), Address::random()};
+  const Address& first = contracts[0];
+  const Address& later = contracts[1];
+  const dev::h256 storageRoot = dev::h256::random();
+
+  vector<ZilliqaMessage::ProtoAccountStore> deltas(5);
+  // The first contract is deployed with two entries, one overridden and one
+  // deleted right after
+  AddContractEntry(deltas[0], first, 100, "first code", {},
+                   {{"a", "1"}, {"b", "1"}}, {});
+  AddContractEntry(deltas[1], first, 0, "", {}, {{"a", "2"}, {"c", "1"}},
+                   {"b"});
+  // The other one only appears in a later delta
+  AddContractEntry(deltas[2], later, 50, "later code", {},
+                   {{"p", "1"}, {"q", "1"}}, {});
+  AddContractEntry(deltas[2], first, -30, "", {}, {{"b", "2"}}, {"c"});
+  // The states of a delta with a storage root are not applied
+  AddContractEntry(deltas[3], later, 0, "", storageRoot, {{"q", "2"}},
+                   {"p"});
+  AddContractEntry(deltas[3], first, 0, "", {}, {}, {"a"});
+  // and an entry deleted can be written again
+  AddContractEntry(deltas[4], first, 0, "", {}, {{"a", "3"}}, {});
+  AddContractEntry(deltas[4], later, 0, "", {}, {{"r", "1"}}, {"p"});
+
+  vector<bytes> stateDeltas;
+  for (const auto& delta : deltas) {
+    stateDeltas.emplace_back(SerializeDelta(delta));
+  }
+
+  ResetAccounts({});
+  for (const auto& stateDelta : stateDeltas) {
+    BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDelta(stateDelta, 0));
+  }
+  const ContractStates expected = GetContractStates(contracts);
+
+  const map<string, bytes> firstStates = {
+      {StateKey(first, "a"), DataConversion::StringToCharArray("3")},
+      {StateKey(first, "b"), DataConversion::StringToCharArray("2")}};
+  const map<string, bytes> laterStates = {
+      {StateKey(later, "q"), DataConversion::StringToCharArray("1")},
+      {StateKey(later, "r"), DataConversion::StringToCharArray("1")}};
+  BOOST_CHECK(expected.m_states[0] == firstStates);
+  BOOST_CHECK(expected.m_states[1] == laterStates);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetBalance(first), 70);
+  BOOST_CHECK_EQUAL(AccountStore::GetInstance().GetBalance(later), 50);
+
+  auto getStateDelta = [&stateDeltas](uint64_t blockNum, bytes& stateDelta) {
+    if (blockNum >= stateDeltas.size()) {
+      return false;
+    }
+    stateDelta = stateDeltas[blockNum];
+    return true;
+  };
+
+  for (unsigned int numThreads : {1, 2, 4}) {
+    ResetAccounts({});
+    bytes merged;
+    uint64_t lastBlockNum = 0;
+    unsigned int numStateDeltas = 0;
+    BOOST_REQUIRE(Retriever::MergeStateDeltas(0, stateDeltas.size() - 1,
+                                              numThreads, getStateDelta,
+                                              merged, lastBlockNum,
+                                              numStateDeltas));
+    BOOST_REQUIRE(AccountStore::GetInstance().DeserializeDelta(merged, 0));
+
+    const ContractStates actual = GetContractStates(contracts);
+    BOOST_CHECK_EQUAL(actual.m_stateRoot, expected.m_stateRoot);
+    BOOST_CHECK(actual.m_storageRoots == expected.m_storageRoots);
+    BOOST_CHECK(actual.m_states == expected.m_states);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
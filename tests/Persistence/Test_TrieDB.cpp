@@ -21,6 +21,7 @@
 #include "depends/common/CommonIO.h"
 #include "depends/common/FixedHash.h"
 #include "depends/common/RLP.h"
+#include "depends/common/SHA3.h"
 #include "libData/AccountData/Account.h"
 #include "libData/DataStructures/TraceableDB.h"
 #include "libUtils/DataConversion.h"
@@ -342,4 +343,69 @@ BOOST_AUTO_TEST_CASE(traceabledb) {
 }
 */
 
+BOOST_AUTO_TEST_CASE(nodeCache) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  dev::OverlayDB m_db("trieDBCache", 1024 * 1024);
+  m_db.ResetDB();
+
+  dev::GenericTrieDB<dev::OverlayDB> m_trie(&m_db);
+  m_trie.init();
+  for (unsigned int i = 0; i < 100; i++) {
+    m_trie.insert(DataConversion::StringToCharArray("key" + to_string(i)),
+                  DataConversion::StringToCharArray("value" + to_string(i)));
+  }
+  m_trie.db()->commit();
+
+  // Nodes are cached when first read from the LevelDB
+  for (unsigned int i = 0; i < 100; i++) {
+    BOOST_CHECK_EQUAL(
+        m_trie.at(DataConversion::StringToCharArray("key" + to_string(i))),
+        "value" + to_string(i));
+  }
+  auto stats = m_db.nodeCacheStats();
+  BOOST_CHECK_GT(stats.misses, 0);
+  BOOST_CHECK_GT(stats.entries, 0);
+  BOOST_CHECK_LE(stats.bytes, stats.capacity);
+
+  for (unsigned int i = 0; i < 100; i++) {
+    BOOST_CHECK_EQUAL(
+        m_trie.at(DataConversion::StringToCharArray("key" + to_string(i))),
+        "value" + to_string(i));
+  }
+  BOOST_CHECK_EQUAL(m_db.nodeCacheStats().misses, stats.misses);
+  BOOST_CHECK_GT(m_db.nodeCacheStats().hits, stats.hits);
+
+  // Dropped with the LevelDB
+  m_db.ResetDB();
+  BOOST_CHECK_EQUAL(m_db.nodeCacheStats().entries, 0);
+  BOOST_CHECK(!m_db.exists(m_trie.root()));
+}
+
+BOOST_AUTO_TEST_CASE(nodeCacheBound) {
+  INIT_STDOUT_LOGGER();
+
+  dev::NodeCache cache(16 * 1024);
+  const string value(200, 'a');
+  vector<h256> hashes;
+  for (unsigned int i = 0; i < 1000; i++) {
+    hashes.emplace_back(dev::sha3(to_string(i)));
+    cache.insert(hashes.back(), value);
+  }
+
+  auto stats = cache.stats();
+  BOOST_CHECK_LE(stats.bytes, stats.capacity);
+  BOOST_CHECK_GT(stats.evictions, 0);
+  BOOST_CHECK_EQUAL(stats.entries + stats.evictions, hashes.size());
+
+  string out;
+  BOOST_CHECK(cache.lookup(hashes.back(), out));
+  BOOST_CHECK_EQUAL(out, value);
+  cache.remove({hashes.back()});
+  BOOST_CHECK(!cache.lookup(hashes.back(), out));
+  BOOST_CHECK_EQUAL(cache.stats().entries, stats.entries - 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
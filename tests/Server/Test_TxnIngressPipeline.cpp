@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "libServer/Server.h"
+#include "libServer/TxnIngressPipeline.h"
+#include "libTestUtils/TestUtils.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE txningresspipeline
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace jsonrpc;
+
+using TxnBatch = vector<pair<Transaction, uint32_t>>;
+
+/// Blocks the stages of the pipeline until opened
+class Gate {
+ public:
+  void Open() {
+    lock_guard<mutex> g(m_mutex);
+    m_open = true;
+    m_cv.notify_all();
+  }
+
+  /// Waits for the gate to open, after flagging that a stage reached it
+  void Pass() {
+    unique_lock<mutex> lock(m_mutex);
+    m_reached = true;
+    m_cv.notify_all();
+    m_cv.wait(lock, [this] { return m_open; });
+  }
+
+  void WaitReached() {
+    unique_lock<mutex> lock(m_mutex);
+    BOOST_REQUIRE(m_cv.wait_for(lock, chrono::seconds(10),
+                                [this] { return m_reached; }));
+  }
+
+ private:
+  mutex m_mutex;
+  condition_variable m_cv;
+  bool m_open{false};
+  bool m_reached{false};
+};
+
+vector<Transaction> GenerateTxns(unsigned int count) {
+  vector<Transaction> txns;
+  for (unsigned int i = 0; i < count; i++) {
+    txns.emplace_back(TestUtils::GenerateRandomTransaction(
+        1, i + 1, Transaction::NON_CONTRACT));
+  }
+  return txns;
+}
+
+/// Waits until the stats of the pipeline show the depth for the queue
+void WaitForDepth(TxnIngressPipeline& pipeline, const string& queue,
+                  uint64_t depth) {
+  for (unsigned int i = 0; i < 10000; i++) {
+    if (pipeline.GetStats()[queue].asUInt64() == depth) {
+      return;
+    }
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  BOOST_FAIL(queue << " never reached " << depth);
+}
+
+future<Json::Value> Submit(TxnIngressPipeline& pipeline, const Transaction& tx,
+                           uint32_t mapIndex = 0) {
+  return async(launch::async, [&pipeline, tx, mapIndex]() {
+    return pipeline.Process(tx, [mapIndex](uint32_t& index) {
+      index = mapIndex;
+      return Json::Value(Json::objectValue);
+    });
+  });
+}
+
+BOOST_AUTO_TEST_SUITE(txningresspipeline)
+
+BOOST_AUTO_TEST_CASE(init) {
+  INIT_STDOUT_LOGGER();
+  TestUtils::Initialize();
+}
+
+BOOST_AUTO_TEST_CASE(test_batching) {
+  const vector<Transaction> txns = GenerateTxns(10);
+
+  Gate gate;
+  mutex mutexBatches;
+  vector<size_t> batchSizes;
+  TxnIngressPipeline pipeline(
+      2, 100, 4, [&](const TxnBatch& batch, vector<bool>& added) {
+        gate.Pass();
+        lock_guard<mutex> g(mutexBatches);
+        batchSizes.emplace_back(batch.size());
+        added.assign(batch.size(), true);
+      });
+
+  // The inserter blocks on the first txn while the others queue up behind it
+  vector<future<Json::Value>> responses;
+  responses.emplace_back(Submit(pipeline, txns[0]));
+  gate.WaitReached();
+  for (unsigned int i = 1; i < txns.size(); i++) {
+    responses.emplace_back(Submit(pipeline, txns[i]));
+  }
+  WaitForDepth(pipeline, "InsertQueueDepth", txns.size() - 1);
+  gate.Open();
+
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    BOOST_CHECK_EQUAL(responses[i].get()["TranID"].asString(),
+                      txns[i].GetTranID().hex());
+  }
+  lock_guard<mutex> g(mutexBatches);
+  BOOST_CHECK(batchSizes == vector<size_t>({1, 4, 4, 1}));
+  BOOST_CHECK_EQUAL(pipeline.GetStats()["InsertMs"]["Count"].asUInt64(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_rejection) {
+  const vector<Transaction> txns = GenerateTxns(4);
+
+  // Odd txns are refused by the shard maps
+  TxnIngressPipeline pipeline(
+      2, 100, 10, [&txns](const TxnBatch& batch, vector<bool>& added) {
+        for (const auto& txn : batch) {
+          added.emplace_back(txn.first.GetTranID() != txns[1].GetTranID() &&
+                             txn.first.GetTranID() != txns[3].GetTranID());
+        }
+      });
+
+  BOOST_CHECK_EQUAL(Submit(pipeline, txns[0]).get()["TranID"].asString(),
+                    txns[0].GetTranID().hex());
+  try {
+    Submit(pipeline, txns[1]).get();
+    BOOST_FAIL("Txn refused by the shard maps accepted");
+  } catch (const JsonRpcException& e) {
+    BOOST_CHECK_EQUAL(e.GetCode(), ServerBase::RPC_DATABASE_ERROR);
+  }
+
+  // A failed precheck is returned as it is, without reaching the inserter
+  try {
+    pipeline.Process(txns[2], [](uint32_t&) -> Json::Value {
+      throw JsonRpcException(ServerBase::RPC_VERIFY_REJECTED,
+                             "Invalid signature");
+    });
+    BOOST_FAIL("Txn failing its precheck accepted");
+  } catch (const JsonRpcException& e) {
+    BOOST_CHECK_EQUAL(e.GetCode(), ServerBase::RPC_VERIFY_REJECTED);
+    BOOST_CHECK_EQUAL(e.GetMessage(), "Invalid signature");
+  }
+  BOOST_CHECK_EQUAL(pipeline.GetStats()["InsertMs"]["Count"].asUInt64(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_queue_full) {
+  const vector<Transaction> txns = GenerateTxns(4);
+
+  Gate gate;
+  TxnIngressPipeline pipeline(
+      1, 2, 10, [](const TxnBatch& batch, vector<bool>& added) {
+        added.assign(batch.size(), true);
+      });
+
+  // The only worker is held by the first txn, the next two fill the queue
+  vector<future<Json::Value>> responses;
+  responses.emplace_back(async(launch::async, [&pipeline, &txns, &gate]() {
+    return pipeline.Process(txns[0], [&gate](uint32_t&) {
+      gate.Pass();
+      return Json::Value(Json::objectValue);
+    });
+  }));
+  gate.WaitReached();
+  responses.emplace_back(Submit(pipeline, txns[1]));
+  responses.emplace_back(Submit(pipeline, txns[2]));
+  WaitForDepth(pipeline, "PrecheckQueueDepth", 2);
+
+  // and the last one is turned away without waiting
+  bool prechecked = false;
+  try {
+    pipeline.Process(txns[3], [&prechecked](uint32_t&) {
+      prechecked = true;
+      return Json::Value(Json::objectValue);
+    });
+    BOOST_FAIL("Txn accepted while the queue is full");
+  } catch (const JsonRpcException& e) {
+    BOOST_CHECK_EQUAL(e.GetCode(), ServerBase::RPC_MISC_ERROR);
+  }
+  BOOST_CHECK(!prechecked);
+  BOOST_CHECK_EQUAL(pipeline.GetStats()["RejectedQueueFull"].asUInt64(), 1);
+
+  gate.Open();
+  for (unsigned int i = 0; i < responses.size(); i++) {
+    BOOST_CHECK_EQUAL(responses[i].get()["TranID"].asString(),
+                      txns[i].GetTranID().hex());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_ordering) {
+  const vector<Transaction> txns = GenerateTxns(20);
+
+  Gate gate;
+  mutex mutexInserted;
+  TxnBatch inserted;
+  TxnIngressPipeline pipeline(
+      1, 100, 8, [&](const TxnBatch& batch, vector<bool>& added) {
+        lock_guard<mutex> g(mutexInserted);
+        inserted.insert(inserted.end(), batch.begin(), batch.end());
+        added.assign(batch.size(), true);
+      });
+
+  // With a single worker, the txns are inserted in the order they arrived,
+  // with the shard map set by their precheck
+  vector<future<Json::Value>> responses;
+  responses.emplace_back(async(launch::async, [&pipeline, &txns, &gate]() {
+    return pipeline.Process(txns[0], [&gate](uint32_t& index) {
+      gate.Pass();
+      index = 0;
+      return Json::Value(Json::objectValue);
+    });
+  }));
+  gate.WaitReached();
+  for (unsigned int i = 1; i < txns.size(); i++) {
+    responses.emplace_back(Submit(pipeline, txns[i], i % 3));
+    WaitForDepth(pipeline, "PrecheckQueueDepth", i);
+  }
+  gate.Open();
+
+  for (auto& response : responses) {
+    response.get();
+  }
+  lock_guard<mutex> g(mutexInserted);
+  BOOST_REQUIRE_EQUAL(inserted.size(), txns.size());
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    BOOST_CHECK_EQUAL(inserted[i].first.GetTranID(), txns[i].GetTranID());
+    BOOST_CHECK_EQUAL(inserted[i].second, i % 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_shutdown) {
+  const vector<Transaction> txns = GenerateTxns(5);
+
+  Gate gate;
+  auto pipeline = make_unique<TxnIngressPipeline>(
+      1, 2, 1, [&gate](const TxnBatch& batch, vector<bool>& added) {
+        gate.Pass();
+        added.assign(batch.size(), true);
+      });
+
+  // The inserter is held by the first txn, the next two fill the insert
+  // queue, the worker waits for room with the fourth and the fifth one is
+  // left in the precheck queue
+  vector<future<Json::Value>> responses;
+  responses.emplace_back(Submit(*pipeline, txns[0]));
+  gate.WaitReached();
+  responses.emplace_back(Submit(*pipeline, txns[1]));
+  responses.emplace_back(Submit(*pipeline, txns[2]));
+  WaitForDepth(*pipeline, "InsertQueueDepth", 2);
+  responses.emplace_back(Submit(*pipeline, txns[3]));
+  while (pipeline->GetStats()["PrecheckMs"]["Count"].asUInt64() < 4) {
+    this_thread::sleep_for(chrono::milliseconds(1));
+  }
+  responses.emplace_back(Submit(*pipeline, txns[4]));
+  WaitForDepth(*pipeline, "PrecheckQueueDepth", 1);
+
+  // The worker gives up the fourth txn once stopping, the inserter then
+  // finishes the first one and the queued txns are answered on the way out
+  auto stopping = async(launch::async, [&pipeline]() { pipeline.reset(); });
+  BOOST_REQUIRE(responses[3].wait_for(chrono::seconds(10)) ==
+                future_status::ready);
+  gate.Open();
+  stopping.get();
+
+  BOOST_CHECK_EQUAL(responses[0].get()["TranID"].asString(),
+                    txns[0].GetTranID().hex());
+  for (unsigned int i = 1; i < responses.size(); i++) {
+    try {
+      responses[i].get();
+      BOOST_FAIL("Txn accepted after the pipeline stopped");
+    } catch (const JsonRpcException& e) {
+      BOOST_CHECK_EQUAL(e.GetCode(), ServerBase::RPC_MISC_ERROR);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE blockingqueuetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/lockfree/queue.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "libUtils/BlockingQueue.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(blockingqueuetest)
+
+/// CPU time used so far by the calling thread, in ms
+double ThreadCpuMs() {
+  struct timespec ts {};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+BOOST_AUTO_TEST_CASE(test_fifo_and_bound) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingQueue<uint64_t> queue(16, "TestQueue");
+  uint64_t item = 0;
+  BOOST_CHECK(!queue.TryPop(item));
+
+  for (uint64_t i = 0; i < 10; i++) {
+    BOOST_CHECK(queue.Push(i));
+  }
+  BOOST_CHECK_EQUAL(queue.Size(), 10);
+  for (uint64_t i = 0; i < 10; i++) {
+    BOOST_CHECK(queue.TryPop(item));
+    BOOST_CHECK_EQUAL(item, i);
+  }
+  BOOST_CHECK_EQUAL(queue.Size(), 0);
+
+  // Pushes fail once the preallocated capacity is used up
+  unsigned int numPushed = 0;
+  while (numPushed < 1000 && queue.Push(numPushed)) {
+    numPushed++;
+  }
+  BOOST_CHECK_LT(numPushed, 1000);
+  BOOST_CHECK_EQUAL(queue.Size(), numPushed);
+  BOOST_CHECK_EQUAL(queue.GetLengths().GetCount(), 10 + numPushed);
+}
+
+BOOST_AUTO_TEST_CASE(test_pop_waits) {
+  INIT_STDOUT_LOGGER();
+
+  BlockingQueue<uint64_t> queue(16, "TestQueue");
+  atomic<uint64_t> popped{0};
+  thread consumer([&queue, &popped]() {
+    uint64_t item = 0;
+    queue.Pop(item);
+    popped = item;
+  });
+
+  this_thread::sleep_for(chrono::milliseconds(50));
+  BOOST_CHECK_EQUAL(popped, 0);
+  BOOST_CHECK(queue.Push(42));
+  consumer.join();
+  BOOST_CHECK_EQUAL(popped, 42);
+  BOOST_CHECK_EQUAL(queue.GetWaitLatency().GetCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_multiple_producers_consumers) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_THREADS = 4;
+  const uint64_t NUM_ITEMS = 100000;
+
+  BlockingQueue<uint64_t> queue(1024, "TestQueue");
+  atomic<uint64_t> sum{0};
+  atomic<uint64_t> count{0};
+
+  vector<thread> consumers;
+  for (unsigned int c = 0; c < NUM_THREADS; c++) {
+    consumers.emplace_back([&]() {
+      uint64_t item = 0;
+      while (true) {
+        queue.Pop(item);
+        // Zero tells the consumer to stop
+        if (item == 0) {
+          return;
+        }
+        sum += item;
+        count++;
+      }
+    });
+  }
+
+  vector<thread> producers;
+  for (unsigned int p = 0; p < NUM_THREADS; p++) {
+    producers.emplace_back([&queue, NUM_ITEMS]() {
+      for (uint64_t i = 1; i <= NUM_ITEMS; i++) {
+        while (!queue.Push(i)) {
+          this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  for (unsigned int c = 0; c < NUM_THREADS; c++) {
+    while (!queue.Push(0)) {
+      this_thread::yield();
+    }
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  BOOST_CHECK_EQUAL(count, NUM_THREADS * NUM_ITEMS);
+  BOOST_CHECK_EQUAL(sum, NUM_THREADS * NUM_ITEMS * (NUM_ITEMS + 1) / 2);
+  LOG_GENERAL(INFO, "Length " << queue.GetLengths().ToString());
+  LOG_GENERAL(INFO, "Wait " << queue.GetWaitLatency().ToString());
+}
+
+BOOST_AUTO_TEST_CASE(test_idle_cpu_and_wakeup) {
+  INIT_STDOUT_LOGGER();
+
+  // One item every ms, as a lightly loaded node sees
+  const unsigned int NUM_ITEMS = 500;
+  using Clock = chrono::steady_clock;
+
+  // Returns the CPU time of the consumer in ms and the sorted wake-up
+  // latencies in us
+  auto run = [NUM_ITEMS](const function<void(Clock::time_point*&)>& pop,
+                         const function<void(Clock::time_point*)>& push,
+                         double& cpuMs, vector<double>& latencies) {
+    thread consumer([&]() {
+      const double start = ThreadCpuMs();
+      for (unsigned int i = 0; i < NUM_ITEMS; i++) {
+        Clock::time_point* sent = nullptr;
+        pop(sent);
+        latencies.emplace_back(
+            chrono::duration<double, micro>(Clock::now() - *sent).count());
+        delete sent;
+      }
+      cpuMs = ThreadCpuMs() - start;
+    });
+    for (unsigned int i = 0; i < NUM_ITEMS; i++) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      push(new Clock::time_point(Clock::now()));
+    }
+    consumer.join();
+    sort(latencies.begin(), latencies.end());
+  };
+
+  BlockingQueue<Clock::time_point*> blocking(1024, "TestQueue");
+  double blockingCpuMs = 0;
+  vector<double> blockingLatencies;
+  run([&blocking](Clock::time_point*& item) { blocking.Pop(item); },
+      [&blocking](Clock::time_point* item) { blocking.Push(item); },
+      blockingCpuMs, blockingLatencies);
+
+  // The loop the message pumps ran before
+  boost::lockfree::queue<Clock::time_point*> polling(1024);
+  double pollingCpuMs = 0;
+  vector<double> pollingLatencies;
+  run(
+      [&polling](Clock::time_point*& item) {
+        while (!polling.pop(item)) {
+          this_thread::sleep_for(chrono::microseconds(1));
+        }
+      },
+      [&polling](Clock::time_point* item) { polling.bounded_push(item); },
+      pollingCpuMs, pollingLatencies);
+
+  auto p99 = [](const vector<double>& l) { return l[l.size() * 99 / 100]; };
+  LOG_GENERAL(INFO, "Blocking queue: consumer CPU " << blockingCpuMs
+                                                    << " ms, wake-up p99 "
+                                                    << p99(blockingLatencies)
+                                                    << " us");
+  LOG_GENERAL(INFO, "Sleep polling: consumer CPU "
+                        << pollingCpuMs << " ms, wake-up p99 "
+                        << p99(pollingLatencies) << " us");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
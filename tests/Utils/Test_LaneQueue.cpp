@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE lanequeuetest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libUtils/BlockingQueue.h"
+#include "libUtils/LaneQueue.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(lanequeuetest)
+
+BOOST_AUTO_TEST_CASE(test_weighted_turns) {
+  INIT_STDOUT_LOGGER();
+
+  LaneQueue<uint64_t> queue({{"A", 64, 3}, {"B", 64, 2}, {"C", 64, 1}});
+  for (uint64_t i = 0; i < 12; i++) {
+    for (unsigned int lane = 0; lane < 3; lane++) {
+      BOOST_CHECK(queue.Push(lane, lane));
+    }
+  }
+
+  // Lane A gets three turns for every one of lane C
+  vector<uint64_t> order;
+  for (unsigned int i = 0; i < 12; i++) {
+    uint64_t item = 0;
+    queue.Pop(item);
+    order.emplace_back(item);
+  }
+  const vector<uint64_t> expected = {0, 0, 0, 1, 1, 2, 0, 0, 0, 1, 1, 2};
+  BOOST_CHECK(order == expected);
+
+  // The lanes running dry hand over to the next ones, lane C goes last
+  vector<uint64_t> rest;
+  for (unsigned int i = 0; i < 24; i++) {
+    uint64_t item = 0;
+    queue.Pop(item);
+    rest.emplace_back(item);
+  }
+  BOOST_CHECK_EQUAL(count(rest.begin(), rest.end(), 0), 6);
+  BOOST_CHECK_EQUAL(count(rest.begin(), rest.end(), 1), 8);
+  BOOST_CHECK(all_of(rest.end() - 6, rest.end(),
+                     [](uint64_t lane) { return lane == 2; }));
+  uint64_t item = 0;
+  BOOST_CHECK(!queue.TryPop(item));
+}
+
+BOOST_AUTO_TEST_CASE(test_lane_bound) {
+  INIT_STDOUT_LOGGER();
+
+  LaneQueue<uint64_t> queue({{"Small", 4, 1}, {"Large", 64, 1}});
+  for (uint64_t i = 0; i < 10; i++) {
+    BOOST_CHECK_EQUAL(queue.Push(0, i), i < 4);
+  }
+  // A full lane does not stop the others
+  BOOST_CHECK(queue.Push(1, 100));
+  BOOST_CHECK(!queue.Push(2, 100));
+
+  const auto stats = queue.GetStats();
+  BOOST_REQUIRE_EQUAL(stats.size(), 2);
+  BOOST_CHECK_EQUAL(stats[0].m_name, "Small");
+  BOOST_CHECK_EQUAL(stats[0].m_size, 4);
+  BOOST_CHECK_EQUAL(stats[0].m_numPushed, 4);
+  BOOST_CHECK_EQUAL(stats[0].m_numDropped, 6);
+  BOOST_CHECK_EQUAL(stats[1].m_size, 1);
+  BOOST_CHECK_EQUAL(stats[1].m_numDropped, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_flood_does_not_delay_priority_lane) {
+  INIT_STDOUT_LOGGER();
+
+  // A backlog of transaction packets while consensus messages keep coming
+  const unsigned int NUM_WORKERS = 4;
+  const unsigned int NUM_FLOOD = 4000;
+  const unsigned int NUM_PRIORITY = 100;
+  const auto WORK = chrono::microseconds(200);
+  using Clock = chrono::steady_clock;
+
+  struct Item {
+    bool m_priority;
+    Clock::time_point m_sent;
+    /// Transaction items dispatched when this one was queued
+    unsigned int m_floodDispatched;
+  };
+
+  // Latencies of the priority items in ms, and the number of transaction
+  // items dispatched while each one waited, both sorted
+  struct Result {
+    vector<double> m_latencies;
+    vector<unsigned int> m_floodAhead;
+  };
+
+  auto run = [&](const function<void(Item*)>& push,
+                 const function<void(Item*&)>& pop) {
+    Result result;
+    mutex mutexResult;
+    // Held while a priority item is queued, so that no transaction item is
+    // counted as dispatched in between
+    mutex mutexDispatched;
+    unsigned int numFloodDispatched = 0;
+    atomic<unsigned int> numLeft{NUM_FLOOD + NUM_PRIORITY};
+    vector<thread> workers;
+    for (unsigned int w = 0; w < NUM_WORKERS; w++) {
+      workers.emplace_back([&]() {
+        while (numLeft > 0) {
+          Item* item = nullptr;
+          pop(item);
+          if (item == nullptr) {
+            return;
+          }
+          if (item->m_priority) {
+            const double latency =
+                chrono::duration<double, milli>(Clock::now() - item->m_sent)
+                    .count();
+            unsigned int floodAhead = 0;
+            {
+              lock_guard<mutex> g(mutexDispatched);
+              floodAhead = numFloodDispatched - item->m_floodDispatched;
+            }
+            lock_guard<mutex> g(mutexResult);
+            result.m_latencies.emplace_back(latency);
+            result.m_floodAhead.emplace_back(floodAhead);
+          } else {
+            lock_guard<mutex> g(mutexDispatched);
+            numFloodDispatched++;
+          }
+          this_thread::sleep_for(WORK);
+          delete item;
+          numLeft--;
+        }
+      });
+    }
+
+    for (unsigned int i = 0; i < NUM_FLOOD; i++) {
+      push(new Item{false, Clock::now(), 0});
+    }
+    for (unsigned int i = 0; i < NUM_PRIORITY; i++) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      lock_guard<mutex> g(mutexDispatched);
+      push(new Item{true, Clock::now(), numFloodDispatched});
+    }
+    while (numLeft > 0) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    for (unsigned int w = 0; w < NUM_WORKERS; w++) {
+      push(nullptr);
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    sort(result.m_latencies.begin(), result.m_latencies.end());
+    sort(result.m_floodAhead.begin(), result.m_floodAhead.end());
+    return result;
+  };
+
+  LaneQueue<Item*> lanes(
+      {{"Consensus", 8192, 8}, {"Txn", NUM_FLOOD + NUM_WORKERS, 1}});
+  const auto laneResult = run(
+      [&lanes](Item* item) {
+        lanes.Push(item != nullptr && item->m_priority ? 0 : 1, item);
+      },
+      [&lanes](Item*& item) { lanes.Pop(item); });
+
+  // One queue for all messages, as before
+  BlockingQueue<Item*> single(8192, "Single");
+  const auto singleResult =
+      run([&single](Item* item) { single.Push(item); },
+          [&single](Item*& item) { single.Pop(item); });
+
+  BOOST_REQUIRE_EQUAL(laneResult.m_latencies.size(), NUM_PRIORITY);
+  BOOST_REQUIRE_EQUAL(singleResult.m_latencies.size(), NUM_PRIORITY);
+
+  // Whatever the timing, a queued priority item only waits for the
+  // transaction items already taken by the workers, and for one turn of the
+  // Txn lane per eight priority items ahead of it
+  BOOST_CHECK_LE(laneResult.m_floodAhead.back(),
+                 NUM_WORKERS + 1 + NUM_PRIORITY / 8 + 1);
+
+  auto p99 = [](const auto& l) { return l[l.size() * 99 / 100]; };
+  LOG_GENERAL(INFO, "Priority message p99 with lanes: "
+                        << p99(laneResult.m_latencies) << " ms, "
+                        << p99(laneResult.m_floodAhead)
+                        << " transaction items ahead. Single queue: "
+                        << p99(singleResult.m_latencies) << " ms, "
+                        << p99(singleResult.m_floodAhead)
+                        << " transaction items ahead");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
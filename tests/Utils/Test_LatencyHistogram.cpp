@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE latencyhistogramtest
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "libUtils/LatencyHistogram.h"
+#include "libUtils/Logger.h"
+
+BOOST_AUTO_TEST_SUITE(latencyhistogramtest)
+
+BOOST_AUTO_TEST_CASE(test_latency_histogram) {
+  INIT_STDOUT_LOGGER();
+
+  LatencyHistogram histogram;
+  BOOST_CHECK_EQUAL(histogram.GetCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.GetPercentile(0.5), 0);
+
+  // 90 fast calls, 9 slower ones and one far beyond the last bucket
+  for (unsigned int i = 0; i < 90; i++) {
+    histogram.Record(i % 2);
+  }
+  for (unsigned int i = 0; i < 9; i++) {
+    histogram.Record(100);
+  }
+  histogram.Record(100000000);
+
+  BOOST_CHECK_EQUAL(histogram.GetCount(), 100);
+  BOOST_CHECK_EQUAL(histogram.GetPercentile(0.5), 1);
+  BOOST_CHECK_EQUAL(histogram.GetPercentile(0.9), 1);
+  BOOST_CHECK_EQUAL(histogram.GetPercentile(0.99), 128);
+  BOOST_CHECK_EQUAL(histogram.GetPercentile(1),
+                    1ULL << (LatencyHistogram::NUM_BUCKETS - 1));
+
+  LOG_GENERAL(INFO, histogram.ToString());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
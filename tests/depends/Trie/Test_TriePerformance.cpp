@@ -17,7 +17,10 @@
 
 #include <array>
 #include <chrono>
+#include <map>
+#include <random>
 #include <string>
+#include <vector>
 
 #define BOOST_TEST_MODULE TriePerformance
 #define BOOST_TEST_DYN_LINK
@@ -40,6 +43,33 @@ BOOST_AUTO_TEST_SUITE(TriePerformance)
 template <class KeyType, class DB>
 using SecureTrieDB = dev::SpecificTrieDB<dev::HashedGenericTrieDB<DB>, KeyType>;
 
+/// Exposes the live nodes of the overlay with their refcounts, and the
+/// committed ones
+class InspectableDB : public dev::OverlayDB {
+ public:
+  explicit InspectableDB(const std::string& dbName) : dev::OverlayDB(dbName) {}
+
+  std::map<dev::h256, std::pair<std::string, unsigned>> GetLiveNodes() const {
+    std::map<dev::h256, std::pair<std::string, unsigned>> live;
+    for (const auto& node : *m_main) {
+      if (node.second.second > 0) {
+        live.emplace(node);
+      }
+    }
+    return live;
+  }
+
+  std::map<std::string, std::string> GetCommitted() {
+    std::map<std::string, std::string> committed;
+    std::unique_ptr<leveldb::Iterator> it(
+        m_levelDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+      committed.emplace(it->key().ToString(), it->value().ToString());
+    }
+    return committed;
+  }
+};
+
 BOOST_AUTO_TEST_CASE(TestSecureTrieDB) {
   INIT_STDOUT_LOGGER();
 
@@ -154,4 +184,162 @@ BOOST_AUTO_TEST_CASE(TestMemoryDB) {
                   << " ms");
 }
 
+BOOST_AUTO_TEST_CASE(TestInsertBatch) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_EXISTING = 20000;
+  const unsigned int NUM_BATCH = 20000;
+
+  // Keyed by address hex as the state trie, values of account sizes
+  std::mt19937 rng(1);
+  auto randomBytes = [&rng](unsigned int size) {
+    dev::bytes b(size);
+    for (auto& c : b) {
+      c = rng();
+    }
+    return b;
+  };
+  auto randomKey = [&randomBytes]() {
+    const std::string hex = dev::toHex(randomBytes(ACC_ADDR_SIZE));
+    return dev::bytes(hex.begin(), hex.end());
+  };
+
+  std::vector<std::pair<dev::bytes, dev::bytes>> existing, batch;
+  for (unsigned int i = 0; i < NUM_EXISTING; i++) {
+    existing.emplace_back(randomKey(), randomBytes(40));
+  }
+  for (unsigned int i = 0; i < NUM_BATCH; i++) {
+    // A quarter updates existing keys, a few keys are repeated in the batch
+    dev::bytes key;
+    if (i % 4 == 0) {
+      key = existing[i].first;
+    } else if (i % 50 == 1) {
+      key = batch[i / 2].first;
+    } else {
+      key = randomKey();
+    }
+    batch.emplace_back(key, randomBytes(20 + i % 60));
+  }
+
+  dev::MemoryDB serialDB, batchDB;
+  dev::GenericTrieDB<dev::MemoryDB> serialTrie(&serialDB), batchTrie(&batchDB);
+  serialTrie.init();
+  batchTrie.init();
+  for (const auto& item : existing) {
+    serialTrie.insert(item.first, item.second);
+    batchTrie.insert(item.first, item.second);
+  }
+
+  auto t_start = std::chrono::high_resolution_clock::now();
+  for (const auto& item : batch) {
+    serialTrie.insert(item.first, item.second);
+  }
+  auto t_serial = std::chrono::high_resolution_clock::now();
+  batchTrie.insertBatch(batch);
+  auto t_batch = std::chrono::high_resolution_clock::now();
+
+  const double serialMs =
+      std::chrono::duration<double, std::milli>(t_serial - t_start).count();
+  const double batchMs =
+      std::chrono::duration<double, std::milli>(t_batch - t_serial).count();
+  LOG_GENERAL(INFO, "Batch of " << NUM_BATCH << " keys on top of "
+                                 << NUM_EXISTING << ": serial insertions "
+                                 << serialMs << " ms, batch insertion "
+                                 << batchMs << " ms");
+
+  BOOST_CHECK_EQUAL(serialTrie.root(), batchTrie.root());
+  for (const auto& item : batch) {
+    BOOST_CHECK(batchTrie.at(item.first) == serialTrie.at(item.first));
+  }
+
+  // Into an empty trie
+  dev::MemoryDB emptyDB;
+  dev::GenericTrieDB<dev::MemoryDB> emptyTrie(&emptyDB);
+  emptyTrie.init();
+  emptyTrie.insertBatch(existing);
+  dev::MemoryDB existingDB;
+  dev::GenericTrieDB<dev::MemoryDB> existingTrie(&existingDB);
+  existingTrie.init();
+  for (const auto& item : existing) {
+    existingTrie.insert(item.first, item.second);
+  }
+  BOOST_CHECK_EQUAL(emptyTrie.root(), existingTrie.root());
+}
+
+BOOST_AUTO_TEST_CASE(TestInsertBatchNodes) {
+  INIT_STDOUT_LOGGER();
+
+  const unsigned int NUM_EXISTING = 4000;
+  const unsigned int NUM_BATCH = 4000;
+
+  std::mt19937 rng(2);
+  auto randomBytes = [&rng](unsigned int size) {
+    dev::bytes b(size);
+    for (auto& c : b) {
+      c = rng();
+    }
+    return b;
+  };
+
+  std::vector<std::pair<dev::bytes, dev::bytes>> existing, batch;
+  for (unsigned int i = 0; i < NUM_EXISTING; i++) {
+    existing.emplace_back(randomBytes(ACC_ADDR_SIZE), randomBytes(40));
+  }
+  for (unsigned int i = 0; i < NUM_BATCH; i++) {
+    // Updates of committed and uncommitted keys, repeated and new keys
+    dev::bytes key;
+    if (i % 5 == 0) {
+      key = existing[i].first;
+    } else if (i % 5 == 1) {
+      key = existing[NUM_EXISTING / 2 + i / 2].first;
+    } else if (i % 40 == 2) {
+      key = batch[i / 2].first;
+    } else {
+      key = randomBytes(ACC_ADDR_SIZE);
+    }
+    batch.emplace_back(key, randomBytes(20 + i % 60));
+  }
+
+  InspectableDB serialDB("triebatch_serial"), batchDB("triebatch_batch");
+  serialDB.ResetDB();
+  batchDB.ResetDB();
+  dev::GenericTrieDB<InspectableDB> serialTrie(&serialDB), batchTrie(&batchDB);
+  serialTrie.init();
+  batchTrie.init();
+
+  // Half of the existing keys committed, the other half still in the overlay
+  for (unsigned int i = 0; i < NUM_EXISTING; i++) {
+    serialTrie.insert(existing[i].first, existing[i].second);
+    batchTrie.insert(existing[i].first, existing[i].second);
+    if (i == NUM_EXISTING / 2 - 1) {
+      BOOST_REQUIRE(serialDB.commit());
+      BOOST_REQUIRE(batchDB.commit());
+    }
+  }
+
+  for (const auto& item : batch) {
+    serialTrie.insert(item.first, item.second);
+  }
+  batchTrie.insertBatch(batch);
+
+  // Both also hold the intermediate nodes they killed, with a refcount of 0,
+  // which differ with the order of the insertions and are purged on commit
+  BOOST_CHECK_EQUAL(serialTrie.root(), batchTrie.root());
+  BOOST_CHECK(serialDB.GetLiveNodes() == batchDB.GetLiveNodes());
+
+  std::vector<dev::h256> toPurge;
+  std::unordered_set<dev::h256> serialInserted, batchInserted;
+  BOOST_REQUIRE(serialDB.commit(false, toPurge, serialInserted));
+  BOOST_REQUIRE(batchDB.commit(false, toPurge, batchInserted));
+  BOOST_CHECK(serialInserted == batchInserted);
+  BOOST_CHECK(serialDB.GetCommitted() == batchDB.GetCommitted());
+
+  for (const auto& item : batch) {
+    BOOST_CHECK(batchTrie.at(item.first) == serialTrie.at(item.first));
+  }
+
+  serialDB.ResetDB();
+  batchDB.ResetDB();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -17,13 +17,15 @@
 
 #include <arpa/inet.h>
 #include <array>
+#include <map>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 
 #define BOOST_TEST_MODULE trietest
 #define BOOST_TEST_DYN_LINK
-#include <boost/filesystem/path.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Constants.h"
@@ -124,4 +126,227 @@ BOOST_AUTO_TEST_CASE(iterator_order) {
   delete iter;
 }
 
+BOOST_AUTO_TEST_CASE(profiles) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  BOOST_CHECK_EQUAL(LevelDB::GetProfile("state"), "point_lookup");
+  BOOST_CHECK_EQUAL(LevelDB::GetProfile("profiles"), "default");
+  BOOST_CHECK(!LevelDB::UsesBinaryKeys("state"));
+
+  const auto defaultOptions = LevelDB::GetProfileOptions("default");
+  BOOST_CHECK(defaultOptions.filter_policy == nullptr);
+  BOOST_CHECK(defaultOptions.block_cache == nullptr);
+
+  const auto pointLookupOptions = LevelDB::GetProfileOptions("point_lookup");
+  BOOST_CHECK(pointLookupOptions.filter_policy != nullptr);
+  BOOST_CHECK(pointLookupOptions.block_cache != nullptr);
+  // The block cache is shared
+  BOOST_CHECK(LevelDB::GetProfileOptions("bulk_write").block_cache ==
+              pointLookupOptions.block_cache);
+
+  // Keys of all sizes
+  LevelDB m_testDB("profiles");
+  const h256 key = h256::random();
+  const bytes value = {'k', 'e', 'y'};
+  BOOST_CHECK_EQUAL(m_testDB.Insert(key, value), 0);
+  BOOST_CHECK_EQUAL(m_testDB.Lookup(key), "key");
+  BOOST_CHECK(m_testDB.Exists(key));
+  bytes auxKey = key.asBytes();
+  auxKey.push_back(255);
+  BOOST_CHECK_EQUAL(m_testDB.Insert(auxKey, value), 0);
+  BOOST_CHECK_EQUAL(m_testDB.Lookup(bytesConstRef(&auxKey)), "key");
+  BOOST_CHECK_EQUAL(m_testDB.DeleteKey(key), 0);
+  BOOST_CHECK(!m_testDB.Exists(key));
+}
+
+BOOST_AUTO_TEST_CASE(binary_keys) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  // Listed in LEVELDB_BINARY_KEY_DBS of the constants.xml of the tests
+  BOOST_REQUIRE(LevelDB::UsesBinaryKeys("binary_keys"));
+  boost::filesystem::remove_all(STORAGE_PATH + PERSISTENCE_PATH +
+                                "/binary_keys");
+  LevelDB m_testDB("binary_keys");
+
+  vector<h256> keys;
+  for (unsigned int i = 0; i < 8; i++) {
+    keys.emplace_back(h256::random());
+  }
+  const bytes value = {'v', 'a', 'l'};
+  BOOST_CHECK_EQUAL(m_testDB.Insert(keys[0], value), 0);
+  BOOST_CHECK_EQUAL(m_testDB.Insert(keys[1], string("val")), 0);
+  BOOST_CHECK_EQUAL(m_testDB.Insert(keys[2], bytesConstRef(&value)), 0);
+  for (unsigned int i = 0; i < 3; i++) {
+    BOOST_CHECK_EQUAL(m_testDB.Lookup(keys[i]), "val");
+    BOOST_CHECK(m_testDB.Exists(keys[i]));
+
+    // Stored as the 32 bytes of the key, not in hex
+    string stored;
+    BOOST_CHECK(m_testDB.GetDB()
+                    ->Get(leveldb::ReadOptions(),
+                          leveldb::Slice((const char*)keys[i].data(),
+                                         keys[i].size),
+                          &stored)
+                    .ok());
+    BOOST_CHECK_EQUAL(stored, "val");
+    BOOST_CHECK(m_testDB.Lookup(keys[i].hex()).empty());
+  }
+  BOOST_CHECK(!m_testDB.Exists(keys[7]));
+
+  // Nodes with a reference are written, along with the aux entries
+  unordered_map<h256, pair<string, unsigned>> main;
+  unordered_map<h256, pair<bytes, bool>> aux;
+  for (unsigned int i = 3; i < 6; i++) {
+    main.emplace(keys[i], make_pair("node" + to_string(i), 1));
+  }
+  main.emplace(keys[6], make_pair("dead", 0));
+  aux.emplace(keys[3], make_pair(bytes{'a', 'u', 'x'}, true));
+  unordered_set<h256> inserted;
+  BOOST_REQUIRE(m_testDB.BatchInsert(main, aux, inserted));
+  BOOST_CHECK(inserted == unordered_set<h256>({keys[3], keys[4], keys[5]}));
+  for (unsigned int i = 3; i < 6; i++) {
+    BOOST_CHECK_EQUAL(m_testDB.Lookup(keys[i]), "node" + to_string(i));
+  }
+  BOOST_CHECK(!m_testDB.Exists(keys[6]));
+  bytes auxKey = keys[3].asBytes();
+  auxKey.push_back(255);
+  BOOST_CHECK_EQUAL(m_testDB.Lookup(bytesConstRef(&auxKey)), "aux");
+
+  BOOST_REQUIRE(m_testDB.BatchDelete({keys[3], keys[4]}));
+  BOOST_CHECK(!m_testDB.Exists(keys[3]));
+  BOOST_CHECK(!m_testDB.Exists(keys[4]));
+  BOOST_CHECK(m_testDB.Exists(keys[5]));
+  BOOST_CHECK_EQUAL(m_testDB.Lookup(bytesConstRef(&auxKey)), "aux");
+
+  BOOST_CHECK_EQUAL(m_testDB.DeleteKey(keys[0]), 0);
+  BOOST_CHECK(!m_testDB.Exists(keys[0]));
+}
+
+/// All the entries of the database at the path
+map<string, string> ReadAll(const string& dbPath) {
+  leveldb::DB* rawDB = nullptr;
+  BOOST_REQUIRE(leveldb::DB::Open(leveldb::Options(), dbPath, &rawDB).ok());
+  unique_ptr<leveldb::DB> db(rawDB);
+  unique_ptr<leveldb::Iterator> it(db->NewIterator(leveldb::ReadOptions()));
+  map<string, string> entries;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    entries.emplace(it->key().ToString(), it->value().ToString());
+  }
+  return entries;
+}
+
+BOOST_AUTO_TEST_CASE(migrate_keys) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  // A database written with hex keys, as before LEVELDB_BINARY_KEY_DBS
+  const string dbPath =
+      STORAGE_PATH + PERSISTENCE_PATH + "/migrate_keys/migrated_keys";
+  boost::filesystem::remove_all(dbPath);
+  boost::filesystem::create_directories(dbPath);
+
+  vector<h256> keys;
+  map<string, string> original;
+  for (unsigned int i = 0; i < 5; i++) {
+    keys.emplace_back(h256::random());
+    original.emplace(keys.back().hex(), "node" + to_string(i));
+  }
+  // Keys that are not h256 stay as they are
+  bytes auxKey = keys[0].asBytes();
+  auxKey.push_back(255);
+  original.emplace(string(auxKey.begin(), auxKey.end()), "aux");
+  original.emplace("metadata", "meta");
+  original.emplace(string(2 * h256::size, 'z'), "not hex");
+  {
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::DB* rawDB = nullptr;
+    BOOST_REQUIRE(leveldb::DB::Open(options, dbPath, &rawDB).ok());
+    unique_ptr<leveldb::DB> db(rawDB);
+    for (const auto& entry : original) {
+      BOOST_REQUIRE(
+          db->Put(leveldb::WriteOptions(), entry.first, entry.second).ok());
+    }
+  }
+
+  uint64_t numKeys = 0;
+  uint64_t numConverted = 0;
+  BOOST_REQUIRE(LevelDB::MigrateKeys(dbPath, true, numKeys, numConverted));
+  BOOST_CHECK_EQUAL(numKeys, original.size());
+  BOOST_CHECK_EQUAL(numConverted, keys.size());
+  BOOST_CHECK(!LevelDB::MigrateKeys(dbPath, true, numKeys, numConverted));
+  {
+    LevelDB m_testDB("migrated_keys", string("migrate_keys"), false);
+    for (unsigned int i = 0; i < keys.size(); i++) {
+      BOOST_CHECK_EQUAL(m_testDB.Lookup(keys[i]), "node" + to_string(i));
+    }
+    BOOST_CHECK_EQUAL(m_testDB.Lookup(bytesConstRef(&auxKey)), "aux");
+    BOOST_CHECK_EQUAL(m_testDB.Lookup(string("metadata")), "meta");
+  }
+
+  // and back to hex
+  BOOST_REQUIRE(LevelDB::MigrateKeys(dbPath, false, numKeys, numConverted));
+  BOOST_CHECK_EQUAL(numKeys, original.size());
+  BOOST_CHECK_EQUAL(numConverted, keys.size());
+  BOOST_CHECK(!LevelDB::MigrateKeys(dbPath, false, numKeys, numConverted));
+  map<string, string> entries = ReadAll(dbPath);
+  BOOST_CHECK_EQUAL(entries["zilliqa_key_format"], "hex");
+  entries.erase("zilliqa_key_format");
+  BOOST_CHECK(entries == original);
+
+  boost::filesystem::remove_all(dbPath);
+}
+
+BOOST_AUTO_TEST_CASE(key_format) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  const string dbPath = STORAGE_PATH + PERSISTENCE_PATH + "/key_format";
+  boost::filesystem::remove_all(dbPath);
+  boost::filesystem::create_directories(dbPath);
+
+  leveldb::Options options;
+  options.create_if_missing = true;
+  leveldb::DB* rawDB = nullptr;
+  BOOST_REQUIRE(leveldb::DB::Open(options, dbPath, &rawDB).ok());
+  unique_ptr<leveldb::DB> db(rawDB);
+
+  // An empty database takes the format it is opened with
+  BOOST_CHECK(LevelDB::CheckKeyFormat(*db, false));
+  BOOST_CHECK(LevelDB::CheckKeyFormat(*db, true));
+  BOOST_CHECK(LevelDB::CheckKeyFormat(*db, true));
+  BOOST_CHECK(!LevelDB::CheckKeyFormat(*db, false));
+
+  // One written in hex without a record is not opened with binary keys
+  BOOST_REQUIRE(
+      db->Delete(leveldb::WriteOptions(), "zilliqa_key_format").ok());
+  BOOST_REQUIRE(
+      db->Put(leveldb::WriteOptions(), h256::random().hex(), "node").ok());
+  BOOST_CHECK(LevelDB::CheckKeyFormat(*db, false));
+  BOOST_CHECK(!LevelDB::CheckKeyFormat(*db, true));
+  db.reset();
+
+  // Nor reverted to hex
+  uint64_t numKeys = 0;
+  uint64_t numConverted = 0;
+  BOOST_CHECK(!LevelDB::MigrateKeys(dbPath, false, numKeys, numConverted));
+
+  // Until it is migrated
+  BOOST_REQUIRE(LevelDB::MigrateKeys(dbPath, true, numKeys, numConverted));
+  BOOST_CHECK_EQUAL(numConverted, 1);
+  BOOST_REQUIRE(leveldb::DB::Open(options, dbPath, &rawDB).ok());
+  db.reset(rawDB);
+  BOOST_CHECK(LevelDB::CheckKeyFormat(*db, true));
+  BOOST_CHECK(!LevelDB::CheckKeyFormat(*db, false));
+  db.reset();
+
+  boost::filesystem::remove_all(dbPath);
+}
+
 BOOST_AUTO_TEST_SUITE_END()